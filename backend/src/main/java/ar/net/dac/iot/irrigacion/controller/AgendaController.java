@@ -7,6 +7,7 @@ import ar.net.dac.iot.irrigacion.dto.ZoneStatusResponse;
 import ar.net.dac.iot.irrigacion.service.AgendaService;
 import ar.net.dac.iot.irrigacion.service.MqttGateway;
 import ar.net.dac.iot.irrigacion.service.ZoneStatusService;
+import com.fasterxml.jackson.databind.node.ObjectNode;
 import jakarta.validation.Valid;
 import org.springframework.http.ResponseEntity;
 import org.springframework.web.bind.annotation.DeleteMapping;
@@ -15,6 +16,7 @@ import org.springframework.web.bind.annotation.PathVariable;
 import org.springframework.web.bind.annotation.PostMapping;
 import org.springframework.web.bind.annotation.RequestBody;
 import org.springframework.web.bind.annotation.RequestMapping;
+import org.springframework.web.bind.annotation.RequestParam;
 import org.springframework.web.bind.annotation.RestController;
 
 import java.util.List;
@@ -42,6 +44,15 @@ public class AgendaController {
         return agendaService.list(nodeId);
     }
 
+    /**
+     * Mismo payload que riego/{nodeId}/agenda/sync: delta desde la versión
+     * {@code desde} que tiene el nodo, o lista completa si no es alcanzable.
+     */
+    @GetMapping("/agendas/sync")
+    public ObjectNode sync(@PathVariable UUID nodeId, @RequestParam(defaultValue = "0") int desde) {
+        return agendaService.buildSyncPayload(nodeId, desde);
+    }
+
     @PostMapping("/agendas")
     public AgendaResponse upsert(@PathVariable UUID nodeId, @Valid @RequestBody AgendaRequest request) {
         if (!nodeId.equals(request.getNodeId())) {
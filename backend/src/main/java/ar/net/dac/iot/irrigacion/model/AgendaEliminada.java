@@ -0,0 +1,63 @@
+package ar.net.dac.iot.irrigacion.model;
+
+import jakarta.persistence.Column;
+import jakarta.persistence.Entity;
+import jakarta.persistence.Id;
+import jakarta.persistence.Index;
+import jakarta.persistence.Table;
+import java.time.OffsetDateTime;
+import java.util.UUID;
+
+/**
+ * Tombstone de una agenda eliminada: permite informar la baja en un sync delta.
+ */
+@Entity
+@Table(name = "agenda_eliminada", indexes = {
+        @Index(name = "idx_agenda_eliminada_node_version", columnList = "node_id,version")
+})
+public class AgendaEliminada {
+    @Id
+    @Column(name = "agenda_id")
+    private UUID agendaId;
+
+    @Column(name = "node_id", nullable = false)
+    private UUID nodeId;
+
+    @Column(nullable = false)
+    private int version;
+
+    @Column(name = "eliminada_at", nullable = false)
+    private OffsetDateTime eliminadaAt;
+
+    public UUID getAgendaId() {
+        return agendaId;
+    }
+
+    public void setAgendaId(UUID agendaId) {
+        this.agendaId = agendaId;
+    }
+
+    public UUID getNodeId() {
+        return nodeId;
+    }
+
+    public void setNodeId(UUID nodeId) {
+        this.nodeId = nodeId;
+    }
+
+    public int getVersion() {
+        return version;
+    }
+
+    public void setVersion(int version) {
+        this.version = version;
+    }
+
+    public OffsetDateTime getEliminadaAt() {
+        return eliminadaAt;
+    }
+
+    public void setEliminadaAt(OffsetDateTime eliminadaAt) {
+        this.eliminadaAt = eliminadaAt;
+    }
+}
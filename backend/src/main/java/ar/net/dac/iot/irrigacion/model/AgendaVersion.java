@@ -20,6 +20,10 @@ public class AgendaVersion {
     @Column(name = "updated_at", nullable = false)
     private OffsetDateTime updatedAt;
 
+    // Versión base mínima para armar un delta (menor = snapshot completo)
+    @Column(name = "delta_desde", nullable = false)
+    private int deltaDesde;
+
     public UUID getNodeId() {
         return nodeId;
     }
@@ -43,4 +47,12 @@ public class AgendaVersion {
     public void setUpdatedAt(OffsetDateTime updatedAt) {
         this.updatedAt = updatedAt;
     }
+
+    public int getDeltaDesde() {
+        return deltaDesde;
+    }
+
+    public void setDeltaDesde(int deltaDesde) {
+        this.deltaDesde = deltaDesde;
+    }
 }
@@ -31,6 +31,9 @@ public class RiegoEvento {
     @Column(name = "version_agenda")
     private Integer versionAgenda;
     
+    @Column
+    private Long seq; // Secuencia del diario de eventos del nodo (deduplicación)
+    
     @Column(columnDefinition = "jsonb")
     @JdbcTypeCode(SqlTypes.JSON)
     private String raw;
@@ -105,6 +108,14 @@ public class RiegoEvento {
         this.versionAgenda = versionAgenda;
     }
 
+    public Long getSeq() {
+        return seq;
+    }
+
+    public void setSeq(Long seq) {
+        this.seq = seq;
+    }
+
     public String getRaw() {
         return raw;
     }
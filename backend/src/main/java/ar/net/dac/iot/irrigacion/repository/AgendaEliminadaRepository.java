@@ -0,0 +1,11 @@
+package ar.net.dac.iot.irrigacion.repository;
+
+import ar.net.dac.iot.irrigacion.model.AgendaEliminada;
+import org.springframework.data.jpa.repository.JpaRepository;
+
+import java.util.List;
+import java.util.UUID;
+
+public interface AgendaEliminadaRepository extends JpaRepository<AgendaEliminada, UUID> {
+    List<AgendaEliminada> findByNodeIdAndVersionGreaterThan(UUID nodeId, int version);
+}
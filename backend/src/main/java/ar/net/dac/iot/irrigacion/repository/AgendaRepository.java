@@ -16,4 +16,6 @@ public interface AgendaRepository extends JpaRepository<Agenda, UUID> {
     List<Agenda> findActiveByNodeAndZona(UUID nodeId, short zona);
 
     Optional<Agenda> findByNodeIdAndId(UUID nodeId, UUID id);
+
+    List<Agenda> findByNodeIdAndVersionGreaterThan(UUID nodeId, int version);
 }
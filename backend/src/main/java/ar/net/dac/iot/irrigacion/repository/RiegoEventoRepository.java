@@ -19,4 +19,8 @@ public interface RiegoEventoRepository extends JpaRepository<RiegoEvento, UUID>
         UUID nodeId, Instant start, Instant end);
     
     List<RiegoEvento> findByNodeIdAndZonaOrderByTimestampDesc(UUID nodeId, Short zona);
+    
+    boolean existsByNodeIdAndSeqAndTimestamp(UUID nodeId, Long seq, Instant timestamp);
+
+    boolean existsByNodeIdAndSeq(UUID nodeId, Long seq);
 }
@@ -3,10 +3,13 @@ package ar.net.dac.iot.irrigacion.service;
 import ar.net.dac.iot.irrigacion.dto.AgendaRequest;
 import ar.net.dac.iot.irrigacion.dto.AgendaResponse;
 import ar.net.dac.iot.irrigacion.model.Agenda;
+import ar.net.dac.iot.irrigacion.model.AgendaEliminada;
 import ar.net.dac.iot.irrigacion.model.AgendaVersion;
+import ar.net.dac.iot.irrigacion.repository.AgendaEliminadaRepository;
 import ar.net.dac.iot.irrigacion.repository.AgendaRepository;
 import ar.net.dac.iot.irrigacion.repository.AgendaVersionRepository;
 import com.fasterxml.jackson.databind.ObjectMapper;
+import com.fasterxml.jackson.databind.node.ObjectNode;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 import org.springframework.stereotype.Service;
@@ -24,15 +27,18 @@ public class AgendaService {
 
     private final AgendaRepository agendaRepository;
     private final AgendaVersionRepository versionRepository;
+    private final AgendaEliminadaRepository eliminadaRepository;
     private final MqttGateway mqttGateway;
     private final ObjectMapper objectMapper;
 
     public AgendaService(AgendaRepository agendaRepository,
                          AgendaVersionRepository versionRepository,
+                         AgendaEliminadaRepository eliminadaRepository,
                          Optional<MqttGateway> mqttGateway,
                          ObjectMapper objectMapper) {
         this.agendaRepository = agendaRepository;
         this.versionRepository = versionRepository;
+        this.eliminadaRepository = eliminadaRepository;
         this.mqttGateway = mqttGateway.orElse(null);
         this.objectMapper = objectMapper;
     }
@@ -58,6 +64,8 @@ public class AgendaService {
         agenda.setUpdatedAt(OffsetDateTime.now());
 
         agendaRepository.save(agenda);
+        // Una agenda recreada con el mismo id deja de estar eliminada
+        eliminadaRepository.findById(request.getId()).ifPresent(eliminadaRepository::delete);
         publishSync(request.getNodeId(), newVersion);
         return toResponse(agenda);
     }
@@ -68,9 +76,73 @@ public class AgendaService {
                 .orElseThrow(() -> new IllegalArgumentException("Agenda no encontrada"));
         agendaRepository.delete(agenda);
         int newVersion = nextVersion(nodeId);
+
+        AgendaEliminada eliminada = new AgendaEliminada();
+        eliminada.setAgendaId(agendaId);
+        eliminada.setNodeId(nodeId);
+        eliminada.setVersion(newVersion);
+        eliminada.setEliminadaAt(OffsetDateTime.now());
+        eliminadaRepository.save(eliminada);
+
         publishSync(nodeId, newVersion);
     }
 
+    /**
+     * Payload de sync para un nodo que tiene la versión {@code desde}.
+     * Delta (agendas con version > desde + ids eliminados) si la versión es
+     * alcanzable; si no (0, futura o anterior a delta_desde), lista completa.
+     */
+    @Transactional(readOnly = true)
+    public ObjectNode buildSyncPayload(UUID nodeId, int desde) {
+        Optional<AgendaVersion> current = versionRepository.findByNodeId(nodeId);
+        int version = current.map(AgendaVersion::getVersion).orElse(0);
+        int deltaDesde = current.map(AgendaVersion::getDeltaDesde).orElse(0);
+        boolean delta = desde > 0 && desde >= deltaDesde && desde <= version;
+
+        List<Agenda> agendas = delta
+                ? agendaRepository.findByNodeIdAndVersionGreaterThan(nodeId, desde)
+                : agendaRepository.findByNodeId(nodeId);
+
+        ObjectNode payload = objectMapper.createObjectNode();
+        payload.put("tipo", delta ? "delta" : "completa");
+        if (delta) {
+            payload.put("baseVersion", desde);
+        }
+        payload.put("version", version);
+        payload.put("updatedAt", OffsetDateTime.now().toString());
+        var arr = payload.putArray("agendas");
+        agendas.forEach(a -> {
+            var n = arr.addObject();
+            n.put("id", a.getId().toString());
+            n.put("zona", a.getZona());
+            var dias = n.putArray("diasSemana");
+            a.getDiasSemana().forEach(dias::add);
+            n.put("horaInicio", a.getHoraInicio().toString());
+            n.put("duracionMin", a.getDuracionMin());
+            n.put("activa", a.isActiva());
+        });
+        if (delta) {
+            var eliminadas = payload.putArray("eliminadas");
+            eliminadaRepository.findByNodeIdAndVersionGreaterThan(nodeId, desde)
+                    .forEach(e -> eliminadas.add(e.getAgendaId().toString()));
+        }
+        return payload;
+    }
+
+    /**
+     * Versión reportada por el nodo (riego/{nodeId}/agenda/version): si está
+     * atrasado se le publica el delta desde esa versión (o la lista completa).
+     */
+    @Transactional(readOnly = true)
+    public void onNodeVersion(UUID nodeId, int nodeVersion) {
+        int version = versionRepository.findByNodeId(nodeId).map(AgendaVersion::getVersion).orElse(0);
+        if (nodeVersion == version && nodeVersion > 0) {
+            log.debug("Nodo al dia nodeId={} version={}", nodeId, version);
+            return;
+        }
+        publishPayload(nodeId, buildSyncPayload(nodeId, nodeVersion));
+    }
+
     private void validateNoOverlap(AgendaRequest req) {
         List<Agenda> agendas = agendaRepository.findActiveByNodeAndZona(req.getNodeId(), req.getZona());
         LocalTime start = LocalTime.parse(req.getHoraInicio());
@@ -103,30 +175,22 @@ public class AgendaService {
         return version.getVersion();
     }
 
+    // Cada cambio se publica como delta desde la versión anterior; los nodos
+    // que no estén en esa versión piden el resto reportando la suya.
     private void publishSync(UUID nodeId, int version) {
+        publishPayload(nodeId, buildSyncPayload(nodeId, version - 1));
+    }
+
+    private void publishPayload(UUID nodeId, ObjectNode payload) {
         if (mqttGateway == null || !mqttGateway.isEnabled()) {
             log.info("MQTT deshabilitado; no se publica sync");
             return;
         }
         try {
-            List<Agenda> agendas = agendaRepository.findByNodeId(nodeId);
-            var payload = objectMapper.createObjectNode();
-            payload.put("version", version);
-            payload.put("updatedAt", OffsetDateTime.now().toString());
-            var arr = payload.putArray("agendas");
-            agendas.forEach(a -> {
-                var n = arr.addObject();
-                n.put("id", a.getId().toString());
-                n.put("zona", a.getZona());
-                var dias = n.putArray("diasSemana");
-                a.getDiasSemana().forEach(dias::add);
-                n.put("horaInicio", a.getHoraInicio().toString());
-                n.put("duracionMin", a.getDuracionMin());
-                n.put("activa", a.isActiva());
-            });
             String topic = "riego/" + nodeId + "/agenda/sync";
             mqttGateway.publish(topic, objectMapper.writeValueAsBytes(payload));
-            log.info("Publicado sync version={} nodeId={} agendas={}", version, nodeId, agendas.size());
+            log.info("Publicado sync tipo={} version={} nodeId={} agendas={}", payload.get("tipo").asText(),
+                    payload.get("version").asInt(), nodeId, payload.get("agendas").size());
         } catch (Exception e) {
             throw new RuntimeException("Error publicando sync MQTT", e);
         }
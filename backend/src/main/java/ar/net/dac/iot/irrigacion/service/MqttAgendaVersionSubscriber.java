@@ -0,0 +1,110 @@
+package ar.net.dac.iot.irrigacion.service;
+
+import com.fasterxml.jackson.databind.JsonNode;
+import com.fasterxml.jackson.databind.ObjectMapper;
+import com.hivemq.client.mqtt.mqtt5.Mqtt5BlockingClient;
+import jakarta.annotation.PostConstruct;
+import jakarta.annotation.PreDestroy;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+import org.springframework.boot.autoconfigure.condition.ConditionalOnBean;
+import org.springframework.stereotype.Service;
+
+import java.nio.charset.StandardCharsets;
+import java.util.Optional;
+import java.util.UUID;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+
+/**
+ * Subscriber para la versión de agenda reportada por los nodos (sync delta).
+ * Topic: riego/{nodeId}/agenda/version
+ * Payload: {"version": N} (0 = sin agenda o agenda inválida: pide lista completa).
+ * Responde en riego/{nodeId}/agenda/sync con el delta desde N o la lista completa.
+ */
+@Service
+@ConditionalOnBean(Mqtt5BlockingClient.class)
+public class MqttAgendaVersionSubscriber {
+
+    private static final Logger log = LoggerFactory.getLogger(MqttAgendaVersionSubscriber.class);
+
+    private final Mqtt5BlockingClient mqttClient;
+    private final AgendaService agendaService;
+    private final ObjectMapper objectMapper = new ObjectMapper();
+    private final ExecutorService executor = Executors.newSingleThreadExecutor();
+    private volatile boolean running = false;
+
+    public MqttAgendaVersionSubscriber(Optional<Mqtt5BlockingClient> mqttClient, AgendaService agendaService) {
+        this.mqttClient = mqttClient.orElse(null);
+        this.agendaService = agendaService;
+    }
+
+    @PostConstruct
+    public void startSubscription() {
+        if (mqttClient == null) {
+            log.warn("MQTT no disponible, no se suscribirá a versiones de agenda");
+            return;
+        }
+
+        running = true;
+        executor.submit(() -> {
+            try {
+                mqttClient.toAsync().subscribeWith()
+                    .topicFilter("riego/+/agenda/version")
+                    .callback(publish -> {
+                        try {
+                            String topic = publish.getTopic().toString();
+                            String payload = new String(publish.getPayloadAsBytes(), StandardCharsets.UTF_8);
+                            handleVersionReport(topic, payload);
+                        } catch (Exception e) {
+                            log.error("Error procesando versión de agenda", e);
+                        }
+                    })
+                    .send();
+
+                log.info("Suscrito a topics MQTT de versión de agenda: riego/+/agenda/version");
+
+                while (running) {
+                    Thread.sleep(1000);
+                }
+            } catch (InterruptedException e) {
+                Thread.currentThread().interrupt();
+                log.info("Suscripción MQTT de versión de agenda interrumpida");
+            } catch (Exception e) {
+                log.error("Error en suscripción MQTT de versión de agenda", e);
+            }
+        });
+    }
+
+    @PreDestroy
+    public void stopSubscription() {
+        running = false;
+        executor.shutdownNow();
+    }
+
+    private void handleVersionReport(String topic, String payload) {
+        try {
+            // Topic format: riego/{nodeId}/agenda/version
+            String[] parts = topic.split("/");
+            if (parts.length < 4) {
+                log.warn("Formato de topic inválido: {}", topic);
+                return;
+            }
+
+            UUID nodeId = UUID.fromString(parts[1]);
+
+            JsonNode json = objectMapper.readTree(payload);
+            if (!json.hasNonNull("version") || !json.get("version").canConvertToInt()) {
+                log.warn("Reporte de versión sin campo version, se descarta: {}", payload);
+                return;
+            }
+
+            int version = json.get("version").asInt();
+            log.info("[Agenda] nodeId={} reporta version={}", nodeId, version);
+            agendaService.onNodeVersion(nodeId, version);
+
+        } catch (Exception e) {
+            log.error("Error parseando versión de agenda: payload={} error={}", payload, e.getMessage());
+        }
+    }
+}
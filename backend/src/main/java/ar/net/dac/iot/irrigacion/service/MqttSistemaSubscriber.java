@@ -111,6 +111,8 @@ public class MqttSistemaSubscriber {
                     log.error("[Sistema] nodeId={} tipo={} detalles={}", nodeId, tipo, detalles);
                     break;
                 case "agenda_fetch_warning":
+                case "agenda_delta_error":
+                case "mqtt_recovery":
                     log.warn("[Sistema] nodeId={} tipo={} detalles={}", nodeId, tipo, detalles);
                     break;
                 default:
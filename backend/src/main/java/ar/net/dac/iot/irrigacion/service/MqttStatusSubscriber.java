@@ -10,6 +10,8 @@ import org.springframework.boot.autoconfigure.condition.ConditionalOnBean;
 import org.springframework.stereotype.Service;
 
 import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+import java.util.List;
 import java.util.Map;
 import java.util.Optional;
 import java.util.UUID;
@@ -56,7 +58,21 @@ public class MqttStatusSubscriber {
                     })
                     .send();
                 
-                log.info("Suscrito a topics MQTT de status: riego/+/status/zona/+");
+                // Estado agregado (un mensaje con todas las zonas)
+                mqttClient.toAsync().subscribeWith()
+                    .topicFilter("riego/+/status/zonas")
+                    .callback(publish -> {
+                        try {
+                            String topic = publish.getTopic().toString();
+                            String payload = new String(publish.getPayloadAsBytes(), StandardCharsets.UTF_8);
+                            handleZonesStatusMessage(topic, payload);
+                        } catch (Exception e) {
+                            log.error("Error procesando mensaje MQTT status agregado", e);
+                        }
+                    })
+                    .send();
+                
+                log.info("Suscrito a topics MQTT de status: riego/+/status/zona/+, riego/+/status/zonas");
                 
                 // Mantener vivo
                 while (running) {
@@ -104,4 +120,36 @@ public class MqttStatusSubscriber {
             log.error("Error parseando mensaje status: topic={} payload={}", topic, payload, e);
         }
     }
+
+    private void handleZonesStatusMessage(String topic, String payload) {
+        try {
+            // Topic format: riego/{nodeId}/status/zonas
+            String[] parts = topic.split("/");
+            if (parts.length != 4) {
+                log.warn("Formato de topic inválido: {}", topic);
+                return;
+            }
+
+            UUID nodeId = UUID.fromString(parts[1]);
+
+            // Parse payload JSON: {"activas": mascara, "restante": [seg zona 1, ..., seg zona N]}
+            Map<String, Object> data = objectMapper.readValue(payload, Map.class);
+            int activas = ((Number) data.getOrDefault("activas", 0)).intValue();
+            List<Integer> restante = new ArrayList<>();
+            Object raw = data.get("restante");
+            if (raw instanceof List<?> valores) {
+                for (Object valor : valores) {
+                    restante.add(valor instanceof Number n ? n.intValue() : 0);
+                }
+            }
+
+            zoneStatusService.updateZonesStatus(nodeId, activas, restante);
+            
+            log.debug("Status agregado actualizado: node={} activas={} restante={}", 
+                nodeId, activas, restante);
+
+        } catch (Exception e) {
+            log.error("Error parseando mensaje status agregado: topic={} payload={}", topic, payload, e);
+        }
+    }
 }
@@ -43,6 +43,9 @@ public class RiegoEventoService {
             String evento = json.get("evento").asText(); // "inicio" o "fin"
             long timestamp = json.get("timestamp").asLong();
             String origen = json.get("origen").asText(); // "agenda" o "manual"
+            // seq del diario de eventos del nodo (ausente en firmware anterior y
+            // en eventos publicados directo, que no se reenvían)
+            Long seq = json.hasNonNull("seq") && json.get("seq").asLong() > 0 ? json.get("seq").asLong() : null;
 
             // Solo guardamos eventos de "fin" con la duración real
             if ("fin".equals(evento)) {
@@ -51,10 +54,28 @@ public class RiegoEventoService {
                     return;
                 }
 
+                // El nodo registra 0 si no tenía hora NTP al momento del evento
+                Instant instant = timestamp > 0 ? Instant.ofEpochSecond(timestamp) : Instant.now();
+                if (timestamp <= 0) {
+                    log.warn("Evento 'fin' sin timestamp NTP, se usa la hora de recepción: nodeId={}, seq={}", nodeId, seq);
+                }
+
+                // Reenvío del diario del nodo (evento ya recibido): descartar. Sin
+                // NTP el timestamp guardado es el de recepción y no coincide entre
+                // reenvíos: se deduplica solo por (nodo, seq)
+                boolean duplicado = seq != null && (timestamp > 0
+                    ? repository.existsByNodeIdAndSeqAndTimestamp(nodeId, seq, instant)
+                    : repository.existsByNodeIdAndSeq(nodeId, seq));
+                if (duplicado) {
+                    log.info("Evento de riego duplicado, se descarta: nodeId={}, seq={}", nodeId, seq);
+                    return;
+                }
+
                 RiegoEvento riegoEvento = new RiegoEvento();
                 riegoEvento.setNodeId(nodeId);
                 riegoEvento.setZona(zona);
-                riegoEvento.setTimestamp(Instant.ofEpochSecond(timestamp));
+                riegoEvento.setTimestamp(instant);
+                riegoEvento.setSeq(seq);
                 riegoEvento.setDuracionSeg(json.get("duracionReal").asInt());
                 riegoEvento.setOrigen(origen);
 
@@ -65,11 +86,12 @@ public class RiegoEventoService {
                 riegoEvento.setRaw(payload);
 
                 repository.save(riegoEvento);
-                log.info("Evento de riego guardado: nodeId={}, zona={}, duracion={}s, origen={}",
-                         nodeId, zona, riegoEvento.getDuracionSeg(), origen);
+                log.info("Evento de riego guardado: nodeId={}, zona={}, duracion={}s, origen={}, seq={}",
+                         nodeId, zona, riegoEvento.getDuracionSeg(), origen, seq);
             } else {
-                log.debug("Evento de inicio recibido: nodeId={}, zona={}, origen={}",
-                         nodeId, zona, origen);
+                // "inicio", "en_cola" o "cancelado": solo se loggean
+                log.debug("Evento '{}' recibido: nodeId={}, zona={}, origen={}",
+                         evento, nodeId, zona, origen);
             }
 
         } catch (Exception e) {
@@ -53,8 +53,11 @@ public class ZoneStatusService {
             
             ZoneStatus status = nodeStatus.get((int) zonaConfig.getZona());
             if (status != null) {
-                response.setActiva(status.activa);
-                response.setTiempoRestanteSeg(status.tiempoRestanteSeg);
+                // El nodo publica solo cambios: el tiempo restante se
+                // extrapola desde la última actualización
+                int restante = status.tiempoRestanteActual(clock.millis());
+                response.setActiva(status.activa && restante > 0);
+                response.setTiempoRestanteSeg(restante);
             } else {
                 response.setActiva(false);
                 response.setTiempoRestanteSeg(0);
@@ -78,7 +81,19 @@ public class ZoneStatusService {
         ZoneStatus status = nodeStatus.computeIfAbsent(zona, k -> new ZoneStatus());
         status.activa = activa;
         status.tiempoRestanteSeg = tiempoRestanteSeg;
-        status.lastUpdate = System.currentTimeMillis();
+        status.lastUpdate = clock.millis();
+    }
+
+    /**
+     * Estado agregado de todas las zonas (topic status/zonas): bit z-1 de la
+     * máscara indica zona z activa y restante[z-1] su tiempo restante.
+     */
+    public void updateZonesStatus(UUID nodeId, int activas, List<Integer> restante) {
+        for (int i = 0; i < restante.size(); i++) {
+            boolean activa = (activas & (1 << i)) != 0;
+            Integer tiempo = restante.get(i);
+            updateZoneStatus(nodeId, i + 1, activa, activa && tiempo != null ? tiempo : 0);
+        }
     }
 
     private String calcularProximoRiego(UUID nodeId, int zona) {
@@ -170,5 +185,13 @@ public class ZoneStatusService {
         boolean activa = false;
         Integer tiempoRestanteSeg = 0;
         long lastUpdate = 0;
+
+        int tiempoRestanteActual(long nowMillis) {
+            if (!activa || tiempoRestanteSeg == null) {
+                return 0;
+            }
+            long transcurridoSeg = Math.max(0, nowMillis - lastUpdate) / 1000;
+            return (int) Math.max(0, tiempoRestanteSeg - transcurridoSeg);
+        }
     }
 }
@@ -0,0 +1,25 @@
+-- Flyway V4: Sincronización incremental (delta) de agendas
+
+-- Tombstones de agendas eliminadas: un nodo que reporta la versión N recibe
+-- las agendas con version > N y las eliminadas con version > N.
+CREATE TABLE IF NOT EXISTS agenda_eliminada (
+    agenda_id UUID PRIMARY KEY,
+    node_id UUID NOT NULL,
+    version INTEGER NOT NULL,
+    eliminada_at TIMESTAMPTZ NOT NULL DEFAULT NOW()
+);
+CREATE INDEX IF NOT EXISTS idx_agenda_eliminada_node_version ON agenda_eliminada (node_id, version);
+
+-- Versión mínima desde la que se puede armar un delta. Las eliminaciones
+-- previas a esta migración no tienen tombstone: esos nodos reciben la lista completa.
+ALTER TABLE agenda_version ADD COLUMN IF NOT EXISTS delta_desde INTEGER NOT NULL DEFAULT 0;
+UPDATE agenda_version SET delta_desde = version;
+
+COMMENT ON TABLE agenda_eliminada IS 'Agendas eliminadas por nodo y versión (sync delta)';
+COMMENT ON COLUMN agenda_version.delta_desde IS 'Versión base mínima para enviar delta; menor = snapshot completo';
+
+-- Retención sugerida (ejecutar como job programado): al purgar tombstones,
+-- subir delta_desde a la mayor versión purgada para no perder eliminaciones.
+-- UPDATE agenda_version v SET delta_desde = GREATEST(delta_desde, (SELECT MAX(version) FROM agenda_eliminada e
+--     WHERE e.node_id = v.node_id AND e.eliminada_at < NOW() - INTERVAL '90 days'));
+-- DELETE FROM agenda_eliminada WHERE eliminada_at < NOW() - INTERVAL '90 days';
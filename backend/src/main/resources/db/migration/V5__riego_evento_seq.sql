@@ -0,0 +1,10 @@
+-- Flyway V5: Deduplicación de eventos de riego reenviados por el nodo
+
+-- El ESP8266 guarda cada evento en un diario en flash con número de secuencia
+-- y lo publica desde ahí; tras un corte puede reenviar eventos ya recibidos.
+-- Un reenvío conserva seq y timestamp originales. El timestamp entra en la
+-- clave porque la secuencia vuelve a 1 si se formatea la flash del nodo.
+ALTER TABLE riego_evento ADD COLUMN IF NOT EXISTS seq BIGINT;
+ALTER TABLE riego_evento ADD CONSTRAINT ux_riego_evento_seq UNIQUE (node_id, seq, timestamp);
+
+COMMENT ON COLUMN riego_evento.seq IS 'Secuencia del diario de eventos del nodo (null en eventos previos a V5)';
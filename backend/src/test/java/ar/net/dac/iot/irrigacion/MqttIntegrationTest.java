@@ -81,6 +81,10 @@ class MqttIntegrationTest {
         testClient.subscribeWith()
                 .topicFilter("riego/#")
                 .callback(publish -> {
+                    // Ignorar los reportes de versión que publica el propio test
+                    if (publish.getTopic().toString().endsWith("/agenda/version")) {
+                        return;
+                    }
                     String payload = new String(publish.getPayloadAsBytes(), StandardCharsets.UTF_8);
                     receivedMessages.offer(payload);
                 })
@@ -145,4 +149,86 @@ class MqttIntegrationTest {
         assertNotNull(payload2, "Debe publicar al actualizar");
         assertTrue(payload2.contains("\"version\":2"), "Versión debe incrementarse a 2");
     }
+
+    @Test
+    void whenAgendaDeleted_thenPublishesDeltaWithTombstone() throws Exception {
+        UUID nodeId = UUID.randomUUID();
+        UUID agendaId = UUID.randomUUID();
+
+        AgendaRequest request = new AgendaRequest();
+        request.setId(agendaId);
+        request.setNodeId(nodeId);
+        request.setZona((short) 3);
+        request.setDiasSemana(List.of("JUE"));
+        request.setHoraInicio("07:00");
+        request.setDuracionMin((short) 10);
+        request.setActiva(true);
+
+        agendaService.upsert(request);
+        assertNotNull(receivedMessages.poll(3, TimeUnit.SECONDS)); // consumir v1
+
+        agendaService.delete(nodeId, agendaId);
+
+        String payload = receivedMessages.poll(3, TimeUnit.SECONDS);
+        assertNotNull(payload, "Debe publicar al eliminar");
+        assertTrue(payload.contains("\"tipo\":\"delta\""), "Debe publicar un delta");
+        assertTrue(payload.contains("\"baseVersion\":1"), "Delta desde la versión 1");
+        assertTrue(payload.contains("\"eliminadas\":[\"" + agendaId + "\"]"), "Delta debe incluir la agenda eliminada");
+    }
+
+    @Test
+    void whenNodeReportsOldVersion_thenPublishesDeltaSinceThatVersion() throws Exception {
+        UUID nodeId = UUID.randomUUID();
+        UUID firstId = UUID.randomUUID();
+        UUID secondId = UUID.randomUUID();
+
+        AgendaRequest first = new AgendaRequest();
+        first.setId(firstId);
+        first.setNodeId(nodeId);
+        first.setZona((short) 1);
+        first.setDiasSemana(List.of("LUN"));
+        first.setHoraInicio("05:00");
+        first.setDuracionMin((short) 10);
+        first.setActiva(true);
+        agendaService.upsert(first);
+
+        AgendaRequest second = new AgendaRequest();
+        second.setId(secondId);
+        second.setNodeId(nodeId);
+        second.setZona((short) 2);
+        second.setDiasSemana(List.of("LUN"));
+        second.setHoraInicio("05:00");
+        second.setDuracionMin((short) 10);
+        second.setActiva(true);
+        agendaService.upsert(second);
+
+        assertNotNull(receivedMessages.poll(3, TimeUnit.SECONDS)); // v1
+        assertNotNull(receivedMessages.poll(3, TimeUnit.SECONDS)); // v2
+
+        // El nodo quedó en la versión 1 (perdió el delta de la 2)
+        testClient.publishWith()
+                .topic("riego/" + nodeId + "/agenda/version")
+                .payload("{\"version\":1}".getBytes(StandardCharsets.UTF_8))
+                .send()
+                .join();
+
+        String payload = receivedMessages.poll(5, TimeUnit.SECONDS);
+        assertNotNull(payload, "Debe responder al reporte de versión");
+        assertTrue(payload.contains("\"tipo\":\"delta\""), "Debe responder con un delta");
+        assertTrue(payload.contains("\"version\":2"), "Delta hasta la versión 2");
+        assertTrue(payload.contains(secondId.toString()), "Delta debe incluir la agenda nueva");
+        assertFalse(payload.contains(firstId.toString()), "Delta no debe repetir agendas sin cambios");
+
+        // Versión 0 (sin agenda local): lista completa
+        testClient.publishWith()
+                .topic("riego/" + nodeId + "/agenda/version")
+                .payload("{\"version\":0}".getBytes(StandardCharsets.UTF_8))
+                .send()
+                .join();
+
+        String full = receivedMessages.poll(5, TimeUnit.SECONDS);
+        assertNotNull(full, "Debe responder con la lista completa");
+        assertTrue(full.contains("\"tipo\":\"completa\""));
+        assertTrue(full.contains(firstId.toString()) && full.contains(secondId.toString()));
+    }
 }
@@ -0,0 +1,89 @@
+package ar.net.dac.iot.irrigacion.service;
+
+import ar.net.dac.iot.irrigacion.model.RiegoEvento;
+import ar.net.dac.iot.irrigacion.repository.RiegoEventoRepository;
+import com.fasterxml.jackson.databind.ObjectMapper;
+import org.junit.jupiter.api.BeforeEach;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.api.extension.ExtendWith;
+import org.mockito.ArgumentCaptor;
+import org.mockito.Mock;
+import org.mockito.junit.jupiter.MockitoExtension;
+
+import java.time.Instant;
+import java.util.UUID;
+
+import static org.junit.jupiter.api.Assertions.*;
+import static org.mockito.ArgumentMatchers.any;
+import static org.mockito.Mockito.never;
+import static org.mockito.Mockito.verify;
+import static org.mockito.Mockito.when;
+
+@ExtendWith(MockitoExtension.class)
+class RiegoEventoServiceTest {
+
+    @Mock
+    private RiegoEventoRepository repository;
+
+    private RiegoEventoService service;
+    private UUID nodeId;
+
+    @BeforeEach
+    void setUp() {
+        service = new RiegoEventoService(repository, new ObjectMapper());
+        nodeId = UUID.randomUUID();
+    }
+
+    private static String finPayload(long seq) {
+        return "{\"zona\":2,\"evento\":\"fin\",\"timestamp\":1735415280,\"origen\":\"agenda\","
+             + "\"duracionReal\":600,\"versionAgenda\":7,\"seq\":" + seq + "}";
+    }
+
+    @Test
+    void whenEventoFinWithSeq_thenSavesSeqAndOriginalTimestamp() {
+        Instant timestamp = Instant.ofEpochSecond(1735415280L);
+        when(repository.existsByNodeIdAndSeqAndTimestamp(nodeId, 41L, timestamp)).thenReturn(false);
+
+        service.procesarEvento(nodeId, finPayload(41));
+
+        ArgumentCaptor<RiegoEvento> captor = ArgumentCaptor.forClass(RiegoEvento.class);
+        verify(repository).save(captor.capture());
+        RiegoEvento saved = captor.getValue();
+        assertEquals(41L, saved.getSeq());
+        assertEquals(timestamp, saved.getTimestamp());
+        assertEquals(600, saved.getDuracionSeg());
+        assertEquals(7, saved.getVersionAgenda());
+    }
+
+    @Test
+    void whenEventoReplayed_thenDuplicateIsDiscarded() {
+        Instant timestamp = Instant.ofEpochSecond(1735415280L);
+        when(repository.existsByNodeIdAndSeqAndTimestamp(nodeId, 41L, timestamp)).thenReturn(true);
+
+        service.procesarEvento(nodeId, finPayload(41));
+
+        verify(repository, never()).save(any());
+    }
+
+    @Test
+    void whenEventoWithoutNtpReplayed_thenDeduplicatedBySeqOnly() {
+        when(repository.existsByNodeIdAndSeq(nodeId, 12L)).thenReturn(true);
+
+        service.procesarEvento(nodeId, "{\"zona\":2,\"evento\":\"fin\",\"timestamp\":0,\"origen\":\"agenda\","
+            + "\"duracionReal\":600,\"versionAgenda\":7,\"seq\":12}");
+
+        verify(repository, never()).existsByNodeIdAndSeqAndTimestamp(any(), any(), any());
+        verify(repository, never()).save(any());
+    }
+
+    @Test
+    void whenEventoWithoutSeq_thenSavedWithoutDeduplication() {
+        service.procesarEvento(nodeId, "{\"zona\":1,\"evento\":\"fin\",\"timestamp\":1735415280,"
+            + "\"origen\":\"manual\",\"duracionReal\":30,\"versionAgenda\":null}");
+
+        ArgumentCaptor<RiegoEvento> captor = ArgumentCaptor.forClass(RiegoEvento.class);
+        verify(repository).save(captor.capture());
+        assertNull(captor.getValue().getSeq());
+        verify(repository, never()).existsByNodeIdAndSeqAndTimestamp(any(), any(), any());
+    }
+}
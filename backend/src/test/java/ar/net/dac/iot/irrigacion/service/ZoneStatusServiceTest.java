@@ -281,6 +281,63 @@ class ZoneStatusServiceTest {
         );
     }
 
+    @Test
+    void testUpdateZonesStatus_mascaraYRestante() {
+        // Given: Zonas 1 y 2 configuradas
+        var zona1 = new ar.net.dac.iot.irrigacion.dto.ZoneConfigResponse();
+        zona1.setZona((short) 1);
+        zona1.setNombre("Zona 1");
+        var zona2 = new ar.net.dac.iot.irrigacion.dto.ZoneConfigResponse();
+        zona2.setZona((short) 2);
+        zona2.setNombre("Zona 2");
+        when(zoneConfigService.listEnabledByNode(testNodeId)).thenReturn(List.of(zona1, zona2));
+        when(agendaRepository.findActiveByNodeAndZona(any(), anyShort())).thenReturn(Collections.emptyList());
+
+        // When: Llega el estado agregado {"activas":2,"restante":[0,275,0,...]}
+        zoneStatusService.updateZonesStatus(testNodeId, 0b10, List.of(0, 275, 0, 0, 0, 0, 0, 0));
+
+        // Then: Solo la zona 2 queda activa, con su tiempo restante
+        List<ZoneStatusResponse> status = zoneStatusService.getStatus(testNodeId);
+        assertFalse(status.get(0).isActiva());
+        assertEquals(0, status.get(0).getTiempoRestanteSeg());
+        assertTrue(status.get(1).isActiva());
+        assertEquals(275, status.get(1).getTiempoRestanteSeg());
+
+        // When: La zona 2 termina
+        zoneStatusService.updateZonesStatus(testNodeId, 0, List.of(0, 0, 0, 0, 0, 0, 0, 0));
+
+        // Then: Se apaga sin necesidad de un mensaje por zona
+        assertFalse(zoneStatusService.getStatus(testNodeId).get(1).isActiva());
+    }
+
+    @Test
+    void testGetStatus_extrapolaTiempoRestanteDesdeUltimaPublicacion() {
+        // Given: Zona 1 activa con 275 s publicada a t0
+        var zona1 = new ar.net.dac.iot.irrigacion.dto.ZoneConfigResponse();
+        zona1.setZona((short) 1);
+        zona1.setNombre("Zona 1");
+        when(zoneConfigService.listEnabledByNode(testNodeId)).thenReturn(List.of(zona1));
+        when(agendaRepository.findActiveByNodeAndZona(any(), anyShort())).thenReturn(Collections.emptyList());
+        when(clock.millis()).thenReturn(1_000_000L);
+        zoneStatusService.updateZoneStatus(testNodeId, 1, true, 275);
+
+        // When: Pasa un minuto sin nuevas publicaciones (el nodo publica solo cambios)
+        when(clock.millis()).thenReturn(1_060_000L);
+        ZoneStatusResponse status = zoneStatusService.getStatus(testNodeId).get(0);
+
+        // Then: El tiempo restante se descuenta localmente
+        assertTrue(status.isActiva());
+        assertEquals(215, status.getTiempoRestanteSeg());
+
+        // When: Vence el tiempo publicado
+        when(clock.millis()).thenReturn(1_300_000L);
+        status = zoneStatusService.getStatus(testNodeId).get(0);
+
+        // Then: La zona se muestra inactiva
+        assertFalse(status.isActiva());
+        assertEquals(0, status.getTiempoRestanteSeg());
+    }
+
     // --- Helpers ---
 
     private Agenda crearAgenda(String nombre, short zona, LocalTime hora, int duracion, String... dias) {
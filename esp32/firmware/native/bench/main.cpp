@@ -0,0 +1,120 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "config/Config.h"
+#include "utils/AgendaBenchmark.h"
+#include "network/MqttPayloads.h"
+
+// ============================================================================
+// Benchmark de agendas en host
+// ============================================================================
+// Uso: pio run -e native_bench -t exec
+//      .pio/build/native_bench/program [cantidades...]   (ej: 8 32 128 256)
+//      .pio/build/native_bench/program payloads          (publicaciones MQTT)
+// Salida: una línea JSON por tamaño en stdout. Los logs del firmware (Serial)
+// se silencian para que la salida sea directamente procesable.
+
+// Print sobre stdout, independiente de Serial
+class StdoutPrint : public Print {
+public:
+    using Print::write;
+    
+    size_t write(uint8_t c) override {
+        return fputc(c, stdout) == EOF ? 0 : 1;
+    }
+    
+    size_t write(const uint8_t* buffer, size_t size) override {
+        return fwrite(buffer, 1, size, stdout);
+    }
+};
+
+// ============================================================================
+// Payloads MQTT: StaticJsonDocument + serializeJson vs JsonWriter
+// ============================================================================
+#define PAYLOAD_BENCH_ITERATIONS 100000
+
+static volatile size_t benchSink = 0;  // Evita que el compilador descarte el trabajo
+
+static uint32_t nsPerIteration(unsigned long startUs) {
+    return (uint32_t)((micros() - startUs) * 1000UL / PAYLOAD_BENCH_ITERATIONS);
+}
+
+static void runPayloadBench(Print& out) {
+    char payload[JSON_BUFFER_MEDIUM];
+    JsonWriter writer(payload, sizeof(payload));
+    const char* detalles = "Agendas cargadas: 9 total, 9 activas";
+    
+    unsigned long start = micros();
+    for (uint32_t i = 0; i < PAYLOAD_BENCH_ITERATIONS; i++) {
+        StaticJsonDocument<JSON_BUFFER_SMALL> doc;
+        doc["activa"] = true;
+        doc["tiempoRestante"] = (int)(i & 0x3FF);
+        benchSink += serializeJson(doc, payload, sizeof(payload));
+    }
+    uint32_t statusDocNs = nsPerIteration(start);
+    
+    start = micros();
+    for (uint32_t i = 0; i < PAYLOAD_BENCH_ITERATIONS; i++) {
+        MqttPayloads::zoneStatus(writer, true, (int32_t)(i & 0x3FF));
+        benchSink += writer.length();
+    }
+    uint32_t statusWriterNs = nsPerIteration(start);
+    
+    start = micros();
+    for (uint32_t i = 0; i < PAYLOAD_BENCH_ITERATIONS; i++) {
+        StaticJsonDocument<JSON_BUFFER_MEDIUM> doc;
+        doc["tipo"] = String("agenda_sync_ok");
+        doc["timestamp"] = i;
+        doc["detalles"] = String(detalles);
+        doc["agendasCargadas"] = 9;
+        doc["memoriaLibre"] = 38256;
+        benchSink += serializeJson(doc, payload, sizeof(payload));
+    }
+    uint32_t eventDocNs = nsPerIteration(start);
+    
+    start = micros();
+    for (uint32_t i = 0; i < PAYLOAD_BENCH_ITERATIONS; i++) {
+        MqttPayloads::systemEvent(writer, SYS_AGENDA_SYNC_OK, i, detalles, 9, 38256);
+        benchSink += writer.length();
+    }
+    uint32_t eventWriterNs = nsPerIteration(start);
+    
+    char line[256];
+    snprintf(line, sizeof(line),
+             "{\"bench\":\"payloads\",\"iterations\":%d,"
+             "\"zoneStatusDocNs\":%lu,\"zoneStatusWriterNs\":%lu,"
+             "\"systemEventDocNs\":%lu,\"systemEventWriterNs\":%lu}",
+             PAYLOAD_BENCH_ITERATIONS,
+             (unsigned long)statusDocNs, (unsigned long)statusWriterNs,
+             (unsigned long)eventDocNs, (unsigned long)eventWriterNs);
+    out.println(line);
+}
+
+int main(int argc, char** argv) {
+    StdoutPrint out;
+    NativeShim::setSerialQuiet(true);
+    LittleFS.begin();
+    
+    if (argc <= 1) {
+        AgendaBenchmark::runSuite(out);
+        return 0;
+    }
+    
+    if (strcmp(argv[1], "payloads") == 0) {
+        runPayloadBench(out);
+        return 0;
+    }
+    
+    int failures = 0;
+    AgendaBenchResult result;
+    for (int i = 1; i < argc; i++) {
+        long agendas = atol(argv[i]);
+        if (agendas <= 0 || agendas > 1024) {
+            fprintf(stderr, "Cantidad de agendas invalida: %s (1-1024)\n", argv[i]);
+            return 2;
+        }
+        if (!AgendaBenchmark::run((uint16_t)agendas, result)) failures++;
+        AgendaBenchmark::printResult(out, result);
+    }
+    return failures > 0 ? 1 : 0;
+}
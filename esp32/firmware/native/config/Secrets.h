@@ -0,0 +1,33 @@
+#ifndef SECRETS_H
+#define SECRETS_H
+
+// ============================================================================
+// Secrets para env:native (host)
+// ============================================================================
+// Se usa solo si no existe src/config/Secrets.h: el include
+// "../config/Secrets.h" se resuelve contra -I native/shim. Valores pensados
+// para un broker Mosquitto/HiveMQ local sin autenticación.
+
+// WiFi (simulado por el shim)
+#define WIFI_SSID "native"
+#define WIFI_PASSWORD ""
+
+// MQTT
+#define MQTT_BROKER "127.0.0.1"
+#define MQTT_PORT 1883
+#define MQTT_USER ""
+#define MQTT_PASSWORD ""
+#define MQTT_CLIENT_ID ""
+#define MQTT_KEEP_ALIVE 60
+#define MQTT_QOS 1
+
+// Nodo
+#define NODE_ID "00000000-0000-0000-0000-000000000001"
+
+// Backend HTTP
+#define BACKEND_HOST "127.0.0.1"
+#define BACKEND_PORT 8080
+#define BACKEND_USER "admin"
+#define BACKEND_PASSWORD "dev123"
+
+#endif // SECRETS_H
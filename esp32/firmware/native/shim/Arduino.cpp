@@ -0,0 +1,423 @@
+#include "Arduino.h"
+
+#include <chrono>
+#include <poll.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+// ============================================================================
+// Estado del entorno simulado
+// ============================================================================
+namespace {
+    typedef std::chrono::steady_clock SteadyClock;
+
+    const SteadyClock::time_point processStart = SteadyClock::now();
+
+    bool fakeClock = false;
+    unsigned long fakeMillis = 0;
+
+    // Epoch UTC anclado a un valor de millis()
+    bool epochSet = false;
+    uint32_t epochBase = 0;
+    unsigned long epochBaseMillis = 0;
+    bool ntpReachable = true;
+
+    int pinLevels[NATIVE_PIN_COUNT];
+    int pinModes[NATIVE_PIN_COUNT];
+    int pinInputs[NATIVE_PIN_COUNT];
+    int analogValues[NATIVE_PIN_COUNT];
+    NativeShim::GpioWriteHook gpioWriteHook = nullptr;
+
+    bool serialQuiet = false;
+
+    uint32_t freeHeap = 40000;
+    NativeShim::RestartHook restartHook = nullptr;
+    unsigned int restartCount = 0;
+    
+    const size_t RTC_USER_MEMORY_SIZE = 512;
+    uint8_t rtcUserMemory[RTC_USER_MEMORY_SIZE];
+
+    uint64_t realMicros() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            SteadyClock::now() - processStart).count();
+    }
+}
+
+// ============================================================================
+// NativeShim - Reloj
+// ============================================================================
+void NativeShim::useFakeClock(unsigned long startMillis) {
+    fakeClock = true;
+    fakeMillis = startMillis;
+}
+
+void NativeShim::useRealClock() {
+    fakeClock = false;
+}
+
+bool NativeShim::isFakeClock() {
+    return fakeClock;
+}
+
+void NativeShim::setMillis(unsigned long ms) {
+    fakeMillis = ms;
+}
+
+void NativeShim::advanceMillis(unsigned long ms) {
+    fakeMillis += ms;
+}
+
+void NativeShim::setUtcEpoch(uint32_t epoch) {
+    epochSet = true;
+    epochBase = epoch;
+    epochBaseMillis = millis();
+}
+
+uint32_t NativeShim::getUtcEpoch() {
+    if (!epochSet) {
+        return (uint32_t)time(nullptr);
+    }
+    return epochBase + (uint32_t)((millis() - epochBaseMillis) / 1000);
+}
+
+void NativeShim::setNtpReachable(bool reachable) {
+    ntpReachable = reachable;
+}
+
+bool NativeShim::isNtpReachable() {
+    return ntpReachable;
+}
+
+// ============================================================================
+// NativeShim - GPIO, Serial y ESP
+// ============================================================================
+void NativeShim::setGpioWriteHook(GpioWriteHook hook) {
+    gpioWriteHook = hook;
+}
+
+int NativeShim::getPinLevel(uint8_t pin) {
+    return pin < NATIVE_PIN_COUNT ? pinLevels[pin] : LOW;
+}
+
+int NativeShim::getPinMode(uint8_t pin) {
+    return pin < NATIVE_PIN_COUNT ? pinModes[pin] : INPUT;
+}
+
+void NativeShim::setPinInput(uint8_t pin, int level) {
+    if (pin < NATIVE_PIN_COUNT) pinInputs[pin] = level;
+}
+
+void NativeShim::setAnalogValue(uint8_t pin, int value) {
+    if (pin < NATIVE_PIN_COUNT) analogValues[pin] = value;
+}
+
+void NativeShim::setSerialQuiet(bool quiet) {
+    serialQuiet = quiet;
+}
+
+void NativeShim::setFreeHeap(uint32_t bytes) {
+    freeHeap = bytes;
+}
+
+void NativeShim::setRestartHook(RestartHook hook) {
+    restartHook = hook;
+}
+
+unsigned int NativeShim::getRestartCount() {
+    return restartCount;
+}
+
+void NativeShim::clearRtcMemory() {
+    memset(rtcUserMemory, 0, sizeof(rtcUserMemory));
+}
+
+void NativeShim::writeOtaCommand() {
+    // El core guarda el comando de eboot (copiar la imagen nueva) en los
+    // bloques 0-31 de la memoria RTC de usuario
+    memset(rtcUserMemory, 0xA5, 128);
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= NATIVE_PIN_COUNT) return;
+    pinModes[pin] = mode;
+    if (mode == INPUT_PULLUP) pinInputs[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin >= NATIVE_PIN_COUNT) return;
+    pinLevels[pin] = value ? HIGH : LOW;
+    if (gpioWriteHook != nullptr) {
+        gpioWriteHook(pin, value ? HIGH : LOW, millis());
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    if (pin >= NATIVE_PIN_COUNT) return LOW;
+    return pinModes[pin] == OUTPUT ? pinLevels[pin] : pinInputs[pin];
+}
+
+int analogRead(uint8_t pin) {
+    return pin < NATIVE_PIN_COUNT ? analogValues[pin] : 0;
+}
+
+// ============================================================================
+// Tiempo
+// ============================================================================
+unsigned long millis() {
+    if (fakeClock) return fakeMillis;
+    return (unsigned long)(realMicros() / 1000);
+}
+
+unsigned long micros() {
+    if (fakeClock) return fakeMillis * 1000UL;
+    return (unsigned long)realMicros();
+}
+
+void delay(unsigned long ms) {
+    if (fakeClock) {
+        fakeMillis += ms;
+        return;
+    }
+    usleep((useconds_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (fakeClock) return;
+    usleep(us);
+}
+
+void yield() {
+    if (!fakeClock) sched_yield();
+}
+
+// ============================================================================
+// Utilidades
+// ============================================================================
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    return rand() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+    srand((unsigned int)seed);
+}
+
+// ============================================================================
+// Print
+// ============================================================================
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (write(*buffer++) == 0) break;
+        n++;
+    }
+    return n;
+}
+
+size_t Print::print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+size_t Print::print(const char* str) { return write(str); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char num, int base) { return print(String(num, (unsigned char)base)); }
+size_t Print::print(int num, int base) { return print(String(num, (unsigned char)base)); }
+size_t Print::print(unsigned int num, int base) { return print(String(num, (unsigned char)base)); }
+size_t Print::print(long num, int base) { return print(String(num, (unsigned char)base)); }
+size_t Print::print(unsigned long num, int base) { return print(String(num, (unsigned char)base)); }
+size_t Print::print(long long num, int base) { return print(String(num, (unsigned char)base)); }
+size_t Print::print(unsigned long long num, int base) { return print(String(num, (unsigned char)base)); }
+size_t Print::print(double num, int digits) { return print(String(num, (unsigned char)digits)); }
+
+size_t Print::println() { return write("\r\n"); }
+size_t Print::println(const String& s) { return print(s) + println(); }
+size_t Print::println(const char* str) { return print(str) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(unsigned char num, int base) { return print(num, base) + println(); }
+size_t Print::println(int num, int base) { return print(num, base) + println(); }
+size_t Print::println(unsigned int num, int base) { return print(num, base) + println(); }
+size_t Print::println(long num, int base) { return print(num, base) + println(); }
+size_t Print::println(unsigned long num, int base) { return print(num, base) + println(); }
+size_t Print::println(long long num, int base) { return print(num, base) + println(); }
+size_t Print::println(unsigned long long num, int base) { return print(num, base) + println(); }
+size_t Print::println(double num, int digits) { return print(num, digits) + println(); }
+
+size_t Print::printf(const char* format, ...) {
+    char stackBuffer[128];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+
+    if ((size_t)len < sizeof(stackBuffer)) {
+        return write((const uint8_t*)stackBuffer, (size_t)len);
+    }
+
+    char* heapBuffer = (char*)malloc((size_t)len + 1);
+    if (heapBuffer == nullptr) return 0;
+    va_start(args, format);
+    vsnprintf(heapBuffer, (size_t)len + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t*)heapBuffer, (size_t)len);
+    free(heapBuffer);
+    return n;
+}
+
+// ============================================================================
+// Stream
+// ============================================================================
+int Stream::timedRead() {
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) return c;
+        if (fakeClock) break;
+        yield();
+    } while (millis() - start < timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0) break;
+        *buffer++ = (char)c;
+        count++;
+    }
+    return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0 || c == terminator) break;
+        *buffer++ = (char)c;
+        count++;
+    }
+    return count;
+}
+
+String Stream::readString() {
+    String result;
+    int c = timedRead();
+    while (c >= 0) {
+        result += (char)c;
+        c = timedRead();
+    }
+    return result;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String result;
+    int c = timedRead();
+    while (c >= 0 && c != terminator) {
+        result += (char)c;
+        c = timedRead();
+    }
+    return result;
+}
+
+// ============================================================================
+// HardwareSerial (stdout / stdin no bloqueante)
+// ============================================================================
+HardwareSerial Serial;
+
+int HardwareSerial::available() {
+    if (peeked >= 0) return 1;
+    struct pollfd pfd;
+    pfd.fd = STDIN_FILENO;
+    pfd.events = POLLIN;
+    return (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN)) ? 1 : 0;
+}
+
+int HardwareSerial::read() {
+    if (peeked >= 0) {
+        int c = peeked;
+        peeked = -1;
+        return c;
+    }
+    if (!available()) return -1;
+    unsigned char c;
+    return ::read(STDIN_FILENO, &c, 1) == 1 ? c : -1;
+}
+
+int HardwareSerial::peek() {
+    if (peeked < 0) peeked = read();
+    return peeked;
+}
+
+void HardwareSerial::flush() {
+    fflush(stdout);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (!serialQuiet) fputc(c, stdout);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (!serialQuiet) fwrite(buffer, 1, size, stdout);
+    return size;
+}
+
+// ============================================================================
+// ESP
+// ============================================================================
+EspClass ESP;
+
+uint32_t EspClass::getFreeHeap() {
+    return freeHeap;
+}
+
+uint32_t EspClass::getMaxFreeBlockSize() {
+    return freeHeap;
+}
+
+uint8_t EspClass::getHeapFragmentation() {
+    return 0;
+}
+
+uint32_t EspClass::getChipId() {
+    return 0x00C0FFEE;
+}
+
+uint32_t EspClass::getCycleCount() {
+    // 80 ciclos por microsegundo (CPU a 80 MHz); desborda igual que el registro CCOUNT
+    return (uint32_t)(realMicros() * 80);
+}
+
+String EspClass::getResetReason() {
+    return restartCount > 0 ? "Software/System restart" : "Power On";
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size) {
+    if (data == nullptr || offset * 4 + size > RTC_USER_MEMORY_SIZE) return false;
+    memcpy(data, rtcUserMemory + offset * 4, size);
+    return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size) {
+    if (data == nullptr || offset * 4 + size > RTC_USER_MEMORY_SIZE) return false;
+    memcpy(rtcUserMemory + offset * 4, data, size);
+    return true;
+}
+
+void EspClass::restart() {
+    restartCount++;
+    fflush(stdout);
+    if (restartHook != nullptr) {
+        restartHook();
+        return;
+    }
+    fprintf(stderr, "[SHIM] ESP.restart() - terminando proceso\n");
+    exit(0);
+}
@@ -0,0 +1,231 @@
+#include "ESP8266WiFi.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+ESP8266WiFiClass WiFi;
+
+// ============================================================================
+// WiFiClient - socket TCP no bloqueante
+// ============================================================================
+WiFiClient::WiFiClient() {
+    fd = -1;
+    peerClosed = false;
+    noDelay = false;
+    timeout = 5000;
+}
+
+WiFiClient::~WiFiClient() {
+    stop();
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip.toString().c_str(), port);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    stop();
+    if (host == nullptr || WiFi.status() != WL_CONNECTED) return 0;
+    
+    char portStr[6];
+    snprintf(portStr, sizeof(portStr), "%u", port);
+    
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    
+    struct addrinfo* result = nullptr;
+    if (getaddrinfo(host, portStr, &hints, &result) != 0 || result == nullptr) {
+        return 0;
+    }
+    
+    int sock = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (sock < 0) {
+        freeaddrinfo(result);
+        return 0;
+    }
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    
+    // Conexión no bloqueante acotada por el timeout del Stream
+    int rc = ::connect(sock, result->ai_addr, result->ai_addrlen);
+    freeaddrinfo(result);
+    
+    if (rc < 0 && errno == EINPROGRESS) {
+        struct pollfd pfd;
+        pfd.fd = sock;
+        pfd.events = POLLOUT;
+        int soError = 0;
+        socklen_t len = sizeof(soError);
+        if (poll(&pfd, 1, (int)timeout) == 1 &&
+            getsockopt(sock, SOL_SOCKET, SO_ERROR, &soError, &len) == 0 && soError == 0) {
+            rc = 0;
+        }
+    }
+    
+    if (rc < 0) {
+        ::close(sock);
+        return 0;
+    }
+    
+    fd = sock;
+    peerClosed = false;
+    setNoDelay(noDelay);
+    return 1;
+}
+
+size_t WiFiClient::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+    if (fd < 0) return 0;
+    
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = send(fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += (size_t)n;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLOUT;
+            if (poll(&pfd, 1, (int)timeout) == 1) continue;
+        }
+        // Error o timeout: el core cierra la conexión
+        stop();
+        break;
+    }
+    return sent;
+}
+
+void WiFiClient::pollClosed() {
+    if (fd < 0 || peerClosed) return;
+    
+    char c;
+    ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        peerClosed = true;
+    }
+}
+
+int WiFiClient::available() {
+    if (fd < 0) return 0;
+    
+    int pending = 0;
+    if (ioctl(fd, FIONREAD, &pending) < 0) return 0;
+    if (pending == 0) pollClosed();
+    return pending;
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+    if (fd < 0 || size == 0) return -1;
+    
+    ssize_t n = recv(fd, buffer, size, MSG_DONTWAIT);
+    if (n > 0) return (int)n;
+    if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) peerClosed = true;
+    return -1;
+}
+
+int WiFiClient::peek() {
+    if (fd < 0) return -1;
+    
+    uint8_t c;
+    ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n == 1 ? c : -1;
+}
+
+void WiFiClient::flush() {
+    // send() es sincrónico respecto del buffer del kernel
+}
+
+void WiFiClient::stop() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    peerClosed = false;
+}
+
+// Ventana de envío de lwIP en el ESP8266 (TCP_SND_BUF = 2 * MSS)
+int WiFiClient::availableForWrite() {
+    return fd < 0 ? 0 : 2920;
+}
+
+uint8_t WiFiClient::connected() {
+    if (fd < 0) return 0;
+    if (available() > 0) return 1;
+    return peerClosed ? 0 : 1;
+}
+
+void WiFiClient::setNoDelay(bool enabled) {
+    noDelay = enabled;
+    if (fd >= 0) {
+        int flag = enabled ? 1 : 0;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    }
+}
+
+// ============================================================================
+// ESP8266WiFiClass - estación simulada
+// ============================================================================
+ESP8266WiFiClass::ESP8266WiFiClass() {
+    currentStatus = WL_DISCONNECTED;
+    currentMode = WIFI_STA;
+    sleepType = WIFI_NONE_SLEEP;
+}
+
+bool ESP8266WiFiClass::mode(WiFiMode_t newMode) {
+    currentMode = newMode;
+    if (newMode == WIFI_OFF) currentStatus = WL_DISCONNECTED;
+    return true;
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char* newSsid, const char* passphrase) {
+    (void)passphrase;
+    ssid = newSsid != nullptr ? newSsid : "";
+    currentStatus = ssid.length() > 0 ? WL_CONNECTED : WL_NO_SSID_AVAIL;
+    return currentStatus;
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifiOff) {
+    currentStatus = WL_DISCONNECTED;
+    if (wifiOff) currentMode = WIFI_OFF;
+    return true;
+}
+
+bool ESP8266WiFiClass::reconnect() {
+    if (ssid.length() == 0) return false;
+    currentStatus = WL_CONNECTED;
+    return true;
+}
+
+int ESP8266WiFiClass::hostByName(const char* host, IPAddress& result, uint32_t timeoutMs) {
+    (void)timeoutMs;
+    if (currentStatus != WL_CONNECTED || host == nullptr) return 0;
+    if (result.fromString(host)) return 1;
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    struct addrinfo* info = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &info) != 0 || info == nullptr) return 0;
+    const struct sockaddr_in* addr = (const struct sockaddr_in*)info->ai_addr;
+    result = IPAddress((uint32_t)addr->sin_addr.s_addr);
+    freeaddrinfo(info);
+    return 1;
+}
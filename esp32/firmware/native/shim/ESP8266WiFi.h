@@ -0,0 +1,127 @@
+#ifndef NATIVE_ESP8266_WIFI_H
+#define NATIVE_ESP8266_WIFI_H
+
+#include <Arduino.h>
+#include "Client.h"
+#include "IPAddress.h"
+
+// ============================================================================
+// ESP8266WiFi (shim host)
+// ============================================================================
+// WiFiClient es un socket TCP real del host (sirve contra un broker local o
+// un servidor de prueba en loopback). WiFi simula la estación: begin()
+// "conecta" de inmediato y disconnect() la baja.
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_WRONG_PASSWORD = 6,
+    WL_DISCONNECTED = 7
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} WiFiMode_t;
+
+typedef enum {
+    WIFI_NONE_SLEEP = 0,
+    WIFI_LIGHT_SLEEP = 1,
+    WIFI_MODEM_SLEEP = 2
+} WiFiSleepType_t;
+
+#define ENC_TYPE_NONE 7
+
+class WiFiClient : public Client {
+private:
+    int fd;
+    bool peerClosed;
+    bool noDelay;
+    
+    WiFiClient(const WiFiClient&);
+    WiFiClient& operator=(const WiFiClient&);
+    
+    // Detectar cierre del otro extremo sin consumir datos
+    void pollClosed();
+
+public:
+    WiFiClient();
+    ~WiFiClient();
+    
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    int connect(const String& host, uint16_t port) { return connect(host.c_str(), port); }
+    
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite() override;
+    
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size) override;
+    int peek() override;
+    void flush() override;
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected() != 0; }
+    
+    void setNoDelay(bool enabled);
+    bool getNoDelay() const { return noDelay; }
+};
+
+class ESP8266WiFiClass {
+private:
+    wl_status_t currentStatus;
+    WiFiMode_t currentMode;
+    WiFiSleepType_t sleepType;
+    String ssid;
+    String hostName;
+
+public:
+    ESP8266WiFiClass();
+    
+    bool mode(WiFiMode_t mode);
+    WiFiMode_t getMode() const { return currentMode; }
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr);
+    wl_status_t begin(const String& ssid, const String& passphrase) { return begin(ssid.c_str(), passphrase.c_str()); }
+    bool disconnect(bool wifiOff = false);
+    bool reconnect();
+    wl_status_t status() const { return currentStatus; }
+    bool isConnected() const { return currentStatus == WL_CONNECTED; }
+    int hostByName(const char* host, IPAddress& result, uint32_t timeoutMs = 10000);
+    
+    bool setSleepMode(WiFiSleepType_t type) { sleepType = type; return true; }
+    WiFiSleepType_t getSleepMode() const { return sleepType; }
+    bool setAutoReconnect(bool autoReconnect) { (void)autoReconnect; return true; }
+    void persistent(bool persistent) { (void)persistent; }
+    bool hostname(const char* name) { hostName = name; return true; }
+    bool hostname(const String& name) { hostName = name; return true; }
+    String hostname() const { return hostName; }
+    
+    IPAddress localIP() const { return isConnected() ? IPAddress(127, 0, 0, 1) : IPAddress(); }
+    IPAddress gatewayIP() const { return IPAddress(127, 0, 0, 1); }
+    IPAddress subnetMask() const { return IPAddress(255, 0, 0, 0); }
+    IPAddress dnsIP(uint8_t index = 0) const { (void)index; return IPAddress(127, 0, 0, 1); }
+    String macAddress() const { return String("02:00:00:C0:FF:EE"); }
+    String SSID() const { return ssid; }
+    String SSID(uint8_t index) const { (void)index; return String(); }
+    int32_t RSSI() const { return isConnected() ? -55 : 0; }
+    int32_t RSSI(uint8_t index) const { (void)index; return 0; }
+    uint8_t encryptionType(uint8_t index) const { (void)index; return ENC_TYPE_NONE; }
+    int8_t scanNetworks() { return 0; }
+    
+    bool softAP(const char* ssid, const char* passphrase = nullptr) { (void)ssid; (void)passphrase; return true; }
+    bool softAPdisconnect(bool wifiOff = false) { (void)wifiOff; return true; }
+    IPAddress softAPIP() const { return IPAddress(192, 168, 4, 1); }
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif // NATIVE_ESP8266_WIFI_H
@@ -0,0 +1,372 @@
+#include "FS.h"
+#include "LittleFS.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+fs::FS LittleFS;
+
+// Geometría aproximada de LittleFS en NodeMCU (4M flash, 2M FS)
+static const size_t FS_TOTAL_BYTES = 2072576;
+static const size_t FS_BLOCK_SIZE = 8192;
+static const size_t FS_PAGE_SIZE = 256;
+
+// ============================================================================
+// Raíz en el host
+// ============================================================================
+static std::string& fsRoot() {
+    static std::string root;
+    if (root.empty()) {
+        const char* env = getenv("LITTLEFS_ROOT");
+        root = (env != nullptr && env[0] != '\0') ? env : "native_fs";
+    }
+    return root;
+}
+
+void NativeShim::setFsRoot(const char* path) {
+    fsRoot() = (path != nullptr && path[0] != '\0') ? path : "native_fs";
+}
+
+const char* NativeShim::getFsRoot() {
+    return fsRoot().c_str();
+}
+
+// Ruta del FS ("/dir/archivo") a ruta del host; vacío si no es válida
+static std::string hostPath(const char* path) {
+    if (path == nullptr || path[0] != '/') return std::string();
+    std::string p(path);
+    if (p.find("/../") != std::string::npos || (p.size() >= 3 && p.compare(p.size() - 3, 3, "/..") == 0)) {
+        return std::string();
+    }
+    while (p.size() > 1 && p[p.size() - 1] == '/') p.erase(p.size() - 1);
+    return p == "/" ? fsRoot() : fsRoot() + p;
+}
+
+// Crear directorios intermedios (LittleFS los crea al abrir para escritura)
+static bool makeParents(const std::string& path) {
+    for (size_t pos = 1; (pos = path.find('/', pos)) != std::string::npos; pos++) {
+        std::string dir = path.substr(0, pos);
+        if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) return false;
+    }
+    return true;
+}
+
+static bool makeDirs(const std::string& path) {
+    return makeParents(path + "/");
+}
+
+static void removeTree(const std::string& path, bool removeSelf) {
+    DIR* dir = opendir(path.c_str());
+    if (dir != nullptr) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+            std::string child = path + "/" + entry->d_name;
+            struct stat st;
+            if (stat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+                removeTree(child, true);
+            } else {
+                unlink(child.c_str());
+            }
+        }
+        closedir(dir);
+    }
+    if (removeSelf) ::rmdir(path.c_str());
+}
+
+static size_t usedBlocksBytes(const std::string& path) {
+    size_t used = 0;
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr) return 0;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        std::string child = path + "/" + entry->d_name;
+        struct stat st;
+        if (stat(child.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            used += FS_BLOCK_SIZE + usedBlocksBytes(child);
+        } else {
+            used += ((size_t)st.st_size + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE * FS_BLOCK_SIZE;
+        }
+    }
+    closedir(dir);
+    return used;
+}
+
+namespace fs {
+
+// ============================================================================
+// FileImpl - FILE* del host
+// ============================================================================
+struct FileImpl {
+    FILE* fp;
+    std::string fsPath;
+    std::string baseName;
+    bool directory;
+
+    FileImpl(FILE* file, const std::string& path, bool isDir) : fp(file), fsPath(path), directory(isDir) {
+        size_t slash = path.rfind('/');
+        baseName = slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+    ~FileImpl() {
+        if (fp != nullptr) fclose(fp);
+    }
+};
+
+// ============================================================================
+// File
+// ============================================================================
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    if (!impl || impl->fp == nullptr) return 0;
+    return fwrite(buffer, 1, size, impl->fp);
+}
+
+int File::available() {
+    if (!impl || impl->fp == nullptr) return 0;
+    size_t total = size();
+    size_t pos = position();
+    return pos < total ? (int)(total - pos) : 0;
+}
+
+int File::read() {
+    if (!impl || impl->fp == nullptr) return -1;
+    int c = fgetc(impl->fp);
+    return c == EOF ? -1 : c;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    if (!impl || impl->fp == nullptr) return 0;
+    return fread(buffer, 1, size, impl->fp);
+}
+
+int File::peek() {
+    if (!impl || impl->fp == nullptr) return -1;
+    int c = fgetc(impl->fp);
+    if (c == EOF) return -1;
+    ungetc(c, impl->fp);
+    return c;
+}
+
+void File::flush() {
+    if (impl && impl->fp != nullptr) fflush(impl->fp);
+}
+
+size_t File::readBytes(char* buffer, size_t length) {
+    return read((uint8_t*)buffer, length);
+}
+
+String File::readString() {
+    String result;
+    if (!impl || impl->fp == nullptr) return result;
+
+    char chunk[256];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), impl->fp)) > 0) {
+        result.concat(chunk, n);
+    }
+    return result;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!impl || impl->fp == nullptr) return false;
+    int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+    return fseek(impl->fp, (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!impl || impl->fp == nullptr) return 0;
+    long pos = ftell(impl->fp);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!impl || impl->fp == nullptr) return 0;
+    fflush(impl->fp);
+    struct stat st;
+    if (fstat(fileno(impl->fp), &st) != 0) return 0;
+    return (size_t)st.st_size;
+}
+
+bool File::truncate(uint32_t newSize) {
+    if (!impl || impl->fp == nullptr) return false;
+    fflush(impl->fp);
+    return ftruncate(fileno(impl->fp), newSize) == 0;
+}
+
+void File::close() {
+    impl.reset();
+}
+
+File::operator bool() const {
+    return impl && (impl->fp != nullptr || impl->directory);
+}
+
+const char* File::name() const {
+    return impl ? impl->baseName.c_str() : "";
+}
+
+const char* File::fullName() const {
+    return impl ? impl->fsPath.c_str() : "";
+}
+
+bool File::isFile() const {
+    return impl && !impl->directory;
+}
+
+bool File::isDirectory() const {
+    return impl && impl->directory;
+}
+
+// ============================================================================
+// Dir
+// ============================================================================
+bool Dir::next() {
+    if (current + 1 >= (int)entries.size()) return false;
+    current++;
+    return true;
+}
+
+bool Dir::rewind() {
+    current = -1;
+    return true;
+}
+
+String Dir::fileName() const {
+    if (current < 0 || current >= (int)entries.size()) return String();
+    return String(entries[current].name.c_str());
+}
+
+size_t Dir::fileSize() const {
+    if (current < 0 || current >= (int)entries.size()) return 0;
+    return entries[current].size;
+}
+
+bool Dir::isFile() const {
+    return current >= 0 && current < (int)entries.size() && !entries[current].directory;
+}
+
+bool Dir::isDirectory() const {
+    return current >= 0 && current < (int)entries.size() && entries[current].directory;
+}
+
+File Dir::openFile(const char* mode) {
+    if (current < 0 || current >= (int)entries.size()) return File();
+    std::string child = (path == "/" ? "" : path) + "/" + entries[current].name;
+    return LittleFS.open(child.c_str(), mode);
+}
+
+// ============================================================================
+// FS
+// ============================================================================
+bool FS::begin() {
+    return makeDirs(fsRoot());
+}
+
+void FS::end() {}
+
+bool FS::format() {
+    removeTree(fsRoot(), false);
+    return begin();
+}
+
+bool FS::info(FSInfo& info) {
+    info.totalBytes = FS_TOTAL_BYTES;
+    info.usedBytes = std::min(FS_TOTAL_BYTES, 2 * FS_BLOCK_SIZE + usedBlocksBytes(fsRoot()));
+    info.blockSize = FS_BLOCK_SIZE;
+    info.pageSize = FS_PAGE_SIZE;
+    info.maxOpenFiles = 5;
+    info.maxPathLength = 32;
+    return true;
+}
+
+File FS::open(const char* path, const char* mode) {
+    std::string host = hostPath(path);
+    if (host.empty() || mode == nullptr) return File();
+
+    struct stat st;
+    if (stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        return File(std::make_shared<FileImpl>(nullptr, path, true));
+    }
+
+    std::string hostMode;
+    if (mode[0] == 'r') {
+        hostMode = mode[1] == '+' ? "r+b" : "rb";
+    } else if (mode[0] == 'w' || mode[0] == 'a') {
+        if (!makeParents(host)) return File();
+        hostMode = std::string(1, mode[0]) + (mode[1] == '+' ? "+b" : "b");
+    } else {
+        return File();
+    }
+
+    FILE* fp = fopen(host.c_str(), hostMode.c_str());
+    if (fp == nullptr) return File();
+    return File(std::make_shared<FileImpl>(fp, path, false));
+}
+
+bool FS::exists(const char* path) {
+    std::string host = hostPath(path);
+    struct stat st;
+    return !host.empty() && stat(host.c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    std::string host = hostPath(path);
+    return !host.empty() && unlink(host.c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    std::string from = hostPath(pathFrom);
+    std::string to = hostPath(pathTo);
+    if (from.empty() || to.empty() || !makeParents(to)) return false;
+    return ::rename(from.c_str(), to.c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    std::string host = hostPath(path);
+    return !host.empty() && makeDirs(host);
+}
+
+bool FS::rmdir(const char* path) {
+    std::string host = hostPath(path);
+    return !host.empty() && ::rmdir(host.c_str()) == 0;
+}
+
+Dir FS::openDir(const char* path) {
+    std::string host = hostPath(path);
+    std::vector<DirEntry> entries;
+
+    DIR* dir = host.empty() ? nullptr : opendir(host.c_str());
+    if (dir != nullptr) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+            std::string child = host + "/" + entry->d_name;
+            struct stat st;
+            if (stat(child.c_str(), &st) != 0) continue;
+
+            DirEntry item;
+            item.name = entry->d_name;
+            item.directory = S_ISDIR(st.st_mode);
+            item.size = item.directory ? 0 : (size_t)st.st_size;
+            entries.push_back(item);
+        }
+        closedir(dir);
+    }
+
+    // Orden estable para que los listados sean reproducibles
+    std::sort(entries.begin(), entries.end(),
+              [](const DirEntry& a, const DirEntry& b) { return a.name < b.name; });
+    return Dir(path != nullptr ? path : "/", entries);
+}
+
+} // namespace fs
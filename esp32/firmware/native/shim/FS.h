@@ -0,0 +1,126 @@
+#ifndef NATIVE_FS_H
+#define NATIVE_FS_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// FS (shim host) - Sistema de archivos respaldado por un directorio
+// ============================================================================
+// Las rutas del firmware ("/agenda.json") se mapean bajo la raíz configurada
+// con NativeShim::setFsRoot() (default: $LITTLEFS_ROOT o ./native_fs).
+
+namespace fs {
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+struct FSInfo {
+    size_t totalBytes;
+    size_t usedBytes;
+    size_t blockSize;
+    size_t pageSize;
+    size_t maxOpenFiles;
+    size_t maxPathLength;
+};
+
+struct FileImpl;
+
+class File : public Stream {
+private:
+    std::shared_ptr<FileImpl> impl;
+
+public:
+    File() {}
+    explicit File(std::shared_ptr<FileImpl> fileImpl) : impl(fileImpl) {}
+    
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    
+    int available() override;
+    int read() override;
+    size_t read(uint8_t* buffer, size_t size);
+    int peek() override;
+    void flush() override;
+    size_t readBytes(char* buffer, size_t length) override;
+    String readString() override;
+    
+    bool seek(uint32_t pos, SeekMode mode);
+    bool seek(uint32_t pos) { return seek(pos, SeekSet); }
+    size_t position() const;
+    size_t size() const;
+    bool truncate(uint32_t size);
+    void close();
+    operator bool() const;
+    
+    const char* name() const;      // Nombre sin directorio
+    const char* fullName() const;  // Ruta completa en el FS ("/dir/archivo")
+    bool isFile() const;
+    bool isDirectory() const;
+};
+
+struct DirEntry {
+    std::string name;
+    size_t size;
+    bool directory;
+};
+
+class Dir {
+private:
+    std::string path;
+    std::vector<DirEntry> entries;
+    int current;
+
+public:
+    Dir() : current(-1) {}
+    Dir(const std::string& dirPath, const std::vector<DirEntry>& dirEntries)
+        : path(dirPath), entries(dirEntries), current(-1) {}
+    
+    bool next();
+    bool rewind();
+    String fileName() const;
+    size_t fileSize() const;
+    bool isFile() const;
+    bool isDirectory() const;
+    File openFile(const char* mode);
+};
+
+class FS {
+public:
+    bool begin();
+    void end();
+    bool format();
+    bool info(FSInfo& info);
+    
+    File open(const char* path, const char* mode);
+    File open(const String& path, const char* mode) { return open(path.c_str(), mode); }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* pathFrom, const char* pathTo);
+    bool rename(const String& pathFrom, const String& pathTo) { return rename(pathFrom.c_str(), pathTo.c_str()); }
+    bool mkdir(const char* path);
+    bool rmdir(const char* path);
+    Dir openDir(const char* path);
+    Dir openDir(const String& path) { return openDir(path.c_str()); }
+};
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
+using fs::Dir;
+using fs::FSInfo;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif // NATIVE_FS_H
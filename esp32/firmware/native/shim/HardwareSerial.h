@@ -0,0 +1,35 @@
+#ifndef NATIVE_HARDWARE_SERIAL_H
+#define NATIVE_HARDWARE_SERIAL_H
+
+#include "Stream.h"
+
+// ============================================================================
+// HardwareSerial - Serial sobre stdout/stdin del host
+// ============================================================================
+class HardwareSerial : public Stream {
+private:
+    int peeked;  // Byte leído por peek() (-1 si no hay)
+
+public:
+    HardwareSerial() : peeked(-1) {}
+    
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    void setDebugOutput(bool enabled) { (void)enabled; }
+    
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush() override;
+    int availableForWrite() override { return 128; }  // FIFO de TX del UART
+    
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_HARDWARE_SERIAL_H
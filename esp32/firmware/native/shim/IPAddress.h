@@ -0,0 +1,50 @@
+#ifndef NATIVE_IP_ADDRESS_H
+#define NATIVE_IP_ADDRESS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "WString.h"
+
+// ============================================================================
+// IPAddress - Dirección IPv4
+// ============================================================================
+class IPAddress {
+private:
+    uint8_t bytes[4];
+
+public:
+    IPAddress() : bytes{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+    IPAddress(uint32_t address) {
+        for (int i = 0; i < 4; i++) bytes[i] = (uint8_t)(address >> (8 * i));
+    }
+    
+    bool fromString(const char* address) {
+        unsigned int a, b, c, d;
+        char extra;
+        if (address == nullptr || sscanf(address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &extra) != 4) return false;
+        if (a > 255 || b > 255 || c > 255 || d > 255) return false;
+        bytes[0] = (uint8_t)a; bytes[1] = (uint8_t)b; bytes[2] = (uint8_t)c; bytes[3] = (uint8_t)d;
+        return true;
+    }
+    bool fromString(const String& address) { return fromString(address.c_str()); }
+    
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+        return String(buf);
+    }
+    
+    // Orden de red (igual que el core: bytes[0] en el byte menos significativo)
+    operator uint32_t() const {
+        return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    }
+    bool operator==(const IPAddress& other) const { return (uint32_t)*this == (uint32_t)other; }
+    bool operator!=(const IPAddress& other) const { return !(*this == other); }
+    uint8_t operator[](int index) const { return bytes[index]; }
+    uint8_t& operator[](int index) { return bytes[index]; }
+    uint8_t* raw_address() { return bytes; }
+    bool isSet() const { return (uint32_t)*this != 0; }
+};
+
+#endif // NATIVE_IP_ADDRESS_H
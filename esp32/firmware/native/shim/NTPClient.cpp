@@ -0,0 +1,100 @@
+#include "NTPClient.h"
+
+// ============================================================================
+// Constructores
+// ============================================================================
+NTPClient::NTPClient(UDP& udp) : NTPClient(udp, "pool.ntp.org", 0, 60000) {}
+NTPClient::NTPClient(UDP& udp, long timeOffset) : NTPClient(udp, "pool.ntp.org", timeOffset, 60000) {}
+NTPClient::NTPClient(UDP& udp, const char* poolServerName) : NTPClient(udp, poolServerName, 0, 60000) {}
+NTPClient::NTPClient(UDP& udp, const char* poolServerName, long timeOffset)
+    : NTPClient(udp, poolServerName, timeOffset, 60000) {}
+
+NTPClient::NTPClient(UDP& udp, const char* poolServerName, long timeOffset, unsigned long updateInterval) {
+    this->udp = &udp;
+    this->udpSetup = false;
+    this->poolServerName = poolServerName;
+    this->timeOffset = timeOffset;
+    this->updateInterval = updateInterval;
+    this->currentEpoc = 0;
+    this->lastUpdate = 0;
+}
+
+void NTPClient::setPoolServerName(const char* name) {
+    poolServerName = name;
+}
+
+void NTPClient::begin() {
+    begin(1337);
+}
+
+void NTPClient::begin(unsigned int port) {
+    udp->begin((uint16_t)port);
+    udpSetup = true;
+}
+
+// ============================================================================
+// Actualización
+// ============================================================================
+bool NTPClient::update() {
+    if ((millis() - lastUpdate >= updateInterval) || lastUpdate == 0) {
+        if (!udpSetup) begin();
+        return forceUpdate();
+    }
+    return false;
+}
+
+bool NTPClient::forceUpdate() {
+    if (!NativeShim::isNtpReachable()) {
+        return false;
+    }
+    
+    lastUpdate = millis();
+    currentEpoc = NativeShim::getUtcEpoch();
+    return true;
+}
+
+bool NTPClient::isTimeSet() const {
+    return lastUpdate != 0;
+}
+
+// ============================================================================
+// Consultas
+// ============================================================================
+unsigned long NTPClient::getEpochTime() const {
+    return timeOffset + currentEpoc + ((millis() - lastUpdate) / 1000);
+}
+
+int NTPClient::getDay() const {
+    return (int)(((getEpochTime() / 86400L) + 4) % 7);  // 0 = Domingo
+}
+
+int NTPClient::getHours() const {
+    return (int)((getEpochTime() % 86400L) / 3600);
+}
+
+int NTPClient::getMinutes() const {
+    return (int)((getEpochTime() % 3600) / 60);
+}
+
+int NTPClient::getSeconds() const {
+    return (int)(getEpochTime() % 60);
+}
+
+void NTPClient::setTimeOffset(int offset) {
+    timeOffset = offset;
+}
+
+void NTPClient::setUpdateInterval(unsigned long interval) {
+    updateInterval = interval;
+}
+
+String NTPClient::getFormattedTime() const {
+    char buf[9];
+    snprintf(buf, sizeof(buf), "%02d:%02d:%02d", getHours(), getMinutes(), getSeconds());
+    return String(buf);
+}
+
+void NTPClient::end() {
+    udp->stop();
+    udpSetup = false;
+}
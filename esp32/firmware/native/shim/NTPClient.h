@@ -0,0 +1,49 @@
+#ifndef NATIVE_NTP_CLIENT_H
+#define NATIVE_NTP_CLIENT_H
+
+#include <Arduino.h>
+#include "Udp.h"
+
+// ============================================================================
+// NTPClient (shim host) - Misma API y lógica de actualización que
+// arduino-libraries/NTPClient, pero la "respuesta" del servidor es el epoch
+// de NativeShim (setUtcEpoch / setNtpReachable).
+// ============================================================================
+class NTPClient {
+private:
+    UDP* udp;
+    bool udpSetup;
+    const char* poolServerName;
+    long timeOffset;
+    unsigned long updateInterval;
+    unsigned long currentEpoc;  // Epoch UTC de la última respuesta
+    unsigned long lastUpdate;   // millis() de la última respuesta
+
+public:
+    NTPClient(UDP& udp);
+    NTPClient(UDP& udp, long timeOffset);
+    NTPClient(UDP& udp, const char* poolServerName);
+    NTPClient(UDP& udp, const char* poolServerName, long timeOffset);
+    NTPClient(UDP& udp, const char* poolServerName, long timeOffset, unsigned long updateInterval);
+    
+    void setPoolServerName(const char* poolServerName);
+    void begin();
+    void begin(unsigned int port);
+    
+    // Actualiza si pasó el intervalo; false si no correspondía o falló
+    bool update();
+    bool forceUpdate();
+    bool isTimeSet() const;
+    
+    int getDay() const;
+    int getHours() const;
+    int getMinutes() const;
+    int getSeconds() const;
+    void setTimeOffset(int timeOffset);
+    void setUpdateInterval(unsigned long updateInterval);
+    String getFormattedTime() const;
+    unsigned long getEpochTime() const;
+    void end();
+};
+
+#endif // NATIVE_NTP_CLIENT_H
@@ -0,0 +1,62 @@
+#ifndef NATIVE_SHIM_H
+#define NATIVE_SHIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// NativeShim - Control del entorno simulado (build env:native)
+// ============================================================================
+// El shim reemplaza el core Arduino/ESP8266 para compilar el firmware en el
+// host. Este namespace expone los controles que no existen en el dispositivo:
+// reloj simulado, estado de pines, NTP alcanzable, raíz de LittleFS, etc.
+// Por defecto el reloj es real (millis() desde el inicio del proceso).
+
+namespace NativeShim {
+    // ============= Reloj =============
+    // Reloj simulado: millis() solo avanza con advanceMillis() o delay()
+    void useFakeClock(unsigned long startMillis = 0);
+    void useRealClock();
+    bool isFakeClock();
+    void setMillis(unsigned long ms);
+    void advanceMillis(unsigned long ms);
+    
+    // Epoch UTC que responde el "servidor NTP" (avanza junto con millis())
+    void setUtcEpoch(uint32_t epoch);
+    uint32_t getUtcEpoch();
+    void setNtpReachable(bool reachable);
+    bool isNtpReachable();
+    
+    // ============= GPIO =============
+    typedef void (*GpioWriteHook)(uint8_t pin, uint8_t value, unsigned long atMillis);
+    void setGpioWriteHook(GpioWriteHook hook);
+    int getPinLevel(uint8_t pin);
+    int getPinMode(uint8_t pin);
+    void setPinInput(uint8_t pin, int level);       // Valor para digitalRead()
+    void setAnalogValue(uint8_t pin, int value);    // Valor para analogRead()
+    
+    // ============= I2C (Wire) =============
+    // Cada endTransmission() que llega a un dispositivo presente llama al hook
+    // con los bytes escritos. Por defecto todas las direcciones responden.
+    typedef void (*I2cWriteHook)(uint8_t address, const uint8_t* data, size_t length, unsigned long atMillis);
+    void setI2cWriteHook(I2cWriteHook hook);
+    void setI2cDevicePresent(uint8_t address, bool present);  // false: NACK
+    
+    // ============= Serial =============
+    void setSerialQuiet(bool quiet);  // Descartar salida (benchmarks)
+    
+    // ============= ESP =============
+    typedef void (*RestartHook)();
+    void setFreeHeap(uint32_t bytes);
+    void setRestartHook(RestartHook hook);  // Sin hook, ESP.restart() termina el proceso
+    unsigned int getRestartCount();
+    void clearRtcMemory();  // Corte de energía: la memoria RTC queda en cero
+    void writeOtaCommand(); // Reinicio por OTA: eboot pisa los primeros 128 bytes
+    
+    // ============= LittleFS =============
+    // Directorio del host que respalda LittleFS (default: $LITTLEFS_ROOT o ./native_fs)
+    void setFsRoot(const char* path);
+    const char* getFsRoot();
+}
+
+#endif // NATIVE_SHIM_H
@@ -0,0 +1,60 @@
+#ifndef NATIVE_PRINT_H
+#define NATIVE_PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// ============================================================================
+// Print - Salida de texto/bytes (base de Serial, File y WiFiClient)
+// ============================================================================
+class Print {
+public:
+    virtual ~Print() {}
+    
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) {
+        return str != nullptr ? write((const uint8_t*)str, strlen(str)) : 0;
+    }
+    size_t write(const char* buffer, size_t size) {
+        return write((const uint8_t*)buffer, size);
+    }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+    
+    size_t print(const String& s);
+    size_t print(const char* str);
+    size_t print(char c);
+    size_t print(unsigned char num, int base = DEC);
+    size_t print(int num, int base = DEC);
+    size_t print(unsigned int num, int base = DEC);
+    size_t print(long num, int base = DEC);
+    size_t print(unsigned long num, int base = DEC);
+    size_t print(long long num, int base = DEC);
+    size_t print(unsigned long long num, int base = DEC);
+    size_t print(double num, int digits = 2);
+    
+    size_t println();
+    size_t println(const String& s);
+    size_t println(const char* str);
+    size_t println(char c);
+    size_t println(unsigned char num, int base = DEC);
+    size_t println(int num, int base = DEC);
+    size_t println(unsigned int num, int base = DEC);
+    size_t println(long num, int base = DEC);
+    size_t println(unsigned long num, int base = DEC);
+    size_t println(long long num, int base = DEC);
+    size_t println(unsigned long long num, int base = DEC);
+    size_t println(double num, int digits = 2);
+    
+    size_t printf(const char* format, ...);
+};
+
+#endif // NATIVE_PRINT_H
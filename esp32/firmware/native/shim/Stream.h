@@ -0,0 +1,38 @@
+#ifndef NATIVE_STREAM_H
+#define NATIVE_STREAM_H
+
+#include "Print.h"
+
+// ============================================================================
+// Stream - Entrada con timeout (base de Serial, File y WiFiClient)
+// ============================================================================
+// Con reloj simulado la espera no avanza el tiempo: si no hay datos, las
+// lecturas con timeout retornan de inmediato.
+
+class Stream : public Print {
+protected:
+    unsigned long timeout;
+    
+    // Leer un byte esperando hasta `timeout` (-1 si no llegó)
+    int timedRead();
+
+public:
+    Stream() : timeout(1000) {}
+    
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    
+    void setTimeout(unsigned long timeoutMs) { timeout = timeoutMs; }
+    unsigned long getTimeout() const { return timeout; }
+    
+    virtual size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        return readBytes((char*)buffer, length);
+    }
+    size_t readBytesUntil(char terminator, char* buffer, size_t length);
+    virtual String readString();
+    String readStringUntil(char terminator);
+};
+
+#endif // NATIVE_STREAM_H
@@ -0,0 +1,16 @@
+#ifndef NATIVE_UDP_H
+#define NATIVE_UDP_H
+
+#include "Stream.h"
+#include "IPAddress.h"
+
+// ============================================================================
+// UDP - Interfaz UDP (solo la referencia que recibe NTPClient)
+// ============================================================================
+class UDP : public Stream {
+public:
+    virtual uint8_t begin(uint16_t port) = 0;
+    virtual void stop() = 0;
+};
+
+#endif // NATIVE_UDP_H
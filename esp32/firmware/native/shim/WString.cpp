@@ -0,0 +1,280 @@
+#include "WString.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Conversión numérica (misma salida que el core: base 2-36, dígitos minúsculas)
+// ============================================================================
+static std::string formatUnsigned(unsigned long long value, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+
+    char digits[65];
+    int pos = sizeof(digits) - 1;
+    digits[pos] = '\0';
+    do {
+        int digit = (int)(value % base);
+        digits[--pos] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    } while (value > 0);
+
+    return std::string(&digits[pos]);
+}
+
+static std::string formatSigned(long long value, unsigned char base) {
+    if (base == 10 && value < 0) {
+        return "-" + formatUnsigned((unsigned long long)(-(value + 1)) + 1, base);
+    }
+    return formatUnsigned((unsigned long long)value, base);
+}
+
+static std::string formatFloat(double value, unsigned char decimalPlaces) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimalPlaces, value);
+    return std::string(buf);
+}
+
+// ============================================================================
+// Constructores
+// ============================================================================
+String::String(const char* cstr) : buffer(cstr != nullptr ? cstr : "") {}
+String::String(const char* cstr, size_t length) : buffer(cstr != nullptr ? std::string(cstr, length) : "") {}
+String::String(const String& other) : buffer(other.buffer) {}
+String::String(String&& other) : buffer(std::move(other.buffer)) {}
+String::String(char c) : buffer(1, c) {}
+String::String(unsigned char value, unsigned char base) : buffer(formatUnsigned(value, base)) {}
+String::String(int value, unsigned char base) : buffer(formatSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : buffer(formatUnsigned(value, base)) {}
+String::String(long value, unsigned char base) : buffer(formatSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : buffer(formatUnsigned(value, base)) {}
+String::String(long long value, unsigned char base) : buffer(formatSigned(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : buffer(formatUnsigned(value, base)) {}
+String::String(float value, unsigned char decimalPlaces) : buffer(formatFloat(value, decimalPlaces)) {}
+String::String(double value, unsigned char decimalPlaces) : buffer(formatFloat(value, decimalPlaces)) {}
+
+String& String::operator=(const String& rhs) {
+    buffer = rhs.buffer;
+    return *this;
+}
+
+String& String::operator=(String&& rhs) {
+    buffer = std::move(rhs.buffer);
+    return *this;
+}
+
+String& String::operator=(const char* cstr) {
+    buffer = cstr != nullptr ? cstr : "";
+    return *this;
+}
+
+String& String::operator=(char c) {
+    buffer.assign(1, c);
+    return *this;
+}
+
+bool String::reserve(size_t size) {
+    buffer.reserve(size);
+    return true;
+}
+
+// ============================================================================
+// Concatenación
+// ============================================================================
+bool String::concat(const String& str) { buffer += str.buffer; return true; }
+bool String::concat(const char* cstr) {
+    if (cstr == nullptr) return false;
+    buffer += cstr;
+    return true;
+}
+bool String::concat(const char* cstr, size_t length) {
+    if (cstr == nullptr) return false;
+    buffer.append(cstr, length);
+    return true;
+}
+bool String::concat(char c) { buffer += c; return true; }
+bool String::concat(unsigned char num) { buffer += formatUnsigned(num, 10); return true; }
+bool String::concat(int num) { buffer += formatSigned(num, 10); return true; }
+bool String::concat(unsigned int num) { buffer += formatUnsigned(num, 10); return true; }
+bool String::concat(long num) { buffer += formatSigned(num, 10); return true; }
+bool String::concat(unsigned long num) { buffer += formatUnsigned(num, 10); return true; }
+bool String::concat(long long num) { buffer += formatSigned(num, 10); return true; }
+bool String::concat(unsigned long long num) { buffer += formatUnsigned(num, 10); return true; }
+bool String::concat(float num) { buffer += formatFloat(num, 2); return true; }
+bool String::concat(double num) { buffer += formatFloat(num, 2); return true; }
+
+StringSumHelper operator+(const String& lhs, const String& rhs) { StringSumHelper r(lhs); r.concat(rhs); return r; }
+StringSumHelper operator+(const String& lhs, const char* cstr) { StringSumHelper r(lhs); r.concat(cstr); return r; }
+StringSumHelper operator+(const char* cstr, const String& rhs) { StringSumHelper r(cstr); r.concat(rhs); return r; }
+StringSumHelper operator+(const String& lhs, char c) { StringSumHelper r(lhs); r.concat(c); return r; }
+StringSumHelper operator+(const String& lhs, unsigned char num) { StringSumHelper r(lhs); r.concat(num); return r; }
+StringSumHelper operator+(const String& lhs, int num) { StringSumHelper r(lhs); r.concat(num); return r; }
+StringSumHelper operator+(const String& lhs, unsigned int num) { StringSumHelper r(lhs); r.concat(num); return r; }
+StringSumHelper operator+(const String& lhs, long num) { StringSumHelper r(lhs); r.concat(num); return r; }
+StringSumHelper operator+(const String& lhs, unsigned long num) { StringSumHelper r(lhs); r.concat(num); return r; }
+StringSumHelper operator+(const String& lhs, long long num) { StringSumHelper r(lhs); r.concat(num); return r; }
+StringSumHelper operator+(const String& lhs, unsigned long long num) { StringSumHelper r(lhs); r.concat(num); return r; }
+StringSumHelper operator+(const String& lhs, float num) { StringSumHelper r(lhs); r.concat(num); return r; }
+StringSumHelper operator+(const String& lhs, double num) { StringSumHelper r(lhs); r.concat(num); return r; }
+
+// ============================================================================
+// Comparación
+// ============================================================================
+int String::compareTo(const String& s) const {
+    return strcmp(buffer.c_str(), s.buffer.c_str());
+}
+
+bool String::equals(const String& s) const {
+    return buffer == s.buffer;
+}
+
+bool String::equals(const char* cstr) const {
+    return buffer == (cstr != nullptr ? cstr : "");
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+    if (buffer.length() != s.buffer.length()) return false;
+    for (size_t i = 0; i < buffer.length(); i++) {
+        if (tolower((unsigned char)buffer[i]) != tolower((unsigned char)s.buffer[i])) return false;
+    }
+    return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+    if (offset > buffer.length() || prefix.length() > buffer.length() - offset) return false;
+    return buffer.compare(offset, prefix.length(), prefix.buffer) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    if (suffix.length() > buffer.length()) return false;
+    return buffer.compare(buffer.length() - suffix.length(), suffix.length(), suffix.buffer) == 0;
+}
+
+// ============================================================================
+// Acceso a caracteres
+// ============================================================================
+char String::charAt(unsigned int index) const {
+    return index < buffer.length() ? buffer[index] : '\0';
+}
+
+void String::setCharAt(unsigned int index, char c) {
+    if (index < buffer.length()) buffer[index] = c;
+}
+
+char& String::operator[](unsigned int index) {
+    static char dummy;
+    if (index >= buffer.length()) {
+        dummy = '\0';
+        return dummy;
+    }
+    return buffer[index];
+}
+
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+    if (buf == nullptr || bufsize == 0) return;
+    if (index >= buffer.length()) {
+        buf[0] = '\0';
+        return;
+    }
+    size_t n = buffer.length() - index;
+    if (n > bufsize - 1) n = bufsize - 1;
+    memcpy(buf, buffer.c_str() + index, n);
+    buf[n] = '\0';
+}
+
+void String::toCharArray(char* buf, unsigned int bufsize, unsigned int index) const {
+    getBytes((unsigned char*)buf, bufsize, index);
+}
+
+// ============================================================================
+// Búsqueda
+// ============================================================================
+static int toIndex(size_t pos) {
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(char ch) const { return toIndex(buffer.find(ch)); }
+int String::indexOf(char ch, unsigned int fromIndex) const { return toIndex(buffer.find(ch, fromIndex)); }
+int String::indexOf(const String& str) const { return toIndex(buffer.find(str.buffer)); }
+int String::indexOf(const String& str, unsigned int fromIndex) const { return toIndex(buffer.find(str.buffer, fromIndex)); }
+int String::lastIndexOf(char ch) const { return toIndex(buffer.rfind(ch)); }
+int String::lastIndexOf(char ch, unsigned int fromIndex) const { return toIndex(buffer.rfind(ch, fromIndex)); }
+int String::lastIndexOf(const String& str) const { return toIndex(buffer.rfind(str.buffer)); }
+int String::lastIndexOf(const String& str, unsigned int fromIndex) const { return toIndex(buffer.rfind(str.buffer, fromIndex)); }
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, (unsigned int)buffer.length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) {
+        unsigned int tmp = beginIndex;
+        beginIndex = endIndex;
+        endIndex = tmp;
+    }
+    if (beginIndex >= buffer.length()) return String();
+    if (endIndex > buffer.length()) endIndex = (unsigned int)buffer.length();
+    return String(buffer.c_str() + beginIndex, endIndex - beginIndex);
+}
+
+// ============================================================================
+// Modificación
+// ============================================================================
+void String::replace(char find, char replace) {
+    for (size_t i = 0; i < buffer.length(); i++) {
+        if (buffer[i] == find) buffer[i] = replace;
+    }
+}
+
+void String::replace(const String& find, const String& replace) {
+    if (find.length() == 0) return;
+    size_t pos = 0;
+    while ((pos = buffer.find(find.buffer, pos)) != std::string::npos) {
+        buffer.replace(pos, find.length(), replace.buffer);
+        pos += replace.length();
+    }
+}
+
+void String::remove(unsigned int index) {
+    if (index < buffer.length()) buffer.erase(index);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index < buffer.length()) buffer.erase(index, count);
+}
+
+void String::toLowerCase() {
+    for (size_t i = 0; i < buffer.length(); i++) buffer[i] = (char)tolower((unsigned char)buffer[i]);
+}
+
+void String::toUpperCase() {
+    for (size_t i = 0; i < buffer.length(); i++) buffer[i] = (char)toupper((unsigned char)buffer[i]);
+}
+
+void String::trim() {
+    size_t first = 0;
+    while (first < buffer.length() && isspace((unsigned char)buffer[first])) first++;
+    size_t last = buffer.length();
+    while (last > first && isspace((unsigned char)buffer[last - 1])) last--;
+    buffer = buffer.substr(first, last - first);
+}
+
+// ============================================================================
+// Conversión
+// ============================================================================
+long String::toInt() const {
+    return atol(buffer.c_str());
+}
+
+float String::toFloat() const {
+    return (float)atof(buffer.c_str());
+}
+
+double String::toDouble() const {
+    return atof(buffer.c_str());
+}
@@ -0,0 +1,160 @@
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+// ============================================================================
+// String - Reemplazo de la clase String de Arduino sobre std::string
+// ============================================================================
+// Cubre la API que usa el firmware (concatenación, búsqueda, conversión
+// numérica). Los constructores numéricos son explicit como en el core.
+
+class StringSumHelper;
+
+class String {
+protected:
+    std::string buffer;
+
+public:
+    String(const char* cstr = "");
+    String(const char* cstr, size_t length);
+    String(const String& other);
+    String(String&& other);
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimalPlaces = 2);
+    explicit String(double value, unsigned char decimalPlaces = 2);
+
+    String& operator=(const String& rhs);
+    String& operator=(String&& rhs);
+    String& operator=(const char* cstr);
+    String& operator=(char c);
+
+    // Memoria
+    bool reserve(size_t size);
+    size_t length() const { return buffer.length(); }
+    bool isEmpty() const { return buffer.empty(); }
+    const char* c_str() const { return buffer.c_str(); }
+    char* begin() { return &buffer[0]; }
+    char* end() { return &buffer[0] + buffer.length(); }
+
+    // Concatenación
+    bool concat(const String& str);
+    bool concat(const char* cstr);
+    bool concat(const char* cstr, size_t length);
+    bool concat(char c);
+    bool concat(unsigned char num);
+    bool concat(int num);
+    bool concat(unsigned int num);
+    bool concat(long num);
+    bool concat(unsigned long num);
+    bool concat(long long num);
+    bool concat(unsigned long long num);
+    bool concat(float num);
+    bool concat(double num);
+
+    template <typename T>
+    String& operator+=(const T& rhs) {
+        concat(rhs);
+        return *this;
+    }
+    String& operator+=(const char* cstr) {
+        concat(cstr);
+        return *this;
+    }
+
+    // Comparación
+    int compareTo(const String& s) const;
+    bool equals(const String& s) const;
+    bool equals(const char* cstr) const;
+    bool equalsIgnoreCase(const String& s) const;
+    bool startsWith(const String& prefix) const;
+    bool startsWith(const String& prefix, unsigned int offset) const;
+    bool endsWith(const String& suffix) const;
+    bool operator==(const String& rhs) const { return equals(rhs); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& rhs) const { return !equals(rhs); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool operator<(const String& rhs) const { return compareTo(rhs) < 0; }
+    bool operator>(const String& rhs) const { return compareTo(rhs) > 0; }
+    bool operator<=(const String& rhs) const { return compareTo(rhs) <= 0; }
+    bool operator>=(const String& rhs) const { return compareTo(rhs) >= 0; }
+
+    // Acceso a caracteres
+    char charAt(unsigned int index) const;
+    void setCharAt(unsigned int index, char c);
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index);
+    void getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const;
+    void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const;
+
+    // Búsqueda
+    int indexOf(char ch) const;
+    int indexOf(char ch, unsigned int fromIndex) const;
+    int indexOf(const String& str) const;
+    int indexOf(const String& str, unsigned int fromIndex) const;
+    int lastIndexOf(char ch) const;
+    int lastIndexOf(char ch, unsigned int fromIndex) const;
+    int lastIndexOf(const String& str) const;
+    int lastIndexOf(const String& str, unsigned int fromIndex) const;
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    // Modificación
+    void replace(char find, char replace);
+    void replace(const String& find, const String& replace);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    // Conversión
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+};
+
+// Resultado de operator+ (el core Arduino lo usa para encadenar sumas)
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+    StringSumHelper(const char* p) : String(p) {}
+    StringSumHelper(char c) : String(c) {}
+    StringSumHelper(unsigned char num) : String(num) {}
+    StringSumHelper(int num) : String(num) {}
+    StringSumHelper(unsigned int num) : String(num) {}
+    StringSumHelper(long num) : String(num) {}
+    StringSumHelper(unsigned long num) : String(num) {}
+    StringSumHelper(long long num) : String(num) {}
+    StringSumHelper(unsigned long long num) : String(num) {}
+    StringSumHelper(float num) : String(num) {}
+    StringSumHelper(double num) : String(num) {}
+};
+
+StringSumHelper operator+(const String& lhs, const String& rhs);
+StringSumHelper operator+(const String& lhs, const char* cstr);
+StringSumHelper operator+(const char* cstr, const String& rhs);
+StringSumHelper operator+(const String& lhs, char c);
+StringSumHelper operator+(const String& lhs, unsigned char num);
+StringSumHelper operator+(const String& lhs, int num);
+StringSumHelper operator+(const String& lhs, unsigned int num);
+StringSumHelper operator+(const String& lhs, long num);
+StringSumHelper operator+(const String& lhs, unsigned long num);
+StringSumHelper operator+(const String& lhs, long long num);
+StringSumHelper operator+(const String& lhs, unsigned long long num);
+StringSumHelper operator+(const String& lhs, float num);
+StringSumHelper operator+(const String& lhs, double num);
+
+inline bool operator==(const char* cstr, const String& rhs) { return rhs.equals(cstr); }
+inline bool operator!=(const char* cstr, const String& rhs) { return !rhs.equals(cstr); }
+
+#endif // NATIVE_WSTRING_H
@@ -0,0 +1,21 @@
+#ifndef NATIVE_WIFI_UDP_H
+#define NATIVE_WIFI_UDP_H
+
+#include "Udp.h"
+
+// ============================================================================
+// WiFiUDP (shim host) - Sin tráfico real: NTPClient es simulado
+// ============================================================================
+class WiFiUDP : public UDP {
+public:
+    uint8_t begin(uint16_t port) override { (void)port; return 1; }
+    void stop() override {}
+    
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    size_t write(uint8_t c) override { (void)c; return 1; }
+    using Print::write;
+};
+
+#endif // NATIVE_WIFI_UDP_H
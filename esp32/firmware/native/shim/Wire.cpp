@@ -0,0 +1,62 @@
+#include "Wire.h"
+#include "NativeShim.h"
+#include "Arduino.h"
+
+// ============================================================================
+// Estado del bus simulado
+// ============================================================================
+namespace {
+    NativeShim::I2cWriteHook i2cWriteHook = nullptr;
+    bool absent[128];
+}
+
+void NativeShim::setI2cWriteHook(I2cWriteHook hook) {
+    i2cWriteHook = hook;
+}
+
+void NativeShim::setI2cDevicePresent(uint8_t address, bool present) {
+    if (address < 128) absent[address] = !present;
+}
+
+TwoWire Wire;
+
+// ============================================================================
+// TwoWire
+// ============================================================================
+TwoWire::TwoWire() : address(0), length(0), transmitting(false) {}
+
+void TwoWire::begin() {}
+
+void TwoWire::begin(int sda, int scl) {
+    (void)sda;
+    (void)scl;
+}
+
+void TwoWire::beginTransmission(uint8_t addr) {
+    address = addr;
+    length = 0;
+    transmitting = true;
+}
+
+size_t TwoWire::write(uint8_t value) {
+    if (!transmitting || length >= sizeof(buffer)) return 0;
+    buffer[length++] = value;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t count) {
+    size_t written = 0;
+    while (written < count && write(data[written]) == 1) written++;
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    if (!transmitting) return 4;
+    transmitting = false;
+    if (address >= 128 || absent[address]) return 2;   // NACK de dirección
+    if (i2cWriteHook != nullptr) {
+        i2cWriteHook(address, buffer, length, millis());
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// TwoWire (shim host) - Bus I2C simulado, solo escrituras
+// ============================================================================
+// Acumula los bytes entre beginTransmission() y endTransmission() y los
+// entrega al hook de NativeShim (ver NativeShim::setI2cWriteHook). Una
+// dirección marcada como ausente responde NACK (endTransmission() = 2).
+
+#define NATIVE_WIRE_BUFFER_SIZE 128
+
+class TwoWire {
+private:
+    uint8_t address;
+    uint8_t buffer[NATIVE_WIRE_BUFFER_SIZE];
+    size_t length;
+    bool transmitting;
+
+public:
+    TwoWire();
+
+    void begin();
+    void begin(int sda, int scl);
+    void setClock(uint32_t frequency) { (void)frequency; }
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t value);
+    size_t write(const uint8_t* data, size_t count);
+    uint8_t endTransmission(bool sendStop = true);
+};
+
+extern TwoWire Wire;
+
+#endif // NATIVE_WIRE_H
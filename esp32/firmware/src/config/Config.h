@@ -7,7 +7,14 @@
 
 
 // ============= Hardware Config para NodeMCU ESP8266 =============
+// 8 zonas es el tope del sistema: el backend (DTOs y CHECK de la base) valida
+// zonas 1-8, y la máscara de estado y el bloque RTC están dimensionados para eso
+#ifndef MAX_ZONES
 #define MAX_ZONES 8
+#endif
+#if MAX_ZONES < 1 || MAX_ZONES > 8
+#error "MAX_ZONES debe estar entre 1 y 8 (el backend valida zonas 1-8)"
+#endif
 #define MAX_SENSORS 1  // Solo 1 pin ADC disponible (A0)
 #define LED_PIN 2      // LED integrado en NodeMCU (GPIO2)
 
@@ -31,6 +38,32 @@ static const int SENSOR_PINS[MAX_SENSORS] = {
     // Para más sensores, se requiere multiplexor externo
 };
 
+// ============= Salidas de relé =============
+// Backend de salidas (OutputBackend): un GPIO por zona (RELAY_PINS, 8 zonas),
+// cadena de 74HC595 o expansores I2C en el bus de la pantalla OLED (liberan
+// los pines de RELAY_PINS, no suman zonas). Para cambiar, compilar con ej:
+// -DOUTPUT_BACKEND=OUTPUT_BACKEND_MCP23017
+#define OUTPUT_BACKEND_GPIO 0
+#define OUTPUT_BACKEND_SHIFT_REGISTER 1
+#define OUTPUT_BACKEND_PCF8574 2
+#define OUTPUT_BACKEND_MCP23017 3
+#ifndef OUTPUT_BACKEND
+#define OUTPUT_BACKEND OUTPUT_BACKEND_GPIO
+#endif
+
+// 74HC595: pines libres al no usar RELAY_PINS (8 salidas por chip)
+#define SHIFT_REGISTER_DATA_PIN 5    // D1 (GPIO5)  -> DS
+#define SHIFT_REGISTER_CLOCK_PIN 4   // D2 (GPIO4)  -> SHCP
+#define SHIFT_REGISTER_LATCH_PIN 14  // D5 (GPIO14) -> STCP
+#define SHIFT_REGISTER_OE_PIN 12     // D6 (GPIO12) -> OE, con pull-up (-1 = OE a masa)
+
+// Expansores I2C: chips en direcciones consecutivas desde la base
+#define PCF8574_ADDRESS 0x20         // 8 salidas por chip
+#define MCP23017_ADDRESS 0x20        // 16 salidas por chip (se usan MAX_ZONES)
+
+// Reintento de escritura tras un fallo del bus (NACK del expansor)
+#define OUTPUT_BUS_RETRY_MS 100
+
 // Pines I2C para pantalla OLED
 #define I2C_SDA 13  // D7 (GPIO13)
 #define I2C_SCL 0   // D3 (GPIO0)
@@ -47,11 +80,18 @@ static const int SENSOR_PINS[MAX_SENSORS] = {
 
 // ============= Network Config =============
 #define WIFI_TIMEOUT 30000           // 30 segundos para conectar WiFi
-#define MQTT_RECONNECT_DELAY 15000   // 15 segundos entre intentos MQTT
-#define MQTT_MAX_ATTEMPTS 20         // Máximo 20 intentos antes de reinicio (5min aprox)
-#define MQTT_TIMEOUT 300000          // 5 minutos sin conexión MQTT = reinicio forzado
 #define OFFLINE_RETRY_INTERVAL 60000 // 60 segundos en modo offline
 
+// Recuperación escalonada sin MQTT (ConnectionRecovery), por tiempo sin
+// conexión: socket nuevo, reasociar WiFi y, por último, reinicio por
+// software con los riegos en curso guardados en memoria RTC (WarmRestart)
+#define MQTT_RECOVERY_SOCKET_MS 60000     // 1 minuto
+#define MQTT_RECOVERY_WIFI_MS 150000      // 2.5 minutos
+#define MQTT_RECOVERY_RESTART_MS 300000   // 5 minutos
+// Bloque de 4 bytes donde empieza en la memoria RTC. Los bloques 0-31 (128
+// bytes) los pisa el comando de eboot en un reinicio por OTA
+#define WARM_RESTART_RTC_OFFSET 32
+
 // OTA - Actualización de firmware por WiFi
 #define OTA_ENABLED true
 #define OTA_PORT 8266
@@ -72,28 +112,122 @@ static const int SENSOR_PINS[MAX_SENSORS] = {
 // Usar snprintf para reemplazar %s con NODE_ID
 #define TOPIC_CMD_PATTERN "riego/%s/cmd/zona/+"
 #define TOPIC_AGENDA_SYNC_PATTERN "riego/%s/agenda/sync"
+#define TOPIC_AGENDA_VERSION_PATTERN "riego/%s/agenda/version"  // Versión local (pide delta o lista completa)
 #define TOPIC_STATUS_PATTERN "riego/%s/status/zona/%d"
 #define TOPIC_HUMIDITY_PATTERN "riego/%s/humedad/zona/%d"
 
+// Buffer de PubSubClient: comandos y publicaciones salientes. Los payloads
+// de agenda/sync no pasan por este buffer (se reciben en streaming a flash).
+#define MQTT_BUFFER_SIZE 768
+
+// Publicación sin heap: topics armados una vez en MqttManager::init() y
+// payloads escritos con JsonWriter en un buffer reutilizable
+#define MQTT_TOPIC_MAX_LEN 96             // "riego/" + nodeId (UUID) + sufijo
+#define MQTT_PUBLISH_BUFFER_SIZE JSON_BUFFER_MEDIUM  // Payload saliente más grande (evento del sistema)
+
+// Conexión no bloqueante (MqttConnector): cada paso de la conexión se avanza
+// desde loop() y bloquea a lo sumo su timeout. DNS y TCP son llamadas
+// síncronas del core: con el broker caído una vuelta de loop() puede quedar
+// retenida hasta el mayor de esos dos timeouts; los reintentos esperan con
+// backoff exponencial con jitter entre MQTT_BACKOFF_MIN_MS y MQTT_BACKOFF_MAX_MS
+#define MQTT_DNS_TIMEOUT_MS 2000          // Resolución del host del broker
+#define MQTT_TCP_CONNECT_TIMEOUT_MS 2000  // Apertura del socket
+#define MQTT_CONNACK_TIMEOUT_MS 5000      // Respuesta al CONNECT (sondeada, no bloquea)
+#define MQTT_BACKOFF_MIN_MS 1000
+#define MQTT_BACKOFF_MAX_MS 60000
+#define MQTT_CONNECT_PACKET_MAX 256       // clientId + usuario + password (hasta 64 c/u)
+
 // Nota: MQTT NO requiere autenticación en desarrollo (broker HiveMQ local)
 // El backend Spring Boot usa HTTP Basic Auth (admin:dev123) pero eso es
 // para endpoints HTTP REST (/api/**), no afecta a la comunicación MQTT
 
 // ============= Timing Config =============
-#define STATUS_PUBLISH_INTERVAL 5000    // Publicar estado cada 5 segundos
 #define HUMIDITY_READ_INTERVAL 60000    // Leer sensores cada 60 segundos
 #define AGENDA_CHECK_INTERVAL 1000      // Verificar agendas cada 1 segundo
 #define RELAY_UPDATE_INTERVAL 1000      // Actualizar timers cada 1 segundo
 
+// Conmutación de bobinas (OutputScheduler): una por vez, separadas al menos
+// RELAY_SWITCH_INTERVAL_MS (corriente de arranque sobre la fuente de 5 V).
+// Con RELAY_CHANGEOVER_OVERLAP_MS > 0, en el traspaso entre zonas la nueva
+// abre antes de que cierre la anterior (golpe de ariete).
+#define RELAY_SWITCH_INTERVAL_MS 250
+#define RELAY_CHANGEOVER_OVERLAP_MS 0
+
+// Estado de zonas (StatusPublisher): se publica solo por flanco - cambio de
+// estado de una zona o deriva del tiempo restante mayor a
+// STATUS_DRIFT_THRESHOLD_SEC respecto de lo que el backend extrapola - más
+// un keepalive cada STATUS_HEARTBEAT_INTERVAL. Modo zona: un mensaje por
+// zona (riego/{id}/status/zona/{n}, compatibilidad); agregado: un único
+// mensaje con todas las zonas (riego/{id}/status/zonas); ambos. Se puede
+// cambiar en runtime con la clave "statusMode" de CONFIG_FILE ("zona",
+// "agregado" o "ambos").
+#define STATUS_MODE_ZONA 0
+#define STATUS_MODE_AGREGADO 1
+#define STATUS_MODE_AMBOS 2
+#define STATUS_PUBLISH_MODE STATUS_MODE_AGREGADO
+#define STATUS_HEARTBEAT_INTERVAL 900000 // Keepalive del estado (15 minutos)
+#define STATUS_DRIFT_THRESHOLD_SEC 5     // Deriva tolerada del tiempo restante
+
 // Límites de duración de riego
 #define MIN_RIEGO_DURATION 1       // Mínimo 1 segundo
 #define MAX_RIEGO_DURATION 7200    // Máximo 2 horas (7200 segundos)
 
+// Capacidad hidráulica (ZoneSequencer): zonas abiertas a la vez y, con
+// SEQUENCER_FLOW_CAPACITY > 0, caudal total repartido según el peso de cada
+// zona (ej. capacidad 4 con pesos {2,1,1,...}: la zona 1 más dos chicas).
+// Los pedidos que no entran esperan en cola (manual antes que agenda).
+#define SEQUENCER_MAX_ACTIVE_ZONES 2
+#define SEQUENCER_FLOW_CAPACITY 0                       // 0 = solo límite de zonas
+#define SEQUENCER_FLOW_WEIGHTS {1, 1, 1, 1, 1, 1, 1, 1}  // Caudal relativo por zona (las que falten: 1)
+
 // ============= Storage Config (SPIFFS/LittleFS) =============
-#define AGENDA_FILE "/agendas.json"
+#define AGENDA_FILE "/agenda.json"
 #define CONFIG_FILE "/config.json"
 #define MAX_AGENDAS 32  // Máximo de agendas totales (8 zonas × 4 agendas/zona)
-// ⚠️ LÍMITE CRÍTICO DE RAM: 32 agendas usan ~24KB durante parseo
+
+// Sincronización en streaming: el payload (MQTT o HTTP) se escribe por bloques
+// a AGENDA_SYNC_TEMP_FILE, se valida leyendo el archivo agenda por agenda y
+// recién entonces se renombra a AGENDA_FILE. La RAM usada no depende de la
+// cantidad de agendas (un documento de AGENDA_ITEM_DOC_SIZE por agenda).
+#define AGENDA_SYNC_TEMP_FILE "/agenda.tmp"
+#define AGENDA_SYNC_MAX_BYTES 32768    // Payload máximo aceptado (se descarta si lo supera)
+#define AGENDA_SYNC_CHUNK_SIZE 256     // Bloque de escritura a flash
+
+// Documento JSON por agenda durante la compilación (filtrado a 7 campos): el
+// objeto y diasSemana en slots de ArduinoJson (16 bytes en el ESP8266, 32 en
+// 64 bits) más los strings copiados: las 7 claves (57 bytes), id UUID (37),
+// 7 días (28), horaInicio "HH:MM:SS" (9) y lugar para la clave más larga que
+// el filtro descarta (nombre, nodeId, updatedAt...: hasta 31 caracteres)
+#define AGENDA_ITEM_STRINGS_SIZE (57 + 37 + 28 + 9 + 32)
+#define AGENDA_ITEM_DOC_SIZE (JSON_OBJECT_SIZE(7) + JSON_ARRAY_SIZE(7) + AGENDA_ITEM_STRINGS_SIZE)
+
+// Sync incremental (ver AgendaDelta.h): el delta se combina con la agenda
+// vigente en AGENDA_DELTA_TEMP_FILE y sigue el mismo camino que un sync completo.
+#define AGENDA_DELTA_TEMP_FILE "/agenda.new"
+#define AGENDA_DELTA_MAX_IDS (MAX_AGENDAS * 2)  // Ids tocados por delta (más: pedir lista completa)
+
+// Imagen binaria de la tabla compilada (ver AgendaImage.h). Se regenera tras
+// cada compilación del JSON y al iniciar se carga con un único read().
+#define AGENDA_IMAGE_FILE "/agenda.bin"
+#define AGENDA_IMAGE_TEMP_FILE "/agenda.bin.tmp"
+
+// Diario de eventos de riego (ver EventJournal.h): todo evento pasa por flash
+// y se publica en lotes; sin conexión quedan pendientes hasta reconectar.
+#define EVENT_JOURNAL_SEGMENTS 4              // Archivos del diario circular
+#define EVENT_JOURNAL_SEGMENT_RECORDS 64      // Registros de 24 bytes por archivo (256 eventos)
+#define EVENT_JOURNAL_FILE_PATTERN "/evj%u.bin"
+#define EVENT_JOURNAL_STATE_FILE "/evj_state.bin"
+#define EVENT_JOURNAL_DRAIN_BATCH 8           // Eventos publicados por lote
+#define EVENT_JOURNAL_DRAIN_INTERVAL_MS 250   // Pausa entre lotes (no saturar el broker)
+
+// Recuperación de agendas perdidas (reinicio, hueco NTP, OTA, minuto salteado)
+// Se persiste el último minuto evaluado y al verificar se evalúa todo el
+// intervalo desde entonces; una agenda perdida corre si su ventana sigue abierta.
+#define AGENDA_WATERMARK_FILE "/agenda_wm.txt"
+#define AGENDA_WATERMARK_PERSIST_SEC 600     // Persistir watermark cada 10 min (o al ejecutar)
+#define AGENDA_CATCHUP_MAX_LATE_SEC 1800     // Gracia: máximo atraso recuperable (30 min)
+#define AGENDA_CATCHUP_MIN_REMAINING_SEC 60  // No iniciar si queda menos de 1 min de ventana
+#define AGENDA_CATCHUP_SHORTEN true          // true: regar solo lo que resta de la ventana
 
 // Tamaño de buffers JSON
 #define JSON_BUFFER_SMALL 256   // Comandos, estado
@@ -104,6 +238,15 @@ static const int SENSOR_PINS[MAX_SENSORS] = {
 #define DEBUG_SERIAL true
 #define SERIAL_BAUD_RATE 115200
 
+// Comandos por consola serial ("bench": benchmark de agendas, ver AgendaBenchmark.h;
+// "info": red, MQTT, hora y LittleFS; "agenda": JSON almacenado;
+// "perfil" / "perfil reset": tiempos del loop, ver LoopProfiler.h).
+// RX (GPIO3) es la salida de la zona 8: con los comandos habilitados ese pin
+// no se configura como salida, así que solo usar en placas sin zona 8 cableada.
+#define SERIAL_COMMANDS_ENABLED false
+#define SERIAL_RX_PIN 3
+#define SERIAL_COMMAND_MAX_LEN 32
+
 // Niveles de log
 #define LOG_LEVEL_NONE  0
 #define LOG_LEVEL_ERROR 1
@@ -111,8 +254,40 @@ static const int SENSOR_PINS[MAX_SENSORS] = {
 #define LOG_LEVEL_INFO  3
 #define LOG_LEVEL_DEBUG 4
 
-// Nivel actual (cambiar para más/menos verbose)
+// Nivel actual (cambiar para más/menos verbose, o compilar con -DLOG_LEVEL=...).
+// Los niveles por encima no ocupan flash ni RAM (ver Logger.h)
+#ifndef LOG_LEVEL
 #define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Logger: líneas a un buffer circular estático que el loop vacía al UART en
+// tiempo ocioso (a 115200 baudios una línea de 100 bytes bloqueaba ~9 ms)
+#define LOG_BUFFER_SIZE 1536        // Bytes (un par de segundos de logs INFO)
+#define LOG_LINE_MAX 160            // Largo máximo de una línea (se trunca)
+#define LOG_DRAIN_INTERVAL_MS 10    // Con líneas pendientes, el loop duerme de a tramos así
+
+// Registro binario en LittleFS (ver storage/LogRecorder.h): cada línea hasta
+// LOG_RECORD_LEVEL se guarda como registro compacto (hora, nivel, id del
+// formato y argumentos). tools/log_decode.py lo vuelve texto en el host
+#define LOG_RECORD_ENABLED true
+#ifndef LOG_RECORD_LEVEL
+#define LOG_RECORD_LEVEL LOG_LEVEL_INFO
+#endif
+#define LOG_RECORD_FILE "/log.bin"
+#define LOG_RECORD_FILE_OLD "/log.1.bin"    // Archivo anterior (rotación)
+#define LOG_RECORD_FILE_MAX 16384           // Bytes por archivo antes de rotar
+#define LOG_RECORD_BATCH_BYTES 256          // Lote en RAM entre escrituras a flash
+#define LOG_RECORD_FLUSH_MS 60000           // Lote parcial: se escribe a lo sumo cada este tiempo
+#define LOG_RECORD_STRING_MAX 32            // Largo máximo de un argumento %s (se trunca)
+
+// Log remoto por MQTT (ver network/LogStreamer.h): las líneas hasta el nivel
+// pedido en riego/{id}/log/nivel se publican en riego/{id}/log, varias por
+// mensaje. Arranca apagado: se prende desde MQTT mientras se diagnostica
+#define LOG_STREAM_ENABLED true
+#define LOG_STREAM_DEFAULT_LEVEL LOG_LEVEL_NONE
+#define LOG_STREAM_QUEUE_BYTES 1024         // Cola de líneas esperando publicación
+#define LOG_STREAM_PAYLOAD_MAX 512          // Bytes por mensaje (líneas enteras)
+#define LOG_STREAM_INTERVAL_MS 500          // Mínimo entre mensajes (tope ~1 KB/s)
 
 // ============= System States =============
 enum SystemState {
@@ -155,6 +330,35 @@ static const char* DIAS_SEMANA[] = {
 // Tiempo máximo sin yield() antes de reset automático
 #define LOOP_DELAY_MS 100  // Delay mínimo en loop()
 
+// Perfil del loop (ver utils/LoopProfiler.h): histogramas de tiempo por
+// módulo, período y retraso al despertar. Se ven con el comando serial
+// "perfil" y se publican en riego/{id}/diagnostico/loop
+#define LOOP_PROFILER_ENABLED true
+#define LOOP_PROFILER_SLOW_MS 100         // Vuelta lenta: se cuenta y se loguea el módulo culpable
+#define LOOP_PROFILER_REPORT_MS 60000     // Ventana entre reportes por MQTT
+#define LOOP_PROFILER_PAYLOAD_MAX 640     // Bytes del reporte JSON
+
+// ============= Power Save Config =============
+// Modo ahorro (nodos solares): en lugar de girar cada LOOP_DELAY_MS, el loop
+// duerme (WiFi en light-sleep) hasta el próximo evento: inicio de agenda,
+// vencimiento de timer, keepalive MQTT o refresco de display.
+// Tope de cada sueño. Agenda, timers, reconexión y keepalive MQTT (cada
+// MQTT_KEEP_ALIVE / 2) ya despiertan por su plazo, así que el tope solo acota
+// lo que llega sin aviso:
+// - Comandos MQTT: quedan en el buffer TCP y se atienden al despertar.
+// - Botón: se sondea; una pulsación que empieza durmiendo se detecta hasta
+//   un sueño tarde y se mide así de corta (hay que mantener
+//   CONFIG_PORTAL_HOLD_MS + POWER_SAVE_MAX_SLEEP_MS como peor caso).
+// Subirlo ahorra poco: en light-sleep la radio despierta igual en cada DTIM
+// y una vuelta ociosa del loop cuesta milisegundos.
+#define POWER_SAVE_ENABLED false
+#define POWER_SAVE_COMMAND_LATENCY_MS 2000        // Atraso aceptable de un comando manual
+#define POWER_SAVE_BUTTON_SLACK_MS (CONFIG_PORTAL_HOLD_MS / 2)  // Pulsación perdida como máximo
+#define POWER_SAVE_MAX_SLEEP_MS (POWER_SAVE_COMMAND_LATENCY_MS < POWER_SAVE_BUTTON_SLACK_MS ? \
+                                 POWER_SAVE_COMMAND_LATENCY_MS : POWER_SAVE_BUTTON_SLACK_MS)
+#define DISPLAY_UPDATE_INTERVAL 2000              // Refresco de display normal
+#define DISPLAY_UPDATE_INTERVAL_POWER_SAVE 30000  // Refresco de display en modo ahorro
+
 // ============= Version del Firmware =============
 #define FIRMWARE_VERSION "1.0.0"
 #define BUILD_DATE __DATE__
@@ -0,0 +1,67 @@
+#ifndef EVENT_TYPES_H
+#define EVENT_TYPES_H
+
+// ============================================================================
+// EventTypes - Tipos de eventos publicados por MQTT
+// ============================================================================
+// Enums en lugar de String: los eventos se generan en el loop de estado y
+// en cada encendido/apagado, y no deben reservar heap. El texto que viaja
+// en el payload (contrato con el backend) sale de las tablas de nombres.
+
+// Evento de riego (riego/{nodeId}/evento)
+enum RiegoEvento {
+    RIEGO_INICIO = 0,
+    RIEGO_FIN,
+    RIEGO_EN_COLA,      // Pedido esperando lugar (ZoneSequencer)
+    RIEGO_CANCELADO     // Pedido en cola apagado antes de arrancar
+};
+
+// Origen del riego
+enum RiegoOrigen {
+    ORIGEN_MANUAL = 0,
+    ORIGEN_AGENDA
+};
+
+// Evento del sistema (riego/{nodeId}/sistema/evento)
+enum SystemEvent {
+    SYS_AGENDA_SYNC_OK = 0,
+    SYS_AGENDA_INITIAL_LOAD_OK,
+    SYS_AGENDA_PARSE_ERROR,
+    SYS_AGENDA_FORMAT_ERROR,
+    SYS_AGENDA_STORAGE_ERROR,
+    SYS_AGENDA_LOAD_ERROR,
+    SYS_AGENDA_FETCH_WARNING,
+    SYS_AGENDA_DELTA_ERROR,
+    SYS_MQTT_RECOVERY,
+    SYS_EVENT_COUNT
+};
+
+inline const char* riegoEventoName(RiegoEvento evento) {
+    switch (evento) {
+        case RIEGO_FIN: return "fin";
+        case RIEGO_EN_COLA: return "en_cola";
+        case RIEGO_CANCELADO: return "cancelado";
+        default: return "inicio";
+    }
+}
+
+inline const char* riegoOrigenName(RiegoOrigen origen) {
+    return origen == ORIGEN_AGENDA ? "agenda" : "manual";
+}
+
+inline const char* systemEventName(SystemEvent tipo) {
+    static const char* const NAMES[SYS_EVENT_COUNT] = {
+        "agenda_sync_ok",
+        "agenda_initial_load_ok",
+        "agenda_parse_error",
+        "agenda_format_error",
+        "agenda_storage_error",
+        "agenda_load_error",
+        "agenda_fetch_warning",
+        "agenda_delta_error",
+        "mqtt_recovery"
+    };
+    return (unsigned)tipo < SYS_EVENT_COUNT ? NAMES[tipo] : "desconocido";
+}
+
+#endif // EVENT_TYPES_H
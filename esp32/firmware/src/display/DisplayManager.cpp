@@ -27,7 +27,7 @@ DisplayManager::~DisplayManager() {
 // Inicialización
 // ============================================================================
 bool DisplayManager::init(int sda, int scl, uint8_t address, int width, int height) {
-    Logger::info("Inicializando DisplayManager...");
+    LOG_INFO("Inicializando DisplayManager...");
     
     screenWidth = width;
     screenHeight = height;
@@ -38,12 +38,12 @@ bool DisplayManager::init(int sda, int scl, uint8_t address, int width, int heig
     oledDisplay = new Adafruit_SSD1306(screenWidth, screenHeight, &Wire, -1);
     
     if (!oledDisplay->begin(SSD1306_SWITCHCAPVCC, i2cAddress)) {
-        Logger::logf(LOG_LEVEL_ERROR, "Fallo init SSD1306 en direccion 0x%02X", i2cAddress);
+        LOG_ERROR("Fallo init SSD1306 en direccion 0x%02X", i2cAddress);
         initialized = false;
         return false;
     }
     
-    Logger::logf(LOG_LEVEL_INFO, "Display SSD1306 inicializado correctamente (0x%02X)", i2cAddress);
+    LOG_INFO("Display SSD1306 inicializado correctamente (0x%02X)", i2cAddress);
     
     oledDisplay->clearDisplay();
     oledDisplay->setTextColor(SSD1306_WHITE);
@@ -0,0 +1,30 @@
+#include "GpioOutputBackend.h"
+#include "../utils/Logger.h"
+
+GpioOutputBackend::GpioOutputBackend(const int* pins, uint8_t count)
+    : OutputBackend(count), pins(pins) {}
+
+bool GpioOutputBackend::usable(uint8_t channel) const {
+    return !(SERIAL_COMMANDS_ENABLED && pins[channel] == SERIAL_RX_PIN);
+}
+
+bool GpioOutputBackend::beginBus() {
+    for (uint8_t i = 0; i < channels; i++) {
+        if (!usable(i)) {
+            // RX reservado para comandos serial: la zona queda sin salida
+            LOG_WARN("Zona %d (GPIO%d) deshabilitada: RX reservado para comandos serial",
+                     i + 1, SERIAL_RX_PIN);
+            continue;
+        }
+        pinMode(pins[i], OUTPUT);
+    }
+    return true;
+}
+
+bool GpioOutputBackend::write(uint32_t levels, uint32_t changed) {
+    for (uint8_t i = 0; i < channels; i++) {
+        if ((changed & (1UL << i)) == 0 || !usable(i)) continue;
+        digitalWrite(pins[i], (levels & (1UL << i)) != 0 ? HIGH : LOW);
+    }
+    return true;
+}
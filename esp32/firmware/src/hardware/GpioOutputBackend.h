@@ -0,0 +1,28 @@
+#ifndef GPIO_OUTPUT_BACKEND_H
+#define GPIO_OUTPUT_BACKEND_H
+
+#include "OutputBackend.h"
+
+// ============================================================================
+// GpioOutputBackend - Un pin del ESP8266 por zona (placa original, 8 zonas)
+// ============================================================================
+// Solo escribe los pines que cambiaron. Con SERIAL_COMMANDS_ENABLED el pin
+// RX queda como entrada y su zona sin salida.
+
+class GpioOutputBackend : public OutputBackend {
+private:
+    const int* pins;
+
+    bool usable(uint8_t channel) const;
+
+protected:
+    bool beginBus() override;
+    bool write(uint32_t levels, uint32_t changed) override;
+
+public:
+    GpioOutputBackend(const int* pins, uint8_t count);
+
+    const char* getName() const override { return "GPIO"; }
+};
+
+#endif // GPIO_OUTPUT_BACKEND_H
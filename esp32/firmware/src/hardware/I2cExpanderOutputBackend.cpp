@@ -0,0 +1,69 @@
+#include "I2cExpanderOutputBackend.h"
+
+#define MCP23017_IODIRA 0x00
+#define MCP23017_OLATA 0x14
+
+// ============================================================================
+// PCF8574
+// ============================================================================
+Pcf8574OutputBackend::Pcf8574OutputBackend(TwoWire& wire, uint8_t address, uint8_t chips)
+    : OutputBackend(chips * 8), wire(wire), address(address) {}
+
+bool Pcf8574OutputBackend::beginBus() {
+    wire.begin(I2C_SDA, I2C_SCL);
+    return true;
+}
+
+bool Pcf8574OutputBackend::write(uint32_t levels, uint32_t changed) {
+    bool ok = true;
+    for (uint8_t chip = 0; chip < channels / 8; chip++) {
+        if (((changed >> (chip * 8)) & 0xFF) == 0) continue;
+        wire.beginTransmission(address + chip);
+        wire.write((uint8_t)(levels >> (chip * 8)));
+        if (wire.endTransmission() != 0) ok = false;
+    }
+    return ok;
+}
+
+// ============================================================================
+// MCP23017
+// ============================================================================
+Mcp23017OutputBackend::Mcp23017OutputBackend(TwoWire& wire, uint8_t address, uint8_t chips)
+    : OutputBackend(chips * 16), wire(wire), address(address), configured(false) {}
+
+bool Mcp23017OutputBackend::writeRegisters(uint8_t chip, uint8_t reg, uint8_t a, uint8_t b) {
+    wire.beginTransmission(address + chip);
+    wire.write(reg);
+    wire.write(a);
+    wire.write(b);
+    return wire.endTransmission() == 0;
+}
+
+bool Mcp23017OutputBackend::beginBus() {
+    wire.begin(I2C_SDA, I2C_SCL);
+    return true;
+}
+
+// Latches en apagado antes de pasar los pines a salida (sin pulso al
+// arrancar). Se repite hasta que el chip responda: un expansor que no estaba
+// al arrancar sigue con los pines como entrada.
+bool Mcp23017OutputBackend::configure() {
+    uint8_t off = RELAY_OFF == HIGH ? 0xFF : 0x00;
+    for (uint8_t chip = 0; chip < channels / 16; chip++) {
+        if (!writeRegisters(chip, MCP23017_OLATA, off, off)) return false;
+        if (!writeRegisters(chip, MCP23017_IODIRA, 0x00, 0x00)) return false;
+    }
+    configured = true;
+    return true;
+}
+
+bool Mcp23017OutputBackend::write(uint32_t levels, uint32_t changed) {
+    if (!configured && !configure()) return false;
+    bool ok = true;
+    for (uint8_t chip = 0; chip < channels / 16; chip++) {
+        if (((changed >> (chip * 16)) & 0xFFFF) == 0) continue;
+        uint16_t chipLevels = (uint16_t)(levels >> (chip * 16));
+        ok &= writeRegisters(chip, MCP23017_OLATA, (uint8_t)chipLevels, (uint8_t)(chipLevels >> 8));
+    }
+    return ok;
+}
@@ -0,0 +1,51 @@
+#ifndef I2C_EXPANDER_OUTPUT_BACKEND_H
+#define I2C_EXPANDER_OUTPUT_BACKEND_H
+
+#include <Wire.h>
+#include "OutputBackend.h"
+
+// ============================================================================
+// Expansores I2C - PCF8574 (8 salidas) y MCP23017 (16 salidas) por chip
+// ============================================================================
+// Comparten el bus de la pantalla OLED (I2C_SDA/I2C_SCL). Los chips van en
+// direcciones consecutivas desde `address` (pines A0-A2). En cada escritura
+// solo se direccionan los chips con canales cambiados, una transacción por
+// chip; un NACK de cualquiera marca el commit como fallido.
+
+class Pcf8574OutputBackend : public OutputBackend {
+private:
+    TwoWire& wire;
+    uint8_t address;
+
+protected:
+    bool beginBus() override;
+    bool write(uint32_t levels, uint32_t changed) override;
+
+public:
+    Pcf8574OutputBackend(TwoWire& wire, uint8_t address, uint8_t chips);
+
+    const char* getName() const override { return "PCF8574"; }
+};
+
+// MCP23017 con IOCON por defecto (BANK=0, direcciones secuenciales): OLATA y
+// OLATB se escriben juntos desde 0x14
+class Mcp23017OutputBackend : public OutputBackend {
+private:
+    TwoWire& wire;
+    uint8_t address;
+    bool configured;             // IODIR escrito (pines como salida)
+
+    bool configure();
+    bool writeRegisters(uint8_t chip, uint8_t reg, uint8_t a, uint8_t b);
+
+protected:
+    bool beginBus() override;
+    bool write(uint32_t levels, uint32_t changed) override;
+
+public:
+    Mcp23017OutputBackend(TwoWire& wire, uint8_t address, uint8_t chips);
+
+    const char* getName() const override { return "MCP23017"; }
+};
+
+#endif // I2C_EXPANDER_OUTPUT_BACKEND_H
@@ -0,0 +1,65 @@
+#include "OutputBackend.h"
+#include "../utils/Logger.h"
+
+// ============================================================================
+// Constructor
+// ============================================================================
+OutputBackend::OutputBackend(uint8_t channels)
+    : state(0), written(0), synced(false), started(false), transactions(0), failures(0),
+      channels(channels > OUTPUT_BACKEND_MAX_CHANNELS ? OUTPUT_BACKEND_MAX_CHANNELS : channels) {}
+
+bool OutputBackend::begin() {
+    if (!started) {
+        if (!beginBus()) {
+            LOG_ERROR("Salidas %s: no se pudo iniciar el bus", getName());
+        }
+        started = true;
+        LOG_INFO("Salidas de rele por %s (%u canales)", getName(), channels);
+    }
+    state = 0;
+    return commit(true);
+}
+
+// ============================================================================
+// Estado deseado
+// ============================================================================
+void OutputBackend::set(uint8_t channel, bool on) {
+    if (channel >= channels) return;
+    if (on) {
+        state |= 1UL << channel;
+    } else {
+        state &= ~(1UL << channel);
+    }
+}
+
+bool OutputBackend::get(uint8_t channel) const {
+    return channel < channels && (state & (1UL << channel)) != 0;
+}
+
+// ============================================================================
+// Escritura
+// ============================================================================
+bool OutputBackend::commit(bool force) {
+    if (!force && !isDirty()) return true;
+
+    uint32_t mask = channels >= 32 ? 0xFFFFFFFFUL : (1UL << channels) - 1;
+    uint32_t changed = (force || !synced) ? mask : (state ^ written);
+    uint32_t levels = RELAY_ON == HIGH ? state : (~state & mask);
+
+    transactions++;
+    if (!write(levels, changed)) {
+        // Escritura parcial posible: reescribir todo en el próximo intento
+        if (synced) {
+            LOG_WARN("Salidas %s: fallo de escritura, se reintenta", getName());
+        }
+        synced = false;
+        failures++;
+        return false;
+    }
+    if (!synced && !force) {
+        LOG_INFO("Salidas %s: escritura recuperada", getName());
+    }
+    written = state;
+    synced = true;
+    return true;
+}
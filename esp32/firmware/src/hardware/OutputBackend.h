@@ -0,0 +1,64 @@
+#ifndef OUTPUT_BACKEND_H
+#define OUTPUT_BACKEND_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+
+// ============================================================================
+// OutputBackend - Salidas de relé sobre GPIO, registros o expansores I2C
+// ============================================================================
+// OutputScheduler decide qué canal conmuta y cuándo; el backend solo guarda
+// el estado deseado de cada canal (un bit por canal, hasta 32) y lo lleva al
+// hardware en commit(): una transacción de bus por vuelta del loop, con todos
+// los canales que cambiaron juntos. Si la escritura falla (NACK en I2C) el
+// hardware queda con estado incierto, isDirty() sigue en true y el próximo
+// commit() reescribe todos los canales.
+//
+// La polaridad sale de RELAY_ON/RELAY_OFF: cada backend recibe el nivel de
+// cada salida ya resuelto (bit en 1 = pin en HIGH).
+
+#define OUTPUT_BACKEND_MAX_CHANNELS 32
+
+class OutputBackend {
+private:
+    uint32_t state;              // Estado deseado (bit = canal encendido)
+    uint32_t written;            // Último estado escrito con éxito
+    bool synced;                 // false = hardware en estado desconocido
+    bool started;
+    uint32_t transactions;
+    uint32_t failures;
+
+protected:
+    uint8_t channels;
+
+    // Preparar el bus/pines (una sola vez, antes de la primera escritura)
+    virtual bool beginBus() = 0;
+
+    // Escribir en una transacción los niveles de todos los canales. `changed`
+    // marca los canales distintos de lo escrito antes (todos si se fuerza).
+    virtual bool write(uint32_t levels, uint32_t changed) = 0;
+
+public:
+    explicit OutputBackend(uint8_t channels);
+    virtual ~OutputBackend() {}
+
+    // Preparar el bus y dejar todos los canales apagados (idempotente)
+    bool begin();
+
+    // Estado deseado de un canal (solo memoria, se escribe en commit())
+    void set(uint8_t channel, bool on);
+    bool get(uint8_t channel) const;
+
+    // Llevar al hardware los cambios pendientes; force reescribe todo
+    bool commit(bool force = false);
+
+    // ¿Hay cambios sin escribir (o una escritura fallida por reintentar)?
+    bool isDirty() const { return !synced || state != written; }
+
+    uint8_t getChannelCount() const { return channels; }
+    uint32_t getTransactionCount() const { return transactions; }
+    uint32_t getFailureCount() const { return failures; }
+    virtual const char* getName() const = 0;
+};
+
+#endif // OUTPUT_BACKEND_H
@@ -0,0 +1,130 @@
+#include "OutputScheduler.h"
+
+// ============================================================================
+// Constructor y configuración
+// ============================================================================
+OutputScheduler::OutputScheduler(OutputBackend* backend)
+    : backend(nullptr), count(0), hasSwitched(false), lastSwitchAt(0),
+      hasOn(false), lastOnAt(0), switchCount(0), lastCommitAt(0) {
+    setTiming(RELAY_SWITCH_INTERVAL_MS, RELAY_CHANGEOVER_OVERLAP_MS);
+    setBackend(backend);
+}
+
+void OutputScheduler::setBackend(OutputBackend* backend) {
+    this->backend = backend;
+    uint8_t channels = backend->getChannelCount();
+    count = channels > MAX_ZONES ? MAX_ZONES : channels;
+    for (uint8_t i = 0; i < MAX_ZONES; i++) {
+        desired[i] = false;
+        applied[i] = false;
+    }
+}
+
+void OutputScheduler::setTiming(uint32_t minInterval, uint32_t overlap) {
+    minIntervalMs = minInterval;
+    overlapMs = overlap;
+}
+
+void OutputScheduler::reset() {
+    for (uint8_t i = 0; i < count; i++) {
+        desired[i] = false;
+        applied[i] = false;
+    }
+    backend->begin();
+    lastCommitAt = millis();
+}
+
+void OutputScheduler::set(uint8_t channel, bool on) {
+    if (channel >= count) return;
+    desired[channel] = on;
+}
+
+// ============================================================================
+// Aplicación escalonada
+// ============================================================================
+int OutputScheduler::pick(unsigned long now) const {
+    int firstOff = -1;
+    int firstOn = -1;
+    for (uint8_t i = 0; i < count; i++) {
+        if (desired[i] == applied[i]) continue;
+        if (desired[i]) {
+            if (firstOn < 0) firstOn = i;
+        } else if (firstOff < 0) {
+            firstOff = i;
+        }
+    }
+
+    if (overlapMs == 0) {
+        return firstOff >= 0 ? firstOff : firstOn;
+    }
+
+    // Traspaso con solapamiento: abrir antes de cerrar
+    if (firstOn >= 0) return firstOn;
+    if (firstOff >= 0 && (!hasOn || now - lastOnAt >= overlapMs)) return firstOff;
+    return -1;
+}
+
+void OutputScheduler::loop(unsigned long now) {
+    bool retry = backend->isDirty() && now - lastCommitAt >= OUTPUT_BUS_RETRY_MS;
+    if (apply(now) || retry) {
+        backend->commit();
+        lastCommitAt = now;
+    }
+}
+
+bool OutputScheduler::apply(unsigned long now) {
+    bool switched = false;
+    while (true) {
+        if (hasSwitched && now - lastSwitchAt < minIntervalMs) return switched;
+        int channel = pick(now);
+        if (channel < 0) return switched;
+
+        bool on = desired[channel];
+        write(channel, on);
+        hasSwitched = true;
+        lastSwitchAt = now;
+        if (on) {
+            hasOn = true;
+            lastOnAt = now;
+        }
+        switched = true;
+    }
+}
+
+void OutputScheduler::write(uint8_t channel, bool on) {
+    backend->set(channel, on);
+    applied[channel] = on;
+    switchCount++;
+}
+
+// ============================================================================
+// Consultas
+// ============================================================================
+bool OutputScheduler::isPending() const {
+    for (uint8_t i = 0; i < count; i++) {
+        if (desired[i] != applied[i]) return true;
+    }
+    return false;
+}
+
+long OutputScheduler::getMsUntilNextSwitch(unsigned long now) const {
+    // Escritura fallida esperando su reintento
+    long retry = -1;
+    if (backend->isDirty()) {
+        unsigned long elapsed = now - lastCommitAt;
+        retry = elapsed >= OUTPUT_BUS_RETRY_MS ? 0 : (long)(OUTPUT_BUS_RETRY_MS - elapsed);
+    }
+    if (!isPending()) return retry;
+
+    unsigned long at = now;
+    if (hasSwitched && now - lastSwitchAt < minIntervalMs) {
+        at = lastSwitchAt + minIntervalMs;
+    }
+    // Solo quedan cierres esperando el solapamiento del último ON
+    if (pick(at) < 0 && hasOn) {
+        unsigned long overlapEnd = lastOnAt + overlapMs;
+        if ((long)(overlapEnd - at) > 0) at = overlapEnd;
+    }
+    long ms = (long)(at - now);
+    return retry >= 0 && retry < ms ? retry : ms;
+}
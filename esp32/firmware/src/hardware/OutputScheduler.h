@@ -0,0 +1,77 @@
+#ifndef OUTPUT_SCHEDULER_H
+#define OUTPUT_SCHEDULER_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "OutputBackend.h"
+
+// ============================================================================
+// OutputScheduler - Conmutación escalonada de las bobinas de relé
+// ============================================================================
+// RelayController decide el estado de cada zona y acá se aplica al backend de
+// salidas (GPIO, 74HC595 o expansor I2C), una bobina por vez y con al menos RELAY_SWITCH_INTERVAL_MS entre
+// conmutaciones: varias zonas que arrancan en el mismo minuto no suman su
+// corriente de arranque sobre la fuente de 5 V (brown-out). Entre cambios
+// pendientes, los OFF van antes que los ON (primero se libera corriente).
+//
+// Con RELAY_CHANGEOVER_OVERLAP_MS > 0 el orden se invierte para el traspaso
+// de una zona a otra: la válvula nueva abre primero y las que cierran esperan
+// ese tiempo desde el último ON, así el agua nunca queda sin salida (golpe de
+// ariete). Los cambios se aplican desde loop(), no al pedirlos: un OFF por
+// vencimiento y el ON que el secuenciador pide en la misma vuelta llegan
+// juntos y se ordenan entre sí. Lo conmutado en una vuelta sale en un solo
+// commit() del backend; si el bus falla se reintenta cada OUTPUT_BUS_RETRY_MS.
+
+class OutputScheduler {
+private:
+    OutputBackend* backend;
+    uint8_t count;
+    uint32_t minIntervalMs;
+    uint32_t overlapMs;
+
+    bool desired[MAX_ZONES];
+    bool applied[MAX_ZONES];
+
+    bool hasSwitched;
+    unsigned long lastSwitchAt;
+    bool hasOn;
+    unsigned long lastOnAt;
+    uint32_t switchCount;
+    unsigned long lastCommitAt;
+
+    // Próximo canal a conmutar ahora (-1 si ninguno puede)
+    int pick(unsigned long now) const;
+
+    // Conmutar lo que el intervalo permita; true si cambió algún canal
+    bool apply(unsigned long now);
+
+    void write(uint8_t channel, bool on);
+
+public:
+    explicit OutputScheduler(OutputBackend* backend);
+
+    // Cambiar de backend (antes de reset(): el nuevo arranca apagado ahí)
+    void setBackend(OutputBackend* backend);
+
+    void setTiming(uint32_t minIntervalMs, uint32_t overlapMs);
+
+    // Todas las salidas apagadas ya, sin escalonar (arranque, emergencia).
+    // La primera vez también prepara el bus del backend.
+    void reset();
+
+    // Estado deseado de un canal (se aplica en loop())
+    void set(uint8_t channel, bool on);
+
+    // Aplicar los cambios pendientes que el intervalo permita
+    void loop(unsigned long now);
+
+    // Ms hasta la próxima conmutación pendiente o reintento de escritura (-1
+    // si no hay ninguno)
+    long getMsUntilNextSwitch(unsigned long now) const;
+
+    bool isPending() const;
+    bool isApplied(uint8_t channel) const { return channel < count && applied[channel]; }
+    uint32_t getSwitchCount() const { return switchCount; }
+};
+
+#endif // OUTPUT_SCHEDULER_H
@@ -1,19 +1,19 @@
 #include "RelayController.h"
+#include "../utils/Logger.h"
 
 // ============================================================================
 // Constructor
 // ============================================================================
-RelayController::RelayController() {
-    lastUpdate = 0;
+RelayController::RelayController()
+    : gpioOutputs(RELAY_PINS, MAX_ZONES), outputs(&gpioOutputs) {
     stateChangedCallback = nullptr;
     riegoEventCallback = nullptr;
     
     // Inicializar arrays
     for (int i = 0; i < MAX_ZONES; i++) {
         zoneState[i] = false;
-        zoneTimer[i] = 0;
         zoneDuracionProgramada[i] = 0;
-        zoneOrigen[i] = "manual";
+        zoneOrigen[i] = ORIGEN_MANUAL;
         zoneVersionAgenda[i] = 0;
     }
 }
@@ -21,27 +21,30 @@ RelayController::RelayController() {
 // ============================================================================
 // Inicializacion
 // ============================================================================
+void RelayController::setOutputBackend(OutputBackend* backend) {
+    outputs.setBackend(backend != nullptr ? backend : &gpioOutputs);
+}
+
 void RelayController::init() {
-    // Los pines ya fueron inicializados en main.cpp initHardware()
-    // Solo aseguramos que todo este apagado
+    // Prepara el bus la primera vez y asegura todo apagado
+    outputs.reset();
     for (int i = 0; i < MAX_ZONES; i++) {
-        digitalWrite(RELAY_PINS[i], RELAY_OFF);
         zoneState[i] = false;
-        zoneTimer[i] = 0;
     }
+    deadlines.clear();
 }
 
 // ============================================================================
 // Encender zona
 // ============================================================================
-void RelayController::turnOn(int zona, int duracionSeg, String origen, int versionAgenda) {
+void RelayController::turnOn(int zona, int duracionSeg, RiegoOrigen origen, int versionAgenda) {
     if (!isValidZone(zona)) return;
     
     int idx = zona - 1;
     
     // Validar duracion
     if (duracionSeg < MIN_RIEGO_DURATION || duracionSeg > MAX_RIEGO_DURATION) {
-        Serial.printf("[WARN] Duracion invalida para zona %d: %d seg\n", zona, duracionSeg);
+        LOG_WARN("Duracion invalida para zona %d: %d seg", zona, duracionSeg);
         return;
     }
     
@@ -50,16 +53,16 @@ void RelayController::turnOn(int zona, int duracionSeg, String origen, int versi
     zoneOrigen[idx] = origen;
     zoneVersionAgenda[idx] = versionAgenda;
     
-    // Activar rele (logica invertida: LOW = ON)
-    digitalWrite(RELAY_PINS[idx], RELAY_ON);
+    // Activar rele (se conmuta escalonado en loop())
+    outputs.set(idx, true);
     zoneState[idx] = true;
-    zoneTimer[idx] = duracionSeg;
+    deadlines.schedule(idx, millis() + (uint32_t)duracionSeg * 1000UL);
     
-    Serial.printf("[INFO] Zona %d activada por %d segundos (origen: %s)\n", zona, duracionSeg, origen.c_str());
+    LOG_INFO("Zona %d activada por %d segundos (origen: %s)", zona, duracionSeg, riegoOrigenName(origen));
     
     // Publicar evento de inicio
     if (riegoEventCallback != nullptr) {
-        riegoEventCallback(zona, "inicio", origen, duracionSeg, versionAgenda);
+        riegoEventCallback(zona, RIEGO_INICIO, origen, duracionSeg, versionAgenda);
     }
 }
 
@@ -73,89 +76,56 @@ void RelayController::turnOff(int zona) {
     
     // Si la zona estaba activa, publicar evento de fin
     if (zoneState[idx]) {
-        int duracionReal = zoneDuracionProgramada[idx] - zoneTimer[idx];
+        int duracionReal = zoneDuracionProgramada[idx] - getRemainingTime(zona);
         if (riegoEventCallback != nullptr) {
-            riegoEventCallback(zona, "fin", zoneOrigen[idx], duracionReal, zoneVersionAgenda[idx]);
+            riegoEventCallback(zona, RIEGO_FIN, zoneOrigen[idx], duracionReal, zoneVersionAgenda[idx]);
         }
     }
     
     // Desactivar rele
-    digitalWrite(RELAY_PINS[idx], RELAY_OFF);
+    outputs.set(idx, false);
     zoneState[idx] = false;
-    zoneTimer[idx] = 0;
+    deadlines.cancel(idx);
     zoneDuracionProgramada[idx] = 0;
-    zoneOrigen[idx] = "manual";
+    zoneOrigen[idx] = ORIGEN_MANUAL;
     zoneVersionAgenda[idx] = 0;
     
-    Serial.printf("[INFO] Zona %d desactivada\n", zona);
+    LOG_INFO("Zona %d desactivada", zona);
 }
 
 // ============================================================================
-// Loop - Actualizar timers
+// Loop - Apagar zonas vencidas
 // ============================================================================
 void RelayController::loop() {
-    static unsigned long loopCount = 0;
-    loopCount++;
-    
     unsigned long now = millis();
+    outputs.loop(now);
     
-    // Inicializar en el primer loop
-    if (lastUpdate == 0) {
-        Serial.println("[DEBUG] RelayController::loop() - Primera ejecucion, inicializando lastUpdate");
-        lastUpdate = now;
-        return;
+    // Solo el próximo vencimiento: sin zonas vencidas no recorre nada
+    uint8_t idx;
+    while (deadlines.popExpired(now, idx)) {
+        expire(idx);
     }
-    
-    // Actualizar cada segundo
-    if (now - lastUpdate < 1000) return;
-    
-    // Log cada 10 segundos para verificar que se llama
-    if (loopCount % 10 == 0) {
-        Serial.printf("[DEBUG] RelayController::loop() ejecutandose (count: %lu)\n", loopCount);
+}
+
+void RelayController::expire(int idx) {
+    // Timer expirado - publicar evento de fin antes de apagar
+    if (riegoEventCallback != nullptr) {
+        riegoEventCallback(idx + 1, RIEGO_FIN, zoneOrigen[idx], zoneDuracionProgramada[idx], zoneVersionAgenda[idx]);
     }
     
-    unsigned long elapsed = (now - lastUpdate) / 1000;
-    lastUpdate = now;
+    // Apagar zona
+    outputs.set(idx, false);
+    zoneState[idx] = false;
+    LOG_INFO("Zona %d apagada automaticamente (timer expirado)", idx + 1);
     
-    // Debug: mostrar si hay timers activos
-    bool hasActiveTimers = false;
-    for (int i = 0; i < MAX_ZONES; i++) {
-        if (zoneTimer[i] > 0) {
-            hasActiveTimers = true;
-            Serial.printf("[DEBUG] Zona %d timer: %d seg (elapsed: %lu)\n", i + 1, zoneTimer[i], elapsed);
-        }
-    }
+    // Limpiar info de riego
+    zoneDuracionProgramada[idx] = 0;
+    zoneOrigen[idx] = ORIGEN_MANUAL;
+    zoneVersionAgenda[idx] = 0;
     
-    // Decrementar timers activos
-    for (int i = 0; i < MAX_ZONES; i++) {
-        if (zoneTimer[i] > 0) {
-            if (zoneTimer[i] <= elapsed) {
-                // Timer expirado - publicar evento de fin antes de apagar
-                if (riegoEventCallback != nullptr) {
-                    riegoEventCallback(i + 1, "fin", zoneOrigen[i], zoneDuracionProgramada[i], zoneVersionAgenda[i]);
-                }
-                
-                // Apagar zona
-                zoneTimer[i] = 0;
-                digitalWrite(RELAY_PINS[i], RELAY_OFF);
-                zoneState[i] = false;
-                Serial.printf("[INFO] Zona %d apagada automaticamente (timer expirado)\n", i + 1);
-                
-                // Limpiar info de riego
-                zoneDuracionProgramada[i] = 0;
-                zoneOrigen[i] = "manual";
-                zoneVersionAgenda[i] = 0;
-                
-                // Notificar cambio de estado
-                if (stateChangedCallback != nullptr) {
-                    stateChangedCallback(i + 1, false);
-                }
-            } else {
-                // Decrementar timer
-                zoneTimer[i] -= elapsed;
-                Serial.printf("[DEBUG] Zona %d nuevo timer: %d seg\n", i + 1, zoneTimer[i]);
-            }
-        }
+    // Notificar cambio de estado
+    if (stateChangedCallback != nullptr) {
+        stateChangedCallback(idx + 1, false);
     }
 }
 
@@ -169,20 +139,89 @@ bool RelayController::isActive(int zona) {
 
 int RelayController::getRemainingTime(int zona) {
     if (!isValidZone(zona)) return 0;
-    return zoneTimer[zona - 1];
+    return (int)((remainingMs(zona - 1, millis()) + 999) / 1000);
+}
+
+uint32_t RelayController::remainingMs(int idx, unsigned long now) {
+    if (!deadlines.contains(idx)) return 0;
+    int32_t ms = (int32_t)(deadlines.deadlineOf(idx) - (uint32_t)now);
+    return ms > 0 ? (uint32_t)ms : 0;
+}
+
+long RelayController::getMsUntilNextExpiry() {
+    unsigned long now = millis();
+    long expiry = deadlines.msUntilNext(now);
+    long output = outputs.getMsUntilNextSwitch(now);
+    if (expiry < 0) return output;
+    if (output < 0) return expiry;
+    return output < expiry ? output : expiry;
 }
 
 // ============================================================================
 // Parada de emergencia
 // ============================================================================
 void RelayController::emergencyStop() {
-    Serial.println("[WARN] Parada de emergencia - apagando todas las zonas");
+    LOG_WARN("Parada de emergencia - apagando todas las zonas");
     
+    // Sin escalonar: apagar no suma corriente de arranque
+    outputs.reset();
     for (int i = 0; i < MAX_ZONES; i++) {
-        digitalWrite(RELAY_PINS[i], RELAY_OFF);
         zoneState[i] = false;
-        zoneTimer[i] = 0;
     }
+    deadlines.clear();
+}
+
+// ============================================================================
+// Foto y reanudación (reinicio por software)
+// ============================================================================
+void RelayController::snapshot(RelaySnapshot& out) {
+    memset(&out, 0, sizeof(out));
+    unsigned long now = millis();
+    for (int i = 0; i < MAX_ZONES; i++) {
+        uint32_t ms = zoneState[i] ? remainingMs(i, now) : 0;
+        if (ms == 0) continue;
+        out.restante[i] = (uint16_t)((ms + 999) / 1000);
+        out.duracion[i] = (uint16_t)zoneDuracionProgramada[i];
+        out.versionAgenda[i] = zoneVersionAgenda[i];
+        out.origen[i] = (uint8_t)zoneOrigen[i];
+    }
+}
+
+uint8_t RelayController::restore(const RelaySnapshot& in, uint32_t elapsedSec) {
+    uint8_t restored = 0;
+    unsigned long now = millis();
+    
+    for (int i = 0; i < MAX_ZONES; i++) {
+        if (in.restante[i] == 0) continue;
+        RiegoOrigen origen = in.origen[i] == ORIGEN_AGENDA ? ORIGEN_AGENDA : ORIGEN_MANUAL;
+        
+        if (in.restante[i] <= elapsedSec) {
+            // Terminó durante el reinicio: cerrar el riego que quedó abierto
+            LOG_INFO("Zona %d termino durante el reinicio", i + 1);
+            if (riegoEventCallback != nullptr) {
+                riegoEventCallback(i + 1, RIEGO_FIN, origen, in.duracion[i], in.versionAgenda[i]);
+            }
+            continue;
+        }
+        
+        zoneDuracionProgramada[i] = in.duracion[i];
+        zoneOrigen[i] = origen;
+        zoneVersionAgenda[i] = in.versionAgenda[i];
+        uint32_t restanteSeg = in.restante[i] - elapsedSec;
+        deadlines.schedule(i, now + restanteSeg * 1000UL);
+        zoneState[i] = true;
+        outputs.set(i, true);
+        restored++;
+        
+        LOG_INFO("Zona %d reanudada: %lu seg restantes (origen: %s)",
+                 i + 1, (unsigned long)restanteSeg, riegoOrigenName(origen));
+    }
+    
+    return restored;
+}
+
+void RelayController::setSwitchTiming(uint32_t minIntervalMs, uint32_t overlapMs) {
+    outputs.setTiming(minIntervalMs, overlapMs);
 }
 
 // ============================================================================
@@ -190,7 +229,7 @@ void RelayController::emergencyStop() {
 // ============================================================================
 bool RelayController::isValidZone(int zona) {
     if (zona < 1 || zona > MAX_ZONES) {
-        Serial.printf("[ERROR] Zona invalida: %d (rango: 1-%d)\n", zona, MAX_ZONES);
+        LOG_ERROR("Zona invalida: %d (rango: 1-%d)", zona, MAX_ZONES);
         return false;
     }
     return true;
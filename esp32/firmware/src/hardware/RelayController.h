@@ -3,67 +3,115 @@
 
 #include <Arduino.h>
 #include "../config/Config.h"
+#include "../config/EventTypes.h"
+#include "../utils/DeadlineHeap.h"
+#include "GpioOutputBackend.h"
+#include "OutputScheduler.h"
 
 // ============================================================================
 // RelayController - Control de relés con timers automáticos
 // ============================================================================
-// Gestiona el estado de hasta 8 relés (zonas de riego) con temporizadores
+// Gestiona el estado de MAX_ZONES relés (zonas de riego) con temporizadores
 // automáticos que apagan los relés al finalizar el tiempo configurado.
+// Cada timer es un vencimiento absoluto de millis() fijado al encender, en un
+// min-heap: el loop solo mira el próximo vencimiento (O(1)) y el atraso de una
+// vuelta no se acumula entre vueltas ni entre riegos. Los pines no se
+// escriben directo: OutputScheduler escalona las conmutaciones de bobina
+// sobre un OutputBackend (por defecto, RELAY_PINS por GPIO).
 
 // Forward declaration para callback
 typedef void (*ZoneStateChangedCallback)(int zona, bool estado);
-typedef void (*RiegoEventCallback)(int zona, String evento, String origen, int duracion, int versionAgenda);
+typedef void (*RiegoEventCallback)(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion, int versionAgenda);
+
+// Foto de los riegos en curso (se guarda en memoria RTC antes de un reinicio
+// por software, ver WarmRestart). Tamaño fijo, múltiplo de 4 bytes.
+struct RelaySnapshot {
+    uint16_t restante[MAX_ZONES];        // Segundos restantes (0 = zona apagada)
+    uint16_t duracion[MAX_ZONES];        // Duración programada
+    int32_t versionAgenda[MAX_ZONES];
+    uint8_t origen[MAX_ZONES];           // RiegoOrigen
+};
 
 class RelayController {
 private:
     // Estado de cada zona (true = activa, false = inactiva)
     bool zoneState[MAX_ZONES];
     
-    // Timer de cada zona en segundos (0 = sin timer activo)
-    int zoneTimer[MAX_ZONES];
+    // Vencimiento de cada zona activa (millis() absoluto, índice = zona - 1)
+    DeadlineHeap<MAX_ZONES> deadlines;
+    
+    // Salidas por defecto: un GPIO por zona (RELAY_PINS)
+    GpioOutputBackend gpioOutputs;
+    
+    // Conmutación escalonada de las salidas de relé
+    OutputScheduler outputs;
     
     // Duración programada inicial de cada zona
     int zoneDuracionProgramada[MAX_ZONES];
     
-    // Origen del riego: "manual" o "agenda"
-    String zoneOrigen[MAX_ZONES];
+    // Origen del riego: manual o agenda
+    RiegoOrigen zoneOrigen[MAX_ZONES];
     
     // Versión de agenda (0 si es manual)
     int zoneVersionAgenda[MAX_ZONES];
     
-    // Último update de timers
-    unsigned long lastUpdate;
-    
     // Callbacks
     ZoneStateChangedCallback stateChangedCallback;
     RiegoEventCallback riegoEventCallback;
+    
+    // Apagar una zona cuyo timer venció
+    void expire(int idx);
+    
+    // Ms restantes de una zona activa (0 si ya venció)
+    uint32_t remainingMs(int idx, unsigned long now);
 
 public:
     // Constructor
     RelayController();
     
-    // Inicializar pines de relés
+    // Usar otro backend de salidas (registro, expansor I2C). Llamar antes de
+    // init(); debe vivir mientras viva el controlador.
+    void setOutputBackend(OutputBackend* backend);
+    
+    // Preparar las salidas y dejar todas las zonas apagadas
     void init();
     
     // Encender zona con duración específica (segundos)
-    void turnOn(int zona, int duracionSeg, String origen = "manual", int versionAgenda = 0);
+    void turnOn(int zona, int duracionSeg, RiegoOrigen origen = ORIGEN_MANUAL, int versionAgenda = 0);
     
     // Apagar zona inmediatamente
     void turnOff(int zona);
     
-    // Actualizar timers (llamar cada segundo en loop)
+    // Aplicar conmutaciones pendientes y apagar las zonas vencidas (llamar en
+    // cada vuelta del loop). Los cambios de esta vuelta salen en la próxima,
+    // ordenados junto con los que pida el secuenciador.
     void loop();
     
     // Consultar estado de zona
     bool isActive(int zona);
     
-    // Obtener tiempo restante de zona (segundos)
+    // Obtener tiempo restante de zona (segundos, redondeado hacia arriba)
     int getRemainingTime(int zona);
     
+    // Ms hasta el próximo vencimiento de timer o conmutación pendiente (-1 si
+    // no hay ninguno)
+    long getMsUntilNextExpiry();
+    
     // Apagar todas las zonas (emergencia)
     void emergencyStop();
     
-    // Validar número de zona (1-8)
+    // Copiar los riegos en curso a `out`
+    void snapshot(RelaySnapshot& out);
+    
+    // Reanudar los riegos de una foto tomada hace `elapsedSec` segundos (sin
+    // evento de inicio: ya se publicó). Las zonas cuyo tiempo venció en el
+    // medio publican su fin. Devuelve cuántas zonas quedaron encendidas.
+    uint8_t restore(const RelaySnapshot& in, uint32_t elapsedSec);
+    
+    // Intervalo mínimo entre conmutaciones y solapamiento en traspasos (ms)
+    void setSwitchTiming(uint32_t minIntervalMs, uint32_t overlapMs);
+    
+    // Validar número de zona (1-MAX_ZONES)
     bool isValidZone(int zona);
     
     // Registrar callback para cambios de estado
@@ -0,0 +1,42 @@
+#include "ShiftRegisterOutputBackend.h"
+
+ShiftRegisterOutputBackend::ShiftRegisterOutputBackend(int dataPin, int clockPin, int latchPin,
+                                                       uint8_t chips, int enablePin)
+    : OutputBackend(chips * 8), dataPin(dataPin), clockPin(clockPin), latchPin(latchPin),
+      enablePin(enablePin), enabled(false) {}
+
+bool ShiftRegisterOutputBackend::beginBus() {
+    if (enablePin >= 0) {
+        digitalWrite(enablePin, HIGH);   // Salidas deshabilitadas (activo en bajo)
+        pinMode(enablePin, OUTPUT);
+    }
+    pinMode(dataPin, OUTPUT);
+    pinMode(clockPin, OUTPUT);
+    pinMode(latchPin, OUTPUT);
+    digitalWrite(clockPin, LOW);
+    digitalWrite(latchPin, LOW);
+    return true;
+}
+
+void ShiftRegisterOutputBackend::shiftByte(uint8_t value) {
+    for (int bit = 7; bit >= 0; bit--) {
+        digitalWrite(dataPin, (value >> bit) & 0x01 ? HIGH : LOW);
+        digitalWrite(clockPin, HIGH);
+        digitalWrite(clockPin, LOW);
+    }
+}
+
+bool ShiftRegisterOutputBackend::write(uint32_t levels, uint32_t changed) {
+    (void)changed;
+    digitalWrite(latchPin, LOW);
+    for (int chip = channels / 8 - 1; chip >= 0; chip--) {
+        shiftByte((uint8_t)(levels >> (chip * 8)));
+    }
+    digitalWrite(latchPin, HIGH);
+
+    if (!enabled && enablePin >= 0) {
+        digitalWrite(enablePin, LOW);
+    }
+    enabled = true;
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef SHIFT_REGISTER_OUTPUT_BACKEND_H
+#define SHIFT_REGISTER_OUTPUT_BACKEND_H
+
+#include "OutputBackend.h"
+
+// ============================================================================
+// ShiftRegisterOutputBackend - Cadena de 74HC595 (8 salidas por chip)
+// ============================================================================
+// Tres pines para toda la cadena. El canal 0 es Q0 del chip más
+// cercano al ESP8266: se desplaza primero el byte del chip más lejano y cada
+// byte desde Q7. Todas las salidas cambian juntas en el flanco de latch, así
+// que cada escritura es la cadena completa. Con OE cableado (pull-up a 3.3 V)
+// las salidas quedan deshabilitadas hasta la primera escritura: sin esto el
+// 595 arranca con contenido aleatorio y puede abrir válvulas al encender.
+
+class ShiftRegisterOutputBackend : public OutputBackend {
+private:
+    int dataPin;
+    int clockPin;
+    int latchPin;
+    int enablePin;               // -1 = OE a masa
+    bool enabled;
+
+    void shiftByte(uint8_t value);
+
+protected:
+    bool beginBus() override;
+    bool write(uint32_t levels, uint32_t changed) override;
+
+public:
+    ShiftRegisterOutputBackend(int dataPin, int clockPin, int latchPin, uint8_t chips, int enablePin = -1);
+
+    const char* getName() const override { return "74HC595"; }
+};
+
+#endif // SHIFT_REGISTER_OUTPUT_BACKEND_H
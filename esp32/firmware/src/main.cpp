@@ -8,11 +8,22 @@
 #include "network/TimeSync.h"
 #include "network/MqttManager.h"
 #include "network/HttpClient.h"
+#include "network/StatusPublisher.h"
+#include "network/LogStreamer.h"
 #include "hardware/RelayController.h"
+#include "hardware/ShiftRegisterOutputBackend.h"
+#include "hardware/I2cExpanderOutputBackend.h"
 #include "storage/SPIFFSManager.h"
+#include "storage/EventJournal.h"
+#include "storage/LogRecorder.h"
+#include "storage/WarmRestart.h"
 #include "scheduler/AgendaManager.h"
+#include "scheduler/ZoneSequencer.h"
 #include "display/DisplayManager.h"
 #include "utils/Logger.h"
+#include "utils/SleepPlanner.h"
+#include "utils/AgendaBenchmark.h"
+#include "utils/LoopProfiler.h"
 
 // ============================================================================
 // FIRMWARE ESP8266 - SISTEMA DE RIEGO MQTT
@@ -24,9 +35,23 @@ void initSerial();
 void printBanner();
 void mainLoop();
 void onMqttCommand(int zona, String accion, int duracion);
-void onAgendaSync(String payload);
+void onAgendaSync(const char* path, size_t length);
+void onMqttRecovery(RecoveryTier tier, uint32_t offlineMs);
+bool resumeWarmRestart(WarmRestartBlock& block);
+void persistWarmState();
 void onZoneStateChanged(int zona, bool estado);
-void onRiegoEvent(int zona, String evento, String origen, int duracion, int versionAgenda);
+void onRiegoEvent(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion, int versionAgenda);
+void recordLog(int level, uint32_t id, PGM_P format, va_list args);
+bool publishJournalEvent(const RiegoEventRecord& record);
+void publishZoneStatusUpdates();
+bool publishZoneStatusSink(int zona, bool activa, uint16_t restante);
+bool publishZonesStatusSink(uint32_t activas, const uint16_t* restante);
+bool publishLogSink(const char* payload, size_t length);
+void streamLogLine(int level, const char* line, size_t length);
+void onLogLevel(uint8_t level);
+const char* statusModeName(uint8_t mode);
+uint8_t parseStatusMode(const char* name, uint8_t fallback);
+void drainEventJournal();
 void showStoredAgenda();
 void fetchAndStoreAgendas();
 void initOTA();
@@ -35,21 +60,27 @@ bool loadWiFiConfig(String& ssid, String& password,
                     String& mqttUser, String& mqttPassword,
                     String& backendHost, uint16_t& backendPort,
                     String& backendUser, String& backendPassword,
-                    String& nodeId);
+                    String& nodeId, uint8_t& statusMode);
 bool saveWiFiConfig(const String& ssid, const String& password,
                     const String& mqttHost, uint16_t mqttPort,
                     const String& mqttUser, const String& mqttPassword,
                     const String& backendHost, uint16_t backendPort,
                     const String& backendUser, const String& backendPassword,
-                    const String& nodeId);
+                    const String& nodeId, uint8_t statusMode);
 void runConfigPortal(bool factoryReset);
 void handleFactoryResetButton();
+unsigned long planLoopSleep();
+void idleDelay(unsigned long ms);
+void handleSerialCommands();
+void runSerialCommand(const char* command);
+void profile(uint8_t channel);
+void reportLoopProfile();
 
 // Estado global del sistema
 SystemState currentState = INIT;
-unsigned long lastStatusPublish = 0;
 unsigned long lastHumidityRead = 0;
 unsigned long lastDisplayUpdate = 0;
+unsigned long lastJournalDrain = 0;
 bool otaInitialized = false;
 String activeWiFiSsid = WIFI_SSID;
 String activeWiFiPassword = WIFI_PASSWORD;
@@ -62,6 +93,7 @@ uint16_t activeBackendPort = BACKEND_PORT;
 String activeBackendUser = BACKEND_USER;
 String activeBackendPassword = BACKEND_PASSWORD;
 String activeNodeId = NODE_ID;
+uint8_t activeStatusMode = STATUS_PUBLISH_MODE;
 unsigned long factoryButtonPressStart = 0;
 
 // Módulos del sistema
@@ -70,9 +102,25 @@ TimeSync timeSync;
 MqttManager mqttManager;
 HttpClient httpClient;
 RelayController relayController;
+#if OUTPUT_BACKEND == OUTPUT_BACKEND_SHIFT_REGISTER
+ShiftRegisterOutputBackend relayOutputs(SHIFT_REGISTER_DATA_PIN, SHIFT_REGISTER_CLOCK_PIN, SHIFT_REGISTER_LATCH_PIN,
+                                        (MAX_ZONES + 7) / 8, SHIFT_REGISTER_OE_PIN);
+#elif OUTPUT_BACKEND == OUTPUT_BACKEND_PCF8574
+Pcf8574OutputBackend relayOutputs(Wire, PCF8574_ADDRESS, (MAX_ZONES + 7) / 8);
+#elif OUTPUT_BACKEND == OUTPUT_BACKEND_MCP23017
+Mcp23017OutputBackend relayOutputs(Wire, MCP23017_ADDRESS, (MAX_ZONES + 15) / 16);
+#endif
+ZoneSequencer zoneSequencer(&relayController);
 SPIFFSManager spiffsManager;
+EventJournal eventJournal(&spiffsManager);
+LogRecorder logRecorder(&spiffsManager);
+StatusPublisher statusPublisher(publishZoneStatusSink, publishZonesStatusSink);
+LogStreamer logStreamer(publishLogSink);
+WarmRestart warmRestart;
 AgendaManager* agendaManager = nullptr;
 DisplayManager displayManager;
+SleepPlanner sleepPlanner(LOOP_DELAY_MS, POWER_SAVE_MAX_SLEEP_MS);
+LoopProfiler loopProfiler;
 
 // Portal de configuración (solo bajo acción física explícita)
 ESP8266WebServer configServer(80);
@@ -96,13 +144,22 @@ void setup() {
     displayManager.display();
     
     // Inicializar módulos
-    Logger::info("Inicializando módulos del sistema...");
+    LOG_INFO("Inicializando módulos del sistema...");
     
     // SPIFFSManager (primero para poder leer configuracion)
     displayManager.showStatusLine("Preparando almacen.");
     displayManager.display();
     spiffsManager.init();
     spiffsManager.printInfo();
+    
+    // Registro binario de logs (desde acá cada línea queda también en flash)
+    if (LOG_RECORD_ENABLED && spiffsManager.isInitialized()) {
+        logRecorder.begin();
+        Logger::setRecordSink(recordLog);
+    }
+    
+    // Diario de eventos de riego (pendientes de publicar de la sesión anterior)
+    eventJournal.init();
 
     // Cargar credenciales WiFi persistidas (si no existen, usar Secrets.h)
     if (loadWiFiConfig(activeWiFiSsid, activeWiFiPassword,
@@ -110,11 +167,12 @@ void setup() {
                        activeMqttUser, activeMqttPassword,
                        activeBackendHost, activeBackendPort,
                        activeBackendUser, activeBackendPassword,
-                       activeNodeId)) {
-        Logger::logf(LOG_LEVEL_INFO, "Config runtime cargada desde %s", CONFIG_FILE);
+                       activeNodeId, activeStatusMode)) {
+        LOG_INFO("Config runtime cargada desde %s", CONFIG_FILE);
     } else {
-        Logger::info("Config runtime no encontrada, usando valores compilados");
+        LOG_INFO("Config runtime no encontrada, usando valores compilados");
     }
+    statusPublisher.setMode(activeStatusMode);
     
     // Mostrar agenda almacenada si existe
     showStoredAgenda();
@@ -124,6 +182,10 @@ void setup() {
     displayManager.display();
     wifiManager.setCredentials(activeWiFiSsid, activeWiFiPassword);
     wifiManager.init();
+    if (POWER_SAVE_ENABLED) {
+        WiFi.setSleepMode(WIFI_LIGHT_SLEEP);
+        LOG_INFO("Modo ahorro de energia habilitado (light-sleep entre eventos)");
+    }
     
     // TimeSync (se sincronizará cuando WiFi esté conectado)
     timeSync.init();
@@ -139,24 +201,40 @@ void setup() {
     mqttManager.init();
     mqttManager.setCommandCallback(onMqttCommand);
     mqttManager.setAgendaSyncCallback(onAgendaSync);
+    mqttManager.setRecoveryCallback(onMqttRecovery);
     
-    // RelayController
-    displayManager.showStatusLine("Iniciando reles...");
-    displayManager.display();
-    relayController.init();
+    // Log remoto: apagado hasta que se pida un nivel en riego/{id}/log/nivel
+    if (LOG_STREAM_ENABLED) {
+        mqttManager.setLogLevelCallback(onLogLevel);
+        Logger::setLineSink(streamLogLine);
+    }
+    
+    // RelayController (salidas ya inicializadas en initHardware)
     relayController.setStateChangedCallback(onZoneStateChanged);
     relayController.setRiegoEventCallback(onRiegoEvent);
+    zoneSequencer.setRiegoEventCallback(onRiegoEvent);
+    
+    // Reinicio en caliente: reanudar los riegos antes de las agendas (así la
+    // recuperación de agendas perdidas ve las zonas activas)
+    WarmRestartBlock warmBlock;
+    bool warmBoot = resumeWarmRestart(warmBlock);
     
-    // AgendaManager (requiere SPIFFSManager, TimeSync, RelayController, MqttManager)
+    // AgendaManager (requiere SPIFFSManager, TimeSync, ZoneSequencer, MqttManager)
     displayManager.showStatusLine("Preparando agendas");
     displayManager.display();
-    agendaManager = new AgendaManager(&spiffsManager, &timeSync, &relayController, &mqttManager);
+    agendaManager = new AgendaManager(&spiffsManager, &timeSync, &zoneSequencer, &mqttManager);
     agendaManager->init();
+    if (warmBoot) {
+        agendaManager->restoreWatermark(warmBlock.agendaWatermark);
+    }
     
     // TODO: Inicializar otros modulos
     // - HumiditySensor (hardware no disponible)
     
-    Logger::info("Sistema inicializado - iniciando conexión WiFi");
+    LOG_INFO("Sistema inicializado - iniciando conexión WiFi");
+    
+    // Desde acá los logs esperan al tiempo ocioso del loop
+    Logger::setDeferred(true);
     
     // Cambiar estado
     currentState = WIFI_CONNECTING;
@@ -166,33 +244,57 @@ void setup() {
 // LOOP - Loop principal
 // ============================================================================
 void loop() {
+    if (LOOP_PROFILER_ENABLED) {
+        loopProfiler.startLoop(micros());
+    }
+    
     handleFactoryResetButton();
 
     if (OTA_ENABLED && wifiManager.isConnected() && !otaInitialized) {
         initOTA();
     }
+    profile(PROF_OTHER);
 
-    // Actualizar módulos
+    // Actualizar módulos (cada profile() mide desde la marca anterior)
     wifiManager.loop();
+    profile(PROF_WIFI);
     mqttManager.loop();
+    profile(PROF_MQTT);
     if (OTA_ENABLED && otaInitialized) {
         ArduinoOTA.handle();
+        profile(PROF_OTA);
     }
     relayController.loop();  // CRITICO: actualizar timers de zonas
+    profile(PROF_RELAY);
+    zoneSequencer.loop();    // Arrancar pedidos en cola si se liberó lugar
+    profile(PROF_SEQUENCER);
     
     // TimeSync solo actualiza si WiFi está conectado
     if (wifiManager.isConnected()) {
         timeSync.loop();
+        profile(PROF_TIME);
     }
     
     // AgendaManager - verificar y ejecutar agendas programadas
     if (agendaManager != nullptr) {
         agendaManager->loop();
+        profile(PROF_AGENDA);
+    }
+    
+    // Riegos en curso a memoria RTC (solo si cambiaron en esta vuelta)
+    persistWarmState();
+    profile(PROF_OTHER);
+    
+    // Lote parcial del registro de logs a flash
+    if (LOG_RECORD_ENABLED) {
+        logRecorder.loop();
+        profile(PROF_LOG);
     }
     
-    // Actualizar iconos de estado en display cada 2 segundos
+    // Actualizar iconos de estado en display (cada 2 segundos, o 30 en modo ahorro)
     unsigned long now = millis();
-    if (now - lastDisplayUpdate >= 2000) {
+    unsigned long displayInterval = POWER_SAVE_ENABLED ? DISPLAY_UPDATE_INTERVAL_POWER_SAVE : DISPLAY_UPDATE_INTERVAL;
+    if (now - lastDisplayUpdate >= displayInterval) {
         lastDisplayUpdate = now;
         int rssi = wifiManager.isConnected() ? wifiManager.getRSSI() : -100;
         displayManager.updateStatusIcons(rssi, wifiManager.isConnected(), mqttManager.isConnected());
@@ -217,13 +319,169 @@ void loop() {
         displayManager.updateZoneIndicators(zone1Active, zone2Active, zone3Active, zone4Active);
         
         displayManager.display();
+        profile(PROF_DISPLAY);
+    }
+    
+    // Comandos de diagnóstico por consola serial
+    if (SERIAL_COMMANDS_ENABLED) {
+        handleSerialCommands();
+        profile(PROF_OTHER);
     }
     
     // Máquina de estados principal
     mainLoop();
+    profile(PROF_MAIN);
     
-    // Delay para evitar watchdog timeout
-    delay(LOOP_DELAY_MS);
+    // Log remoto al final: el estado de zonas ya tuvo el socket en esta vuelta
+    if (LOG_STREAM_ENABLED) {
+        logStreamer.loop(millis());
+        profile(PROF_LOG);
+    }
+    
+    if (LOOP_PROFILER_ENABLED) {
+        reportLoopProfile();
+    }
+    
+    // Delay para evitar watchdog timeout (en modo ahorro, dormir hasta el próximo evento)
+    unsigned long sleepMs = planLoopSleep();
+    if (LOOP_PROFILER_ENABLED && loopProfiler.endLoop(micros(), sleepMs)) {
+        LOG_WARN("Vuelta lenta del loop (%s: %lu ms)", LoopProfiler::channelName(loopProfiler.getSlowestChannel()),
+                 (unsigned long)(loopProfiler.getSlowestUs() / 1000));
+    }
+    idleDelay(sleepMs);
+}
+
+// ============================================================================
+// Perfil del loop (LoopProfiler)
+// ============================================================================
+// Atribuye a `channel` el tiempo desde la marca anterior de esta vuelta
+void profile(uint8_t channel) {
+    if (LOOP_PROFILER_ENABLED) {
+        loopProfiler.mark(channel, micros());
+    }
+}
+
+// Cada LOOP_PROFILER_REPORT_MS publica la ventana y empieza otra; sin MQTT
+// la ventana sigue acumulando hasta que se pueda publicar
+void reportLoopProfile() {
+    unsigned long now = millis();
+    unsigned long window = loopProfiler.getWindowMs(now);
+    if (window < LOOP_PROFILER_REPORT_MS || !mqttManager.isConnected()) return;
+    if (mqttManager.publishLoopProfile(loopProfiler, window)) {
+        loopProfiler.reset(now);
+    }
+    profile(PROF_OTHER);
+}
+
+// ============================================================================
+// Tiempo ocioso: dormir vaciando el log al UART
+// ============================================================================
+// Logger::drain() solo escribe lo que entra en la FIFO de transmisión; con
+// líneas pendientes se duerme de a LOG_DRAIN_INTERVAL_MS para seguir
+// vaciando (a 115200 baudios la FIFO de 128 bytes se vacía en ~11 ms).
+void idleDelay(unsigned long ms) {
+    unsigned long start = millis();
+    while (true) {
+        Logger::drain();
+        unsigned long elapsed = millis() - start;
+        if (elapsed >= ms) return;
+        unsigned long step = ms - elapsed;
+        if (Logger::pending() > 0 && step > LOG_DRAIN_INTERVAL_MS) {
+            step = LOG_DRAIN_INTERVAL_MS;
+        }
+        delay(step);
+    }
+}
+
+// ============================================================================
+// Planificar sueño del loop (modo ahorro de energía)
+// ============================================================================
+unsigned long planLoopSleep() {
+    // Fuera de ONLINE/OFFLINE hay conexiones en curso que requieren polling
+    if (!POWER_SAVE_ENABLED || (currentState != ONLINE && currentState != OFFLINE)) {
+        return LOOP_DELAY_MS;
+    }
+    
+    // Botón presionado: medir la duración con la resolución normal
+    if (factoryButtonPressStart != 0) {
+        return LOOP_DELAY_MS;
+    }
+    
+    unsigned long now = millis();
+    long relayMs = relayController.getMsUntilNextExpiry();
+    
+    sleepPlanner.begin();
+    if (agendaManager != nullptr) {
+        sleepPlanner.addDeadline(WAKE_AGENDA, agendaManager->getMsUntilNextRun());
+    }
+    sleepPlanner.addDeadline(WAKE_RELAY, relayMs);
+    if (mqttManager.isConnected()) {
+        sleepPlanner.addDeadline(WAKE_MQTT, MQTT_KEEP_ALIVE * 1000L / 2);
+    } else {
+        // Próximo paso de la conexión (fin del backoff o sondeo del CONNACK)
+        sleepPlanner.addDeadline(WAKE_MQTT, mqttManager.getMsUntilConnectStep());
+    }
+    sleepPlanner.addPeriodic(WAKE_DISPLAY, now, lastDisplayUpdate, DISPLAY_UPDATE_INTERVAL_POWER_SAVE);
+    if (mqttManager.isConnected()) {
+        // Los cambios de estado llegan por relé/comando: acá solo el keepalive
+        sleepPlanner.addDeadline(WAKE_STATUS, statusPublisher.getMsUntilKeepalive(now));
+    }
+    if (eventJournal.getPending() > 0 && mqttManager.isConnected()) {
+        sleepPlanner.addPeriodic(WAKE_JOURNAL, now, lastJournalDrain, EVENT_JOURNAL_DRAIN_INTERVAL_MS);
+    }
+    if (LOG_STREAM_ENABLED && mqttManager.isConnected()) {
+        sleepPlanner.addDeadline(WAKE_LOG, logStreamer.getMsUntilNextPublish(now));
+    }
+    
+    return sleepPlanner.sleepMs();
+}
+
+// ============================================================================
+// Comandos por consola serial (SERIAL_COMMANDS_ENABLED)
+// ============================================================================
+void handleSerialCommands() {
+    static char line[SERIAL_COMMAND_MAX_LEN];
+    static uint8_t length = 0;
+    
+    while (Serial.available() > 0) {
+        char c = (char)Serial.read();
+        if (c == '\r' || c == '\n') {
+            if (length > 0) {
+                line[length] = '\0';
+                runSerialCommand(line);
+                length = 0;
+            }
+        } else if (length < sizeof(line) - 1) {
+            line[length++] = c;
+        }
+    }
+}
+
+void runSerialCommand(const char* command) {
+    if (strcmp(command, "bench") == 0) {
+        // Bloquea el loop unos segundos; los timers de zona usan millis() y
+        // se procesan al volver, pero puede caer el keepalive MQTT
+        LOG_WARN("Benchmark de agendas en curso (loop bloqueado)");
+        AgendaBenchmark::runSuite(Serial);
+        LOG_INFO("Benchmark de agendas finalizado");
+    } else if (strcmp(command, "info") == 0) {
+        // Volcados directos al UART: primero lo que espera en el logger
+        Logger::flush();
+        wifiManager.printInfo();
+        mqttManager.printInfo();
+        timeSync.printTime();
+        spiffsManager.printInfo();
+        spiffsManager.listFiles();
+    } else if (strcmp(command, "agenda") == 0) {
+        showStoredAgenda();
+    } else if (strcmp(command, "perfil") == 0) {
+        loopProfiler.printReport(Serial, millis());
+    } else if (strcmp(command, "perfil reset") == 0) {
+        loopProfiler.reset(millis());
+        LOG_INFO("Perfil del loop reiniciado");
+    } else {
+        LOG_WARN("Comando serial desconocido: %s (disponibles: bench, info, agenda, perfil, perfil reset)", command);
+    }
 }
 
 // ============================================================================
@@ -241,7 +499,7 @@ void initSerial() {
 }
 
 void initHardware() {
-    Serial.println("[INFO] Inicializando hardware...");
+    LOG_INFO("Inicializando hardware...");
 
     pinMode(FACTORY_RESET_BUTTON_PIN, INPUT_PULLUP);
     
@@ -249,19 +507,19 @@ void initHardware() {
     // pinMode(LED_PIN, OUTPUT);
     // digitalWrite(LED_PIN, LOW);
     
-    // Pines de relés (todos OFF al inicio)
-    for (int i = 0; i < MAX_ZONES; i++) {
-        pinMode(RELAY_PINS[i], OUTPUT);
-        digitalWrite(RELAY_PINS[i], RELAY_OFF);
-    }
-    Serial.printf("[INFO] %d relés inicializados (todos OFF)\n", MAX_ZONES);
+    // Salidas de relés (todas OFF al inicio, ver OUTPUT_BACKEND)
+#if OUTPUT_BACKEND != OUTPUT_BACKEND_GPIO
+    relayController.setOutputBackend(&relayOutputs);
+#endif
+    relayController.init();
+    LOG_INFO("%d relés inicializados (todos OFF)", MAX_ZONES);
     
     // Pines de sensores (INPUT)
     for (int i = 0; i < MAX_SENSORS; i++) {
         pinMode(SENSOR_PINS[i], INPUT);
     }
-    Serial.printf("[INFO] %d sensores ADC configurados\n", MAX_SENSORS);
-    Serial.printf("[INFO] Boton config/factory en GPIO%d (INPUT_PULLUP)\n", FACTORY_RESET_BUTTON_PIN);
+    LOG_INFO("%d sensores ADC configurados", MAX_SENSORS);
+    LOG_INFO("Boton config/factory en GPIO%d (INPUT_PULLUP)", FACTORY_RESET_BUTTON_PIN);
     
     // Parpadeo de LED deshabilitado - LED_PIN no disponible
     // for (int i = 0; i < 3; i++) {
@@ -295,13 +553,15 @@ void initOTA() {
     ArduinoOTA.setHostname(otaHost.c_str());
 
     ArduinoOTA.onStart([]() {
-        Logger::info("OTA iniciado");
+        LOG_INFO("OTA iniciado");
         displayManager.showStatusLine("OTA: iniciando...");
         displayManager.display();
     });
 
     ArduinoOTA.onEnd([]() {
-        Logger::info("OTA completado");
+        LOG_INFO("OTA completado");
+        logRecorder.flush();
+        Logger::flush();   // ArduinoOTA reinicia al volver
         displayManager.showStatusLine("OTA: completo");
         displayManager.display();
     });
@@ -311,12 +571,12 @@ void initOTA() {
         static unsigned int lastPercentage = 0;
         if (percentage >= lastPercentage + 10 || percentage == 100) {
             lastPercentage = percentage;
-            Logger::info("OTA progreso: " + String(percentage) + "%");
+            LOG_INFO("OTA progreso: %u%%", percentage);
         }
     });
 
     ArduinoOTA.onError([](ota_error_t error) {
-        Logger::error("OTA error: " + String((int)error));
+        LOG_ERROR("OTA error: %d", (int)error);
         displayManager.showStatusLine("OTA: error");
         displayManager.display();
     });
@@ -324,7 +584,23 @@ void initOTA() {
     ArduinoOTA.begin();
     otaInitialized = true;
 
-    Logger::info("OTA listo. Host: " + otaHost + " Puerto: " + String(OTA_PORT));
+    LOG_INFO("OTA listo. Host: %s Puerto: %d", otaHost.c_str(), OTA_PORT);
+}
+
+// Modo de publicación de estado en CONFIG_FILE ("zona", "agregado", "ambos")
+const char* statusModeName(uint8_t mode) {
+    switch (mode) {
+        case STATUS_MODE_ZONA: return "zona";
+        case STATUS_MODE_AMBOS: return "ambos";
+        default: return "agregado";
+    }
+}
+
+uint8_t parseStatusMode(const char* name, uint8_t fallback) {
+    if (strcmp(name, "zona") == 0) return STATUS_MODE_ZONA;
+    if (strcmp(name, "agregado") == 0) return STATUS_MODE_AGREGADO;
+    if (strcmp(name, "ambos") == 0) return STATUS_MODE_AMBOS;
+    return fallback;
 }
 
 bool loadWiFiConfig(String& ssid, String& password,
@@ -332,7 +608,7 @@ bool loadWiFiConfig(String& ssid, String& password,
                     String& mqttUser, String& mqttPassword,
                     String& backendHost, uint16_t& backendPort,
                     String& backendUser, String& backendPassword,
-                    String& nodeId) {
+                    String& nodeId, uint8_t& statusMode) {
     if (!spiffsManager.isInitialized() || !spiffsManager.exists(CONFIG_FILE)) {
         return false;
     }
@@ -345,7 +621,7 @@ bool loadWiFiConfig(String& ssid, String& password,
     StaticJsonDocument<JSON_BUFFER_SMALL> doc;
     DeserializationError err = deserializeJson(doc, raw);
     if (err) {
-        Logger::logf(LOG_LEVEL_ERROR, "Config WiFi invalida en %s", CONFIG_FILE);
+        LOG_ERROR("Config WiFi invalida en %s", CONFIG_FILE);
         return false;
     }
 
@@ -373,6 +649,8 @@ bool loadWiFiConfig(String& ssid, String& password,
         nodeId = NODE_ID;
     }
 
+    statusMode = parseStatusMode(doc["statusMode"] | "", STATUS_PUBLISH_MODE);
+
     return true;
 }
 
@@ -381,7 +659,7 @@ bool saveWiFiConfig(const String& ssid, const String& password,
                     const String& mqttUser, const String& mqttPassword,
                     const String& backendHost, uint16_t backendPort,
                     const String& backendUser, const String& backendPassword,
-                    const String& nodeId) {
+                    const String& nodeId, uint8_t statusMode) {
     if (!spiffsManager.isInitialized() || ssid.length() == 0) {
         return false;
     }
@@ -398,6 +676,7 @@ bool saveWiFiConfig(const String& ssid, const String& password,
     doc["backendUser"] = backendUser;
     doc["backendPassword"] = backendPassword;
     doc["nodeId"] = nodeId;
+    doc["statusMode"] = statusModeName(statusMode);
 
     String out;
     serializeJson(doc, out);
@@ -405,11 +684,11 @@ bool saveWiFiConfig(const String& ssid, const String& password,
 }
 
 void runConfigPortal(bool factoryReset) {
-    Logger::warn("Entrando a portal de configuracion WiFi por boton fisico");
+    LOG_WARN("Entrando a portal de configuracion WiFi por boton fisico");
 
     if (factoryReset) {
         spiffsManager.deleteFile(CONFIG_FILE);
-        Logger::warn("Factory reset: configuracion persistida eliminada");
+        LOG_WARN("Factory reset: configuracion persistida eliminada");
     }
 
     mqttManager.disconnect();
@@ -423,11 +702,11 @@ void runConfigPortal(bool factoryReset) {
     String apSsid = String("RIEGO-CONFIG-") + String(ESP.getChipId(), HEX);
     bool apOk = WiFi.softAP(apSsid.c_str(), CONFIG_PORTAL_AP_PASSWORD);
     if (!apOk) {
-        Logger::error("No se pudo iniciar AP de configuracion");
+        LOG_ERROR("No se pudo iniciar AP de configuracion");
         return;
     }
 
-    Logger::logf(LOG_LEVEL_INFO, "AP config: SSID=%s IP=%s", apSsid.c_str(), WiFi.softAPIP().toString().c_str());
+    LOG_INFO("AP config: SSID=%s IP=%s", apSsid.c_str(), WiFi.softAPIP().toString().c_str());
 
     bool shouldReboot = false;
     bool testInProgress = false;
@@ -659,6 +938,20 @@ void runConfigPortal(bool factoryReset) {
         shouldReboot = true;
     });
 
+    // Registro binario de logs para tools/log_decode.py
+    auto serveLogRecord = [&](const char* path) {
+        logRecorder.flush();
+        File file = spiffsManager.exists(path) ? spiffsManager.openFile(path, "r") : File();
+        if (!file) {
+            configServer.send(404, "text/plain", "Sin registro");
+            return;
+        }
+        configServer.streamFile(file, "application/octet-stream");
+        file.close();
+    };
+    configServer.on(LOG_RECORD_FILE, HTTP_GET, [&]() { serveLogRecord(LOG_RECORD_FILE); });
+    configServer.on(LOG_RECORD_FILE_OLD, HTTP_GET, [&]() { serveLogRecord(LOG_RECORD_FILE_OLD); });
+
     configServer.begin();
 
     while (!shouldReboot) {
@@ -671,7 +964,7 @@ void runConfigPortal(bool factoryReset) {
                                     testMqttUser, testMqttPassword,
                                     testBackendHost, testBackendPort,
                                     testBackendUser, testBackendPassword,
-                                    testNodeId)) {
+                                    testNodeId, activeStatusMode)) {
                     testMessage = "Conecto OK, pero fallo al guardar en flash.";
                     testSuccess = false;
                 } else {
@@ -707,10 +1000,12 @@ void runConfigPortal(bool factoryReset) {
             }
         }
 
-        delay(10);
+        idleDelay(10);
     }
 
     configServer.stop();
+    logRecorder.flush();
+    Logger::flush();
     delay(200);
     ESP.restart();
 }
@@ -733,10 +1028,10 @@ void handleFactoryResetButton() {
     factoryButtonPressStart = 0;
 
     if (pressedMs >= FACTORY_RESET_HOLD_MS) {
-        Logger::warn("Boton: FACTORY RESET (hold largo)");
+        LOG_WARN("Boton: FACTORY RESET (hold largo)");
         runConfigPortal(true);
     } else if (pressedMs >= CONFIG_PORTAL_HOLD_MS) {
-        Logger::warn("Boton: abrir portal de configuracion");
+        LOG_WARN("Boton: abrir portal de configuracion");
         runConfigPortal(false);
     }
 }
@@ -752,9 +1047,9 @@ void mainLoop() {
     // Log de cambio de estado
     static SystemState lastState = INIT;
     if (currentState != lastState) {
-        Serial.printf("[INFO] Estado cambiado: %s → %s\n", 
-                      STATE_NAMES[lastState], 
-                      STATE_NAMES[currentState]);
+        LOG_INFO("Estado cambiado: %s → %s", 
+                 STATE_NAMES[lastState], 
+                 STATE_NAMES[currentState]);
         lastState = currentState;
         lastStateChange = millis();
         statusMessageShown = false;
@@ -775,12 +1070,11 @@ void mainLoop() {
             
             // Intentar conectar WiFi
             if (wifiManager.isConnected()) {
-                Logger::info("WiFi conectado exitosamente");
-                wifiManager.printInfo();
+                LOG_INFO("WiFi conectado exitosamente");
                 currentState = WIFI_CONNECTED;
             } else if (millis() - lastStateChange > WIFI_TIMEOUT * 2) {
                 // Timeout extendido: Si después de varios intentos no se conecta
-                Logger::warn("WiFi no disponible - entrando en modo OFFLINE");
+                LOG_WARN("WiFi no disponible - entrando en modo OFFLINE");
                 displayManager.showStatusLine("WiFi no disponible");
                 displayManager.display();
                 currentState = OFFLINE;
@@ -788,7 +1082,7 @@ void mainLoop() {
                 // Primer intento de conexión después de 5 segundos
                 static bool firstAttempt = true;
                 if (firstAttempt) {
-                    Logger::info("Iniciando conexión WiFi...");
+                    LOG_INFO("Iniciando conexión WiFi...");
                     wifiManager.connect();
                     firstAttempt = false;
                 }
@@ -804,13 +1098,13 @@ void mainLoop() {
             
             // Sincronizar tiempo con NTP
             if (!timeSync.isSynchronized()) {
-                Logger::info("Sincronizando tiempo con NTP...");
+                LOG_INFO("Sincronizando tiempo con NTP...");
                 if (timeSync.sync()) {
-                    Logger::info("Tiempo sincronizado correctamente");
+                    LOG_INFO("Tiempo sincronizado correctamente");
                     currentState = MQTT_CONNECTING;
                 } else {
                     // Si falla NTP, continuar igual (no es crítico)
-                    Logger::warn("Fallo sincronización NTP, continuando sin tiempo exacto");
+                    LOG_WARN("Fallo sincronización NTP, continuando sin tiempo exacto");
                     currentState = MQTT_CONNECTING;
                 }
             } else {
@@ -827,32 +1121,23 @@ void mainLoop() {
             
             // Intentar conectar MQTT
             if (mqttManager.isConnected()) {
-                Logger::info("MQTT conectado, sistema ONLINE");
-                mqttManager.printInfo();
-                currentState = ONLINE;
-            } else if (millis() - lastStateChange > MQTT_RECONNECT_DELAY * 2) {
-                // Si MQTT falla despues de varios intentos, volver a verificar WiFi
-                Logger::warn("MQTT no disponible, verificando WiFi...");
-                if (wifiManager.isConnected()) {
-                    // WiFi OK pero MQTT falla, reintentar
-                    static unsigned long lastMqttRetry = 0;
-                    if (millis() - lastMqttRetry > 30000) {
-                        Logger::info("Reintentando conexion MQTT...");
-                        mqttManager.connect();
-                        lastMqttRetry = millis();
-                    }
-                } else {
-                    // WiFi caido, volver a conectar
-                    currentState = WIFI_CONNECTING;
-                }
-            } else if (millis() - lastStateChange > 5000) {
-                // Primer intento despues de 5 segundos
-                static bool firstMqttAttempt = true;
-                if (firstMqttAttempt) {
-                    Logger::info("Iniciando conexion MQTT...");
-                    mqttManager.connect();
-                    firstMqttAttempt = false;
+                LOG_INFO("MQTT conectado, sistema ONLINE");
+                
+                // Reportar versión de agenda: el backend responde con los
+                // cambios perdidos mientras no hubo conexión (delta)
+                if (agendaManager != nullptr) {
+                    mqttManager.publishAgendaVersion(agendaManager->getTable().version);
                 }
+                statusPublisher.invalidate();
+                currentState = ONLINE;
+            } else if (!wifiManager.isConnected()) {
+                // WiFi caido, volver a conectar
+                LOG_WARN("MQTT no disponible, WiFi desconectado");
+                currentState = WIFI_CONNECTING;
+            } else {
+                // La conexión avanza en mqttManager.loop() con backoff propio:
+                // acá solo se pide (no bloquea ni acorta el backoff en curso)
+                mqttManager.connect();
             }
             break;
             
@@ -866,10 +1151,10 @@ void mainLoop() {
             
             // Modo online completo - verificar que todo sigue conectado
             if (!wifiManager.isConnected()) {
-                Logger::warn("WiFi desconectado, volviendo a WIFI_CONNECTING");
+                LOG_WARN("WiFi desconectado, volviendo a WIFI_CONNECTING");
                 currentState = WIFI_CONNECTING;
             } else if (!mqttManager.isConnected()) {
-                Logger::warn("MQTT desconectado, volviendo a MQTT_CONNECTING");
+                LOG_WARN("MQTT desconectado, volviendo a MQTT_CONNECTING");
                 currentState = MQTT_CONNECTING;
             }
             
@@ -879,7 +1164,7 @@ void mainLoop() {
                 static unsigned long lastFetchAttempt = 0;
                 
                 if (!agendasFetched) {
-                    Logger::info("Solicitando agendas al backend...");
+                    LOG_INFO("Solicitando agendas al backend...");
                     fetchAndStoreAgendas();
                     agendasFetched = true;
                     lastFetchAttempt = millis();
@@ -890,26 +1175,18 @@ void mainLoop() {
                 } else {
                     // Reintentar cada 5 minutos si la primera vez falló
                     if (millis() - lastFetchAttempt > 300000) { // 5 minutos
-                        Logger::info("Reintentando sincronización de agendas...");
+                        LOG_INFO("Reintentando sincronización de agendas...");
                         fetchAndStoreAgendas();
                         lastFetchAttempt = millis();
                     }
                 }
             }
             
-            // Publicar estado de zonas activas cada 5 segundos
-            {
-                static unsigned long lastStatusPublish = 0;
-                if (millis() - lastStatusPublish > 5000) {
-                    for (int zona = 1; zona <= MAX_ZONES; zona++) {
-                        if (relayController.isActive(zona)) {
-                            int remaining = relayController.getRemainingTime(zona);
-                            mqttManager.publishZoneStatus(zona, true, remaining);
-                        }
-                    }
-                    lastStatusPublish = millis();
-                }
-            }
+            // Publicar eventos de riego pendientes (en lotes)
+            drainEventJournal();
+            
+            // Publicar estado de zonas (solo cambios, deriva y keepalive)
+            publishZoneStatusUpdates();
             
             break;
             
@@ -923,7 +1200,7 @@ void mainLoop() {
             // Modo offline - el WiFiManager intentará reconectar automáticamente
             // Si se reconecta, cambiar de estado
             if (wifiManager.isConnected()) {
-                Logger::info("WiFi reconectado desde modo OFFLINE");
+                LOG_INFO("WiFi reconectado desde modo OFFLINE");
                 currentState = WIFI_CONNECTED;
             }
             
@@ -931,7 +1208,7 @@ void mainLoop() {
             
             static unsigned long lastOfflineLog = 0;
             if (millis() - lastOfflineLog > 30000) {
-                Logger::info("Modo OFFLINE - sistema funcionando de forma autonoma");
+                LOG_INFO("Modo OFFLINE - sistema funcionando de forma autonoma");
                 lastOfflineLog = millis();
             }
             break;
@@ -953,18 +1230,48 @@ void mainLoop() {
     // Debug: Mostrar tiempo cada 30 segundos si está sincronizado
     static unsigned long lastTimeDebug = 0;
     if (timeSync.isSynchronized() && millis() - lastTimeDebug > 30000) {
-        Logger::logf(LOG_LEVEL_INFO, "Tiempo actual: %s", timeSync.getDateTimeString().c_str());
+        LOG_INFO("Tiempo actual: %s", timeSync.getDateTimeString().c_str());
         lastTimeDebug = millis();
     }
 }
 
 // ============================================================================
-// FUNCIONES AUXILIARES (STUBS)
+// FUNCIONES AUXILIARES
 // ============================================================================
 
-// TODO: Implementar en módulos correspondientes
-void publishZoneStatus() {
-    // Publicar estado de todas las zonas via MQTT
+void publishZoneStatusUpdates() {
+    uint32_t activas = 0;
+    uint16_t restante[MAX_ZONES];
+    for (int zona = 1; zona <= MAX_ZONES; zona++) {
+        restante[zona - 1] = 0;
+        if (relayController.isActive(zona)) {
+            activas |= 1UL << (zona - 1);
+            restante[zona - 1] = (uint16_t)relayController.getRemainingTime(zona);
+        }
+    }
+    statusPublisher.update(millis(), activas, restante);
+}
+
+bool publishZoneStatusSink(int zona, bool activa, uint16_t restante) {
+    return mqttManager.publishZoneStatus(zona, activa, restante);
+}
+
+bool publishZonesStatusSink(uint32_t activas, const uint16_t* restante) {
+    return mqttManager.publishZonesStatus(activas, restante);
+}
+
+// Log remoto por MQTT (LogStreamer)
+void streamLogLine(int level, const char* line, size_t length) {
+    logStreamer.enqueue(level, line, length);
+}
+
+bool publishLogSink(const char* payload, size_t length) {
+    return mqttManager.publishLog(payload, length);
+}
+
+void onLogLevel(uint8_t level) {
+    logStreamer.setLevel(level);
+    LOG_INFO("Log remoto: nivel %u", logStreamer.getLevel());
 }
 
 
@@ -973,97 +1280,223 @@ void publishZoneStatus() {
 // ============================================================================
 
 void onMqttCommand(int zona, String accion, int duracion) {
-    Logger::logf(LOG_LEVEL_INFO, ">>> Comando recibido - Zona: %d, Accion: %s, Duracion: %d seg", 
-               zona, accion.c_str(), duracion);
+    LOG_INFO(">>> Comando recibido - Zona: %d, Accion: %s, Duracion: %d seg", 
+             zona, accion.c_str(), duracion);
     
-    // Ejecutar comando en relayController
+    // Pasar por el secuenciador: con la capacidad hidráulica ocupada el
+    // pedido queda en cola (delante de los de agenda)
     if (accion == "ON") {
-        relayController.turnOn(zona, duracion);
+        if (zoneSequencer.request(zona, duracion) == SEQ_QUEUED) {
+            LOG_INFO("Zona %d en cola: %u zonas activas", zona, zoneSequencer.getActiveCount());
+        }
     } else if (accion == "OFF") {
-        relayController.turnOff(zona);
+        zoneSequencer.cancel(zona);
     }
     
-    // Publicar estado actualizado inmediatamente con tiempo restante
+    // Publicar estado actualizado inmediatamente (solo si cambió el estado
+    // o el tiempo restante respecto de lo ya publicado)
     bool estado = relayController.isActive(zona);
     int remaining = relayController.getRemainingTime(zona);
-    mqttManager.publishZoneStatus(zona, estado, remaining);
+    publishZoneStatusUpdates();
     
     // Log de confirmacion
     if (estado) {
-        Logger::logf(LOG_LEVEL_INFO, "Zona %d encendida, tiempo restante: %d seg", zona, remaining);
+        LOG_INFO("Zona %d encendida, tiempo restante: %d seg", zona, remaining);
+    }
+}
+
+// Niveles de recuperación de MQTT que no resuelve MqttManager solo
+void onMqttRecovery(RecoveryTier tier, uint32_t offlineMs) {
+    if (tier == RECOVERY_WIFI) {
+        wifiManager.reassociate();
+    } else if (tier == RECOVERY_RESTART) {
+        // Guardar los riegos en curso: al arrancar se reanudan (resumeWarmRestart)
+        RelaySnapshot relays;
+        SequencerSnapshot queue;
+        relayController.snapshot(relays);
+        zoneSequencer.snapshot(queue);
+        uint32_t watermark = agendaManager != nullptr ? agendaManager->getWatermark() : 0;
+        if (warmRestart.save(relays, queue, watermark, (uint8_t)tier, offlineMs)) {
+            LOG_WARN("Riegos en curso guardados en memoria RTC, reiniciando...");
+        } else {
+            LOG_ERROR("No se pudo guardar el estado en memoria RTC, reiniciando igual");
+        }
+        logRecorder.flush();
     }
 }
 
-void onAgendaSync(String payload) {
-    Logger::logf(LOG_LEVEL_INFO, ">>> Sincronizacion de agenda recibida (%d bytes)", payload.length());
+bool resumeWarmRestart(WarmRestartBlock& block) {
+    if (!WarmRestart::take(block)) {
+        LOG_INFO("Arranque en frio: sin estado en memoria RTC");
+        return false;
+    }
+    
+    // millis() cuenta desde el reinicio: es lo que los relés estuvieron
+    // apagados (más hasta 1 s desde la última escritura del bloque)
+    uint32_t elapsedSec = (millis() + 500) / 1000;
+    uint8_t zonas = relayController.restore(block.relays, elapsedSec);
+    uint8_t enCola = zoneSequencer.restore(block.queue);
     
-    // Guardar agenda en SPIFFS
-    if (spiffsManager.isInitialized()) {
-        const char* agendaFile = "/agenda.json";
+    if (block.reason == RECOVERY_RESTART) {
+        LOG_WARN("Reinicio de recuperacion MQTT: %d zonas reanudadas, %d en cola, %lu ms sin MQTT",
+                 zonas, enCola, (unsigned long)block.offlineMs);
+        mqttManager.resumeAfterRestart(block.offlineMs);
+    } else {
+        LOG_WARN("Reinicio en caliente (%s): %d zonas reanudadas, %d en cola",
+                 ESP.getResetReason().c_str(), zonas, enCola);
+    }
+    return true;
+}
+
+// Sumidero de Logger: cada línea también al registro binario en flash
+void recordLog(int level, uint32_t id, PGM_P format, va_list args) {
+    logRecorder.record(level, id, format, args);
+}
+
+void persistWarmState() {
+    RelaySnapshot relays;
+    SequencerSnapshot queue;
+    relayController.snapshot(relays);
+    zoneSequencer.snapshot(queue);
+    warmRestart.update(relays, queue, agendaManager != nullptr ? agendaManager->getWatermark() : 0);
+}
+
+void onAgendaSync(const char* path, size_t length) {
+    LOG_INFO(">>> Sincronizacion de agenda recibida (%u bytes en %s)", (unsigned)length, path);
+    
+    if (!spiffsManager.isInitialized()) {
+        LOG_WARN("SPIFFS no inicializado, agenda no guardada");
         
-        if (spiffsManager.writeFile(agendaFile, payload)) {
-            Logger::logf(LOG_LEVEL_INFO, "Agenda guardada en SPIFFS: %s", agendaFile);
-            
-            // Mostrar info de almacenamiento
-            Logger::logf(LOG_LEVEL_INFO, "Espacio usado: %.1f%% (%d/%d bytes)", 
-                       spiffsManager.getUsagePercent(),
-                       spiffsManager.getUsedBytes(),
-                       spiffsManager.getTotalBytes());
-            
-            // Listar archivos
-            spiffsManager.listFiles();
-            
-            // Mostrar contenido de la agenda guardada
-            showStoredAgenda();
-            
-            // Publicar evento de sincronización exitosa
-            if (mqttManager.isConnected()) {
-                String detalles = String("Agenda sincronizada correctamente (") + payload.length() + " bytes)";
-                mqttManager.publishSystemEvent("agenda_sync_ok", detalles, -1);
-            }
-        } else {
-            Logger::error("Error al guardar agenda en SPIFFS");
-            
-            // Publicar evento de error
+        // Publicar evento de error
+        if (mqttManager.isConnected()) {
+            mqttManager.publishSystemEvent(SYS_AGENDA_STORAGE_ERROR, "SPIFFS no inicializado", 0);
+        }
+        return;
+    }
+    
+    // Sync delta: combinar con la agenda vigente en un archivo nuevo y seguir
+    // como un sync completo. Ante un salto de versión o error se pide resync.
+    String errorMsg;
+    if (agendaManager != nullptr) {
+        AgendaDeltaResult delta = agendaManager->mergeDelta(path, AGENDA_DELTA_TEMP_FILE, errorMsg);
+        if (delta != AGENDA_DELTA_NOT_DELTA) {
+            spiffsManager.deleteFile(path);
+        }
+        
+        if (delta == AGENDA_DELTA_UP_TO_DATE) {
+            LOG_INFO("Agenda ya actualizada, delta sin cambios");
+            return;
+        }
+        
+        if (delta != AGENDA_DELTA_OK && delta != AGENDA_DELTA_NOT_DELTA) {
+            LOG_WARN("Delta de agenda descartado: %s", errorMsg.c_str());
             if (mqttManager.isConnected()) {
-                String detalles = String("Error al guardar agenda en SPIFFS (") + payload.length() + " bytes, " + 
-                                spiffsManager.getFreeBytes() + " bytes libres)";
-                mqttManager.publishSystemEvent("agenda_storage_error", detalles, 0);
+                mqttManager.publishSystemEvent(SYS_AGENDA_DELTA_ERROR, errorMsg.c_str(), -1);
+                // Salto de versión: pedir delta desde la local; error: lista completa
+                mqttManager.publishAgendaVersion(delta == AGENDA_DELTA_VERSION_GAP ? agendaManager->getTable().version : 0);
             }
+            return;
+        }
+        
+        if (delta == AGENDA_DELTA_OK) {
+            path = AGENDA_DELTA_TEMP_FILE;
+        }
+    }
+    
+    // Validar antes de reemplazar: una agenda inválida no pisa la vigente
+    if (agendaManager != nullptr && !agendaManager->validateFile(path, errorMsg)) {
+        LOG_ERROR("Agenda rechazada: %s", errorMsg.c_str());
+        spiffsManager.deleteFile(path);
+        
+        if (mqttManager.isConnected()) {
+            mqttManager.publishSystemEvent(SYS_AGENDA_PARSE_ERROR, errorMsg.c_str(), 0);
+        }
+        return;
+    }
+    
+    // La imagen binaria deja de corresponder al JSON vigente: borrarla antes
+    // del reemplazo para que un corte de energía no cargue la tabla anterior
+    if (agendaManager != nullptr) {
+        agendaManager->invalidateImage();
+    }
+    
+    // Reemplazo atómico: rename sobre el archivo vigente
+    if (spiffsManager.renameFile(path, AGENDA_FILE)) {
+        LOG_INFO("Agenda guardada en SPIFFS: %s", AGENDA_FILE);
+        
+        // Mostrar info de almacenamiento
+        LOG_INFO("Espacio usado: %.1f%% (%u/%u bytes)", 
+                 spiffsManager.getUsagePercent(),
+                 (unsigned)spiffsManager.getUsedBytes(),
+                 (unsigned)spiffsManager.getTotalBytes());
+        
+        // Recompilar tabla de agendas en RAM (única vez que se parsea el JSON)
+        if (agendaManager != nullptr) {
+            agendaManager->reload();
+        }
+        
+        // Publicar evento de sincronización exitosa
+        if (mqttManager.isConnected()) {
+            String detalles = String("Agenda sincronizada correctamente (") + (unsigned)length + " bytes)";
+            mqttManager.publishSystemEvent(SYS_AGENDA_SYNC_OK, detalles.c_str(), -1);
         }
     } else {
-        Logger::warn("SPIFFS no inicializado, agenda no guardada");
+        LOG_ERROR("Error al guardar agenda en SPIFFS");
+        spiffsManager.deleteFile(path);
         
         // Publicar evento de error
         if (mqttManager.isConnected()) {
-            mqttManager.publishSystemEvent("agenda_storage_error", "SPIFFS no inicializado", 0);
+            String detalles = String("Error al guardar agenda en SPIFFS (") + (unsigned)length + " bytes, " + 
+                            spiffsManager.getFreeBytes() + " bytes libres)";
+            mqttManager.publishSystemEvent(SYS_AGENDA_STORAGE_ERROR, detalles.c_str(), 0);
         }
     }
-    
-    // TODO: Parsear agenda y cargar en AgendaManager
 }
 
 void onZoneStateChanged(int zona, bool estado) {
     // Callback llamado cuando una zona cambia de estado (ej: auto-apagado por timer)
-    Logger::logf(LOG_LEVEL_INFO, ">>> Cambio de estado zona %d: %s", zona, estado ? "ON" : "OFF");
+    LOG_INFO(">>> Cambio de estado zona %d: %s", zona, estado ? "ON" : "OFF");
     
-    // Publicar estado actualizado via MQTT
+    // Publicar estado actualizado via MQTT (sin conexión queda pendiente en
+    // StatusPublisher hasta la próxima vuelta ONLINE)
     if (mqttManager.isConnected()) {
-        int remaining = estado ? relayController.getRemainingTime(zona) : 0;
-        mqttManager.publishZoneStatus(zona, estado, remaining);
+        publishZoneStatusUpdates();
     }
 }
 
-void onRiegoEvent(int zona, String evento, String origen, int duracion, int versionAgenda) {
+void onRiegoEvent(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion, int versionAgenda) {
     // Callback para eventos de inicio/fin de riego
-    Logger::logf(LOG_LEVEL_INFO, ">>> Evento riego zona %d: %s (%s, %d seg)", 
-                 zona, evento.c_str(), origen.c_str(), duracion);
+    LOG_INFO(">>> Evento riego zona %d: %s (%s, %d seg)", 
+             zona, riegoEventoName(evento), riegoOrigenName(origen), duracion);
     
-    // Publicar evento via MQTT
-    if (mqttManager.isConnected()) {
-        mqttManager.publishRiegoEvento(zona, evento, origen, duracion, versionAgenda);
-    } else {
-        Logger::warn("MQTT no conectado - evento no publicado");
+    // Conectado y sin pendientes se publica directo; si no hay conexión o
+    // falla queda en el diario y sale al reconectar (con su timestamp original)
+    uint32_t timestamp = timeSync.getUtcEpoch();
+    bool connected = mqttManager.isConnected();
+    if (!eventJournal.record(connected ? publishJournalEvent : nullptr,
+                             zona, evento, origen, duracion, versionAgenda, timestamp)) {
+        LOG_WARN("Evento no publicado y diario no disponible - evento perdido");
+    } else if (eventJournal.getPending() > 0) {
+        LOG_INFO("Evento guardado en el diario (%u pendientes)", eventJournal.getPending());
+    }
+}
+
+bool publishJournalEvent(const RiegoEventRecord& record) {
+    return mqttManager.publishRiegoEvento(record.zona, (RiegoEvento)record.evento, (RiegoOrigen)record.origen,
+                                          record.duracion, record.versionAgenda, record.timestamp, record.seq);
+}
+
+// ============================================================================
+// Publicar eventos pendientes del diario (lotes acotados, con pausa)
+// ============================================================================
+void drainEventJournal() {
+    if (eventJournal.getPending() == 0 || !mqttManager.isConnected()) return;
+    if (millis() - lastJournalDrain < EVENT_JOURNAL_DRAIN_INTERVAL_MS) return;
+    lastJournalDrain = millis();
+    
+    uint16_t published = eventJournal.drain(publishJournalEvent, EVENT_JOURNAL_DRAIN_BATCH);
+    if (published > 0 && eventJournal.getPending() == 0) {
+        LOG_INFO("Diario de eventos al dia (seq %lu)", (unsigned long)eventJournal.getAckedSeq());
     }
 }
 
@@ -1082,37 +1515,44 @@ void updateRelayTimers() {
 // ============================================================================
 // Mostrar agenda almacenada en SPIFFS
 // ============================================================================
+// Volcado directo al UART (bloquea mientras sale todo el JSON): solo desde
+// setup() o el comando serial "agenda", nunca desde el loop normal
 void showStoredAgenda() {
-    const char* agendaFile = "/agenda.json";
-    
     if (!spiffsManager.isInitialized()) {
-        Logger::warn("SPIFFS no inicializado, no se puede leer agenda");
+        LOG_WARN("SPIFFS no inicializado, no se puede leer agenda");
         return;
     }
     
-    if (!spiffsManager.exists(agendaFile)) {
-        Logger::info("No hay agenda almacenada en SPIFFS");
+    if (!spiffsManager.exists(AGENDA_FILE)) {
+        LOG_INFO("No hay agenda almacenada en SPIFFS");
         return;
     }
     
-    String agendaContent = spiffsManager.readFile(agendaFile);
-    
-    if (agendaContent.length() == 0) {
-        Logger::error("Archivo de agenda vacio o error al leer");
+    File file = spiffsManager.openFile(AGENDA_FILE, "r");
+    if (!file || file.size() == 0) {
+        LOG_ERROR("Archivo de agenda vacio o error al leer");
         return;
     }
     
+    // Las líneas pendientes del logger salen antes, así el orden se mantiene
+    Logger::flush();
     Serial.println("\n╔════════════════════════════════════════════════════════════════");
     Serial.println("║ AGENDA ALMACENADA EN SPIFFS");
     Serial.println("╠════════════════════════════════════════════════════════════════");
-    Serial.printf("║ Archivo: %s\n", agendaFile);
-    Serial.printf("║ Tamaño: %d bytes\n", agendaContent.length());
+    Serial.printf("║ Archivo: %s\n", AGENDA_FILE);
+    Serial.printf("║ Tamaño: %u bytes\n", (unsigned)file.size());
     Serial.println("╠════════════════════════════════════════════════════════════════");
     Serial.println("║ Contenido JSON:");
     Serial.println("╠────────────────────────────────────────────────────────────────");
     
-    // Imprimir el JSON con indentación básica
-    Serial.println(agendaContent);
+    // Imprimir el JSON por bloques (sin cargar el archivo completo en RAM)
+    uint8_t buffer[64];
+    size_t n;
+    while ((n = file.read(buffer, sizeof(buffer))) > 0) {
+        Serial.write(buffer, n);
+    }
+    file.close();
+    Serial.println();
     
     Serial.println("╚════════════════════════════════════════════════════════════════\n");
 }
@@ -1122,54 +1562,62 @@ void showStoredAgenda() {
 // ============================================================================
 void fetchAndStoreAgendas() {
     if (!wifiManager.isConnected()) {
-        Logger::warn("WiFi no conectado, no se pueden solicitar agendas");
-        Logger::info("Continuando con agendas almacenadas localmente");
+        LOG_WARN("WiFi no conectado, no se pueden solicitar agendas");
+        LOG_INFO("Continuando con agendas almacenadas localmente");
         
         // Publicar evento de advertencia
         if (mqttManager.isConnected()) {
-            mqttManager.publishSystemEvent("agenda_fetch_warning", "WiFi no conectado - usando agendas locales", -1);
+            mqttManager.publishSystemEvent(SYS_AGENDA_FETCH_WARNING, "WiFi no conectado - usando agendas locales", -1);
         }
         return;
     }
     
-    // Obtener agendas desde backend
-    String agendasJson = httpClient.fetchAgendas();
+    // Obtener el sync desde backend directo al archivo temporal. Se pide desde
+    // la versión local: el backend responde un delta (o la lista completa si
+    // no hay agenda local o la versión no es alcanzable), igual que por MQTT.
+    int received = -1;
+    size_t storedBytes = 0;
+    int32_t localVersion = agendaManager != nullptr ? agendaManager->getTable().version : 0;
+    File tempFile = spiffsManager.openFile(AGENDA_SYNC_TEMP_FILE, "w");
+    if (tempFile) {
+        received = httpClient.fetchAgendaSync(localVersion, tempFile);
+        storedBytes = tempFile.size();
+        tempFile.close();
+        if (received <= 0) {
+            spiffsManager.deleteFile(AGENDA_SYNC_TEMP_FILE);
+        }
+    }
     
-    if (agendasJson.length() == 0) {
-        Logger::warn("No se pudieron obtener agendas del backend");
+    if (received <= 0) {
+        LOG_WARN("No se pudieron obtener agendas del backend");
         
         // Verificar si hay agendas almacenadas localmente
-        if (spiffsManager.exists("/agenda.json")) {
-            Logger::info("Continuando con agendas almacenadas localmente");
-            showStoredAgenda();
+        if (spiffsManager.exists(AGENDA_FILE)) {
+            LOG_INFO("Continuando con agendas almacenadas localmente");
             
             // Publicar evento de advertencia
             if (mqttManager.isConnected()) {
-                mqttManager.publishSystemEvent("agenda_fetch_warning", "Backend no disponible - usando agendas locales", -1);
+                mqttManager.publishSystemEvent(SYS_AGENDA_FETCH_WARNING, "Backend no disponible - usando agendas locales", -1);
             }
         } else {
-            Logger::warn("No hay agendas locales - sistema funcionara sin agendas programadas");
+            LOG_WARN("No hay agendas locales - sistema funcionara sin agendas programadas");
             
             // Publicar evento de error crítico
             if (mqttManager.isConnected()) {
-                mqttManager.publishSystemEvent("agenda_load_error", "Sin agendas: backend no disponible y sin cache local", 0);
+                mqttManager.publishSystemEvent(SYS_AGENDA_LOAD_ERROR, "Sin agendas: backend no disponible y sin cache local", 0);
             }
         }
         return;
     }
     
-    Logger::info("Agendas obtenidas exitosamente del backend");
-    
-    // El HTTP retorna un array directo [...], pero el ESP8266 espera formato MQTT: {"agendas": [...]}
-    // Envolver el array en un objeto para mantener compatibilidad con AgendaManager
-    String wrappedJson = "{\"agendas\":" + agendasJson + "}";
+    LOG_INFO("Agendas obtenidas exitosamente del backend");
     
     // Publicar evento de carga inicial exitosa
     if (mqttManager.isConnected()) {
-        String detalles = String("Agendas cargadas desde backend HTTP (") + agendasJson.length() + " bytes)";
-        mqttManager.publishSystemEvent("agenda_initial_load_ok", detalles, -1);
+        String detalles = String("Agendas cargadas desde backend HTTP (") + received + " bytes)";
+        mqttManager.publishSystemEvent(SYS_AGENDA_INITIAL_LOAD_OK, detalles.c_str(), -1);
     }
     
     // Procesar como si fuera una sincronización MQTT
-    onAgendaSync(wrappedJson);
+    onAgendaSync(AGENDA_SYNC_TEMP_FILE, storedBytes);
 }
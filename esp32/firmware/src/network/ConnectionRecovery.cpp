@@ -0,0 +1,90 @@
+#include "ConnectionRecovery.h"
+#include <string.h>
+
+// ============================================================================
+// Constructor y configuración
+// ============================================================================
+ConnectionRecovery::ConnectionRecovery()
+    : armed(false), online(false), offlineSince(0), offlineOffsetMs(0),
+      applied(RECOVERY_NONE), appliedAt(0), reportPending(false) {
+    memset(stats, 0, sizeof(stats));
+    memset(&report, 0, sizeof(report));
+    setThresholds(MQTT_RECOVERY_SOCKET_MS, MQTT_RECOVERY_WIFI_MS, MQTT_RECOVERY_RESTART_MS);
+}
+
+void ConnectionRecovery::setThresholds(uint32_t socketMs, uint32_t wifiMs, uint32_t restartMs) {
+    thresholdMs[RECOVERY_NONE] = 0;
+    thresholdMs[RECOVERY_SOCKET] = socketMs;
+    thresholdMs[RECOVERY_WIFI] = wifiMs;
+    thresholdMs[RECOVERY_RESTART] = restartMs;
+}
+
+void ConnectionRecovery::resumeAfterRestart(uint32_t offlineMsBeforeRestart) {
+    // millis() arranca en 0 con el reinicio: el nivel se aplicó en t = 0
+    armed = true;
+    online = false;
+    offlineSince = 0;
+    offlineOffsetMs = offlineMsBeforeRestart;
+    applied = RECOVERY_RESTART;
+    appliedAt = 0;
+}
+
+// ============================================================================
+// Escalado
+// ============================================================================
+RecoveryTier ConnectionRecovery::update(uint32_t nowMs, bool connected) {
+    if (connected) {
+        if (!online) {
+            if (armed) recordRecovery(nowMs);
+            online = true;
+            armed = true;
+            offlineOffsetMs = 0;
+        }
+        return RECOVERY_NONE;
+    }
+
+    if (online) {
+        // Se acaba de caer
+        online = false;
+        offlineSince = nowMs;
+        applied = RECOVERY_NONE;
+        appliedAt = nowMs;
+    }
+    if (!armed || applied >= RECOVERY_RESTART) return RECOVERY_NONE;
+
+    RecoveryTier next = (RecoveryTier)(applied + 1);
+    if (getOfflineMs(nowMs) < thresholdMs[next]) return RECOVERY_NONE;
+
+    applied = next;
+    appliedAt = nowMs;
+    return next;
+}
+
+uint32_t ConnectionRecovery::getOfflineMs(uint32_t nowMs) const {
+    if (online) return 0;
+    return nowMs - offlineSince + offlineOffsetMs;
+}
+
+// ============================================================================
+// Medición
+// ============================================================================
+void ConnectionRecovery::recordRecovery(uint32_t nowMs) {
+    report.tier = applied;
+    report.tierMs = nowMs - appliedAt;
+    report.offlineMs = getOfflineMs(nowMs);
+    reportPending = true;
+
+    RecoveryStats& tierStats = stats[applied];
+    if (tierStats.count < 0xFFFF) tierStats.count++;
+    tierStats.lastMs = report.tierMs;
+    if (report.tierMs > tierStats.maxMs) tierStats.maxMs = report.tierMs;
+    uint32_t total = tierStats.totalMs + report.tierMs;
+    tierStats.totalMs = total < tierStats.totalMs ? 0xFFFFFFFF : total;
+}
+
+bool ConnectionRecovery::takeReport(RecoveryReport& out) {
+    if (!reportPending) return false;
+    out = report;
+    reportPending = false;
+    return true;
+}
@@ -0,0 +1,87 @@
+#ifndef CONNECTION_RECOVERY_H
+#define CONNECTION_RECOVERY_H
+
+#include <stdint.h>
+#include "../config/Config.h"
+
+// ============================================================================
+// ConnectionRecovery - Recuperación escalonada de la sesión MQTT
+// ============================================================================
+// Con la sesión caída, MqttConnector ya reintenta con backoff. Si aun así no
+// vuelve, se escala según el tiempo sin conexión, un nivel por vez y cada
+// nivel una sola vez por caída:
+//   1. SOCKET  (MQTT_RECOVERY_SOCKET_MS):  socket nuevo, descarta el backoff
+//   2. WIFI    (MQTT_RECOVERY_WIFI_MS):    reasociar el WiFi
+//   3. RESTART (MQTT_RECOVERY_RESTART_MS): foto de los relés en memoria RTC
+//      y reinicio por software (los riegos se reanudan al arrancar)
+// Al volver la conexión se mide cuánto tardó desde el último nivel aplicado
+// (y desde la caída) y se acumula por nivel. Solo decide: las acciones las
+// ejecuta quien lo usa (MqttManager).
+
+enum RecoveryTier {
+    RECOVERY_NONE = 0,     // Volvió sola (backoff del conector)
+    RECOVERY_SOCKET,
+    RECOVERY_WIFI,
+    RECOVERY_RESTART,
+    RECOVERY_TIER_COUNT
+};
+
+static const char* const RECOVERY_TIER_NAMES[] = {
+    "backoff", "socket", "wifi", "reinicio"
+};
+
+// Tiempos de recuperación acumulados de un nivel
+struct RecoveryStats {
+    uint16_t count;          // Recuperaciones cerradas por este nivel
+    uint32_t lastMs;         // Desde que se aplicó el nivel hasta reconectar
+    uint32_t maxMs;
+    uint32_t totalMs;        // Para el promedio (satura en 0xFFFFFFFF)
+};
+
+// Última recuperación (para informarla una vez reconectado)
+struct RecoveryReport {
+    RecoveryTier tier;       // Nivel más alto aplicado en la caída
+    uint32_t tierMs;         // Desde que se aplicó ese nivel
+    uint32_t offlineMs;      // Desde la caída (incluye el tiempo antes de un reinicio)
+};
+
+class ConnectionRecovery {
+private:
+    uint32_t thresholdMs[RECOVERY_TIER_COUNT];
+    RecoveryStats stats[RECOVERY_TIER_COUNT];
+
+    bool armed;              // Hubo una conexión (sin ella no se escala)
+    bool online;
+    uint32_t offlineSince;
+    uint32_t offlineOffsetMs;    // Tiempo sin conexión previo al reinicio
+    RecoveryTier applied;
+    uint32_t appliedAt;
+
+    RecoveryReport report;
+    bool reportPending;
+
+    void recordRecovery(uint32_t nowMs);
+
+public:
+    ConnectionRecovery();
+
+    void setThresholds(uint32_t socketMs, uint32_t wifiMs, uint32_t restartMs);
+
+    // Tras un reinicio de nivel RESTART: la caída sigue abierta desde el
+    // arranque y arrastra `offlineMsBeforeRestart`
+    void resumeAfterRestart(uint32_t offlineMsBeforeRestart);
+
+    // Llamar en cada vuelta. Devuelve el nivel a aplicar ahora (RECOVERY_NONE
+    // si no hay que hacer nada)
+    RecoveryTier update(uint32_t nowMs, bool connected);
+
+    // Recuperación cerrada pendiente de informar (una sola vez)
+    bool takeReport(RecoveryReport& out);
+
+    bool isOnline() const { return online; }
+    RecoveryTier getAppliedTier() const { return applied; }
+    uint32_t getOfflineMs(uint32_t nowMs) const;
+    const RecoveryStats& getStats(RecoveryTier tier) const { return stats[tier]; }
+};
+
+#endif // CONNECTION_RECOVERY_H
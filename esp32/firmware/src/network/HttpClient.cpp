@@ -36,7 +36,7 @@ void HttpClient::setRuntimeConfig(const String& newBackendHost, uint16_t newBack
 // Inicializar cliente HTTP
 // ============================================================================
 void HttpClient::init() {
-    Logger::info("Inicializando HttpClient...");
+    LOG_INFO("Inicializando HttpClient...");
     
     // Construir base URL
     baseUrl = String("http://") + backendHost + ":" + String(backendPort) + "/api";
@@ -44,7 +44,7 @@ void HttpClient::init() {
     // Construir header de autenticación
     basicAuthHeader = buildBasicAuth(backendUser.c_str(), backendPassword.c_str());
     
-    Logger::logf(LOG_LEVEL_INFO, "Backend URL: %s", baseUrl.c_str());
+    LOG_INFO("Backend URL: %s", baseUrl.c_str());
 }
 
 // ============================================================================
@@ -59,16 +59,16 @@ String HttpClient::buildBasicAuth(const char* user, const char* password) {
 // ============================================================================
 // Obtener agendas desde backend
 // ============================================================================
-String HttpClient::fetchAgendas() {
+int HttpClient::fetchAgendaSync(int32_t desde, Stream& out) {
     if (baseUrl.length() == 0) {
-        Logger::error("HttpClient no inicializado");
-        return "";
+        LOG_ERROR("HttpClient no inicializado");
+        return -1;
     }
     
     HTTPClient http;
-    String url = baseUrl + "/nodos/" + nodeId + "/agendas";
+    String url = baseUrl + "/nodos/" + nodeId + "/agendas/sync?desde=" + String((long)desde);
     
-    Logger::logf(LOG_LEVEL_INFO, "Solicitando agendas desde: %s", url.c_str());
+    LOG_INFO("Solicitando agendas desde: %s", url.c_str());
     
     http.begin(wifiClient, url);
     http.addHeader("Authorization", basicAuthHeader);
@@ -77,24 +77,31 @@ String HttpClient::fetchAgendas() {
     int httpCode = http.GET();
     
     if (httpCode > 0) {
-        Logger::logf(LOG_LEVEL_INFO, "HTTP GET respuesta: %d", httpCode);
+        LOG_INFO("HTTP GET respuesta: %d", httpCode);
         
         if (httpCode == HTTP_CODE_OK) {
-            String payload = http.getString();
-            Logger::logf(LOG_LEVEL_INFO, "Agendas recibidas: %d bytes", payload.length());
+            // writeToStream copia el cuerpo por bloques (soporta chunked)
+            int written = http.writeToStream(&out);
             http.end();
-            return payload;
+            
+            if (written < 0) {
+                LOG_ERROR("Error leyendo agendas: %s", HTTPClient::errorToString(written).c_str());
+                return -1;
+            }
+            
+            LOG_INFO("Agendas recibidas: %d bytes", written);
+            return written;
         } else if (httpCode == HTTP_CODE_UNAUTHORIZED) {
-            Logger::error("Autenticacion fallida - verificar credenciales");
+            LOG_ERROR("Autenticacion fallida - verificar credenciales");
         } else {
-            Logger::logf(LOG_LEVEL_ERROR, "HTTP error code: %d", httpCode);
+            LOG_ERROR("HTTP error code: %d", httpCode);
         }
     } else {
-        Logger::logf(LOG_LEVEL_ERROR, "HTTP GET fallo: %s", http.errorToString(httpCode).c_str());
+        LOG_ERROR("HTTP GET fallo: %s", http.errorToString(httpCode).c_str());
     }
     
     http.end();
-    return "";
+    return -1;
 }
 
 // ============================================================================
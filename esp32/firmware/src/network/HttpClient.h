@@ -39,9 +39,10 @@ public:
                           const String& backendUser, const String& backendPassword,
                           const String& nodeId);
     
-    // Obtener agendas desde backend
-    // Retorna JSON string o string vacío si falla
-    String fetchAgendas();
+    // Obtener el sync de agendas (delta desde `desde` o lista completa, mismo
+    // payload que agenda/sync) escribiendo el cuerpo en `out` por bloques
+    // (sin armar el JSON en RAM). Retorna bytes escritos o -1 si falla.
+    int fetchAgendaSync(int32_t desde, Stream& out);
     
     // Verificar si backend está disponible
     bool isBackendAvailable();
@@ -0,0 +1,115 @@
+#include "LogStreamer.h"
+
+static_assert(LOG_STREAM_QUEUE_BYTES <= 65535, "LOG_STREAM_QUEUE_BYTES debe entrar en uint16_t");
+static_assert(LOG_STREAM_PAYLOAD_MAX >= LOG_LINE_MAX, "LOG_STREAM_PAYLOAD_MAX debe alojar una línea completa");
+static_assert(LOG_STREAM_PAYLOAD_MAX + MQTT_TOPIC_MAX_LEN + 8 <= MQTT_BUFFER_SIZE,
+              "El mensaje de log no entra en el buffer de PubSubClient");
+
+static const char* const LEVEL_NAMES[] = {"NONE", "ERROR", "WARN", "INFO", "DEBUG"};
+
+// ============================================================================
+// Constructor y nivel
+// ============================================================================
+LogStreamer::LogStreamer(LogPublishSink publishSink)
+    : publishSink(publishSink), head(0), tail(0), level(LOG_LEVEL_NONE), publishing(false),
+      hasPublished(false), lastPublishAt(0), dropped(0), droppedReported(0), lines(0), messages(0) {
+    setLevel(LOG_STREAM_DEFAULT_LEVEL);
+}
+
+void LogStreamer::setLevel(uint8_t newLevel) {
+    level = newLevel > LOG_LEVEL ? LOG_LEVEL : newLevel;
+    if (level == LOG_LEVEL_NONE) {
+        head = tail = 0;
+        droppedReported = dropped;
+    }
+}
+
+int LogStreamer::parseLevel(const char* text, size_t length) {
+    while (length > 0 && (text[length - 1] == ' ' || text[length - 1] == '\n' || text[length - 1] == '\r')) length--;
+    if (length == 1 && text[0] >= '0' && text[0] <= '0' + LOG_LEVEL_DEBUG) return text[0] - '0';
+    if (length == 3 && strncasecmp(text, "OFF", 3) == 0) return LOG_LEVEL_NONE;
+    for (int i = LOG_LEVEL_NONE; i <= LOG_LEVEL_DEBUG; i++) {
+        if (strlen(LEVEL_NAMES[i]) == length && strncasecmp(text, LEVEL_NAMES[i], length) == 0) return i;
+    }
+    return -1;
+}
+
+// ============================================================================
+// Cola
+// ============================================================================
+size_t LogStreamer::used() const {
+    return head >= tail ? (size_t)(head - tail) : (size_t)(LOG_STREAM_QUEUE_BYTES - tail + head);
+}
+
+void LogStreamer::copyOut(uint16_t pos, char* out, size_t length) const {
+    size_t first = LOG_STREAM_QUEUE_BYTES - pos;
+    if (first > length) first = length;
+    memcpy(out, queue + pos, first);
+    memcpy(out + first, queue, length - first);
+}
+
+void LogStreamer::enqueue(int lineLevel, const char* line, size_t length) {
+    if (publishing || lineLevel > level || length == 0) return;
+    if (length > 255) length = 255;
+
+    // Un byte libre siempre: head == tail significa vacío
+    if (length + 1 > LOG_STREAM_QUEUE_BYTES - 1 - used()) {
+        dropped++;
+        return;
+    }
+    queue[head] = (uint8_t)length;
+    uint16_t pos = (uint16_t)((head + 1) % LOG_STREAM_QUEUE_BYTES);
+    size_t first = LOG_STREAM_QUEUE_BYTES - pos;
+    if (first > length) first = length;
+    memcpy(queue + pos, line, first);
+    memcpy(queue, line + first, length - first);
+    head = (uint16_t)((pos + length) % LOG_STREAM_QUEUE_BYTES);
+}
+
+// ============================================================================
+// Publicación
+// ============================================================================
+long LogStreamer::getMsUntilNextPublish(unsigned long now) const {
+    if (head == tail && dropped == droppedReported) return -1;
+    if (!hasPublished || now - lastPublishAt >= LOG_STREAM_INTERVAL_MS) return 0;
+    return (long)(LOG_STREAM_INTERVAL_MS - (now - lastPublishAt));
+}
+
+void LogStreamer::loop(unsigned long now) {
+    if (getMsUntilNextPublish(now) != 0) return;
+
+    // Resumen de lo perdido primero, después las líneas enteras que entren
+    size_t length = 0;
+    uint32_t lost = dropped - droppedReported;
+    if (lost > 0) {
+        int written = snprintf_P(payload, sizeof(payload), PSTR("[WARN] Log remoto: %lu lineas descartadas (cola llena)"),
+                                 (unsigned long)lost);
+        if (written > 0) length = (size_t)written < sizeof(payload) ? (size_t)written : sizeof(payload) - 1;
+    }
+    uint16_t pos = tail;
+    uint16_t count = 0;
+    while (pos != head) {
+        size_t lineLength = queue[pos];
+        size_t separator = length > 0 ? 1 : 0;
+        if (length + separator + lineLength > sizeof(payload)) break;
+        if (separator) payload[length++] = '\n';
+        copyOut((uint16_t)((pos + 1) % LOG_STREAM_QUEUE_BYTES), payload + length, lineLength);
+        length += lineLength;
+        pos = (uint16_t)((pos + 1 + lineLength) % LOG_STREAM_QUEUE_BYTES);
+        count++;
+    }
+
+    // También tras un fallo: el próximo intento espera el intervalo
+    hasPublished = true;
+    lastPublishAt = now;
+
+    publishing = true;
+    bool ok = publishSink != nullptr && publishSink(payload, length);
+    publishing = false;
+    if (!ok) return;
+
+    tail = pos;
+    droppedReported += lost;
+    lines += count;
+    messages++;
+}
@@ -0,0 +1,71 @@
+#ifndef LOG_STREAMER_H
+#define LOG_STREAMER_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+
+// ============================================================================
+// LogStreamer - Log remoto por MQTT (riego/{id}/log)
+// ============================================================================
+// Sumidero de líneas de Logger: las líneas hasta el nivel elegido en
+// ejecución (setLevel, desde riego/{id}/log/nivel) se copian a una cola
+// circular de LOG_STREAM_QUEUE_BYTES y loop() las publica desde el loop
+// principal, nunca desde MqttManager::loop() ni al loguear. Cada mensaje
+// lleva las líneas enteras que entren en LOG_STREAM_PAYLOAD_MAX, separadas por
+// '\n', y sale a lo sumo uno cada LOG_STREAM_INTERVAL_MS. El publicador
+// devuelve false si no hay sesión o el socket no tiene lugar para el mensaje
+// completo (no bloquea ni compite con el estado de zonas): las líneas quedan
+// para el próximo intento. Con la cola llena la línea nueva se descarta y se
+// cuenta, y el mensaje siguiente empieza con el resumen de las perdidas.
+
+// Publicador del mensaje (MqttManager::publishLog); false = reintentar luego
+typedef bool (*LogPublishSink)(const char* payload, size_t length);
+
+class LogStreamer {
+private:
+    LogPublishSink publishSink;
+    uint8_t queue[LOG_STREAM_QUEUE_BYTES];   // Entradas [largo u8][texto]
+    uint16_t head;
+    uint16_t tail;
+    char payload[LOG_STREAM_PAYLOAD_MAX];
+    uint8_t level;
+    bool publishing;       // Publicando: lo que se loguee mientras tanto no entra
+    bool hasPublished;
+    unsigned long lastPublishAt;
+    uint32_t dropped;
+    uint32_t droppedReported;
+    uint32_t lines;
+    uint32_t messages;
+
+    size_t used() const;
+
+    // Copiar `length` bytes de la cola desde `pos` (con la vuelta del buffer)
+    void copyOut(uint16_t pos, char* out, size_t length) const;
+
+public:
+    explicit LogStreamer(LogPublishSink publishSink);
+
+    // Nivel a publicar (LOG_LEVEL_NONE apaga y vacía la cola). No puede
+    // superar LOG_LEVEL: esos niveles no están compilados
+    void setLevel(uint8_t level);
+    uint8_t getLevel() const { return level; }
+
+    // Sumidero de Logger (ver Logger::setLineSink)
+    void enqueue(int level, const char* line, size_t length);
+
+    // Publicar un mensaje si pasó el intervalo y hay líneas o descartes
+    void loop(unsigned long now);
+
+    // Ms hasta el próximo mensaje (-1 si no hay nada que publicar)
+    long getMsUntilNextPublish(unsigned long now) const;
+
+    // "DEBUG", "info", "off", "3"...: nivel o -1 si no se reconoce
+    static int parseLevel(const char* text, size_t length);
+
+    size_t pending() const { return used(); }
+    uint32_t getDropped() const { return dropped; }
+    uint32_t getLinesPublished() const { return lines; }
+    uint32_t getMessagesPublished() const { return messages; }
+};
+
+#endif // LOG_STREAMER_H
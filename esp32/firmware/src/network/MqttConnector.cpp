@@ -0,0 +1,319 @@
+#include "MqttConnector.h"
+#include <ESP8266WiFi.h>
+#include <string.h>
+
+// ============================================================================
+// Constructor y configuración
+// ============================================================================
+MqttConnector::MqttConnector(Client& transport)
+    : transport(transport), host(""), port(0), clientId(""), user(nullptr), password(nullptr),
+      keepAlive(0), state(MQTT_CONN_IDLE), lastError(MQTT_CONN_OK), refusedCode(0),
+      ipResolved(false), failedAttempts(0), stateSince(0), backoffMs(0), replayPos(0),
+      swallowConnect(false) {
+    memset(connack, 0, sizeof(connack));
+}
+
+void MqttConnector::configure(const char* newHost, uint16_t newPort, const char* newClientId,
+                              const char* newUser, const char* newPassword, uint16_t newKeepAlive) {
+    host = newHost != nullptr ? newHost : "";
+    port = newPort;
+    clientId = newClientId != nullptr ? newClientId : "";
+    user = (newUser != nullptr && newUser[0] != '\0') ? newUser : nullptr;
+    password = newPassword;
+    keepAlive = newKeepAlive;
+    ipResolved = false;
+}
+
+// ============================================================================
+// Control de intentos
+// ============================================================================
+void MqttConnector::begin(uint32_t nowMs) {
+    if (state == MQTT_CONN_IDLE) {
+        failedAttempts = 0;
+        enter(MQTT_CONN_RESOLVE, nowMs);
+    }
+}
+
+void MqttConnector::retryNow(uint32_t nowMs) {
+    if (state == MQTT_CONN_CONNECTED || state == MQTT_CONN_READY) {
+        transport.stop();
+    }
+    failedAttempts = 0;
+    backoffMs = 0;
+    enter(MQTT_CONN_RESOLVE, nowMs);
+}
+
+void MqttConnector::end() {
+    transport.stop();
+    swallowConnect = false;
+    state = MQTT_CONN_IDLE;
+}
+
+void MqttConnector::enter(MqttConnectState next, uint32_t nowMs) {
+    state = next;
+    stateSince = nowMs;
+}
+
+void MqttConnector::fail(MqttConnectError error, uint32_t nowMs) {
+    transport.stop();
+    swallowConnect = false;
+    lastError = error;
+    if (failedAttempts < 0xFFFF) failedAttempts++;
+
+    // Sin respuesta o sin TCP puede ser una IP vieja: resolver de nuevo
+    if (error == MQTT_CONN_ERR_TCP || error == MQTT_CONN_ERR_TIMEOUT) {
+        ipResolved = false;
+    }
+
+    backoffMs = backoffDelay(failedAttempts, (uint32_t)random(0x7FFFFFFF));
+    enter(MQTT_CONN_BACKOFF, nowMs);
+}
+
+uint32_t MqttConnector::backoffDelay(uint16_t attempt, uint32_t randomValue) {
+    uint32_t delayMs = MQTT_BACKOFF_MAX_MS;
+    if (attempt > 0 && attempt <= 16) {
+        uint32_t exponential = (uint32_t)MQTT_BACKOFF_MIN_MS << (attempt - 1);
+        if (exponential < delayMs) delayMs = exponential;
+    }
+    // Mitad fija + mitad aleatoria: los nodos que cayeron juntos no
+    // reintentan todos en el mismo instante
+    uint32_t half = delayMs / 2;
+    return half + randomValue % (delayMs - half + 1);
+}
+
+int32_t MqttConnector::getMsUntilNextStep(uint32_t nowMs) const {
+    switch (state) {
+        case MQTT_CONN_IDLE:
+        case MQTT_CONN_CONNECTED:
+            return -1;
+        case MQTT_CONN_BACKOFF: {
+            uint32_t elapsed = nowMs - stateSince;
+            return elapsed >= backoffMs ? 0 : (int32_t)(backoffMs - elapsed);
+        }
+        default:
+            return 0;  // Conexión en curso: sondear en cada vuelta
+    }
+}
+
+// ============================================================================
+// Máquina de estados
+// ============================================================================
+MqttConnectState MqttConnector::tick(uint32_t nowMs) {
+    switch (state) {
+        case MQTT_CONN_IDLE:
+        case MQTT_CONN_READY:
+        case MQTT_CONN_CONNECTED:
+            break;
+
+        case MQTT_CONN_BACKOFF:
+            if (nowMs - stateSince >= backoffMs) {
+                enter(MQTT_CONN_RESOLVE, nowMs);
+            }
+            break;
+
+        case MQTT_CONN_RESOLVE:
+            if (WiFi.status() != WL_CONNECTED) {
+                // Sin WiFi no se cuenta como fallo del broker: esperar
+                lastError = MQTT_CONN_ERR_NO_WIFI;
+                backoffMs = MQTT_BACKOFF_MIN_MS;
+                enter(MQTT_CONN_BACKOFF, nowMs);
+                break;
+            }
+            if (!ipResolved) {
+                if (brokerIp.fromString(host)) {
+                    ipResolved = true;
+                } else if (WiFi.hostByName(host, brokerIp, MQTT_DNS_TIMEOUT_MS) == 1) {
+                    ipResolved = true;
+                } else {
+                    fail(MQTT_CONN_ERR_DNS, nowMs);
+                    break;
+                }
+            }
+            enter(MQTT_CONN_TCP, nowMs);
+            break;
+
+        case MQTT_CONN_TCP:
+            transport.setTimeout(MQTT_TCP_CONNECT_TIMEOUT_MS);
+            if (!transport.connect(brokerIp, port)) {
+                fail(MQTT_CONN_ERR_TCP, nowMs);
+            } else if (!sendConnect()) {
+                fail(MQTT_CONN_ERR_WRITE, nowMs);
+            } else {
+                enter(MQTT_CONN_CONNACK, nowMs);
+            }
+            break;
+
+        case MQTT_CONN_CONNACK:
+            if (transport.available() >= (int)sizeof(connack)) {
+                transport.read(connack, sizeof(connack));
+                if (connack[0] != 0x20 || connack[1] != 0x02) {
+                    fail(MQTT_CONN_ERR_PROTOCOL, nowMs);
+                } else if (connack[3] != 0) {
+                    refusedCode = connack[3];
+                    fail(MQTT_CONN_ERR_REFUSED, nowMs);
+                } else {
+                    lastError = MQTT_CONN_OK;
+                    failedAttempts = 0;
+                    replayPos = 0;
+                    swallowConnect = true;
+                    enter(MQTT_CONN_READY, nowMs);
+                }
+            } else if (!transport.connected()) {
+                fail(MQTT_CONN_ERR_CLOSED, nowMs);
+            } else if (nowMs - stateSince >= MQTT_CONNACK_TIMEOUT_MS) {
+                fail(MQTT_CONN_ERR_TIMEOUT, nowMs);
+            }
+            break;
+    }
+    return state;
+}
+
+// ============================================================================
+// Paquete CONNECT
+// ============================================================================
+static size_t putString(uint8_t* out, size_t pos, size_t capacity, const char* text) {
+    size_t length = strlen(text);
+    if (length > 0xFFFF || pos + 2 + length > capacity) return 0;
+    out[pos++] = (uint8_t)(length >> 8);
+    out[pos++] = (uint8_t)(length & 0xFF);
+    memcpy(out + pos, text, length);
+    return pos + length;
+}
+
+size_t MqttConnector::buildConnectPacket(uint8_t* out, size_t capacity, const char* clientId,
+                                         const char* user, const char* password, uint16_t keepAlive) {
+    // El encabezado fijo (tipo + longitud restante de 1 o 2 bytes) se
+    // escribe al final: el cuerpo se arma desde el byte 3 y después se corre
+    // si la longitud entra en un byte
+    const size_t HEADER_MAX = 3;
+    if (capacity <= HEADER_MAX + 10) return 0;
+
+    size_t pos = HEADER_MAX;
+    static const uint8_t PROTOCOL[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04};
+    memcpy(out + pos, PROTOCOL, sizeof(PROTOCOL));
+    pos += sizeof(PROTOCOL);
+
+    uint8_t flags = 0x02;  // Sesión limpia
+    if (user != nullptr) {
+        flags |= 0x80;
+        if (password != nullptr) flags |= 0x40;
+    }
+    out[pos++] = flags;
+    out[pos++] = (uint8_t)(keepAlive >> 8);
+    out[pos++] = (uint8_t)(keepAlive & 0xFF);
+
+    pos = putString(out, pos, capacity, clientId);
+    if (pos != 0 && user != nullptr) {
+        pos = putString(out, pos, capacity, user);
+        if (pos != 0 && password != nullptr) pos = putString(out, pos, capacity, password);
+    }
+    if (pos == 0) return 0;
+
+    size_t remaining = pos - HEADER_MAX;
+    if (remaining > 0x3FFF) return 0;
+    size_t start;
+    if (remaining < 128) {
+        start = HEADER_MAX - 2;
+        out[start + 1] = (uint8_t)remaining;
+    } else {
+        start = 0;
+        out[1] = (uint8_t)((remaining & 0x7F) | 0x80);
+        out[2] = (uint8_t)(remaining >> 7);
+    }
+    out[start] = 0x10;  // CONNECT
+
+    if (start > 0) memmove(out, out + start, pos - start);
+    return pos - start;
+}
+
+bool MqttConnector::sendConnect() {
+    uint8_t packet[MQTT_CONNECT_PACKET_MAX];
+    size_t length = buildConnectPacket(packet, sizeof(packet), clientId, user, password, keepAlive);
+    if (length == 0) return false;
+    return transport.write(packet, length) == length;
+}
+
+// ============================================================================
+// Client
+// ============================================================================
+// El socket lo abre tick(); PubSubClient solo encuentra la sesión lista
+int MqttConnector::connect(IPAddress, uint16_t) {
+    return connected();
+}
+
+int MqttConnector::connect(const char*, uint16_t) {
+    return connected();
+}
+
+size_t MqttConnector::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t MqttConnector::write(const uint8_t* buffer, size_t size) {
+    if (swallowConnect) {
+        // CONNECT de PubSubClient en el traspaso: ya se envió el propio
+        swallowConnect = false;
+        return size;
+    }
+    return transport.write(buffer, size);
+}
+
+int MqttConnector::availableForWrite() {
+    return transport.availableForWrite();
+}
+
+int MqttConnector::available() {
+    if (state == MQTT_CONN_READY) return (int)(sizeof(connack) - replayPos);
+    return transport.available();
+}
+
+int MqttConnector::read() {
+    if (state == MQTT_CONN_READY) {
+        uint8_t c = connack[replayPos++];
+        if (replayPos >= sizeof(connack)) state = MQTT_CONN_CONNECTED;
+        return c;
+    }
+    return transport.read();
+}
+
+int MqttConnector::read(uint8_t* buffer, size_t size) {
+    if (state == MQTT_CONN_READY) {
+        size_t count = 0;
+        while (count < size && state == MQTT_CONN_READY) {
+            buffer[count++] = (uint8_t)read();
+        }
+        return (int)count;
+    }
+    return transport.read(buffer, size);
+}
+
+int MqttConnector::peek() {
+    if (state == MQTT_CONN_READY) return connack[replayPos];
+    return transport.peek();
+}
+
+void MqttConnector::flush() {
+    transport.flush();
+}
+
+void MqttConnector::stop() {
+    MqttConnectState previous = state;
+    transport.stop();
+    swallowConnect = false;
+
+    if (previous == MQTT_CONN_CONNECTED) {
+        // Sesión perdida (o cerrada por PubSubClient): reconectar con backoff
+        lastError = MQTT_CONN_ERR_CLOSED;
+        backoffMs = backoffDelay(1, (uint32_t)random(0x7FFFFFFF));
+        enter(MQTT_CONN_BACKOFF, millis());
+    } else if (previous == MQTT_CONN_READY) {
+        // PubSubClient rechazó el traspaso
+        fail(MQTT_CONN_ERR_PROTOCOL, millis());
+    }
+}
+
+uint8_t MqttConnector::connected() {
+    if (state == MQTT_CONN_READY) return 1;
+    if (state != MQTT_CONN_CONNECTED) return 0;
+    return transport.connected();
+}
@@ -0,0 +1,141 @@
+#ifndef MQTT_CONNECTOR_H
+#define MQTT_CONNECTOR_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <IPAddress.h>
+#include "../config/Config.h"
+
+// ============================================================================
+// MqttConnector - Conexión MQTT no bloqueante (transporte de PubSubClient)
+// ============================================================================
+// PubSubClient::connect() resuelve, abre el TCP y espera el CONNACK en una
+// sola llamada: con el broker caído bloquea loop() durante todo el timeout.
+// MqttConnector envuelve al WiFiClient y avanza la conexión de a un paso por
+// tick() desde loop():
+//   BACKOFF -> RESOLVE (DNS, acotado) -> TCP (connect, acotado por timeout)
+//   -> CONNACK (CONNECT propio; se sondea available() sin esperar)
+//   -> READY -> CONNECTED
+// En READY quien lo usa llama a PubSubClient::connect(): como el socket ya
+// está abierto, PubSubClient escribe su CONNECT (se descarta) y lee el
+// CONNACK ya recibido (se repite desde un buffer), quedando conectado sin
+// esperar a la red. Desde ahí el tráfico pasa directo al WiFiClient.
+// Cada fallo reintenta con backoff exponencial con jitter (mitad fija +
+// mitad aleatoria) entre MQTT_BACKOFF_MIN_MS y MQTT_BACKOFF_MAX_MS.
+
+enum MqttConnectState {
+    MQTT_CONN_IDLE = 0,    // Sin conexión pedida (connect() no llamado o disconnect())
+    MQTT_CONN_BACKOFF,     // Esperando el próximo intento
+    MQTT_CONN_RESOLVE,     // Resolver el host del broker
+    MQTT_CONN_TCP,         // Abrir el socket
+    MQTT_CONN_CONNACK,     // CONNECT enviado, esperando CONNACK
+    MQTT_CONN_READY,       // CONNACK aceptado, falta el traspaso a PubSubClient
+    MQTT_CONN_CONNECTED    // Sesión en manos de PubSubClient
+};
+
+enum MqttConnectError {
+    MQTT_CONN_OK = 0,
+    MQTT_CONN_ERR_NO_WIFI,
+    MQTT_CONN_ERR_DNS,
+    MQTT_CONN_ERR_TCP,
+    MQTT_CONN_ERR_WRITE,
+    MQTT_CONN_ERR_TIMEOUT,     // El broker no respondió el CONNECT
+    MQTT_CONN_ERR_CLOSED,      // El broker cortó antes del CONNACK
+    MQTT_CONN_ERR_PROTOCOL,    // Respuesta que no es CONNACK
+    MQTT_CONN_ERR_REFUSED      // CONNACK con código de rechazo
+};
+
+static const char* const MQTT_CONNECT_STATE_NAMES[] = {
+    "idle", "backoff", "resolve", "tcp", "connack", "ready", "connected"
+};
+
+class MqttConnector : public Client {
+private:
+    Client& transport;
+
+    // Broker y sesión (punteros a strings del dueño, deben seguir vivos)
+    const char* host;
+    uint16_t port;
+    const char* clientId;
+    const char* user;
+    const char* password;
+    uint16_t keepAlive;
+
+    MqttConnectState state;
+    MqttConnectError lastError;
+    uint8_t refusedCode;         // Código del último CONNACK rechazado
+    IPAddress brokerIp;
+    bool ipResolved;
+
+    uint16_t failedAttempts;     // Fallos consecutivos (0 tras un CONNACK aceptado)
+    uint32_t stateSince;         // millis() de entrada al estado actual
+    uint32_t backoffMs;          // Espera del backoff en curso
+
+    // Traspaso a PubSubClient: su CONNECT se descarta y el CONNACK se repite
+    uint8_t connack[4];
+    uint8_t replayPos;
+    bool swallowConnect;
+
+    void enter(MqttConnectState next, uint32_t nowMs);
+    void fail(MqttConnectError error, uint32_t nowMs);
+    bool sendConnect();
+
+public:
+    explicit MqttConnector(Client& transport);
+
+    // Datos del broker y de la sesión (se copian los punteros, no el texto)
+    void configure(const char* host, uint16_t port, const char* clientId,
+                   const char* user, const char* password, uint16_t keepAlive);
+
+    // Pedir conexión: desde IDLE arranca el primer intento; si ya hay uno en
+    // curso o en backoff no hace nada (no acorta el backoff)
+    void begin(uint32_t nowMs);
+
+    // Intentar de inmediato (descarta el backoff en curso)
+    void retryNow(uint32_t nowMs);
+
+    // Cerrar y no volver a intentar hasta begin()
+    void end();
+
+    // Avanzar un paso. RESOLVE bloquea hasta MQTT_DNS_TIMEOUT_MS y TCP hasta
+    // MQTT_TCP_CONNECT_TIMEOUT_MS: WiFiClient::connect() del core no tiene
+    // variante asíncrona, así que ese tick retiene loop() ese tiempo con el
+    // broker caído. Cada tick hace un solo paso: el peor caso por vuelta es
+    // el mayor de los dos timeouts, no su suma. El resto no espera.
+    MqttConnectState tick(uint32_t nowMs);
+
+    // Armar el CONNECT (MQTT 3.1.1, sesión limpia); devuelve la longitud o 0
+    static size_t buildConnectPacket(uint8_t* out, size_t capacity, const char* clientId,
+                                     const char* user, const char* password, uint16_t keepAlive);
+
+    // Espera con backoff exponencial y jitter para el intento `attempt` (>= 1)
+    static uint32_t backoffDelay(uint16_t attempt, uint32_t randomValue);
+
+    MqttConnectState getState() const { return state; }
+    MqttConnectError getLastError() const { return lastError; }
+    uint8_t getRefusedCode() const { return refusedCode; }
+    uint16_t getFailedAttempts() const { return failedAttempts; }
+    uint32_t getBackoffMs() const { return backoffMs; }
+
+    // ms hasta el próximo paso (para el SleepPlanner; -1 = nada pendiente)
+    int32_t getMsUntilNextStep(uint32_t nowMs) const;
+
+    // ============= Client (lo usa PubSubClient) =============
+    // connect() no abre conexiones: el socket lo abre tick(). Devuelve si ya
+    // está conectado (PubSubClient no llega a llamarlo en el traspaso).
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int availableForWrite() override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size) override;
+    int peek() override;
+    void flush() override;
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected() != 0; }
+};
+
+#endif // MQTT_CONNECTOR_H
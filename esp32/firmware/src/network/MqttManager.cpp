@@ -1,4 +1,8 @@
 #include "MqttManager.h"
+#include "LogStreamer.h"
+
+static_assert(LOOP_PROFILER_PAYLOAD_MAX + MQTT_TOPIC_MAX_LEN + 8 <= MQTT_BUFFER_SIZE,
+              "El perfil del loop no entra en el buffer de PubSubClient");
 
 // Instancia estática para callback
 MqttManager* MqttManager::instance = nullptr;
@@ -6,7 +10,10 @@ MqttManager* MqttManager::instance = nullptr;
 // ============================================================================
 // Constructor
 // ============================================================================
-MqttManager::MqttManager() {
+MqttManager::MqttManager()
+    : connector(espClient),
+      payloadSpool(AGENDA_SYNC_TEMP_FILE, AGENDA_SYNC_MAX_BYTES),
+      payloadWriter(publishBuffer, sizeof(publishBuffer)) {
     mqttClient = nullptr;
     brokerHost = MQTT_BROKER;
     brokerPort = MQTT_PORT;
@@ -19,6 +26,21 @@ MqttManager::MqttManager() {
     reconnectAttempts = 0;
     commandCallback = nullptr;
     agendaSyncCallback = nullptr;
+    recoveryCallback = nullptr;
+    logLevelCallback = nullptr;
+    cmdTopicPattern[0] = '\0';
+    agendaSyncTopic[0] = '\0';
+    logLevelTopic[0] = '\0';
+    riegoEventoTopic[0] = '\0';
+    sistemaEventoTopic[0] = '\0';
+    agendaVersionTopic[0] = '\0';
+    systemStatusTopic[0] = '\0';
+    zoneStatusTopic[0] = '\0';
+    humidityTopic[0] = '\0';
+    logTopic[0] = '\0';
+    loopProfileTopic[0] = '\0';
+    zoneStatusPrefixLen = 0;
+    humidityPrefixLen = 0;
     instance = this;
 }
 
@@ -58,29 +80,48 @@ MqttManager::~MqttManager() {
 // Inicialización
 // ============================================================================
 void MqttManager::init() {
-    Logger::info("Inicializando MqttManager...");
-    
-    // Crear cliente MQTT
-    mqttClient = new PubSubClient(espClient);
+    LOG_INFO("Inicializando MqttManager...");
+    
+    // Crear cliente MQTT: el socket lo abre connector, PubSubClient solo
+    // hace el traspaso (setServer queda por printInfo/diagnóstico)
+    clientId = getClientId();
+    connector.configure(brokerHost.c_str(), brokerPort, clientId.c_str(),
+                        brokerUser.c_str(), brokerPassword.c_str(), MQTT_KEEP_ALIVE);
+    mqttClient = new PubSubClient(connector);
     mqttClient->setServer(brokerHost.c_str(), brokerPort);
     mqttClient->setCallback(messageCallback);
     mqttClient->setKeepAlive(MQTT_KEEP_ALIVE);
     
-    // Aumentar buffer MQTT para recibir mensajes de agenda (por defecto es 256 bytes)
-    // 10240 bytes permite ~30-35 agendas completas (8 zonas × 4)
-    if (!mqttClient->setBufferSize(10240)) {
-        Logger::error("No se pudo establecer buffer MQTT de 10240 bytes");
+    // Buffer MQTT para comandos y publicaciones (por defecto es 256 bytes).
+    // Los payloads de agenda no pasan por aquí: el stream los recibe completos
+    // aunque excedan el buffer, y se escriben a flash por bloques.
+    if (!mqttClient->setBufferSize(MQTT_BUFFER_SIZE)) {
+        LOG_ERROR("No se pudo establecer buffer MQTT de %d bytes", MQTT_BUFFER_SIZE);
     } else {
-        Logger::info("Buffer MQTT configurado a 10KB (10240 bytes)");
+        LOG_INFO("Buffer MQTT configurado a %d bytes", MQTT_BUFFER_SIZE);
+    }
+    mqttClient->setStream(payloadSpool);
+    
+    // Construir topics una sola vez (las publicaciones solo los reutilizan)
+    bool topicsOk = buildTopic(cmdTopicPattern, "cmd/zona/+") > 0;
+    topicsOk &= buildTopic(agendaSyncTopic, "agenda/sync") > 0;
+    topicsOk &= buildTopic(riegoEventoTopic, "evento") > 0;
+    topicsOk &= buildTopic(sistemaEventoTopic, "sistema/evento") > 0;
+    topicsOk &= buildTopic(agendaVersionTopic, "agenda/version") > 0;
+    topicsOk &= buildTopic(systemStatusTopic, "status/system") > 0;
+    topicsOk &= buildTopic(zonesStatusTopic, "status/zonas") > 0;
+    topicsOk &= buildTopic(logTopic, "log") > 0;
+    topicsOk &= buildTopic(logLevelTopic, "log/nivel") > 0;
+    topicsOk &= buildTopic(loopProfileTopic, "diagnostico/loop") > 0;
+    zoneStatusPrefixLen = buildTopic(zoneStatusTopic, "status/zona/");
+    humidityPrefixLen = buildTopic(humidityTopic, "humedad/zona/");
+    if (!topicsOk || zoneStatusPrefixLen == 0 || humidityPrefixLen == 0) {
+        LOG_ERROR("Node ID demasiado largo para los topics MQTT (max %d bytes por topic)", MQTT_TOPIC_MAX_LEN);
     }
     
-    // Construir patterns de topics
-    cmdTopicPattern = String("riego/") + nodeId + "/cmd/zona/+";
-    agendaSyncTopic = String("riego/") + nodeId + "/agenda/sync";
-    
-    Logger::logf(LOG_LEVEL_INFO, "Broker: %s:%d", brokerHost.c_str(), brokerPort);
-    Logger::logf(LOG_LEVEL_INFO, "Client ID: %s", getClientId().c_str());
-    Logger::logf(LOG_LEVEL_INFO, "Node ID: %s", nodeId.c_str());
+    LOG_INFO("Broker: %s:%d", brokerHost.c_str(), brokerPort);
+    LOG_INFO("Client ID: %s", clientId.c_str());
+    LOG_INFO("Node ID: %s", nodeId.c_str());
 }
 
 // ============================================================================
@@ -88,16 +129,23 @@ void MqttManager::init() {
 // ============================================================================
 bool MqttManager::connect() {
     if (mqttClient->connected()) {
-        Logger::info("MQTT ya estaba conectado");
+        LOG_INFO("MQTT ya estaba conectado");
         return true;
     }
     
-    Logger::logf(LOG_LEVEL_INFO, "Conectando a broker MQTT: %s:%d", brokerHost.c_str(), brokerPort);
-    lastConnectionAttempt = millis();
-    
-    String clientId = getClientId();
-    
-    // Intentar conexión (con o sin autenticación)
+    if (connector.getState() == MQTT_CONN_IDLE) {
+        LOG_INFO("Conectando a broker MQTT: %s:%d", brokerHost.c_str(), brokerPort);
+        lastConnectionAttempt = millis();
+        connector.begin(lastConnectionAttempt);
+    }
+    return false;
+}
+
+// ============================================================================
+// Traspaso a PubSubClient
+// ============================================================================
+bool MqttManager::completeConnection() {
+    // connector ya tiene el CONNACK: PubSubClient no espera a la red
     bool result;
     if (brokerUser.length() > 0) {
         result = mqttClient->connect(clientId.c_str(), brokerUser.c_str(), brokerPassword.c_str());
@@ -105,31 +153,30 @@ bool MqttManager::connect() {
         result = mqttClient->connect(clientId.c_str());
     }
     
-    if (result) {
-        onConnected();
-        lastSuccessfulConnection = millis();
-        reconnectAttempts = 0;
-        
-        // Suscribirse a topics
-        subscribeToCommands();
-        subscribeToAgendaSync();
-        
-        return true;
-    } else {
-        Logger::logf(LOG_LEVEL_ERROR, "Fallo conexión MQTT. Estado: %d", mqttClient->state());
-        reconnectAttempts++;
+    if (!result) {
+        LOG_ERROR("Fallo traspaso de conexión MQTT. Estado: %d", mqttClient->state());
         return false;
     }
+    
+    onConnected();
+    reconnectAttempts = 0;
+    
+    // Suscribirse a topics
+    subscribeToCommands();
+    subscribeToAgendaSync();
+    subscribeToLogLevel();
+    return true;
 }
 
 // ============================================================================
 // Desconectar del broker
 // ============================================================================
 void MqttManager::disconnect() {
-    Logger::info("Desconectando MQTT...");
+    LOG_INFO("Desconectando MQTT...");
     if (mqttClient != nullptr) {
         mqttClient->disconnect();
     }
+    connector.end();
     connected = false;
     onDisconnected();
 }
@@ -140,46 +187,103 @@ void MqttManager::disconnect() {
 void MqttManager::loop() {
     // Procesar mensajes MQTT
     if (mqttClient->connected()) {
+        // Cada loop() procesa a lo sumo un paquete: el spool arranca vacío
+        payloadSpool.reset();
         mqttClient->loop();
         connected = true;
         lastSuccessfulConnection = millis();
         reconnectAttempts = 0;
-    } else {
-        connected = false;
-        
-        // Intentar reconectar
-        unsigned long now = millis();
-        
-        // Verificar timeout total (sin conexión por >5 min = reinicio forzado)
-        if (lastSuccessfulConnection > 0) {
-            unsigned long timeSinceLastConnection = now - lastSuccessfulConnection;
-            if (timeSinceLastConnection >= RECONNECT_TIMEOUT) {
-                Logger::logf(LOG_LEVEL_WARN, 
-                           "MQTT desconectado por %lu ms (>%lu ms), forzando reinicio", 
-                           timeSinceLastConnection, RECONNECT_TIMEOUT);
-                delay(1000);
-                ESP.restart();
-            }
-        }
+        recovery.update(lastSuccessfulConnection, true);
+        reportRecovery();
+        return;
+    }
+    
+    connected = false;
+    unsigned long now = millis();
+    
+    // Sin conexión por mucho tiempo: escalar un nivel (cada uno una vez por caída)
+    RecoveryTier tier = recovery.update(now, false);
+    if (tier != RECOVERY_NONE) {
+        applyRecovery(tier, recovery.getOfflineMs(now));
+    }
+    
+    // Avanzar la conexión un paso (la sesión perdida vuelve sola a BACKOFF)
+    connect();
+    MqttConnectState previous = connector.getState();
+    MqttConnectState state = connector.tick(now);
+    
+    if (state == MQTT_CONN_READY) {
+        completeConnection();
+    } else if (state == MQTT_CONN_BACKOFF && previous != MQTT_CONN_BACKOFF) {
+        if (connector.getLastError() == MQTT_CONN_ERR_NO_WIFI) return;
         
-        if (now - lastConnectionAttempt >= RECONNECT_DELAY) {
-            if (reconnectAttempts < MAX_TOTAL_ATTEMPTS) {
-                Logger::logf(LOG_LEVEL_INFO, 
-                           "Reintentando conexión MQTT (intento %d/%d)...", 
-                           reconnectAttempts + 1, MAX_TOTAL_ATTEMPTS);
-                connect();
+        reconnectAttempts = connector.getFailedAttempts();
+        LOG_ERROR("Fallo conexión MQTT (error %d, rc %d), intento %d, reintento en %lu ms", 
+                  connector.getLastError(), connector.getRefusedCode(),
+                  reconnectAttempts, (unsigned long)connector.getBackoffMs());
+    }
+}
+
+// ============================================================================
+// Recuperación escalonada
+// ============================================================================
+void MqttManager::applyRecovery(RecoveryTier tier, uint32_t offlineMs) {
+    LOG_WARN("MQTT sin conexión hace %lu ms: recuperación nivel %s",
+             (unsigned long)offlineMs, RECOVERY_TIER_NAMES[tier]);
+    
+    switch (tier) {
+        case RECOVERY_SOCKET:
+            // Socket nuevo y sin esperar el backoff en curso
+            forceReconnect();
+            break;
+            
+        case RECOVERY_WIFI:
+            if (recoveryCallback != nullptr) {
+                recoveryCallback(tier, offlineMs);
             } else {
-                // Demasiados intentos fallidos, forzar reinicio del ESP
-                Logger::logf(LOG_LEVEL_ERROR, 
-                           "MQTT: %d intentos fallidos, reiniciando ESP en 3 segundos...", 
-                           reconnectAttempts);
-                delay(3000);
-                ESP.restart();
+                WiFi.reconnect();
             }
-        }
+            forceReconnect();
+            break;
+            
+        case RECOVERY_RESTART:
+            // El dueño guarda los riegos en curso antes de reiniciar
+            if (recoveryCallback != nullptr) {
+                recoveryCallback(tier, offlineMs);
+            }
+            Logger::flush();
+            ESP.restart();
+            break;
+            
+        default:
+            break;
     }
 }
 
+void MqttManager::reportRecovery() {
+    RecoveryReport report;
+    if (!recovery.takeReport(report)) return;
+    
+    char detalles[96];
+    snprintf(detalles, sizeof(detalles), "nivel=%s recuperacion_ms=%lu sin_conexion_ms=%lu",
+             RECOVERY_TIER_NAMES[report.tier], (unsigned long)report.tierMs, (unsigned long)report.offlineMs);
+    LOG_INFO("MQTT recuperado: %s", detalles);
+    publishSystemEvent(SYS_MQTT_RECOVERY, detalles);
+}
+
+void MqttManager::resumeAfterRestart(uint32_t offlineMsBeforeRestart) {
+    recovery.resumeAfterRestart(offlineMsBeforeRestart);
+}
+
+void MqttManager::setRecoveryCallback(MqttRecoveryCallback callback) {
+    recoveryCallback = callback;
+}
+
+int32_t MqttManager::getMsUntilConnectStep() {
+    if (mqttClient == nullptr || mqttClient->connected()) return -1;
+    return connector.getMsUntilNextStep(millis());
+}
+
 // ============================================================================
 // Verificar conexión
 // ============================================================================
@@ -188,11 +292,39 @@ bool MqttManager::isConnected() {
 }
 
 // ============================================================================
-// Publicar estado de zona (legacy)
+// Topics precalculados
 // ============================================================================
-bool MqttManager::publishZoneStatus(int zona, bool estado, String origen) {
-    // Delegar a la versión con tiempo restante
-    return publishZoneStatus(zona, estado, 0);
+uint8_t MqttManager::buildTopic(char* out, const char* suffix) {
+    int len = snprintf(out, MQTT_TOPIC_MAX_LEN, "riego/%s/%s", nodeId.c_str(), suffix);
+    // Los topics de zona necesitan lugar para el número (hasta 2 dígitos)
+    if (len < 0 || len + 3 > MQTT_TOPIC_MAX_LEN) {
+        out[0] = '\0';
+        return 0;
+    }
+    return (uint8_t)len;
+}
+
+const char* MqttManager::zoneTopic(char* topic, uint8_t prefixLen, int zona) {
+    char* p = topic + prefixLen;
+    if (zona >= 10) {
+        *p++ = (char)('0' + (zona / 10) % 10);
+    }
+    *p++ = (char)('0' + zona % 10);
+    *p = '\0';
+    return topic;
+}
+
+// ============================================================================
+// Publicar el payload armado en payloadWriter
+// ============================================================================
+bool MqttManager::publishPayload(const char* topic) {
+    if (payloadWriter.overflowed() || topic[0] == '\0') {
+        LOG_ERROR("Payload MQTT descartado para [%s] (excede %d bytes o topic invalido)",
+                  topic, MQTT_PUBLISH_BUFFER_SIZE);
+        return false;
+    }
+    return mqttClient->publish(topic, (const uint8_t*)payloadWriter.c_str(),
+                               (unsigned int)payloadWriter.length(), false);
 }
 
 // ============================================================================
@@ -200,69 +332,58 @@ bool MqttManager::publishZoneStatus(int zona, bool estado, String origen) {
 // ============================================================================
 bool MqttManager::publishZoneStatus(int zona, bool estado, int tiempoRestante) {
     if (!isConnected()) return false;
+    if (zona < 1 || zona > MAX_ZONES) return false;
     
-    // Construir topic: riego/{NODE_ID}/status/zona/{zona}
-    char topic[128];
-    snprintf(topic, sizeof(topic), "riego/%s/status/zona/%d", nodeId.c_str(), zona);
-    
-    // Construir payload JSON con formato esperado por backend
+    // Topic: riego/{NODE_ID}/status/zona/{zona}
     // Backend espera: {"activa": true/false, "tiempoRestante": seconds}
-    StaticJsonDocument<JSON_BUFFER_SMALL> doc;
-    doc["activa"] = estado;
-    doc["tiempoRestante"] = tiempoRestante;
-    
-    char payload[JSON_BUFFER_SMALL];
-    serializeJson(doc, payload);
-    
-    bool result = mqttClient->publish(topic, payload, false);
+    MqttPayloads::zoneStatus(payloadWriter, estado, tiempoRestante);
+    bool result = publishPayload(zoneTopic(zoneStatusTopic, zoneStatusPrefixLen, zona));
     
     if (result) {
-        Logger::logf(LOG_LEVEL_DEBUG, "Publicado estado zona %d: %s", zona, payload);
+        LOG_DEBUG("Publicado estado zona %d: %s", zona, payloadWriter.c_str());
     } else {
-        Logger::logf(LOG_LEVEL_ERROR, "Fallo al publicar estado zona %d", zona);
+        LOG_ERROR("Fallo al publicar estado zona %d", zona);
     }
     
     return result;
 }
 
 // ============================================================================
-// Publicar evento de riego
+// Publicar estado agregado de todas las zonas
 // ============================================================================
-bool MqttManager::publishRiegoEvento(int zona, String evento, String origen, int duracion, int versionAgenda) {
+bool MqttManager::publishZonesStatus(uint32_t activas, const uint16_t* restante) {
     if (!isConnected()) return false;
     
-    // Construir topic: riego/{NODE_ID}/evento
-    char topic[128];
-    snprintf(topic, sizeof(topic), "riego/%s/evento", nodeId.c_str());
+    // Topic: riego/{NODE_ID}/status/zonas
+    // Backend espera: {"activas": mascara, "restante": [seg zona 1, ..., seg zona MAX_ZONES]}
+    MqttPayloads::zonesStatus(payloadWriter, activas, restante, MAX_ZONES);
+    bool result = publishPayload(zonesStatusTopic);
     
-    // Construir payload JSON
-    StaticJsonDocument<JSON_BUFFER_SMALL> doc;
-    doc["zona"] = zona;
-    doc["evento"] = evento; // "inicio" o "fin"
-    doc["timestamp"] = millis() / 1000; // timestamp en segundos (será reemplazado por NTP)
-    doc["origen"] = origen; // "agenda" o "manual"
-    
-    if (evento == "fin") {
-        doc["duracionReal"] = duracion;
-    } else {
-        doc["duracionProgramada"] = duracion;
-    }
-    
-    if (versionAgenda > 0) {
-        doc["versionAgenda"] = versionAgenda;
+    if (result) {
+        LOG_DEBUG("Publicado estado de zonas: %s", payloadWriter.c_str());
     } else {
-        doc["versionAgenda"] = nullptr;
+        LOG_ERROR("Fallo al publicar estado de zonas");
     }
     
-    char payload[JSON_BUFFER_SMALL];
-    serializeJson(doc, payload);
+    return result;
+}
+
+// ============================================================================
+// Publicar evento de riego
+// ============================================================================
+bool MqttManager::publishRiegoEvento(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion,
+                                     int versionAgenda, uint32_t timestamp, uint32_t seq) {
+    if (!isConnected()) return false;
     
-    bool result = mqttClient->publish(topic, payload, false);
+    // Topic: riego/{NODE_ID}/evento
+    MqttPayloads::riegoEvento(payloadWriter, zona, evento, origen, timestamp, duracion, versionAgenda, seq);
+    bool result = publishPayload(riegoEventoTopic);
     
     if (result) {
-        Logger::logf(LOG_LEVEL_INFO, "Publicado evento riego zona %d: %s (%s)", zona, evento.c_str(), origen.c_str());
+        LOG_INFO("Publicado evento riego zona %d: %s (%s, seq %lu)", zona,
+                 riegoEventoName(evento), riegoOrigenName(origen), (unsigned long)seq);
     } else {
-        Logger::logf(LOG_LEVEL_ERROR, "Fallo al publicar evento zona %d", zona);
+        LOG_ERROR("Fallo al publicar evento zona %d", zona);
     }
     
     return result;
@@ -271,35 +392,37 @@ bool MqttManager::publishRiegoEvento(int zona, String evento, String origen, int
 // ============================================================================
 // Publicar evento del sistema
 // ============================================================================
-bool MqttManager::publishSystemEvent(String tipoEvento, String detalles, int agendasCargadas) {
+bool MqttManager::publishSystemEvent(SystemEvent tipo, const char* detalles, int agendasCargadas) {
     if (!isConnected()) return false;
     
-    // Construir topic: riego/{NODE_ID}/sistema/evento
-    char topic[128];
-    snprintf(topic, sizeof(topic), "riego/%s/sistema/evento", nodeId.c_str());
+    // Topic: riego/{NODE_ID}/sistema/evento
+    // Incluye memoria libre para diagnóstico
+    MqttPayloads::systemEvent(payloadWriter, tipo, millis() / 1000, detalles, agendasCargadas, ESP.getFreeHeap());
+    bool result = publishPayload(sistemaEventoTopic);
     
-    // Construir payload JSON
-    StaticJsonDocument<JSON_BUFFER_MEDIUM> doc;
-    doc["tipo"] = tipoEvento;
-    doc["timestamp"] = millis() / 1000;
-    doc["detalles"] = detalles;
-    
-    if (agendasCargadas >= 0) {
-        doc["agendasCargadas"] = agendasCargadas;
+    if (result) {
+        LOG_INFO("Publicado evento sistema: %s - %s", systemEventName(tipo), detalles);
+    } else {
+        LOG_ERROR("Fallo al publicar evento sistema: %s", systemEventName(tipo));
     }
     
-    // Agregar info de memoria para diagnóstico
-    doc["memoriaLibre"] = ESP.getFreeHeap();
-    
-    char payload[JSON_BUFFER_MEDIUM];
-    serializeJson(doc, payload);
+    return result;
+}
+
+// ============================================================================
+// Reportar versión de agenda (sync delta)
+// ============================================================================
+bool MqttManager::publishAgendaVersion(int32_t version) {
+    if (!isConnected()) return false;
     
-    bool result = mqttClient->publish(topic, payload, false);
+    // Topic: riego/{NODE_ID}/agenda/version
+    MqttPayloads::agendaVersion(payloadWriter, version);
+    bool result = publishPayload(agendaVersionTopic);
     
     if (result) {
-        Logger::logf(LOG_LEVEL_INFO, "Publicado evento sistema: %s - %s", tipoEvento.c_str(), detalles.c_str());
+        LOG_INFO("Publicada version de agenda: %ld", (long)version);
     } else {
-        Logger::logf(LOG_LEVEL_ERROR, "Fallo al publicar evento sistema: %s", tipoEvento.c_str());
+        LOG_ERROR("Fallo al publicar version de agenda");
     }
     
     return result;
@@ -310,25 +433,16 @@ bool MqttManager::publishSystemEvent(String tipoEvento, String detalles, int age
 // ============================================================================
 bool MqttManager::publishTelemetry(int zona, int humedad) {
     if (!isConnected()) return false;
+    if (zona < 1 || zona > MAX_ZONES) return false;
     
-    // Construir topic: riego/{NODE_ID}/humedad/zona/{zona}
-    char topic[128];
-    snprintf(topic, sizeof(topic), "riego/%s/humedad/zona/%d", nodeId.c_str(), zona);
-    
-    // Construir payload JSON
-    StaticJsonDocument<JSON_BUFFER_SMALL> doc;
-    doc["humedad"] = humedad;
-    doc["uptime"] = millis() / 1000;
-    
-    char payload[JSON_BUFFER_SMALL];
-    serializeJson(doc, payload);
-    
-    bool result = mqttClient->publish(topic, payload, false);
+    // Topic: riego/{NODE_ID}/humedad/zona/{zona}
+    MqttPayloads::telemetry(payloadWriter, humedad, millis() / 1000);
+    bool result = publishPayload(zoneTopic(humidityTopic, humidityPrefixLen, zona));
     
     if (result) {
-        Logger::logf(LOG_LEVEL_DEBUG, "Publicada telemetría zona %d: %d%%", zona, humedad);
+        LOG_DEBUG("Publicada telemetría zona %d: %d%%", zona, humedad);
     } else {
-        Logger::logf(LOG_LEVEL_ERROR, "Fallo al publicar telemetría zona %d", zona);
+        LOG_ERROR("Fallo al publicar telemetría zona %d", zona);
     }
     
     return result;
@@ -337,21 +451,45 @@ bool MqttManager::publishTelemetry(int zona, int humedad) {
 // ============================================================================
 // Publicar estado del sistema
 // ============================================================================
-bool MqttManager::publishSystemStatus(String status) {
+bool MqttManager::publishSystemStatus(const char* status) {
     if (!isConnected()) return false;
     
-    char topic[128];
-    snprintf(topic, sizeof(topic), "riego/%s/status/system", nodeId.c_str());
+    MqttPayloads::systemStatus(payloadWriter, status, millis() / 1000, ESP.getFreeHeap());
+    return publishPayload(systemStatusTopic);
+}
+
+// ============================================================================
+// Publicar líneas del log remoto
+// ============================================================================
+bool MqttManager::publishLog(const char* payload, size_t length) {
+    return publishIfRoom(logTopic, payload, length);
+}
+
+// ============================================================================
+// Publicar perfil del loop
+// ============================================================================
+bool MqttManager::publishLoopProfile(const LoopProfiler& profiler, uint32_t ventanaMs) {
+    if (!isConnected()) return false;
     
-    StaticJsonDocument<JSON_BUFFER_MEDIUM> doc;
-    doc["status"] = status;
-    doc["uptime"] = millis() / 1000;
-    doc["freeHeap"] = ESP.getFreeHeap();
+    // Más grande que publishBuffer: va en la pila solo mientras se publica
+    char buffer[LOOP_PROFILER_PAYLOAD_MAX];
+    JsonWriter writer(buffer, sizeof(buffer));
+    MqttPayloads::loopProfile(writer, profiler, ventanaMs);
+    if (writer.overflowed()) {
+        LOG_WARN("Perfil del loop: no entra en %d bytes", LOOP_PROFILER_PAYLOAD_MAX);
+        return false;
+    }
+    return publishIfRoom(loopProfileTopic, writer.c_str(), writer.length());
+}
+
+bool MqttManager::publishIfRoom(const char* topic, const char* payload, size_t length) {
+    if (!isConnected() || topic[0] == '\0') return false;
     
-    char payload[JSON_BUFFER_MEDIUM];
-    serializeJson(doc, payload);
+    // PUBLISH entero: encabezado (hasta 5 bytes), largo y texto del topic, payload
+    size_t packet = 5 + 2 + strlen(topic) + length;
+    if (connector.availableForWrite() < (int)packet) return false;
     
-    return mqttClient->publish(topic, payload, false);
+    return mqttClient->publish(topic, (const uint8_t*)payload, (unsigned int)length, false);
 }
 
 // ============================================================================
@@ -360,16 +498,16 @@ bool MqttManager::publishSystemStatus(String status) {
 bool MqttManager::subscribeToCommands() {
     if (!isConnected()) return false;
     
-    Logger::logf(LOG_LEVEL_INFO, "Suscribiendo a: %s", cmdTopicPattern.c_str());
+    LOG_INFO("Suscribiendo a: %s", cmdTopicPattern);
     
     // Suscribirse a comandos de todas las zonas
     // Pattern: riego/{NODE_ID}/cmd/zona/+
-    bool result = mqttClient->subscribe(cmdTopicPattern.c_str(), MQTT_QOS);
+    bool result = mqttClient->subscribe(cmdTopicPattern, MQTT_QOS);
     
     if (result) {
-        Logger::info("Suscripción a comandos exitosa");
+        LOG_INFO("Suscripción a comandos exitosa");
     } else {
-        Logger::error("Fallo al suscribirse a comandos");
+        LOG_ERROR("Fallo al suscribirse a comandos");
     }
     
     return result;
@@ -381,19 +519,32 @@ bool MqttManager::subscribeToCommands() {
 bool MqttManager::subscribeToAgendaSync() {
     if (!isConnected()) return false;
     
-    Logger::logf(LOG_LEVEL_INFO, "Suscribiendo a: %s", agendaSyncTopic.c_str());
+    LOG_INFO("Suscribiendo a: %s", agendaSyncTopic);
     
-    bool result = mqttClient->subscribe(agendaSyncTopic.c_str(), MQTT_QOS);
+    bool result = mqttClient->subscribe(agendaSyncTopic, MQTT_QOS);
     
     if (result) {
-        Logger::info("Suscripción a agenda sync exitosa");
+        LOG_INFO("Suscripción a agenda sync exitosa");
     } else {
-        Logger::error("Fallo al suscribirse a agenda sync");
+        LOG_ERROR("Fallo al suscribirse a agenda sync");
     }
     
     return result;
 }
 
+// ============================================================================
+// Suscribir al nivel del log remoto
+// ============================================================================
+bool MqttManager::subscribeToLogLevel() {
+    if (!isConnected()) return false;
+    
+    bool result = mqttClient->subscribe(logLevelTopic, MQTT_QOS);
+    if (!result) {
+        LOG_ERROR("Fallo al suscribirse a %s", logLevelTopic);
+    }
+    return result;
+}
+
 // ============================================================================
 // Registrar callbacks
 // ============================================================================
@@ -405,6 +556,10 @@ void MqttManager::setAgendaSyncCallback(MqttAgendaSyncCallback callback) {
     agendaSyncCallback = callback;
 }
 
+void MqttManager::setLogLevelCallback(MqttLogLevelCallback callback) {
+    logLevelCallback = callback;
+}
+
 // ============================================================================
 // Callback estático MQTT
 // ============================================================================
@@ -418,39 +573,46 @@ void MqttManager::messageCallback(char* topic, byte* payload, unsigned int lengt
 // Procesar mensaje recibido
 // ============================================================================
 void MqttManager::handleMessage(char* topic, byte* payload, unsigned int length) {
-    // Convertir payload a String
-    char message[length + 1];
-    memcpy(message, payload, length);
-    message[length] = '\0';
+    // `payload` es el buffer de PubSubClient (truncado a MQTT_BUFFER_SIZE);
+    // el payload completo quedó en payloadSpool
+    size_t fullLength = payloadSpool.length();
     
-    Logger::logf(LOG_LEVEL_INFO, "Mensaje MQTT recibido en [%s]: %s", topic, message);
+    LOG_INFO("Mensaje MQTT recibido en [%s] (%u bytes)", topic, (unsigned)fullLength);
     
     String topicStr = String(topic);
     
     // Debug: mostrar análisis del topic
-    Logger::logf(LOG_LEVEL_DEBUG, "Analizando topic: %s", topicStr.c_str());
+    LOG_DEBUG("Analizando topic: %s", topicStr.c_str());
     
     // Verificar si es comando de zona
     if (topicStr.indexOf("/cmd/zona/") >= 0) {
-        Logger::debug("Detectado como comando de zona");
+        LOG_DEBUG("Detectado como comando de zona");
+        payloadSpool.discard();
+        
+        if (fullLength > length) {
+            LOG_ERROR("Comando de %u bytes excede el buffer MQTT (%d)", (unsigned)fullLength, MQTT_BUFFER_SIZE);
+            return;
+        }
+        LOG_DEBUG("Payload: %.*s", (int)length, (const char*)payload);
+        
         // Extraer número de zona del topic
         int lastSlash = topicStr.lastIndexOf('/');
         int zona = topicStr.substring(lastSlash + 1).toInt();
         
-        // Parsear JSON
+        // Parsear JSON directo desde el buffer de PubSubClient
         StaticJsonDocument<JSON_BUFFER_SMALL> doc;
-        DeserializationError error = deserializeJson(doc, message);
+        DeserializationError error = deserializeJson(doc, (const char*)payload, length);
         
         if (error) {
-            Logger::logf(LOG_LEVEL_ERROR, "Error parseando JSON: %s", error.c_str());
+            LOG_ERROR("Error parseando JSON: %s", error.c_str());
             return;
         }
         
         String accion = doc["accion"] | "OFF";
         int duracion = doc["duracion"] | 0;
         
-        Logger::logf(LOG_LEVEL_INFO, "Comando zona %d: %s, duración: %d seg", 
-                   zona, accion.c_str(), duracion);
+        LOG_INFO("Comando zona %d: %s, duración: %d seg", 
+                 zona, accion.c_str(), duracion);
         
         // Llamar callback si está registrado
         if (commandCallback != nullptr) {
@@ -459,18 +621,41 @@ void MqttManager::handleMessage(char* topic, byte* payload, unsigned int length)
     }
     // Verificar si es sincronización de agenda
     else if (topicStr.indexOf("/agenda/sync") >= 0) {
-        Logger::info("Detectado como sincronizacion de agenda");
+        LOG_INFO("Detectado como sincronizacion de agenda");
         
-        // Llamar callback si está registrado
-        if (agendaSyncCallback != nullptr) {
-            Logger::info("Ejecutando callback de agenda sync");
-            agendaSyncCallback(String(message));
-        } else {
-            Logger::warn("Callback de agenda sync no registrado");
+        if (agendaSyncCallback == nullptr) {
+            LOG_WARN("Callback de agenda sync no registrado");
+            payloadSpool.discard();
+            return;
+        }
+        
+        if (!payloadSpool.commit()) {
+            String detalles = payloadSpool.isOverflow()
+                ? String("Agenda de ") + fullLength + " bytes excede el maximo (" + AGENDA_SYNC_MAX_BYTES + " bytes)"
+                : String("Error al escribir agenda en flash (") + fullLength + " bytes)";
+            LOG_ERROR("%s", detalles.c_str());
+            publishSystemEvent(SYS_AGENDA_STORAGE_ERROR, detalles.c_str(), 0);
+            return;
+        }
+        
+        LOG_INFO("Ejecutando callback de agenda sync");
+        agendaSyncCallback(payloadSpool.getPath(), fullLength);
+    }
+    // Nivel del log remoto ("DEBUG", "INFO", ..., "OFF" o el número)
+    else if (strcmp(topic, logLevelTopic) == 0) {
+        payloadSpool.discard();
+        int level = LogStreamer::parseLevel((const char*)payload, fullLength > length ? 0 : length);
+        if (level < 0) {
+            LOG_WARN("Nivel de log remoto invalido: %.*s", (int)length, (const char*)payload);
+            return;
+        }
+        if (logLevelCallback != nullptr) {
+            logLevelCallback((uint8_t)level);
         }
     }
     else {
-        Logger::logf(LOG_LEVEL_WARN, "Topic desconocido: %s", topicStr.c_str());
+        payloadSpool.discard();
+        LOG_WARN("Topic desconocido: %s", topicStr.c_str());
     }
 }
 
@@ -478,11 +663,11 @@ void MqttManager::handleMessage(char* topic, byte* payload, unsigned int length)
 // Forzar reconexión
 // ============================================================================
 void MqttManager::forceReconnect() {
-    Logger::info("Forzando reconexión MQTT...");
+    LOG_INFO("Forzando reconexión MQTT...");
     disconnect();
     reconnectAttempts = 0;
-    delay(1000);
-    connect();
+    lastConnectionAttempt = millis();
+    connector.retryNow(lastConnectionAttempt);
 }
 
 // ============================================================================
@@ -510,9 +695,20 @@ String MqttManager::getClientId() {
 void MqttManager::printInfo() {
     Serial.println("\n=== Información MQTT ===");
     Serial.printf("Broker: %s:%d\n", brokerHost.c_str(), brokerPort);
-    Serial.printf("Client ID: %s\n", getClientId().c_str());
+    Serial.printf("Client ID: %s\n", clientId.c_str());
     Serial.printf("Node ID: %s\n", nodeId.c_str());
     Serial.printf("Conectado: %s\n", isConnected() ? "SI" : "NO");
+    if (!isConnected()) {
+        Serial.printf("Conexión: %s (fallos seguidos: %u)\n",
+                      MQTT_CONNECT_STATE_NAMES[connector.getState()], connector.getFailedAttempts());
+    }
+    for (int tier = RECOVERY_NONE; tier < RECOVERY_TIER_COUNT; tier++) {
+        const RecoveryStats& stats = recovery.getStats((RecoveryTier)tier);
+        if (stats.count == 0) continue;
+        Serial.printf("Recuperaciones por %s: %u (ultima %lu ms, max %lu ms, prom %lu ms)\n",
+                      RECOVERY_TIER_NAMES[tier], stats.count, (unsigned long)stats.lastMs,
+                      (unsigned long)stats.maxMs, (unsigned long)(stats.totalMs / stats.count));
+    }
     if (isConnected()) {
         Serial.printf("Tiempo conectado: %lu s\n", getTimeSinceLastConnection() / 1000);
     }
@@ -525,10 +721,10 @@ void MqttManager::printInfo() {
 void MqttManager::onConnected() {
     connected = true;
     lastSuccessfulConnection = millis();
-    Logger::info("MQTT conectado exitosamente");
+    LOG_INFO("MQTT conectado exitosamente");
 }
 
 void MqttManager::onDisconnected() {
     connected = false;
-    Logger::warn("MQTT desconectado");
+    LOG_WARN("MQTT desconectado");
 }
@@ -7,27 +7,54 @@
 #include <ArduinoJson.h>
 #include "../config/Config.h"
 #include "../config/Secrets.h"
+#include "../config/EventTypes.h"
 #include "../utils/Logger.h"
+#include "../utils/JsonWriter.h"
+#include "ConnectionRecovery.h"
+#include "MqttConnector.h"
+#include "MqttPayloadSpool.h"
+#include "MqttPayloads.h"
 
 // ============================================================================
 // MqttManager - Gestión de comunicación MQTT
 // ============================================================================
 // Maneja la conexión al broker MQTT, suscripción a topics, publicación de
 // mensajes y procesamiento de comandos recibidos.
+// Las publicaciones no reservan heap: los topics se arman una vez en init()
+// (los de zona guardan el prefijo y solo reescriben el número) y el payload
+// se escribe con JsonWriter en publishBuffer.
+// La conexión no bloquea: MqttConnector avanza resolución, TCP y CONNACK
+// desde loop() y recién entonces PubSubClient toma la sesión. Si la sesión
+// no vuelve, ConnectionRecovery escala (socket, WiFi, reinicio con riegos
+// guardados) en lugar de reiniciar el ESP de una.
+// El log remoto (LogStreamer) publica por publishLog() desde el loop
+// principal: solo si el socket tiene lugar para el mensaje entero, así nunca
+// bloquea ni demora las publicaciones de estado. El perfil del loop
+// (publishLoopProfile) sale por el mismo camino.
 
 // Forward declaration para callback
 typedef void (*MqttCommandCallback)(int zona, String accion, int duracion);
-typedef void (*MqttAgendaSyncCallback)(String payload);
+// Agenda sync: payload completo ya escrito en `path` (AGENDA_SYNC_TEMP_FILE)
+typedef void (*MqttAgendaSyncCallback)(const char* path, size_t length);
+// Niveles de recuperación que ejecuta el dueño (RECOVERY_WIFI, RECOVERY_RESTART)
+typedef void (*MqttRecoveryCallback)(RecoveryTier tier, uint32_t offlineMs);
+// Nivel del log remoto pedido en riego/{id}/log/nivel (LOG_LEVEL_NONE..DEBUG)
+typedef void (*MqttLogLevelCallback)(uint8_t level);
 
 class MqttManager {
 private:
     WiFiClient espClient;
+    MqttConnector connector;     // Transporte de PubSubClient (envuelve espClient)
     PubSubClient* mqttClient;
+    
+    // Payload de los PUBLISH recibidos (en streaming, sin copiarlo a RAM)
+    MqttPayloadSpool payloadSpool;
     String brokerHost;
     uint16_t brokerPort;
     String brokerUser;
     String brokerPassword;
     String nodeId;
+    String clientId;             // Armado en init(); connector guarda el puntero
     
     // Estado de conexión
     bool connected;
@@ -35,19 +62,36 @@ private:
     unsigned long lastSuccessfulConnection;
     int reconnectAttempts;
     
-    // Control de reconexión
-    static const int MAX_RECONNECT_ATTEMPTS = 5;
-    static const unsigned long RECONNECT_DELAY = 15000; // 15 segundos
-    static const int MAX_TOTAL_ATTEMPTS = 20;  // 20 intentos antes de reinicio (100 segundos aprox)
-    static const unsigned long RECONNECT_TIMEOUT = 300000; // 5 minutos sin conectar = reinicio forzado
+    // Recuperación escalonada (la espera entre intentos la decide el backoff de connector)
+    ConnectionRecovery recovery;
     
     // Topics suscritos
-    String cmdTopicPattern;
-    String agendaSyncTopic;
+    char cmdTopicPattern[MQTT_TOPIC_MAX_LEN];
+    char agendaSyncTopic[MQTT_TOPIC_MAX_LEN];
+    char logLevelTopic[MQTT_TOPIC_MAX_LEN];
+    
+    // Topics de publicación (armados en init())
+    char riegoEventoTopic[MQTT_TOPIC_MAX_LEN];
+    char sistemaEventoTopic[MQTT_TOPIC_MAX_LEN];
+    char agendaVersionTopic[MQTT_TOPIC_MAX_LEN];
+    char systemStatusTopic[MQTT_TOPIC_MAX_LEN];
+    char zonesStatusTopic[MQTT_TOPIC_MAX_LEN];
+    char zoneStatusTopic[MQTT_TOPIC_MAX_LEN];   // "riego/{id}/status/zona/" + número
+    char humidityTopic[MQTT_TOPIC_MAX_LEN];     // "riego/{id}/humedad/zona/" + número
+    char logTopic[MQTT_TOPIC_MAX_LEN];
+    char loopProfileTopic[MQTT_TOPIC_MAX_LEN];
+    uint8_t zoneStatusPrefixLen;
+    uint8_t humidityPrefixLen;
+    
+    // Buffer reutilizable para el payload saliente
+    char publishBuffer[MQTT_PUBLISH_BUFFER_SIZE];
+    JsonWriter payloadWriter;
     
     // Callbacks para eventos
     MqttCommandCallback commandCallback;
     MqttAgendaSyncCallback agendaSyncCallback;
+    MqttRecoveryCallback recoveryCallback;
+    MqttLogLevelCallback logLevelCallback;
     
     // Procesar mensaje MQTT recibido
     static void messageCallback(char* topic, byte* payload, unsigned int length);
@@ -61,6 +105,25 @@ private:
     // Construir client ID único
     String getClientId();
     
+    // Armar "riego/{nodeId}/{suffix}" en `out` (devuelve la longitud, 0 si no entra)
+    uint8_t buildTopic(char* out, const char* suffix);
+    
+    // Reescribir el número de zona tras el prefijo de un topic de zona
+    static const char* zoneTopic(char* topic, uint8_t prefixLen, int zona);
+    
+    // Publicar el payload de payloadWriter
+    bool publishPayload(const char* topic);
+    
+    // Publicar sin bloquear: false si el socket no tiene lugar para el PUBLISH entero
+    bool publishIfRoom(const char* topic, const char* payload, size_t length);
+    
+    // Traspasar a PubSubClient la conexión abierta por connector
+    bool completeConnection();
+    
+    // Ejecutar un nivel de recuperación / informar una recuperación cerrada
+    void applyRecovery(RecoveryTier tier, uint32_t offlineMs);
+    void reportRecovery();
+    
     // Callback interno
     void onConnected();
     void onDisconnected();
@@ -83,7 +146,8 @@ public:
     // Obtener Node ID activo
     String getNodeId();
     
-    // Conectar al broker MQTT (bloqueante con timeout)
+    // Pedir conexión al broker (no bloquea: avanza en loop()). Devuelve
+    // true si ya estaba conectado
     bool connect();
     
     // Desconectar del broker
@@ -95,21 +159,29 @@ public:
     // Verificar si está conectado
     bool isConnected();
     
-    // Publicar estado de zona
-    bool publishZoneStatus(int zona, bool estado, String origen);
+    // Publicar estado de zona con tiempo restante
     bool publishZoneStatus(int zona, bool estado, int tiempoRestante);
     
-    // Publicar evento de riego (inicio/fin)
-    bool publishRiegoEvento(int zona, String evento, String origen, int duracion, int versionAgenda = 0);
+    // Publicar estado de todas las zonas en un solo mensaje (máscara de
+    // activas + tiempo restante por zona, MAX_ZONES valores)
+    bool publishZonesStatus(uint32_t activas, const uint16_t* restante);
+    
+    // Publicar evento de riego (inicio/fin) con su timestamp (epoch UTC) y
+    // secuencia del diario de eventos
+    bool publishRiegoEvento(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion,
+                            int versionAgenda, uint32_t timestamp, uint32_t seq);
     
     // Publicar evento del sistema (agenda sync, errores, etc)
-    bool publishSystemEvent(String tipoEvento, String detalles, int agendasCargadas = -1);
+    bool publishSystemEvent(SystemEvent tipo, const char* detalles, int agendasCargadas = -1);
+    
+    // Reportar versión local de agenda (el backend responde con delta o lista completa)
+    bool publishAgendaVersion(int32_t version);
     
     // Publicar telemetría (humedad, uptime, etc)
     bool publishTelemetry(int zona, int humedad);
     
     // Publicar estado general del sistema
-    bool publishSystemStatus(String status);
+    bool publishSystemStatus(const char* status);
     
     // Suscribir a comandos
     bool subscribeToCommands();
@@ -117,15 +189,42 @@ public:
     // Suscribir a sincronización de agendas
     bool subscribeToAgendaSync();
     
+    // Suscribir al nivel del log remoto
+    bool subscribeToLogLevel();
+    
+    // Publicar líneas del log remoto (sin loguear). false si no hay sesión o
+    // el socket no tiene lugar para el mensaje completo
+    bool publishLog(const char* payload, size_t length);
+    
+    // Publicar el perfil del loop en riego/{id}/diagnostico/loop (mismas
+    // condiciones que publishLog: no bloquea esperando lugar en el socket)
+    bool publishLoopProfile(const LoopProfiler& profiler, uint32_t ventanaMs);
+    
     // Registrar callback para comandos recibidos
     void setCommandCallback(MqttCommandCallback callback);
     
     // Registrar callback para sincronización de agendas
     void setAgendaSyncCallback(MqttAgendaSyncCallback callback);
     
+    // Registrar callback para los niveles WiFi y reinicio (sin callback se
+    // reasocia con WiFi.reconnect() y se reinicia sin guardar estado)
+    void setRecoveryCallback(MqttRecoveryCallback callback);
+    
+    // Registrar callback para el nivel del log remoto
+    void setLogLevelCallback(MqttLogLevelCallback callback);
+    
+    // Arranque tras un reinicio de recuperación: la caída sigue abierta
+    void resumeAfterRestart(uint32_t offlineMsBeforeRestart);
+    
+    // Tiempos de recuperación por nivel
+    const ConnectionRecovery& getRecovery() const { return recovery; }
+    
     // Forzar reconexión
     void forceReconnect();
     
+    // ms hasta el próximo paso de conexión pendiente (-1 si no hay)
+    int32_t getMsUntilConnectStep();
+    
     // Obtener tiempo desde última conexión (ms)
     unsigned long getTimeSinceLastConnection();
     
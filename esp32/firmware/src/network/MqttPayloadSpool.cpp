@@ -0,0 +1,120 @@
+#include "MqttPayloadSpool.h"
+#include <LittleFS.h>
+#include "../utils/Logger.h"
+
+// ============================================================================
+// Constructor
+// ============================================================================
+MqttPayloadSpool::MqttPayloadSpool(const char* path, size_t maxBytes) {
+    this->path = path;
+    this->maxBytes = maxBytes;
+    chunkLength = 0;
+    totalLength = 0;
+    overflow = false;
+    writeError = false;
+}
+
+// ============================================================================
+// Ciclo por mensaje
+// ============================================================================
+void MqttPayloadSpool::reset() {
+    if (file) {
+        file.close();
+    }
+    chunkLength = 0;
+    totalLength = 0;
+    overflow = false;
+    writeError = false;
+}
+
+bool MqttPayloadSpool::commit() {
+    if (overflow || writeError || !flushChunk()) {
+        discard();
+        return false;
+    }
+    
+    if (!file) {
+        // Payload vacío: crear el archivo igualmente para que la validación lo rechace
+        file = LittleFS.open(path, "w");
+        if (!file) {
+            writeError = true;
+            return false;
+        }
+    }
+    
+    file.close();
+    return true;
+}
+
+void MqttPayloadSpool::discard() {
+    bool opened = (bool)file;
+    reset();
+    if (opened) {
+        LittleFS.remove(path);
+    }
+}
+
+// ============================================================================
+// Escritura
+// ============================================================================
+bool MqttPayloadSpool::flushChunk() {
+    if (chunkLength == 0) return true;
+    
+    if (!file) {
+        file = LittleFS.open(path, "w");
+        if (!file) {
+            LOG_ERROR("No se pudo crear %s para payload MQTT", path);
+            writeError = true;
+            return false;
+        }
+    }
+    
+    size_t written = file.write(chunk, chunkLength);
+    if (written != chunkLength) {
+        LOG_ERROR("Escritura incompleta en %s (%u/%u bytes)",
+                  path, (unsigned)written, (unsigned)chunkLength);
+        writeError = true;
+        return false;
+    }
+    
+    chunkLength = 0;
+    return true;
+}
+
+size_t MqttPayloadSpool::write(uint8_t c) {
+    totalLength++;
+    if (overflow || writeError) return 1;
+    
+    if (totalLength > maxBytes) {
+        overflow = true;
+        return 1;
+    }
+    
+    chunk[chunkLength++] = c;
+    if (chunkLength == sizeof(chunk)) {
+        flushChunk();
+    }
+    return 1;
+}
+
+size_t MqttPayloadSpool::write(const uint8_t* buffer, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        write(buffer[i]);
+    }
+    return size;
+}
+
+// ============================================================================
+// Getters
+// ============================================================================
+size_t MqttPayloadSpool::length() const {
+    return totalLength;
+}
+
+bool MqttPayloadSpool::isOverflow() const {
+    return overflow;
+}
+
+const char* MqttPayloadSpool::getPath() const {
+    return path;
+}
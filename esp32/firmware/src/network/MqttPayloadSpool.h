@@ -0,0 +1,64 @@
+#ifndef MQTT_PAYLOAD_SPOOL_H
+#define MQTT_PAYLOAD_SPOOL_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "../config/Config.h"
+
+// ============================================================================
+// MqttPayloadSpool - Recepción de payloads MQTT grandes directo a flash
+// ============================================================================
+// Se registra con PubSubClient::setStream(): el cliente escribe aquí cada byte
+// del payload de los PUBLISH recibidos, sin importar el tamaño de su buffer.
+// Los bytes se juntan en un bloque de AGENDA_SYNC_CHUNK_SIZE y solo se abre
+// el archivo cuando el payload supera ese bloque, así los comandos chicos no
+// escriben en flash. La RAM usada es fija (un bloque).
+//
+// Ciclo por mensaje: reset() antes de PubSubClient::loop(), y en el callback
+// commit() (el mensaje va al archivo) o discard() (se descarta).
+
+class MqttPayloadSpool : public Stream {
+private:
+    const char* path;
+    size_t maxBytes;
+    uint8_t chunk[AGENDA_SYNC_CHUNK_SIZE];
+    size_t chunkLength;
+    size_t totalLength;
+    File file;
+    bool overflow;
+    bool writeError;
+    
+    // Volcar el bloque pendiente al archivo (abriéndolo si hace falta)
+    bool flushChunk();
+
+public:
+    MqttPayloadSpool(const char* path, size_t maxBytes);
+    
+    // Descartar el mensaje anterior (llamar antes de PubSubClient::loop())
+    void reset();
+    
+    // Cerrar el mensaje actual en el archivo. false si excedió maxBytes o
+    // falló la escritura (el archivo parcial se elimina).
+    bool commit();
+    
+    // Descartar el mensaje actual (elimina el archivo si se llegó a abrir)
+    void discard();
+    
+    // Bytes recibidos del mensaje actual (incluye los que excedieron maxBytes)
+    size_t length() const;
+    bool isOverflow() const;
+    const char* getPath() const;
+    
+    // Print
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    
+    // Stream (solo escritura)
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override {}
+};
+
+#endif // MQTT_PAYLOAD_SPOOL_H
@@ -0,0 +1,100 @@
+#include "MqttPayloads.h"
+
+// ============================================================================
+// Estado de zona
+// ============================================================================
+void MqttPayloads::zoneStatus(JsonWriter& out, bool activa, int32_t tiempoRestante) {
+    out.begin();
+    out.fieldBool("activa", activa);
+    out.fieldInt("tiempoRestante", tiempoRestante);
+    out.end();
+}
+
+// ============================================================================
+// Estado agregado de todas las zonas
+// ============================================================================
+void MqttPayloads::zonesStatus(JsonWriter& out, uint32_t activas, const uint16_t* restante, uint8_t zonas) {
+    out.begin();
+    out.fieldUInt("activas", activas);
+    out.fieldUIntArray("restante", restante, zonas);
+    out.end();
+}
+
+// ============================================================================
+// Evento de riego
+// ============================================================================
+void MqttPayloads::riegoEvento(JsonWriter& out, int zona, RiegoEvento evento, RiegoOrigen origen,
+                               uint32_t timestamp, int32_t duracion, int32_t versionAgenda, uint32_t seq) {
+    out.begin();
+    out.fieldInt("zona", zona);
+    out.fieldString("evento", riegoEventoName(evento));
+    out.fieldUInt("timestamp", timestamp);
+    out.fieldString("origen", riegoOrigenName(origen));
+    out.fieldInt(evento == RIEGO_FIN ? "duracionReal" : "duracionProgramada", duracion);
+    if (versionAgenda > 0) {
+        out.fieldInt("versionAgenda", versionAgenda);
+    } else {
+        out.fieldNull("versionAgenda");
+    }
+    if (seq > 0) {
+        out.fieldUInt("seq", seq);
+    }
+    out.end();
+}
+
+// ============================================================================
+// Evento del sistema
+// ============================================================================
+void MqttPayloads::systemEvent(JsonWriter& out, SystemEvent tipo, uint32_t timestamp,
+                               const char* detalles, int32_t agendasCargadas, uint32_t memoriaLibre) {
+    out.begin();
+    out.fieldString("tipo", systemEventName(tipo));
+    out.fieldUInt("timestamp", timestamp);
+    out.fieldString("detalles", detalles != nullptr ? detalles : "");
+    if (agendasCargadas >= 0) {
+        out.fieldInt("agendasCargadas", agendasCargadas);
+    }
+    out.fieldUInt("memoriaLibre", memoriaLibre);
+    out.end();
+}
+
+// ============================================================================
+// Versión de agenda, telemetría y estado del sistema
+// ============================================================================
+void MqttPayloads::agendaVersion(JsonWriter& out, int32_t version) {
+    out.begin();
+    out.fieldInt("version", version);
+    out.end();
+}
+
+void MqttPayloads::telemetry(JsonWriter& out, int32_t humedad, uint32_t uptime) {
+    out.begin();
+    out.fieldInt("humedad", humedad);
+    out.fieldUInt("uptime", uptime);
+    out.end();
+}
+
+void MqttPayloads::systemStatus(JsonWriter& out, const char* status, uint32_t uptime, uint32_t freeHeap) {
+    out.begin();
+    out.fieldString("status", status);
+    out.fieldUInt("uptime", uptime);
+    out.fieldUInt("freeHeap", freeHeap);
+    out.end();
+}
+
+// ============================================================================
+// Perfil del loop principal
+// ============================================================================
+void MqttPayloads::loopProfile(JsonWriter& out, const LoopProfiler& profiler, uint32_t ventanaMs) {
+    out.begin();
+    out.fieldUInt("ventanaMs", ventanaMs);
+    out.fieldUInt("lentas", profiler.getSlowLoops());
+    ProfileSummary summary;
+    for (uint8_t i = 0; i < PROF_CHANNELS; i++) {
+        profiler.summarize(i, summary);
+        if (summary.count == 0) continue;
+        uint32_t values[5] = {summary.count, summary.minUs, summary.p50Us, summary.p99Us, summary.maxUs};
+        out.fieldUIntArray(LoopProfiler::channelName(i), values, 5);
+    }
+    out.end();
+}
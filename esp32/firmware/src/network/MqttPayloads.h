@@ -0,0 +1,49 @@
+#ifndef MQTT_PAYLOADS_H
+#define MQTT_PAYLOADS_H
+
+#include <stdint.h>
+#include "../config/EventTypes.h"
+#include "../utils/JsonWriter.h"
+#include "../utils/LoopProfiler.h"
+
+// ============================================================================
+// MqttPayloads - Payloads salientes de MQTT (esquema fijo)
+// ============================================================================
+// Cada función escribe el payload completo en `out` con el mismo orden de
+// campos que la serialización anterior con ArduinoJson (contrato en
+// docs/implementacion/contratos-mqtt-http.md). Sin dependencias de
+// PubSubClient ni del ESP: se prueban en host (test_mqtt_payloads).
+
+class MqttPayloads {
+public:
+    // riego/{nodeId}/status/zona/{zona}: {"activa":..,"tiempoRestante":..}
+    static void zoneStatus(JsonWriter& out, bool activa, int32_t tiempoRestante);
+
+    // riego/{nodeId}/status/zonas: {"activas":mascara,"restante":[..]}
+    // (bit z-1 de la máscara = zona z activa; restante[z-1] en segundos)
+    static void zonesStatus(JsonWriter& out, uint32_t activas, const uint16_t* restante, uint8_t zonas);
+
+    // riego/{nodeId}/evento (duración programada en "inicio", real en "fin";
+    // versionAgenda null si es 0; seq del diario de eventos para deduplicar, se omite si es 0)
+    static void riegoEvento(JsonWriter& out, int zona, RiegoEvento evento, RiegoOrigen origen,
+                            uint32_t timestamp, int32_t duracion, int32_t versionAgenda, uint32_t seq);
+
+    // riego/{nodeId}/sistema/evento (agendasCargadas se omite si es < 0)
+    static void systemEvent(JsonWriter& out, SystemEvent tipo, uint32_t timestamp,
+                            const char* detalles, int32_t agendasCargadas, uint32_t memoriaLibre);
+
+    // riego/{nodeId}/agenda/version
+    static void agendaVersion(JsonWriter& out, int32_t version);
+
+    // riego/{nodeId}/humedad/zona/{zona}
+    static void telemetry(JsonWriter& out, int32_t humedad, uint32_t uptime);
+
+    // riego/{nodeId}/status/system
+    static void systemStatus(JsonWriter& out, const char* status, uint32_t uptime, uint32_t freeHeap);
+
+    // riego/{nodeId}/diagnostico/loop: {"ventanaMs":..,"lentas":..,"wifi":[n,min,p50,p99,max],...}
+    // (microsegundos; los canales sin muestras se omiten)
+    static void loopProfile(JsonWriter& out, const LoopProfiler& profiler, uint32_t ventanaMs);
+};
+
+#endif // MQTT_PAYLOADS_H
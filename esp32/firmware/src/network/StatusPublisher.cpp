@@ -0,0 +1,129 @@
+#include "StatusPublisher.h"
+
+// ============================================================================
+// Constructor y configuración
+// ============================================================================
+StatusPublisher::StatusPublisher(ZoneStatusSink zoneSink, ZonesStatusSink zonesSink)
+    : zoneSink(zoneSink), zonesSink(zonesSink), mode(STATUS_PUBLISH_MODE),
+      driftThreshold(STATUS_DRIFT_THRESHOLD_SEC), keepaliveMs(STATUS_HEARTBEAT_INTERVAL),
+      lastZonesPublish(0), zonesPending(true), published(0) {
+    invalidate();
+}
+
+void StatusPublisher::setMode(uint8_t mode) {
+    if (mode != this->mode) {
+        this->mode = mode;
+        invalidate();
+    }
+}
+
+void StatusPublisher::setDriftThreshold(uint16_t seconds) {
+    driftThreshold = seconds;
+}
+
+void StatusPublisher::setKeepalive(uint32_t ms) {
+    keepaliveMs = ms;
+}
+
+void StatusPublisher::invalidate() {
+    for (int i = 0; i < MAX_ZONES; i++) {
+        zones[i].known = false;
+        zones[i].activa = false;
+        zones[i].restante = 0;
+        zones[i].publishedAt = 0;
+    }
+    zonesPending = true;
+}
+
+// ============================================================================
+// Detección de cambios
+// ============================================================================
+bool StatusPublisher::zoneChanged(const ZoneState& state, bool activa, uint16_t restante, uint32_t nowMs) const {
+    if (!state.known || state.activa != activa) return true;
+    if (!activa) return false;
+
+    // Lo que el backend extrapola desde la última publicación
+    uint32_t elapsed = (nowMs - state.publishedAt) / 1000;
+    int32_t expected = (int32_t)state.restante - (int32_t)elapsed;
+    if (expected < 0) expected = 0;
+
+    int32_t drift = (int32_t)restante - expected;
+    if (drift < 0) drift = -drift;
+    return drift > (int32_t)driftThreshold;
+}
+
+// ============================================================================
+// Publicación
+// ============================================================================
+uint8_t StatusPublisher::update(uint32_t nowMs, uint32_t activas, const uint16_t* restante) {
+    bool perZone = mode != STATUS_MODE_AGREGADO && zoneSink != nullptr;
+    bool aggregated = mode != STATUS_MODE_ZONA && zonesSink != nullptr;
+    uint16_t current[MAX_ZONES];
+    bool changed[MAX_ZONES];
+    uint8_t count = 0;
+
+    for (int i = 0; i < MAX_ZONES; i++) {
+        bool activa = (activas & (1UL << i)) != 0;
+        current[i] = activa ? restante[i] : 0;
+        changed[i] = zoneChanged(zones[i], activa, current[i], nowMs);
+        if (changed[i]) zonesPending = true;
+    }
+
+    if (perZone) {
+        for (int i = 0; i < MAX_ZONES; i++) {
+            bool activa = (activas & (1UL << i)) != 0;
+            bool keepalive = activa && nowMs - zones[i].publishedAt >= keepaliveMs;
+            if (!changed[i] && !keepalive) continue;
+
+            // Si falla queda distinto de lo publicado y se reintenta
+            if (!zoneSink(i + 1, activa, current[i])) continue;
+            zones[i].known = true;
+            zones[i].activa = activa;
+            zones[i].restante = current[i];
+            zones[i].publishedAt = nowMs;
+            count++;
+        }
+    }
+
+    if (aggregated) {
+        bool keepalive = nowMs - lastZonesPublish >= keepaliveMs;
+        if ((zonesPending || keepalive) && zonesSink(activas, current)) {
+            zonesPending = false;
+            lastZonesPublish = nowMs;
+            count++;
+            if (!perZone) {
+                for (int i = 0; i < MAX_ZONES; i++) {
+                    zones[i].known = true;
+                    zones[i].activa = (activas & (1UL << i)) != 0;
+                    zones[i].restante = current[i];
+                    zones[i].publishedAt = nowMs;
+                }
+            }
+        }
+    } else {
+        zonesPending = false;
+    }
+
+    published += count;
+    return count;
+}
+
+int32_t StatusPublisher::getMsUntilKeepalive(uint32_t nowMs) const {
+    int32_t earliest = -1;
+
+    if (mode != STATUS_MODE_ZONA) {
+        uint32_t elapsed = nowMs - lastZonesPublish;
+        earliest = elapsed >= keepaliveMs ? 0 : (int32_t)(keepaliveMs - elapsed);
+    }
+
+    if (mode != STATUS_MODE_AGREGADO) {
+        for (int i = 0; i < MAX_ZONES; i++) {
+            if (!zones[i].known || !zones[i].activa) continue;
+            uint32_t elapsed = nowMs - zones[i].publishedAt;
+            int32_t ms = elapsed >= keepaliveMs ? 0 : (int32_t)(keepaliveMs - elapsed);
+            if (earliest < 0 || ms < earliest) earliest = ms;
+        }
+    }
+
+    return earliest;
+}
@@ -0,0 +1,71 @@
+#ifndef STATUS_PUBLISHER_H
+#define STATUS_PUBLISHER_H
+
+#include <stdint.h>
+#include "../config/Config.h"
+
+// ============================================================================
+// StatusPublisher - Publicación de estado de zonas por flanco
+// ============================================================================
+// Guarda el último estado publicado de cada zona (activa + tiempo restante y
+// cuándo se publicó) y solo vuelve a publicar cuando:
+//   - la zona cambia de estado (encendido/apagado),
+//   - el tiempo restante se aparta del que el backend puede extrapolar
+//     (restante publicado - tiempo transcurrido) en más de driftThreshold
+//     segundos (ej: un comando que extiende el riego),
+//   - vence el keepalive (zonas activas en modo zona; el mensaje agregado
+//     completo en modo agregado).
+// Tras invalidate() (reconexión) se republica todo en la próxima llamada.
+// No depende de Arduino ni de MqttManager: la hora y el estado los aporta
+// quien llama y la publicación sale por callbacks (test_status_publisher).
+
+// Publicar una zona en su topic (riego/{id}/status/zona/{n})
+typedef bool (*ZoneStatusSink)(int zona, bool activa, uint16_t restante);
+// Publicar todas las zonas en un mensaje (riego/{id}/status/zonas)
+typedef bool (*ZonesStatusSink)(uint32_t activas, const uint16_t* restante);
+
+class StatusPublisher {
+private:
+    struct ZoneState {
+        bool known;              // false = nada publicado desde invalidate()
+        bool activa;
+        uint16_t restante;       // Segundos al publicar
+        uint32_t publishedAt;    // millis() de la última publicación
+    };
+
+    ZoneStatusSink zoneSink;
+    ZonesStatusSink zonesSink;
+    uint8_t mode;                // STATUS_MODE_*
+    uint16_t driftThreshold;     // Segundos
+    uint32_t keepaliveMs;
+
+    ZoneState zones[MAX_ZONES];
+    uint32_t lastZonesPublish;   // millis() del último mensaje agregado
+    bool zonesPending;           // Cambios sin publicar en el mensaje agregado
+    uint32_t published;          // Mensajes publicados (desde el arranque)
+
+    // ¿La zona difiere de lo publicado (estado o deriva del tiempo restante)?
+    bool zoneChanged(const ZoneState& state, bool activa, uint16_t restante, uint32_t nowMs) const;
+
+public:
+    StatusPublisher(ZoneStatusSink zoneSink, ZonesStatusSink zonesSink);
+
+    void setMode(uint8_t mode);
+    void setDriftThreshold(uint16_t seconds);
+    void setKeepalive(uint32_t ms);
+
+    // Olvidar lo publicado (el broker/backend pudo perder el estado)
+    void invalidate();
+
+    // Comparar el estado actual contra lo publicado y publicar lo necesario.
+    // `activas`: bit z-1 = zona z activa; `restante`: MAX_ZONES valores.
+    // Devuelve la cantidad de mensajes publicados.
+    uint8_t update(uint32_t nowMs, uint32_t activas, const uint16_t* restante);
+
+    // ms hasta el próximo keepalive (para el SleepPlanner; -1 = ninguno)
+    int32_t getMsUntilKeepalive(uint32_t nowMs) const;
+
+    uint32_t getPublishedCount() const { return published; }
+};
+
+#endif // STATUS_PUBLISHER_H
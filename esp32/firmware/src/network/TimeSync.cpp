@@ -24,20 +24,20 @@ TimeSync::~TimeSync() {
 // Inicialización
 // ============================================================================
 void TimeSync::init() {
-    Logger::info("Inicializando TimeSync...");
+    LOG_INFO("Inicializando TimeSync...");
     
     // Crear cliente NTP con offset de zona horaria
     timeClient = new NTPClient(ntpUDP, NTP_SERVER, GMT_OFFSET_SEC, 60000);
     
-    Logger::logf(LOG_LEVEL_INFO, "Servidor NTP: %s", NTP_SERVER);
-    Logger::logf(LOG_LEVEL_INFO, "Zona horaria: GMT%+d", GMT_OFFSET_SEC / 3600);
+    LOG_INFO("Servidor NTP: %s", NTP_SERVER);
+    LOG_INFO("Zona horaria: GMT%+d", GMT_OFFSET_SEC / 3600);
 }
 
 // ============================================================================
 // Sincronizar con NTP
 // ============================================================================
 bool TimeSync::sync() {
-    Logger::info("Sincronizando tiempo con NTP...");
+    LOG_INFO("Sincronizando tiempo con NTP...");
     lastSyncAttempt = millis();
     
     // Iniciar cliente NTP
@@ -56,8 +56,8 @@ bool TimeSync::sync() {
             synchronized = true;
             lastSuccessfulSync = millis();
             
-            Logger::info("Tiempo sincronizado exitosamente");
-            printTime();
+            LOG_INFO("Tiempo sincronizado: %s %s (%s)", getDateString().c_str(),
+                     getTimeString().c_str(), getWeekDayName().c_str());
             
             return true;
         }
@@ -66,7 +66,7 @@ bool TimeSync::sync() {
         delay(1000);
     }
     
-    Logger::error("Fallo al sincronizar tiempo con NTP");
+    LOG_ERROR("Fallo al sincronizar tiempo con NTP");
     synchronized = false;
     return false;
 }
@@ -86,7 +86,7 @@ void TimeSync::loop() {
     // Actualizar tiempo desde NTP periódicamente
     unsigned long now = millis();
     if (now - lastSuccessfulSync > SYNC_INTERVAL) {
-        Logger::info("Resincronizando tiempo (sincronización periódica)...");
+        LOG_INFO("Resincronizando tiempo (sincronización periódica)...");
         sync();
     } else {
         // Actualizar tiempo local (sin consultar NTP)
@@ -113,6 +113,11 @@ time_t TimeSync::getEpoch() {
     return 0;
 }
 
+uint32_t TimeSync::getUtcEpoch() {
+    if (!synchronized) return 0;
+    return (uint32_t)(timeClient->getEpochTime() - GMT_OFFSET_SEC - DAYLIGHT_OFFSET_SEC);
+}
+
 // ============================================================================
 // Obtener estructura tm
 // ============================================================================
@@ -218,7 +223,7 @@ String TimeSync::getWeekDayName() {
 // ============================================================================
 void TimeSync::printTime() {
     if (!synchronized) {
-        Logger::warn("Tiempo no sincronizado");
+        LOG_WARN("Tiempo no sincronizado");
         return;
     }
     
@@ -243,6 +248,6 @@ unsigned long TimeSync::getTimeSinceLastSync() {
 // Forzar resincronización
 // ============================================================================
 void TimeSync::forceSync() {
-    Logger::info("Forzando resincronización de tiempo...");
+    LOG_INFO("Forzando resincronización de tiempo...");
     sync();
 }
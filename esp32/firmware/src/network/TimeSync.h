@@ -56,6 +56,10 @@ public:
     // Obtener epoch (Unix timestamp en segundos)
     time_t getEpoch();
     
+    // Epoch UTC (sin el offset de zona horaria), 0 si no está sincronizado.
+    // Es el que viaja en los eventos hacia el backend.
+    uint32_t getUtcEpoch();
+    
     // Obtener estructura tm con fecha/hora actual
     struct tm getTimeInfo();
     
@@ -17,7 +17,7 @@ WiFiManager::WiFiManager() {
 // Inicialización
 // ============================================================================
 void WiFiManager::init() {
-    Logger::info("Inicializando WiFiManager...");
+    LOG_INFO("Inicializando WiFiManager...");
     
     // Configurar modo WiFi
     WiFi.mode(WIFI_STA);
@@ -26,12 +26,12 @@ void WiFiManager::init() {
     
     // Obtener MAC address
     macAddress = WiFi.macAddress();
-    Logger::logf(LOG_LEVEL_INFO, "MAC Address: %s", macAddress.c_str());
+    LOG_INFO("MAC Address: %s", macAddress.c_str());
     
     // Configurar hostname
     #ifdef MDNS_HOSTNAME
     WiFi.hostname(MDNS_HOSTNAME);
-    Logger::logf(LOG_LEVEL_INFO, "Hostname: %s", MDNS_HOSTNAME);
+    LOG_INFO("Hostname: %s", MDNS_HOSTNAME);
     #endif
 }
 
@@ -48,17 +48,17 @@ void WiFiManager::setCredentials(const String& ssid, const String& password) {
 // ============================================================================
 bool WiFiManager::connect() {
     if (WiFi.status() == WL_CONNECTED) {
-        Logger::info("WiFi ya estaba conectado");
+        LOG_INFO("WiFi ya estaba conectado");
         return true;
     }
     
     if (configuredSSID.length() == 0) {
-        Logger::error("SSID vacio - no se puede conectar a WiFi");
+        LOG_ERROR("SSID vacio - no se puede conectar a WiFi");
         reconnectAttempts++;
         return false;
     }
 
-    Logger::logf(LOG_LEVEL_INFO, "Conectando a WiFi: %s", configuredSSID.c_str());
+    LOG_INFO("Conectando a WiFi: %s", configuredSSID.c_str());
     
     // Iniciar conexión
     WiFi.begin(configuredSSID.c_str(), configuredPassword.c_str());
@@ -68,15 +68,13 @@ bool WiFiManager::connect() {
     unsigned long startTime = millis();
     while (WiFi.status() != WL_CONNECTED) {
         if (millis() - startTime > WIFI_TIMEOUT) {
-            Logger::error("Timeout conectando a WiFi");
+            LOG_ERROR("Timeout conectando a WiFi");
             reconnectAttempts++;
             return false;
         }
         
         delay(500);
-        Serial.print(".");
     }
-    Serial.println();
     
     // Conexión exitosa
     onConnected();
@@ -88,7 +86,7 @@ bool WiFiManager::connect() {
 // Desconectar WiFi
 // ============================================================================
 void WiFiManager::disconnect() {
-    Logger::info("Desconectando WiFi...");
+    LOG_INFO("Desconectando WiFi...");
     WiFi.disconnect();
     connected = false;
     onDisconnected();
@@ -118,14 +116,14 @@ void WiFiManager::loop() {
         // Verificar si es momento de reintentar
         if (now - lastConnectionAttempt >= RECONNECT_DELAY) {
             if (reconnectAttempts < MAX_RECONNECT_ATTEMPTS) {
-                Logger::logf(LOG_LEVEL_INFO, "Reintentando conexión WiFi (intento %d/%d)...", 
-                           reconnectAttempts + 1, MAX_RECONNECT_ATTEMPTS);
+                LOG_INFO("Reintentando conexión WiFi (intento %d/%d)...", 
+                         reconnectAttempts + 1, MAX_RECONNECT_ATTEMPTS);
                 lastConnectionAttempt = now;
                 connect();
             } else {
                 // Demasiados intentos fallidos, esperar más tiempo
                 if (now - lastConnectionAttempt >= RECONNECT_DELAY * 6) { // 60 segundos
-                    Logger::warn("Reiniciando contador de intentos WiFi");
+                    LOG_WARN("Reiniciando contador de intentos WiFi");
                     reconnectAttempts = 0;
                 }
             }
@@ -195,13 +193,23 @@ String WiFiManager::getConfiguredSSID() {
 // Forzar reconexión
 // ============================================================================
 void WiFiManager::forceReconnect() {
-    Logger::info("Forzando reconexión WiFi...");
+    LOG_INFO("Forzando reconexión WiFi...");
     disconnect();
     reconnectAttempts = 0;
     delay(1000);
     connect();
 }
 
+// ============================================================================
+// Reasociar (no bloquea: loop() ve la caída y la reconexión)
+// ============================================================================
+void WiFiManager::reassociate() {
+    LOG_WARN("Reasociando WiFi...");
+    reconnectAttempts = 0;
+    lastConnectionAttempt = millis();
+    WiFi.reconnect();
+}
+
 // ============================================================================
 // Obtener uptime de conexión
 // ============================================================================
@@ -217,7 +225,7 @@ unsigned long WiFiManager::getConnectionUptime() {
 // ============================================================================
 void WiFiManager::printInfo() {
     if (!connected) {
-        Logger::warn("WiFi no conectado");
+        LOG_WARN("WiFi no conectado");
         return;
     }
     
@@ -241,13 +249,13 @@ void WiFiManager::onConnected() {
     rssi = WiFi.RSSI();
     connectionStartTime = millis();
     
-    Logger::logf(LOG_LEVEL_INFO, "WiFi conectado a: %s", configuredSSID.c_str());
-    Logger::logf(LOG_LEVEL_INFO, "IP: %s", localIP.c_str());
-    Logger::logf(LOG_LEVEL_INFO, "RSSI: %d dBm", rssi);
+    LOG_INFO("WiFi conectado a: %s", configuredSSID.c_str());
+    LOG_INFO("IP: %s", localIP.c_str());
+    LOG_INFO("RSSI: %d dBm", rssi);
 }
 
 void WiFiManager::onDisconnected() {
     connected = false;
-    Logger::warn("WiFi desconectado");
+    LOG_WARN("WiFi desconectado");
     lastConnectionAttempt = millis();
 }
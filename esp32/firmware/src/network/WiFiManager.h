@@ -75,6 +75,9 @@ public:
     // Forzar reconexión
     void forceReconnect();
     
+    // Reasociar con el AP sin bloquear (recuperación de MQTT)
+    void reassociate();
+    
     // Obtener tiempo de uptime de conexión (milisegundos)
     unsigned long getConnectionUptime();
     
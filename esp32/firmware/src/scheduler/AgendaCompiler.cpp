@@ -0,0 +1,268 @@
+#include "AgendaCompiler.h"
+#include "../utils/Logger.h"
+
+// ============================================================================
+// Capacidad del documento
+// ============================================================================
+size_t AgendaCompiler::docCapacityFor(size_t jsonLength) {
+    // ~1.5x con slots de 16 bytes; los slots dominan, así que escala con su tamaño
+    return (jsonLength * 3 / 2) * JSON_OBJECT_SIZE(1) / 16 + 1024;
+}
+
+// ============================================================================
+// Lectura en streaming
+// ============================================================================
+int AgendaCompiler::peekNonSpace(Stream& input) {
+    int c = input.peek();
+    while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        input.read();
+        c = input.peek();
+    }
+    return c;
+}
+
+// Consumir un string ya abierto (tras la comilla) hasta su comilla de cierre.
+// Si `expected` no es nullptr, devuelve 1 si el contenido es exactamente ese
+// texto; un escape nunca coincide (las claves buscadas no llevan escapes).
+int AgendaCompiler::readString(Stream& input, const char* expected) {
+    size_t matched = 0;
+    bool equal = expected != nullptr;
+    while (true) {
+        int c = input.read();
+        if (c < 0) return -1;
+        if (c == '"') break;
+        if (c == '\\') {
+            if (input.read() < 0) return -1;
+            equal = false;
+            continue;
+        }
+        if (equal && expected[matched] == (char)c) {
+            matched++;
+        } else {
+            equal = false;
+        }
+    }
+    return (equal && expected[matched] == '\0') ? 1 : 0;
+}
+
+// Saltar un valor completo: string, objeto/array anidado o escalar
+bool AgendaCompiler::skipValue(Stream& input) {
+    int c = peekNonSpace(input);
+    if (c == '"') {
+        input.read();
+        return readString(input, nullptr) >= 0;
+    }
+    if (c == '{' || c == '[') {
+        uint16_t depth = 0;
+        do {
+            c = input.read();
+            if (c < 0) return false;
+            if (c == '"') {
+                if (readString(input, nullptr) < 0) return false;
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                depth--;
+            }
+        } while (depth > 0);
+        return true;
+    }
+    // Número, true, false o null: hasta el separador
+    bool any = false;
+    while (c >= 0 && c != ',' && c != '}' && c != ']' &&
+           c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+        input.read();
+        any = true;
+        c = input.peek();
+    }
+    return any;
+}
+
+int AgendaCompiler::seekArray(Stream& input, const char* key) {
+    if (peekNonSpace(input) != '{') return -1;
+    input.read();
+    if (peekNonSpace(input) == '}') return 0;
+    
+    while (true) {
+        if (peekNonSpace(input) != '"') return -1;
+        input.read();
+        int match = readString(input, key);
+        if (match < 0) return -1;
+        if (peekNonSpace(input) != ':') return -1;
+        input.read();
+        
+        if (match == 1) {
+            if (peekNonSpace(input) != '[') return 0;
+            input.read();
+            peekNonSpace(input);
+            return 1;
+        }
+        
+        if (!skipValue(input)) return -1;
+        int separator = peekNonSpace(input);
+        input.read();
+        if (separator == '}') return 0;
+        if (separator != ',') return -1;
+    }
+}
+
+// ============================================================================
+// Compilar desde archivo (streaming)
+// ============================================================================
+AgendaCompileResult AgendaCompiler::compileFile(File& file, AgendaTable& table, DeserializationError& error) {
+    table.clear();
+    error = DeserializationError::Ok;
+    
+    // Pasada 1: versión global. El filtro descarta las agendas sin guardarlas,
+    // pero el parser recorre todo el archivo y valida la sintaxis completa.
+    // versionDoc: un miembro, su clave y lugar para la clave temporal más larga
+    StaticJsonDocument<JSON_OBJECT_SIZE(1)> versionFilter;
+    versionFilter["version"] = true;
+    StaticJsonDocument<JSON_OBJECT_SIZE(1) + 8 + 32> versionDoc;
+    error = deserializeJson(versionDoc, file, DeserializationOption::Filter(versionFilter));
+    if (error) {
+        return AGENDA_COMPILE_PARSE_ERROR;
+    }
+    table.version = versionDoc["version"] | 0;
+    
+    // Pasada 2: cada elemento de "agendas" en un documento de tamaño fijo
+    file.seek(0, SeekSet);
+    int found = seekArray(file, "agendas");
+    if (found < 0) {
+        error = DeserializationError::InvalidInput;
+        return AGENDA_COMPILE_PARSE_ERROR;
+    }
+    if (found == 0) {
+        return AGENDA_COMPILE_NO_AGENDAS;
+    }
+    
+    AgendaItemFilter itemFilter;
+    initItemFilter(itemFilter);
+    
+    StaticJsonDocument<AGENDA_ITEM_DOC_SIZE> item;
+    int ignoradas = 0;
+    
+    if (peekNonSpace(file) == ']') {
+        return AGENDA_COMPILE_OK;
+    }
+    
+    while (true) {
+        error = deserializeJson(item, file, DeserializationOption::Filter(itemFilter));
+        if (error) {
+            return AGENDA_COMPILE_PARSE_ERROR;
+        }
+        
+        if (table.totalAgendas < 255) table.totalAgendas++;
+        
+        if (table.count >= MAX_AGENDAS) {
+            ignoradas++;
+        } else if (compileAgenda(item.as<JsonObject>(), table.version, table.slots[table.count])) {
+            table.count++;
+        }
+        
+        int separator = peekNonSpace(file);
+        file.read();
+        if (separator == ']') break;
+        if (separator != ',') {
+            error = DeserializationError::InvalidInput;
+            return AGENDA_COMPILE_PARSE_ERROR;
+        }
+        peekNonSpace(file);
+    }
+    
+    if (ignoradas > 0) {
+        LOG_WARN("Se supero MAX_AGENDAS (%d), %d agendas ignoradas", MAX_AGENDAS, ignoradas);
+    }
+    
+    return AGENDA_COMPILE_OK;
+}
+
+// ============================================================================
+// Compilar documento completo
+// ============================================================================
+bool AgendaCompiler::compile(JsonDocument& doc, AgendaTable& table) {
+    table.clear();
+    
+    // Verificar que exista el array de agendas
+    if (!doc.containsKey("agendas")) {
+        return false;
+    }
+    
+    JsonArray agendas = doc["agendas"].as<JsonArray>();
+    
+    // Obtener versión de la agenda si existe
+    table.version = doc["version"] | 0;
+    
+    int ignoradas = 0;
+    for (JsonObject agenda : agendas) {
+        if (table.totalAgendas < 255) table.totalAgendas++;
+        
+        if (table.count >= MAX_AGENDAS) {
+            ignoradas++;
+            continue;
+        }
+        
+        if (compileAgenda(agenda, table.version, table.slots[table.count])) {
+            table.count++;
+        }
+    }
+    
+    if (ignoradas > 0) {
+        LOG_WARN("Se supero MAX_AGENDAS (%d), %d agendas ignoradas", MAX_AGENDAS, ignoradas);
+    }
+    
+    return true;
+}
+
+void AgendaCompiler::initItemFilter(AgendaItemFilter& filter) {
+    filter["id"] = true;
+    filter["zona"] = true;
+    filter["diasSemana"] = true;
+    filter["horaInicio"] = true;
+    filter["duracionMin"] = true;
+    filter["activa"] = true;
+    filter["version"] = true;
+}
+
+// ============================================================================
+// Compilar una agenda JSON a un slot (false si está inactiva o es inválida)
+// ============================================================================
+bool AgendaCompiler::compileAgenda(JsonObject agenda, int32_t versionGlobal, AgendaSlot& slot) {
+    // Verificar que la agenda esté activa
+    bool activa = agenda["activa"] | false;
+    if (!activa) {
+        return false;
+    }
+    
+    // Días de la semana
+    JsonArray diasSemana = agenda["diasSemana"];
+    if (!diasSemana) {
+        return false;
+    }
+    
+    uint8_t diasMask = 0;
+    for (JsonVariant dia : diasSemana) {
+        int dayIndex = agendaDayIndexFromName(dia.as<const char*>());
+        if (dayIndex >= 0) {
+            diasMask |= (1 << dayIndex);
+        }
+    }
+    
+    // Hora de inicio (formato "HH:MM")
+    int minutoDia = agendaMinuteFromHora(agenda["horaInicio"] | "");
+    
+    int zona = agenda["zona"] | 0;
+    int duracionMin = agenda["duracionMin"] | 0;
+    
+    if (diasMask == 0 || minutoDia < 0 || zona < 1 || zona > MAX_ZONES || duracionMin <= 0) {
+        LOG_WARN("Agenda [%s] invalida, ignorada", agenda["id"] | "unknown");
+        return false;
+    }
+    
+    slot.zona = (uint8_t)zona;
+    slot.diasMask = diasMask;
+    slot.minutoDia = (uint16_t)minutoDia;
+    slot.duracionMin = (uint16_t)duracionMin;
+    slot.version = (uint32_t)(agenda["version"] | versionGlobal);
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef AGENDA_COMPILER_H
+#define AGENDA_COMPILER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FS.h>
+#include "AgendaTable.h"
+
+// ============================================================================
+// AgendaCompiler - JSON de agendas (formato /agenda.json) a AgendaTable
+// ============================================================================
+// compileFile() lee el archivo en streaming: primero la versión global (con
+// filtro, sin guardar las agendas) y luego cada elemento de "agendas" en un
+// documento fijo de AGENDA_ITEM_DOC_SIZE. La RAM no crece con el payload.
+// compile() trabaja sobre un documento ya parseado (usado por el benchmark).
+
+enum AgendaCompileResult {
+    AGENDA_COMPILE_OK = 0,
+    AGENDA_COMPILE_NO_AGENDAS,   // El JSON no contiene el array "agendas"
+    AGENDA_COMPILE_PARSE_ERROR   // JSON inválido o agenda que no entra en el documento
+};
+
+// Filtro con los 7 campos que lee compileAgenda()
+typedef StaticJsonDocument<JSON_OBJECT_SIZE(7)> AgendaItemFilter;
+
+class AgendaCompiler {
+public:
+    // Capacidad de DynamicJsonDocument para un JSON de `jsonLength` bytes
+    // (ArduinoJson requiere ~1.5x el tamaño del JSON + overhead de estructuras
+    // con slots de 16 bytes; en host, con slots de 32, el doble)
+    static size_t docCapacityFor(size_t jsonLength);
+    
+    // Compilar desde archivo en streaming. `error` detalla los errores de parseo.
+    static AgendaCompileResult compileFile(File& file, AgendaTable& table, DeserializationError& error);
+    
+    // Compilar el documento completo. false si no contiene el array "agendas".
+    static bool compile(JsonDocument& doc, AgendaTable& table);
+    
+    // Campos de una agenda que se leen (AgendaDelta copia solo estos: el resto
+    // de lo que manda el backend no entra en AGENDA_ITEM_DOC_SIZE)
+    static void initItemFilter(AgendaItemFilter& filter);
+    
+    // Compilar una agenda a un slot (false si está inactiva o es inválida)
+    static bool compileAgenda(JsonObject agenda, int32_t versionGlobal, AgendaSlot& slot);
+    
+    // Lectura de arrays en streaming (también usados por AgendaDelta)
+    // Saltar espacios sin consumir el siguiente carácter significativo
+    static int peekNonSpace(Stream& input);
+    
+    // Posicionar dentro del array `key` del objeto raíz, recorriendo las
+    // claves y saltando sus valores completos (un "agendas" dentro de un
+    // string o de un objeto anidado no cuenta). 1 = listo tras el '[',
+    // 0 = la clave no existe o su valor no es un array, -1 = JSON inválido.
+    static int seekArray(Stream& input, const char* key);
+    
+private:
+    static int readString(Stream& input, const char* expected);
+    static bool skipValue(Stream& input);
+};
+
+#endif // AGENDA_COMPILER_H
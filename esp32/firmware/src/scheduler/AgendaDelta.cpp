@@ -0,0 +1,243 @@
+#include "AgendaDelta.h"
+#include "AgendaCompiler.h"
+
+// Hashes de ids agregados, modificados o eliminados por el delta (estático: fuera del stack)
+static uint32_t touchedIds[AGENDA_DELTA_MAX_IDS];
+
+// ============================================================================
+// Cabecera del delta
+// ============================================================================
+bool AgendaDelta::readHeader(File& delta, AgendaDeltaInfo& info, DeserializationError& error) {
+    memset(&info, 0, sizeof(info));
+    
+    StaticJsonDocument<JSON_OBJECT_SIZE(3)> headerFilter;
+    headerFilter["tipo"] = true;
+    headerFilter["baseVersion"] = true;
+    headerFilter["version"] = true;
+    // Tres miembros, sus claves (25 bytes), "completa" y la clave temporal más larga
+    StaticJsonDocument<JSON_OBJECT_SIZE(3) + 25 + 9 + 32> header;
+    
+    delta.seek(0, SeekSet);
+    error = deserializeJson(header, delta, DeserializationOption::Filter(headerFilter));
+    if (error) {
+        return false;
+    }
+    
+    const char* tipo = header["tipo"] | "completa";
+    info.isDelta = strcmp(tipo, "delta") == 0;
+    info.baseVersion = header["baseVersion"] | -1;
+    info.version = header["version"] | 0;
+    return true;
+}
+
+// ============================================================================
+// Combinar agenda vigente + delta
+// ============================================================================
+AgendaDeltaResult AgendaDelta::merge(File& current, File& delta, int32_t localVersion, Print& out,
+                                     AgendaDeltaInfo& info, DeserializationError& error) {
+    error = DeserializationError::Ok;
+    if (!readHeader(delta, info, error)) return AGENDA_DELTA_PARSE_ERROR;
+    if (!info.isDelta) return AGENDA_DELTA_NOT_DELTA;
+    if (info.version == localVersion) return AGENDA_DELTA_UP_TO_DATE;
+    if (info.baseVersion != localVersion) return AGENDA_DELTA_VERSION_GAP;
+    
+    // Ids que el delta reemplaza o elimina
+    uint16_t touched = 0;
+    if (!collectIds(delta, "agendas", true, touched, error)) {
+        return error == DeserializationError::NoMemory ? AGENDA_DELTA_TOO_LARGE : AGENDA_DELTA_PARSE_ERROR;
+    }
+    info.upserts = (uint8_t)(touched > 255 ? 255 : touched);
+    uint16_t upsertIds = touched;
+    if (!collectIds(delta, "eliminadas", false, touched, error)) {
+        return error == DeserializationError::NoMemory ? AGENDA_DELTA_TOO_LARGE : AGENDA_DELTA_PARSE_ERROR;
+    }
+    info.removed = (uint8_t)(touched - upsertIds > 255 ? 255 : touched - upsertIds);
+    
+    out.print("{\"version\":");
+    out.print((long)info.version);
+    out.print(",\"agendas\":[");
+    bool first = true;
+    
+    // Solo los campos que se compilan: lo demás (nombre, nodeId, updatedAt...)
+    // no entra en AGENDA_ITEM_DOC_SIZE y el nodo no lo usa
+    AgendaItemFilter itemFilter;
+    AgendaCompiler::initItemFilter(itemFilter);
+    StaticJsonDocument<AGENDA_ITEM_DOC_SIZE> item;
+    
+    // Agendas vigentes que el delta no toca
+    if (current && AgendaCompiler::seekArray(current, "agendas") == 1 &&
+        AgendaCompiler::peekNonSpace(current) != ']') {
+        while (true) {
+            error = deserializeJson(item, current, DeserializationOption::Filter(itemFilter));
+            if (error) return AGENDA_DELTA_PARSE_ERROR;
+            
+            // Hash tocado: confirmar con el id completo (una colisión no borra la agenda)
+            const char* id = item["id"] | "";
+            bool replaced = false;
+            if (id[0] != '\0' && isTouched(hashId(id), touched) && !deltaHasId(delta, id, replaced, error)) {
+                return AGENDA_DELTA_PARSE_ERROR;
+            }
+            if (!replaced) {
+                if (!first) out.print(',');
+                if (serializeJson(item, out) == 0) return AGENDA_DELTA_WRITE_ERROR;
+                first = false;
+                if (info.kept < 255) info.kept++;
+            }
+            
+            int next = nextElement(current);
+            if (next < 0) {
+                error = DeserializationError::InvalidInput;
+                return AGENDA_DELTA_PARSE_ERROR;
+            }
+            if (next == 0) break;
+        }
+    }
+    
+    // Agendas nuevas o modificadas del delta
+    delta.seek(0, SeekSet);
+    if (AgendaCompiler::seekArray(delta, "agendas") == 1 &&
+        AgendaCompiler::peekNonSpace(delta) != ']') {
+        while (true) {
+            error = deserializeJson(item, delta, DeserializationOption::Filter(itemFilter));
+            if (error) return AGENDA_DELTA_PARSE_ERROR;
+            
+            if (!first) out.print(',');
+            if (serializeJson(item, out) == 0) return AGENDA_DELTA_WRITE_ERROR;
+            first = false;
+            
+            int next = nextElement(delta);
+            if (next < 0) {
+                error = DeserializationError::InvalidInput;
+                return AGENDA_DELTA_PARSE_ERROR;
+            }
+            if (next == 0) break;
+        }
+    }
+    
+    if (out.print("]}") != 2) return AGENDA_DELTA_WRITE_ERROR;
+    return AGENDA_DELTA_OK;
+}
+
+// ============================================================================
+// Ids del array `key` (objetos con "id" o strings)
+// ============================================================================
+bool AgendaDelta::scanIds(File& delta, const char* key, bool objects, IdVisitor visit, void* context,
+                          DeserializationError& error) {
+    delta.seek(0, SeekSet);
+    int found = AgendaCompiler::seekArray(delta, key);
+    if (found < 0) {
+        error = DeserializationError::InvalidInput;
+        return false;
+    }
+    if (found == 0) {
+        return true;  // Array ausente = vacío
+    }
+    if (AgendaCompiler::peekNonSpace(delta) == ']') {
+        return true;
+    }
+    
+    StaticJsonDocument<JSON_OBJECT_SIZE(1)> idFilter;
+    idFilter["id"] = true;
+    StaticJsonDocument<ID_DOC_SIZE> entry;
+    
+    while (true) {
+        error = objects
+            ? deserializeJson(entry, delta, DeserializationOption::Filter(idFilter))
+            : deserializeJson(entry, delta);
+        if (error) return false;
+        
+        const char* id = objects ? (entry["id"] | "") : (entry.as<const char*>());
+        if (id != nullptr && id[0] != '\0' && !visit(id, context)) {
+            return true;
+        }
+        
+        int next = nextElement(delta);
+        if (next < 0) {
+            error = DeserializationError::InvalidInput;
+            return false;
+        }
+        if (next == 0) return true;
+    }
+}
+
+struct CollectContext {
+    uint16_t* count;
+    bool full;
+};
+
+static bool collectVisitor(const char* id, void* context) {
+    CollectContext* collect = (CollectContext*)context;
+    if (*collect->count >= AGENDA_DELTA_MAX_IDS) {
+        collect->full = true;
+        return false;
+    }
+    touchedIds[(*collect->count)++] = AgendaDelta::hashId(id);
+    return true;
+}
+
+bool AgendaDelta::collectIds(File& delta, const char* key, bool objects, uint16_t& count, DeserializationError& error) {
+    CollectContext context = { &count, false };
+    if (!scanIds(delta, key, objects, collectVisitor, &context, error)) return false;
+    if (context.full) {
+        error = DeserializationError::NoMemory;
+        return false;
+    }
+    return true;
+}
+
+struct FindContext {
+    const char* id;
+    bool found;
+};
+
+static bool findVisitor(const char* id, void* context) {
+    FindContext* find = (FindContext*)context;
+    find->found = strcmp(id, find->id) == 0;
+    return !find->found;
+}
+
+bool AgendaDelta::deltaHasId(File& delta, const char* id, bool& found, DeserializationError& error) {
+    FindContext context = { id, false };
+    if (!scanIds(delta, "agendas", true, findVisitor, &context, error)) return false;
+    if (!context.found && !scanIds(delta, "eliminadas", false, findVisitor, &context, error)) return false;
+    found = context.found;
+    return true;
+}
+
+bool AgendaDelta::isTouched(uint32_t hash, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        if (touchedIds[i] == hash) return true;
+    }
+    return false;
+}
+
+int AgendaDelta::nextElement(Stream& input) {
+    int separator = AgendaCompiler::peekNonSpace(input);
+    input.read();
+    if (separator == ']') return 0;
+    if (separator != ',') return -1;
+    AgendaCompiler::peekNonSpace(input);
+    return 1;
+}
+
+uint32_t AgendaDelta::hashId(const char* id) {
+    uint32_t hash = 2166136261u;
+    while (*id != '\0') {
+        hash ^= (uint8_t)*id++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+const char* AgendaDelta::resultName(AgendaDeltaResult result) {
+    switch (result) {
+        case AGENDA_DELTA_OK: return "ok";
+        case AGENDA_DELTA_NOT_DELTA: return "lista completa";
+        case AGENDA_DELTA_UP_TO_DATE: return "sin cambios";
+        case AGENDA_DELTA_VERSION_GAP: return "salto de version";
+        case AGENDA_DELTA_TOO_LARGE: return "demasiados cambios";
+        case AGENDA_DELTA_PARSE_ERROR: return "JSON invalido";
+        case AGENDA_DELTA_WRITE_ERROR: return "error de escritura";
+    }
+    return "?";
+}
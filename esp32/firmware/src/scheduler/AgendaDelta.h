@@ -0,0 +1,75 @@
+#ifndef AGENDA_DELTA_H
+#define AGENDA_DELTA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FS.h>
+#include "AgendaTable.h"
+
+// ============================================================================
+// AgendaDelta - Sync incremental de agendas (delta por versión)
+// ============================================================================
+// El backend publica en agenda/sync, además de la lista completa, deltas:
+//   {"tipo":"delta","baseVersion":B,"version":V,
+//    "agendas":[agendas nuevas o modificadas],"eliminadas":["id", ...]}
+// Un delta solo se aplica si B es la versión local. merge() escribe la agenda
+// resultante completa (formato /agenda.json) en otro archivo, copiando en
+// streaming las agendas vigentes que el delta no toca y agregando las del
+// delta; el reemplazo posterior es el mismo rename atómico del sync completo.
+// Los ids tocados se guardan como hash FNV-1a de 32 bits (sin copiar strings);
+// si una agenda vigente coincide en hash, se busca su id completo en el delta
+// antes de descartarla. Las agendas se copian filtradas a los campos que se
+// compilan (AgendaCompiler::initItemFilter).
+
+enum AgendaDeltaResult {
+    AGENDA_DELTA_OK = 0,
+    AGENDA_DELTA_NOT_DELTA,     // Lista completa: procesar como sync normal
+    AGENDA_DELTA_UP_TO_DATE,    // version == versión local, nada que aplicar
+    AGENDA_DELTA_VERSION_GAP,   // baseVersion != versión local: pedir resync
+    AGENDA_DELTA_TOO_LARGE,     // Más de AGENDA_DELTA_MAX_IDS ids tocados
+    AGENDA_DELTA_PARSE_ERROR,   // Delta o agenda vigente inválidos
+    AGENDA_DELTA_WRITE_ERROR
+};
+
+struct AgendaDeltaInfo {
+    bool isDelta;
+    int32_t baseVersion;
+    int32_t version;
+    uint8_t upserts;    // Agendas nuevas o modificadas
+    uint8_t removed;    // Ids eliminados
+    uint8_t kept;       // Agendas vigentes copiadas sin cambios
+};
+
+class AgendaDelta {
+public:
+    // Leer la cabecera (tipo y versiones). Valida la sintaxis de todo el archivo.
+    static bool readHeader(File& delta, AgendaDeltaInfo& info, DeserializationError& error);
+    
+    // Combinar `current` (puede no estar abierto: agenda vacía) con `delta`
+    // y escribir el resultado en `out`. `out` solo es válido si devuelve OK.
+    static AgendaDeltaResult merge(File& current, File& delta, int32_t localVersion, Print& out,
+                                   AgendaDeltaInfo& info, DeserializationError& error);
+    
+    static const char* resultName(AgendaDeltaResult result);
+    
+    // Hash del id de agenda (FNV-1a 32 bits)
+    static uint32_t hashId(const char* id);
+
+private:
+    // Un id: objeto de un miembro, "id", un UUID y la clave temporal más larga
+    static const size_t ID_DOC_SIZE = JSON_OBJECT_SIZE(1) + 3 + 37 + 32;
+    
+    // Recibe cada id; devuelve false para terminar el recorrido
+    typedef bool (*IdVisitor)(const char* id, void* context);
+    
+    // Tras un elemento de array: 1 = sigue otro, 0 = fin, -1 = separador inválido
+    static int nextElement(Stream& input);
+    static bool scanIds(File& delta, const char* key, bool objects, IdVisitor visit, void* context,
+                        DeserializationError& error);
+    static bool collectIds(File& delta, const char* key, bool objects, uint16_t& count, DeserializationError& error);
+    // `found` = el id aparece (completo) en "agendas" o "eliminadas" del delta
+    static bool deltaHasId(File& delta, const char* id, bool& found, DeserializationError& error);
+    static bool isTouched(uint32_t hash, uint16_t count);
+};
+
+#endif // AGENDA_DELTA_H
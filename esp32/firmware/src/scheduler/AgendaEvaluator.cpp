@@ -0,0 +1,77 @@
+#include "AgendaEvaluator.h"
+
+// ============================================================================
+// Constructores
+// ============================================================================
+AgendaEvaluator::AgendaEvaluator() {
+    policy.maxLateSec = AGENDA_CATCHUP_MAX_LATE_SEC;
+    policy.minRemainingSec = AGENDA_CATCHUP_MIN_REMAINING_SEC;
+    policy.shortenDuration = AGENDA_CATCHUP_SHORTEN;
+}
+
+AgendaEvaluator::AgendaEvaluator(const CatchUpPolicy& catchUpPolicy) {
+    policy = catchUpPolicy;
+}
+
+const CatchUpPolicy& AgendaEvaluator::getPolicy() const {
+    return policy;
+}
+
+// ============================================================================
+// Watermark
+// ============================================================================
+uint32_t AgendaEvaluator::normalizeWatermark(uint32_t watermark, uint32_t now) const {
+    uint32_t current = minuteStart(now);
+    
+    if (watermark == 0 || watermark > current) {
+        return current - 60;
+    }
+    
+    // No mirar más atrás que la gracia: esos inicios no se recuperarían igual
+    uint32_t oldest = now > policy.maxLateSec ? minuteStart(now - policy.maxLateSec) : 0;
+    if (oldest >= 60 && watermark < oldest - 60) {
+        return oldest - 60;
+    }
+    
+    return minuteStart(watermark);
+}
+
+// ============================================================================
+// Evaluar intervalo (watermark, now]
+// ============================================================================
+uint8_t AgendaEvaluator::evaluate(const AgendaTable& table, const AgendaIndex& index,
+                                  uint32_t watermark, uint32_t now,
+                                  AgendaRun* runs, uint8_t max) const {
+    uint8_t count = 0;
+    uint32_t current = minuteStart(now);
+    uint8_t firing[MAX_AGENDAS];
+    
+    for (uint32_t start = normalizeWatermark(watermark, now) + 60; start <= current; start += 60) {
+        uint8_t found = index.firingAt(epochMinuteOfWeek(start), firing, MAX_AGENDAS);
+        
+        for (uint8_t f = 0; f < found && count < max; f++) {
+            const AgendaSlot& slot = table.slots[firing[f]];
+            uint32_t late = now - start;
+            uint32_t windowSec = (uint32_t)slot.duracionMin * 60;
+            uint32_t duracion = windowSec;
+            
+            if (late >= 60) {
+                // Inicio perdido: aplicar política de recuperación
+                if (late > policy.maxLateSec || late >= windowSec) continue;
+                
+                uint32_t remaining = windowSec - late;
+                if (remaining < policy.minRemainingSec) continue;
+                if (policy.shortenDuration) duracion = remaining;
+            }
+            
+            AgendaRun& run = runs[count++];
+            run.slot = firing[f];
+            run.zona = slot.zona;
+            run.duracionSeg = duracion;
+            run.lateSec = late;
+            run.version = slot.version;
+        }
+    }
+    
+    return count;
+}
@@ -0,0 +1,63 @@
+#ifndef AGENDA_EVALUATOR_H
+#define AGENDA_EVALUATOR_H
+
+#include <stdint.h>
+#include "AgendaTable.h"
+#include "AgendaIndex.h"
+
+// ============================================================================
+// AgendaEvaluator - Evaluación de agendas por intervalo con recuperación
+// ============================================================================
+// Evalúa todos los inicios de agenda en el intervalo (watermark, ahora] en
+// lugar de solo el minuto actual. Así un minuto salteado por el poll, un
+// reinicio o un hueco de NTP no pierde el riego: si la ventana de la agenda
+// sigue abierta se ejecuta (o se acorta al tiempo restante) según la política.
+// Los epoch son "locales" (con offset de zona horaria, como TimeSync).
+
+struct CatchUpPolicy {
+    uint32_t maxLateSec;       // Gracia: atraso máximo para recuperar un inicio perdido
+    uint32_t minRemainingSec;  // No iniciar si queda menos de esto de la ventana
+    bool shortenDuration;      // true: regar solo lo que resta de la ventana
+};
+
+struct AgendaRun {
+    uint8_t slot;          // Índice en AgendaTable::slots
+    uint8_t zona;
+    uint32_t duracionSeg;  // Duración a aplicar (completa o acortada)
+    uint32_t lateSec;      // Atraso respecto del inicio programado (0-59 = a tiempo)
+    uint32_t version;
+};
+
+class AgendaEvaluator {
+private:
+    CatchUpPolicy policy;
+
+public:
+    // Política por defecto desde Config.h (AGENDA_CATCHUP_*)
+    AgendaEvaluator();
+    AgendaEvaluator(const CatchUpPolicy& policy);
+    
+    // Normalizar watermark (inicio del último minuto evaluado): sin watermark
+    // o con reloj hacia atrás se evalúa solo el minuto actual.
+    uint32_t normalizeWatermark(uint32_t watermark, uint32_t now) const;
+    
+    // Evaluar inicios en (watermark, now]. Escribe hasta `max` ejecuciones en
+    // `runs` y retorna la cantidad. El nuevo watermark es minuteStart(now).
+    uint8_t evaluate(const AgendaTable& table, const AgendaIndex& index,
+                     uint32_t watermark, uint32_t now,
+                     AgendaRun* runs, uint8_t max) const;
+    
+    const CatchUpPolicy& getPolicy() const;
+};
+
+// Inicio del minuto que contiene `epoch`
+inline uint32_t minuteStart(uint32_t epoch) {
+    return epoch - (epoch % 60);
+}
+
+// Minuto de la semana (0 = Lunes 00:00) de un epoch local. 1970-01-01 fue jueves.
+inline uint16_t epochMinuteOfWeek(uint32_t epoch) {
+    return (uint16_t)(((epoch / 60) + 3 * MINUTOS_POR_DIA) % MINUTOS_POR_SEMANA);
+}
+
+#endif // AGENDA_EVALUATOR_H
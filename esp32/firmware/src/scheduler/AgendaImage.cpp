@@ -0,0 +1,102 @@
+#include "AgendaImage.h"
+#include "../utils/Crc32.h"
+#include <string.h>
+
+static_assert(sizeof(AgendaImageHeader) == 24, "AgendaImageHeader cambio de tamaño");
+static_assert(sizeof(AgendaImageRecord) == 12, "AgendaImageRecord cambio de tamaño");
+static_assert(MAX_AGENDAS <= 255, "count de la imagen es de 8 bits");
+
+// ============================================================================
+// Serializar tabla -> imagen
+// ============================================================================
+size_t AgendaImage::encode(const AgendaTable& table, uint32_t sourceBytes, AgendaImageBuffer& buffer) {
+    memset(&buffer, 0, sizeof(buffer));
+    
+    AgendaImageHeader& header = buffer.header;
+    header.magic = AGENDA_IMAGE_MAGIC;
+    header.format = AGENDA_IMAGE_FORMAT;
+    header.recordSize = sizeof(AgendaImageRecord);
+    header.version = table.version;
+    header.count = table.count;
+    header.totalAgendas = table.totalAgendas;
+    header.sourceBytes = sourceBytes;
+    
+    for (uint8_t i = 0; i < table.count; i++) {
+        const AgendaSlot& slot = table.slots[i];
+        AgendaImageRecord& record = buffer.records[i];
+        record.version = slot.version;
+        record.minutoDia = slot.minutoDia;
+        record.duracionMin = slot.duracionMin;
+        record.zona = slot.zona;
+        record.diasMask = slot.diasMask;
+    }
+    
+    header.crc = computeCrc(buffer);
+    return sizeof(AgendaImageHeader) + (size_t)table.count * sizeof(AgendaImageRecord);
+}
+
+// ============================================================================
+// Validar imagen -> tabla
+// ============================================================================
+AgendaImageResult AgendaImage::decode(const AgendaImageBuffer& buffer, size_t length, AgendaTable& table) {
+    const AgendaImageHeader& header = buffer.header;
+    
+    if (length < sizeof(AgendaImageHeader)) return AGENDA_IMAGE_TRUNCATED;
+    if (header.magic != AGENDA_IMAGE_MAGIC) return AGENDA_IMAGE_BAD_MAGIC;
+    if (header.format != AGENDA_IMAGE_FORMAT || header.recordSize != sizeof(AgendaImageRecord)) {
+        return AGENDA_IMAGE_BAD_FORMAT;
+    }
+    if (header.count > MAX_AGENDAS || header.count > header.totalAgendas) {
+        return AGENDA_IMAGE_BAD_RECORD;
+    }
+    if (length != sizeof(AgendaImageHeader) + (size_t)header.count * sizeof(AgendaImageRecord)) {
+        return AGENDA_IMAGE_TRUNCATED;
+    }
+    if (computeCrc(buffer) != header.crc) return AGENDA_IMAGE_BAD_CRC;
+    
+    // Mismas reglas que AgendaCompiler: un registro inválido invalida la imagen
+    for (uint8_t i = 0; i < header.count; i++) {
+        const AgendaImageRecord& record = buffer.records[i];
+        if (record.zona < 1 || record.zona > MAX_ZONES) return AGENDA_IMAGE_BAD_RECORD;
+        if (record.minutoDia >= 1440 || record.duracionMin == 0) return AGENDA_IMAGE_BAD_RECORD;
+        if (record.diasMask == 0 || (record.diasMask & ~AGENDA_DIAS_TODOS) != 0) return AGENDA_IMAGE_BAD_RECORD;
+    }
+    
+    for (uint8_t i = 0; i < header.count; i++) {
+        const AgendaImageRecord& record = buffer.records[i];
+        AgendaSlot& slot = table.slots[i];
+        slot.version = record.version;
+        slot.minutoDia = record.minutoDia;
+        slot.duracionMin = record.duracionMin;
+        slot.zona = record.zona;
+        slot.diasMask = record.diasMask;
+    }
+    table.count = header.count;
+    table.totalAgendas = header.totalAgendas;
+    table.version = header.version;
+    return AGENDA_IMAGE_OK;
+}
+
+const char* AgendaImage::resultName(AgendaImageResult result) {
+    switch (result) {
+        case AGENDA_IMAGE_OK: return "ok";
+        case AGENDA_IMAGE_TRUNCATED: return "truncada";
+        case AGENDA_IMAGE_BAD_MAGIC: return "magic invalido";
+        case AGENDA_IMAGE_BAD_FORMAT: return "formato distinto";
+        case AGENDA_IMAGE_BAD_CRC: return "CRC invalido";
+        case AGENDA_IMAGE_BAD_RECORD: return "registro invalido";
+    }
+    return "?";
+}
+
+// ============================================================================
+// CRC de cabecera (con crc = 0) + registros ocupados
+// ============================================================================
+uint32_t AgendaImage::computeCrc(const AgendaImageBuffer& buffer) {
+    AgendaImageHeader header = buffer.header;
+    header.crc = 0;
+    
+    uint8_t count = header.count <= MAX_AGENDAS ? header.count : MAX_AGENDAS;
+    uint32_t crc = Crc32::update(0, &header, sizeof(header));
+    return Crc32::update(crc, buffer.records, (size_t)count * sizeof(AgendaImageRecord));
+}
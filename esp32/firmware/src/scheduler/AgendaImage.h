@@ -0,0 +1,74 @@
+#ifndef AGENDA_IMAGE_H
+#define AGENDA_IMAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "AgendaTable.h"
+
+// ============================================================================
+// AgendaImage - Imagen binaria de AgendaTable para flash
+// ============================================================================
+// Copia de la tabla compilada en registros de tamaño fijo (AGENDA_IMAGE_FILE).
+// Al iniciar se lee con un único read() a un buffer estático y se valida con
+// CRC32: no hace falta volver a parsear /agenda.json. El JSON queda solo como
+// formato de intercambio con el backend.
+//
+// Layout (little-endian, sin padding):
+//   AgendaImageHeader (24 bytes) + count × AgendaImageRecord (12 bytes)
+// El CRC cubre la cabecera (con crc = 0) y los registros ocupados.
+
+#define AGENDA_IMAGE_MAGIC 0x444E4741UL  // "AGND"
+#define AGENDA_IMAGE_FORMAT 1            // Incrementar al cambiar el layout
+
+struct AgendaImageHeader {
+    uint32_t magic;         // AGENDA_IMAGE_MAGIC
+    uint16_t format;        // AGENDA_IMAGE_FORMAT
+    uint16_t recordSize;    // sizeof(AgendaImageRecord)
+    int32_t version;        // AgendaTable::version
+    uint8_t count;          // Registros que siguen a la cabecera
+    uint8_t totalAgendas;   // AgendaTable::totalAgendas
+    uint16_t reserved;
+    uint32_t sourceBytes;   // Tamaño del JSON del que se compiló (detecta imagen vieja)
+    uint32_t crc;           // CRC32 de cabecera (crc = 0) + registros
+};
+
+struct AgendaImageRecord {
+    uint32_t version;
+    uint16_t minutoDia;
+    uint16_t duracionMin;
+    uint8_t zona;
+    uint8_t diasMask;
+    uint16_t reserved;
+};
+
+// Buffer de una imagen completa (tamaño máximo del archivo)
+struct AgendaImageBuffer {
+    AgendaImageHeader header;
+    AgendaImageRecord records[MAX_AGENDAS];
+};
+
+enum AgendaImageResult {
+    AGENDA_IMAGE_OK = 0,
+    AGENDA_IMAGE_TRUNCATED,     // Archivo más corto que la cabecera o que count registros
+    AGENDA_IMAGE_BAD_MAGIC,
+    AGENDA_IMAGE_BAD_FORMAT,    // Otra versión de formato o de tamaño de registro
+    AGENDA_IMAGE_BAD_CRC,
+    AGENDA_IMAGE_BAD_RECORD     // CRC correcto pero datos fuera de rango
+};
+
+class AgendaImage {
+public:
+    // Serializar la tabla; devuelve los bytes a escribir desde &buffer
+    static size_t encode(const AgendaTable& table, uint32_t sourceBytes, AgendaImageBuffer& buffer);
+    
+    // Validar y cargar una imagen leída (length = bytes leídos). La tabla
+    // solo se modifica si el resultado es AGENDA_IMAGE_OK.
+    static AgendaImageResult decode(const AgendaImageBuffer& buffer, size_t length, AgendaTable& table);
+    
+    static const char* resultName(AgendaImageResult result);
+
+private:
+    static uint32_t computeCrc(const AgendaImageBuffer& buffer);
+};
+
+#endif // AGENDA_IMAGE_H
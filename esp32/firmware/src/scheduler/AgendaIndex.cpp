@@ -0,0 +1,79 @@
+#include "AgendaIndex.h"
+
+// ============================================================================
+// Constructor
+// ============================================================================
+AgendaIndex::AgendaIndex() {
+    count = 0;
+}
+
+// ============================================================================
+// Construir índice desde la tabla compilada
+// ============================================================================
+void AgendaIndex::build(const AgendaTable& table) {
+    count = 0;
+    
+    for (uint8_t s = 0; s < table.count; s++) {
+        const AgendaSlot& slot = table.slots[s];
+        for (int day = 0; day < 7; day++) {
+            if (!slot.runsOnDay(day)) continue;
+            
+            AgendaIndexEntry entry;
+            entry.minutoSemana = (uint16_t)(day * MINUTOS_POR_DIA + slot.minutoDia);
+            entry.slot = s;
+            
+            // Inserción ordenada (estable: a igual minuto conserva el orden de la tabla)
+            uint16_t pos = count;
+            while (pos > 0 && entries[pos - 1].minutoSemana > entry.minutoSemana) {
+                entries[pos] = entries[pos - 1];
+                pos--;
+            }
+            entries[pos] = entry;
+            count++;
+        }
+    }
+}
+
+// ============================================================================
+// Búsqueda binaria
+// ============================================================================
+uint16_t AgendaIndex::lowerBound(uint16_t minuto) const {
+    uint16_t lo = 0;
+    uint16_t hi = count;
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        if (entries[mid].minutoSemana < minuto) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// ============================================================================
+// Consultas
+// ============================================================================
+uint8_t AgendaIndex::firingAt(uint16_t minuto, uint8_t* slots, uint8_t max) const {
+    uint8_t found = 0;
+    for (uint16_t i = lowerBound(minuto); i < count && entries[i].minutoSemana == minuto; i++) {
+        if (found >= max) break;
+        slots[found++] = entries[i].slot;
+    }
+    return found;
+}
+
+int32_t AgendaIndex::minutesUntilNext(uint16_t minuto) const {
+    if (count == 0) return -1;
+    
+    uint16_t i = lowerBound(minuto);
+    if (i < count) {
+        return entries[i].minutoSemana - minuto;
+    }
+    // Sin disparos hasta fin de semana: el próximo es el primero de la semana siguiente
+    return (int32_t)(MINUTOS_POR_SEMANA - minuto) + entries[0].minutoSemana;
+}
+
+uint16_t AgendaIndex::size() const {
+    return count;
+}
@@ -0,0 +1,55 @@
+#ifndef AGENDA_INDEX_H
+#define AGENDA_INDEX_H
+
+#include <stdint.h>
+#include "AgendaTable.h"
+
+// ============================================================================
+// AgendaIndex - Índice de disparos por minuto de la semana
+// ============================================================================
+// Lista ordenada de (minuto de la semana, slot) construida desde AgendaTable.
+// Responde "qué dispara ahora" y "cuánto falta para el próximo disparo" con
+// una búsqueda binaria, sin comparar strings ni recorrer todas las agendas.
+// Minuto de la semana: 0 = Lunes 00:00 ... 10079 = Domingo 23:59.
+
+#define MINUTOS_POR_DIA 1440
+#define MINUTOS_POR_SEMANA 10080
+#define AGENDA_INDEX_MAX_ENTRIES (MAX_AGENDAS * 7)
+
+struct AgendaIndexEntry {
+    uint16_t minutoSemana;  // Minuto de inicio (0-10079)
+    uint8_t slot;           // Índice en AgendaTable::slots
+};
+
+class AgendaIndex {
+private:
+    AgendaIndexEntry entries[AGENDA_INDEX_MAX_ENTRIES];
+    uint16_t count;
+    
+    // Primera entrada con minutoSemana >= minuto
+    uint16_t lowerBound(uint16_t minuto) const;
+
+public:
+    AgendaIndex();
+    
+    // Reconstruir el índice (llamar cada vez que se recompila la tabla)
+    void build(const AgendaTable& table);
+    
+    // Slots que inician exactamente en `minuto`. Escribe hasta `max` índices
+    // en `slots` y retorna la cantidad escrita.
+    uint8_t firingAt(uint16_t minuto, uint8_t* slots, uint8_t max) const;
+    
+    // Minutos desde `minuto` hasta el próximo inicio (0 si dispara en `minuto`),
+    // considerando el cruce de fin de semana. -1 si no hay agendas.
+    int32_t minutesUntilNext(uint16_t minuto) const;
+    
+    // Cantidad de disparos semanales indexados
+    uint16_t size() const;
+};
+
+// Convertir tm_wday (0=Domingo), hora y minuto a minuto de la semana
+inline uint16_t agendaMinuteOfWeek(int wday, int hour, int minute) {
+    return (uint16_t)(agendaDayIndex(wday) * MINUTOS_POR_DIA + hour * 60 + minute);
+}
+
+#endif // AGENDA_INDEX_H
@@ -2,21 +2,26 @@
 #include "../storage/SPIFFSManager.h"
 #include "../network/TimeSync.h"
 #include "../network/MqttManager.h"
-#include "../hardware/RelayController.h"
+#include "ZoneSequencer.h"
 #include "../utils/Logger.h"
 #include <time.h>
 
+// Buffer de lectura/escritura de /agenda.bin (estático: fuera del stack)
+static AgendaImageBuffer imageBuffer;
+
 // ============================================================================
 // Constructor y Destructor
 // ============================================================================
-AgendaManager::AgendaManager(SPIFFSManager* spiffs, TimeSync* timeSync, RelayController* relay, MqttManager* mqtt) {
+AgendaManager::AgendaManager(SPIFFSManager* spiffs, TimeSync* timeSync, ZoneSequencer* zoneSequencer, MqttManager* mqtt) {
     spiffsManager = spiffs;
     timeSyncManager = timeSync;
-    relayController = relay;
+    sequencer = zoneSequencer;
     mqttManager = mqtt;
     enabled = true;
     lastCheckTime = 0;
-    lastMinuteChecked = -1;
+    watermark = 0;
+    lastPersistedWatermark = 0;
+    loadReported = false;
 }
 
 AgendaManager::~AgendaManager() {
@@ -26,11 +31,20 @@ AgendaManager::~AgendaManager() {
 // Inicialización
 // ============================================================================
 void AgendaManager::init() {
-    Logger::info("Inicializando AgendaManager...");
+    LOG_INFO("Inicializando AgendaManager...");
     enabled = true;
     lastCheckTime = 0;
-    lastMinuteChecked = -1;
-    Logger::info("AgendaManager inicializado correctamente");
+    
+    // Recuperar último minuto evaluado antes del reinicio
+    loadWatermark();
+    
+    // Cargar la tabla desde la imagen binaria; si falta o no es válida,
+    // compilar /agenda.json (reload() regenera la imagen)
+    if (!loadImage()) {
+        reload();
+    }
+    
+    LOG_INFO("AgendaManager inicializado correctamente");
 }
 
 // ============================================================================
@@ -49,183 +63,364 @@ void AgendaManager::loop() {
 }
 
 // ============================================================================
-// Verificar y ejecutar agendas
+// Compilar /agenda.json a la tabla en RAM
 // ============================================================================
-void AgendaManager::checkAndExecuteAgendas() {
-    // Verificar que la hora esté sincronizada
-    if (!timeSyncManager->isSynchronized()) {
-        return;
+bool AgendaManager::reload() {
+    table.clear();
+    agendaIndex.build(table);
+    loadReported = false;
+    
+    if (!spiffsManager->exists(AGENDA_FILE)) {
+        LOG_DEBUG("No hay agendas en SPIFFS");
+        invalidateImage();
+        return false;
     }
     
-    // Obtener tiempo actual
-    time_t now = timeSyncManager->getEpoch();
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
+    File file = spiffsManager->openFile(AGENDA_FILE, "r");
+    if (!file) {
+        return false;
+    }
     
-    int currentDayOfWeek = timeinfo.tm_wday; // 0=DOM, 1=LUN, ..., 6=SAB
-    int currentHour = timeinfo.tm_hour;
-    int currentMinute = timeinfo.tm_min;
+    // Log de tamaño para diagnóstico (el archivo se lee en streaming)
+    size_t fileSize = file.size();
+    LOG_DEBUG("JSON de agendas: %u bytes (RAM libre: %u bytes)",
+              (unsigned)fileSize, ESP.getFreeHeap());
     
-    // Evitar ejecutar múltiples veces en el mismo minuto
-    int currentMinuteId = currentHour * 60 + currentMinute;
-    if (currentMinuteId == lastMinuteChecked) {
-        return;
+    DeserializationError error;
+    AgendaCompileResult result = AgendaCompiler::compileFile(file, table, error);
+    file.close();
+    
+    if (result == AGENDA_COMPILE_PARSE_ERROR) {
+        table.clear();
+        String errorMsg = String("Error parseando agendas: ") + error.c_str() + 
+                         " (JSON: " + String((unsigned)fileSize) + " bytes)";
+        LOG_ERROR("%s", errorMsg.c_str());
+        publishLoadError(SYS_AGENDA_PARSE_ERROR, errorMsg);
+        invalidateImage();
+        return false;
+    }
+    
+    if (result == AGENDA_COMPILE_NO_AGENDAS) {
+        String errorMsg = "JSON no contiene campo 'agendas'";
+        LOG_WARN("%s", errorMsg.c_str());
+        publishLoadError(SYS_AGENDA_FORMAT_ERROR, errorMsg);
+        invalidateImage();
+        return false;
     }
-    lastMinuteChecked = currentMinuteId;
     
-    Logger::logf(LOG_LEVEL_DEBUG, "Verificando agendas: %s %02d:%02d", 
-                 getDayOfWeekString(currentDayOfWeek).c_str(), currentHour, currentMinute);
+    agendaIndex.build(table);
+    saveImage((uint32_t)fileSize);
     
-    // Leer archivo de agendas
-    String jsonContent = spiffsManager->readFile("/agenda.json");
-    if (jsonContent.length() == 0) {
-        Logger::debug("No hay agendas en SPIFFS");
-        return;
+    LOG_INFO("Agendas compiladas: %d activas de %d, %d disparos/semana (version %ld, %u bytes en RAM)",
+             table.count, table.totalAgendas, agendaIndex.size(), (long)table.version,
+             (unsigned)(sizeof(table) + sizeof(agendaIndex)));
+    return true;
+}
+
+// ============================================================================
+// Imagen binaria de la tabla (/agenda.bin)
+// ============================================================================
+bool AgendaManager::loadImage() {
+    if (!spiffsManager->exists(AGENDA_IMAGE_FILE) || !spiffsManager->exists(AGENDA_FILE)) {
+        return false;
     }
     
-    // Log de tamaño para diagnóstico
-    Logger::logf(LOG_LEVEL_DEBUG, "JSON de agendas: %d bytes (RAM libre: %d bytes)", 
-                 jsonContent.length(), ESP.getFreeHeap());
+    unsigned long start = micros();
     
-    // Parsear JSON (usar DynamicJsonDocument con overhead suficiente)
-    // ArduinoJson requiere ~1.5x el tamaño del JSON + overhead de estructuras
-    size_t docSize = (jsonContent.length() * 3 / 2) + 1024;
-    Logger::logf(LOG_LEVEL_DEBUG, "Reservando %d bytes para DynamicJsonDocument", docSize);
+    // Tamaño del JSON vigente: si no coincide, la imagen es de otra agenda
+    File json = spiffsManager->openFile(AGENDA_FILE, "r");
+    if (!json) return false;
+    size_t jsonBytes = json.size();
+    json.close();
     
-    DynamicJsonDocument doc(docSize);
-    DeserializationError error = deserializeJson(doc, jsonContent);
+    File file = spiffsManager->openFile(AGENDA_IMAGE_FILE, "r");
+    if (!file) return false;
     
-    if (error) {
-        String errorMsg = String("Error parseando agendas: ") + error.c_str() + 
-                         " (JSON: " + String(jsonContent.length()) + " bytes, Buffer: " + String(docSize) + " bytes)";
-        Logger::logf(LOG_LEVEL_ERROR, "%s", errorMsg.c_str());
-        
-        // Publicar evento de error via MQTT
-        if (mqttManager != nullptr && mqttManager->isConnected()) {
-            mqttManager->publishSystemEvent("agenda_parse_error", errorMsg, 0);
-        }
-        
-        return;
+    size_t fileSize = file.size();
+    size_t readBytes = 0;
+    if (fileSize <= sizeof(imageBuffer)) {
+        readBytes = file.read((uint8_t*)&imageBuffer, fileSize);
     }
+    file.close();
     
-    // Verificar que exista el array de agendas
-    if (!doc.containsKey("agendas")) {
-        String errorMsg = "JSON no contiene campo 'agendas'";
-        Logger::warn(errorMsg.c_str());
-        
-        // Publicar evento de error via MQTT
-        if (mqttManager != nullptr && mqttManager->isConnected()) {
-            mqttManager->publishSystemEvent("agenda_format_error", errorMsg, 0);
-        }
-        
-        return;
+    AgendaImageResult result = fileSize <= sizeof(imageBuffer)
+        ? AgendaImage::decode(imageBuffer, readBytes, table)
+        : AGENDA_IMAGE_TRUNCATED;
+    if (result == AGENDA_IMAGE_OK && imageBuffer.header.sourceBytes != jsonBytes) {
+        table.clear();
+        LOG_WARN("Imagen de agendas desactualizada (%lu bytes de JSON, vigente %u), recompilando",
+                 (unsigned long)imageBuffer.header.sourceBytes, (unsigned)jsonBytes);
+        return false;
+    }
+    if (result != AGENDA_IMAGE_OK) {
+        LOG_WARN("Imagen de agendas descartada (%s, %u bytes), recompilando JSON",
+                 AgendaImage::resultName(result), (unsigned)fileSize);
+        return false;
     }
     
-    JsonArray agendas = doc["agendas"].as<JsonArray>();
+    agendaIndex.build(table);
+    loadReported = false;
     
-    // Obtener versión de la agenda si existe
-    int versionAgenda = doc["version"] | 0;
+    LOG_INFO("Agendas cargadas desde imagen: %d activas de %d (version %ld, %u bytes, %lu us)",
+             table.count, table.totalAgendas, (long)table.version, (unsigned)fileSize,
+             (unsigned long)(micros() - start));
+    return true;
+}
+
+void AgendaManager::saveImage(uint32_t sourceBytes) {
+    size_t length = AgendaImage::encode(table, sourceBytes, imageBuffer);
     
-    // Contar agendas activas
-    int agendasActivas = 0;
-    int agendasTotal = 0;
+    // Escribir a temporal y renombrar: nunca queda una imagen a medio escribir
+    File file = spiffsManager->openFile(AGENDA_IMAGE_TEMP_FILE, "w");
+    if (!file) return;
+    size_t written = file.write((const uint8_t*)&imageBuffer, length);
+    file.close();
     
-    // Iterar sobre cada agenda
-    for (JsonObject agenda : agendas) {
-        agendasTotal++;
-        bool activa = agenda["activa"] | false;
-        if (activa) agendasActivas++;
-        
-        if (shouldExecuteAgenda(agenda, currentDayOfWeek, currentHour, currentMinute)) {
-            int zona = agenda["zona"] | 0;
-            int duracionMin = agenda["duracionMin"] | 0;
-            String id = agenda["id"] | "unknown";
-            
-            Logger::logf(LOG_LEVEL_INFO, "Ejecutando agenda [%s]: Zona %d por %d minutos (version %d)", 
-                         id.c_str(), zona, duracionMin, versionAgenda);
-            
-            // Activar zona con origen "agenda" y versión
-            int duracionSeg = duracionMin * 60;
-            relayController->turnOn(zona, duracionSeg, "agenda", versionAgenda);
-        }
+    if (written != length || !spiffsManager->renameFile(AGENDA_IMAGE_TEMP_FILE, AGENDA_IMAGE_FILE)) {
+        LOG_ERROR("No se pudo guardar %s (%u/%u bytes)",
+                  AGENDA_IMAGE_FILE, (unsigned)written, (unsigned)length);
+        spiffsManager->deleteFile(AGENDA_IMAGE_TEMP_FILE);
+        invalidateImage();
+        return;
     }
     
-    // Publicar evento de sincronización exitosa (solo la primera vez que se parsea exitosamente)
-    static bool firstSuccessfulParse = true;
-    if (firstSuccessfulParse && mqttManager != nullptr && mqttManager->isConnected()) {
-        String detalles = String("Agendas cargadas: ") + agendasTotal + " total, " + agendasActivas + " activas";
-        mqttManager->publishSystemEvent("agenda_sync_ok", detalles, agendasTotal);
-        firstSuccessfulParse = false;
+    LOG_DEBUG("Imagen de agendas guardada: %u bytes", (unsigned)length);
+}
+
+void AgendaManager::invalidateImage() {
+    if (spiffsManager->exists(AGENDA_IMAGE_FILE)) {
+        spiffsManager->deleteFile(AGENDA_IMAGE_FILE);
     }
 }
 
 // ============================================================================
-// Verificar si una agenda debe ejecutarse
+// Sync delta: agenda vigente + delta -> archivo nuevo
 // ============================================================================
-bool AgendaManager::shouldExecuteAgenda(JsonObject agenda, int currentDayOfWeek, int currentHour, int currentMinute) {
-    // Verificar que la agenda esté activa
-    bool activa = agenda["activa"] | false;
-    if (!activa) {
-        return false;
+AgendaDeltaResult AgendaManager::mergeDelta(const char* deltaPath, const char* outPath, String& errorMsg) {
+    File delta = spiffsManager->openFile(deltaPath, "r");
+    if (!delta) {
+        errorMsg = String("No se pudo abrir ") + deltaPath;
+        return AGENDA_DELTA_PARSE_ERROR;
     }
     
-    // Verificar día de la semana
-    JsonArray diasSemana = agenda["diasSemana"];
-    if (!diasSemana) {
-        return false;
+    // Cabecera primero: una lista completa no necesita abrir más archivos
+    AgendaDeltaInfo info;
+    DeserializationError error;
+    if (!AgendaDelta::readHeader(delta, info, error) || !info.isDelta) {
+        delta.close();
+        return AGENDA_DELTA_NOT_DELTA;
+    }
+    
+    File current;
+    if (spiffsManager->exists(AGENDA_FILE)) {
+        current = spiffsManager->openFile(AGENDA_FILE, "r");
+    }
+    File out = spiffsManager->openFile(outPath, "w");
+    if (!out) {
+        delta.close();
+        if (current) current.close();
+        errorMsg = String("No se pudo crear ") + outPath;
+        return AGENDA_DELTA_WRITE_ERROR;
     }
     
-    String currentDay = getDayOfWeekString(currentDayOfWeek);
-    bool diaCoincide = false;
+    AgendaDeltaResult result = AgendaDelta::merge(current, delta, table.version, out, info, error);
+    size_t outBytes = out.size();
+    out.close();
+    delta.close();
+    if (current) current.close();
     
-    for (JsonVariant dia : diasSemana) {
-        String diaStr = dia.as<String>();
-        if (diaStr.equalsIgnoreCase(currentDay)) {
-            diaCoincide = true;
-            break;
+    if (result != AGENDA_DELTA_OK) {
+        spiffsManager->deleteFile(outPath);
+        errorMsg = String("Delta ") + info.baseVersion + " -> " + info.version + " (local " + table.version + "): " +
+                   AgendaDelta::resultName(result);
+        if (error) {
+            errorMsg += String(" - ") + error.c_str();
         }
+        return result;
     }
     
-    if (!diaCoincide) {
+    LOG_INFO("Delta de agenda %ld -> %ld: %d nuevas/modificadas, %d eliminadas, %d sin cambios (%u bytes)",
+             (long)info.baseVersion, (long)info.version, info.upserts, info.removed, info.kept,
+             (unsigned)outBytes);
+    return AGENDA_DELTA_OK;
+}
+
+// ============================================================================
+// Validar un archivo de agendas sin tocar la tabla activa
+// ============================================================================
+bool AgendaManager::validateFile(const char* path, String& errorMsg) {
+    File file = spiffsManager->openFile(path, "r");
+    if (!file) {
+        errorMsg = String("No se pudo abrir ") + path;
         return false;
     }
     
-    // Verificar hora
-    String horaInicio = agenda["horaInicio"] | "";
-    if (horaInicio.length() == 0) {
+    AgendaTable scratch;
+    DeserializationError error;
+    AgendaCompileResult result = AgendaCompiler::compileFile(file, scratch, error);
+    size_t fileSize = file.size();
+    file.close();
+    
+    if (result == AGENDA_COMPILE_PARSE_ERROR) {
+        errorMsg = String("Error parseando agendas: ") + error.c_str() + 
+                   " (JSON: " + String((unsigned)fileSize) + " bytes)";
         return false;
     }
     
-    // Parsear hora (formato "HH:MM")
-    int separatorPos = horaInicio.indexOf(':');
-    if (separatorPos < 0) {
+    if (result == AGENDA_COMPILE_NO_AGENDAS) {
+        errorMsg = "JSON no contiene campo 'agendas'";
         return false;
     }
     
-    int agendaHour = horaInicio.substring(0, separatorPos).toInt();
-    int agendaMinute = horaInicio.substring(separatorPos + 1).toInt();
+    LOG_INFO("Agenda valida: %d activas de %d (%u bytes)",
+             scratch.count, scratch.totalAgendas, (unsigned)fileSize);
+    return true;
+}
+
+// ============================================================================
+// Publicar error de carga via MQTT
+// ============================================================================
+void AgendaManager::publishLoadError(SystemEvent tipo, const String& detalles) {
+    if (mqttManager != nullptr && mqttManager->isConnected()) {
+        mqttManager->publishSystemEvent(tipo, detalles.c_str(), 0);
+    }
+}
+
+const AgendaTable& AgendaManager::getTable() {
+    return table;
+}
+
+// ============================================================================
+// Próximo disparo (para planificar el sueño del loop principal)
+// ============================================================================
+time_t AgendaManager::getNextAgendaEpoch() {
+    if (!timeSyncManager->isSynchronized()) return 0;
+    
+    uint32_t now = (uint32_t)timeSyncManager->getEpoch();
+    uint32_t current = minuteStart(now);
+    uint16_t minuteOfWeek = epochMinuteOfWeek(now);
+    int32_t minutes;
     
-    // Comparar hora y minuto
-    if (agendaHour == currentHour && agendaMinute == currentMinute) {
-        return true;
+    // Si el minuto actual ya fue evaluado, buscar desde el siguiente
+    if (current == watermark) {
+        minutes = agendaIndex.minutesUntilNext((minuteOfWeek + 1) % MINUTOS_POR_SEMANA);
+        if (minutes >= 0) minutes += 1;
+    } else {
+        minutes = agendaIndex.minutesUntilNext(minuteOfWeek);
     }
     
-    return false;
+    if (minutes < 0) return 0;
+    return (time_t)current + (time_t)minutes * 60;
+}
+
+long AgendaManager::getMsUntilNextRun() {
+    if (!enabled) return -1;
+    
+    time_t next = getNextAgendaEpoch();
+    if (next == 0) return -1;
+    
+    long ms = (long)(next - timeSyncManager->getEpoch()) * 1000L;
+    
+    // loop() solo verifica cada CHECK_INTERVAL: despertar cuando ambas condiciones se cumplan
+    unsigned long sinceCheck = millis() - lastCheckTime;
+    long untilCheck = sinceCheck >= CHECK_INTERVAL ? 0 : (long)(CHECK_INTERVAL - sinceCheck);
+    return ms > untilCheck ? ms : untilCheck;
 }
 
 // ============================================================================
-// Convertir día de la semana a string
+// Verificar y ejecutar agendas (sin heap: búsquedas en el índice)
 // ============================================================================
-String AgendaManager::getDayOfWeekString(int dayOfWeek) {
-    switch (dayOfWeek) {
-        case 0: return "DOM";
-        case 1: return "LUN";
-        case 2: return "MAR";
-        case 3: return "MIE";
-        case 4: return "JUE";
-        case 5: return "VIE";
-        case 6: return "SAB";
-        default: return "???";
+void AgendaManager::checkAndExecuteAgendas() {
+    // Verificar que la hora esté sincronizada
+    if (!timeSyncManager->isSynchronized()) {
+        return;
+    }
+    
+    uint32_t now = (uint32_t)timeSyncManager->getEpoch();
+    uint32_t current = minuteStart(now);
+    
+    // Evitar ejecutar múltiples veces en el mismo minuto
+    if (current == watermark) {
+        return;
+    }
+    
+    uint32_t from = evaluator.normalizeWatermark(watermark, now);
+    if (current - from > 60) {
+        LOG_INFO("Evaluando agendas desde hace %lu min (recuperacion)",
+                 (unsigned long)((current - from) / 60));
+    } else {
+        LOG_DEBUG("Verificando agendas: minuto %u de la semana", epochMinuteOfWeek(now));
+    }
+    
+    // Todos los inicios en (watermark, ahora]
+    AgendaRun runs[MAX_AGENDAS];
+    uint8_t runCount = evaluator.evaluate(table, agendaIndex, watermark, now, runs, MAX_AGENDAS);
+    watermark = current;
+    
+    for (uint8_t i = 0; i < runCount; i++) {
+        const AgendaRun& run = runs[i];
+        
+        if (run.lateSec >= 60) {
+            // Inicio perdido: no pisar un riego que ya esté en curso o en cola en la zona
+            if (sequencer->isBusy(run.zona)) {
+                LOG_INFO("Agenda atrasada zona %d omitida (zona ya activa o en cola)", run.zona);
+                continue;
+            }
+            LOG_WARN("Recuperando agenda atrasada %lu seg: Zona %d por %lu seg (version %lu)",
+                     (unsigned long)run.lateSec, run.zona, (unsigned long)run.duracionSeg,
+                     (unsigned long)run.version);
+        } else {
+            LOG_INFO("Ejecutando agenda: Zona %d por %lu seg (version %lu)", 
+                     run.zona, (unsigned long)run.duracionSeg, (unsigned long)run.version);
+        }
+        
+        // Pedir la zona con origen "agenda" y versión (arranca o queda en cola
+        // según la capacidad hidráulica)
+        sequencer->request(run.zona, run.duracionSeg, ORIGEN_AGENDA, run.version);
+    }
+    
+    // Persistir siempre que se ejecutó algo (evita repetir riegos tras reiniciar)
+    persistWatermark(runCount > 0);
+    
+    // Publicar evento de carga exitosa (una vez por compilación, cuando haya conexión)
+    if (!loadReported && mqttManager != nullptr && mqttManager->isConnected()) {
+        String detalles = String("Agendas cargadas: ") + table.totalAgendas + " total, " + table.count + " activas";
+        mqttManager->publishSystemEvent(SYS_AGENDA_SYNC_OK, detalles.c_str(), table.totalAgendas);
+        loadReported = true;
+    }
+}
+
+// ============================================================================
+// Watermark persistido (último minuto evaluado)
+// ============================================================================
+void AgendaManager::loadWatermark() {
+    watermark = 0;
+    lastPersistedWatermark = 0;
+    
+    if (!spiffsManager->exists(AGENDA_WATERMARK_FILE)) {
+        return;
+    }
+    
+    String raw = spiffsManager->readFile(AGENDA_WATERMARK_FILE);
+    watermark = (uint32_t)strtoul(raw.c_str(), nullptr, 10);
+    lastPersistedWatermark = watermark;
+    LOG_INFO("Watermark de agendas recuperado: %lu", (unsigned long)watermark);
+}
+
+void AgendaManager::restoreWatermark(uint32_t rtcWatermark) {
+    if (rtcWatermark <= watermark) return;
+    LOG_INFO("Watermark de agendas desde memoria RTC: %lu (archivo: %lu)",
+             (unsigned long)rtcWatermark, (unsigned long)watermark);
+    watermark = rtcWatermark;
+}
+
+void AgendaManager::persistWatermark(bool force) {
+    if (!force && watermark - lastPersistedWatermark < AGENDA_WATERMARK_PERSIST_SEC) {
+        return;
+    }
+    
+    if (spiffsManager->writeFile(AGENDA_WATERMARK_FILE, String((unsigned long)watermark))) {
+        lastPersistedWatermark = watermark;
     }
 }
 
@@ -234,13 +429,14 @@ String AgendaManager::getDayOfWeekString(int dayOfWeek) {
 // ============================================================================
 void AgendaManager::enable() {
     enabled = true;
-    lastMinuteChecked = -1;
-    Logger::info("AgendaManager habilitado");
+    // No recuperar lo que se omitió mientras estuvo deshabilitado
+    watermark = 0;
+    LOG_INFO("AgendaManager habilitado");
 }
 
 void AgendaManager::disable() {
     enabled = false;
-    Logger::info("AgendaManager deshabilitado");
+    LOG_INFO("AgendaManager deshabilitado");
 }
 
 bool AgendaManager::isEnabled() {
@@ -3,42 +3,94 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <time.h>
+#include "../config/EventTypes.h"
+#include "AgendaTable.h"
+#include "AgendaIndex.h"
+#include "AgendaEvaluator.h"
+#include "AgendaCompiler.h"
+#include "AgendaImage.h"
+#include "AgendaDelta.h"
 
 class SPIFFSManager;
 class TimeSync;
-class RelayController;
+class ZoneSequencer;
 class MqttManager;
 
 // ============================================================================
 // AgendaManager - Gestión y ejecución de agendas programadas
 // ============================================================================
-// Lee agendas desde SPIFFS y las ejecuta automáticamente verificando
-// la hora actual contra las programaciones configuradas.
+// Compila /agenda.json a una tabla en RAM (en cada sync) y la ejecuta
+// automáticamente evaluando el intervalo desde el último minuto verificado,
+// de modo que los inicios perdidos puedan recuperarse. La tabla compilada se
+// guarda también como imagen binaria (/agenda.bin) y al iniciar se carga de
+// ahí; el JSON solo se vuelve a compilar si la imagen falta o no es válida.
 
 class AgendaManager {
 private:
     SPIFFSManager* spiffsManager;
     TimeSync* timeSyncManager;
-    RelayController* relayController;
+    ZoneSequencer* sequencer;
     MqttManager* mqttManager;
     
     bool enabled;
     unsigned long lastCheckTime;
-    int lastMinuteChecked;
+    
+    // Inicio del último minuto evaluado (persistido en AGENDA_WATERMARK_FILE)
+    uint32_t watermark;
+    uint32_t lastPersistedWatermark;
+    AgendaEvaluator evaluator;
+    
+    // Agendas compiladas (se recompila solo en reload())
+    AgendaTable table;
+    AgendaIndex agendaIndex;
+    bool loadReported;
     
     static const unsigned long CHECK_INTERVAL = 10000;
     
     void checkAndExecuteAgendas();
-    bool shouldExecuteAgenda(JsonObject agenda, int currentDayOfWeek, int currentHour, int currentMinute);
-    String getDayOfWeekString(int dayOfWeek);
+    void loadWatermark();
+    void persistWatermark(bool force);
+    void publishLoadError(SystemEvent tipo, const String& detalles);
+    bool loadImage();
+    void saveImage(uint32_t sourceBytes);
 
 public:
-    AgendaManager(SPIFFSManager* spiffs, TimeSync* timeSync, RelayController* relay, MqttManager* mqtt);
+    AgendaManager(SPIFFSManager* spiffs, TimeSync* timeSync, ZoneSequencer* sequencer, MqttManager* mqtt);
     ~AgendaManager();
     
     void init();
     void loop();
     
+    // Recompilar la tabla desde /agenda.json (llamar tras cada sync)
+    bool reload();
+    
+    // Borrar la imagen binaria (llamar antes de reemplazar /agenda.json)
+    void invalidateImage();
+    
+    // Sync delta: combinar el delta en `deltaPath` con /agenda.json en `outPath`
+    // (solo queda escrito si devuelve AGENDA_DELTA_OK). NOT_DELTA = lista completa.
+    AgendaDeltaResult mergeDelta(const char* deltaPath, const char* outPath, String& errorMsg);
+    
+    // Validar un JSON de agendas (streaming, sin modificar la tabla activa)
+    bool validateFile(const char* path, String& errorMsg);
+    
+    // Tabla compilada actual (solo lectura)
+    const AgendaTable& getTable();
+    
+    // Epoch del próximo inicio de agenda aún no ejecutado (0 si no hay agendas u hora)
+    time_t getNextAgendaEpoch();
+    
+    // Ms hasta que loop() ejecutará ese inicio (-1 si no hay nada programado)
+    long getMsUntilNextRun();
+    
+    // Último minuto evaluado (se guarda también en memoria RTC, ver WarmRestart)
+    uint32_t getWatermark() const { return watermark; }
+    
+    // Reinicio en caliente: el watermark de la memoria RTC está al día; el
+    // archivo solo se escribe cada AGENDA_WATERMARK_PERSIST_SEC
+    void restoreWatermark(uint32_t rtcWatermark);
+    
     void enable();
     void disable();
     bool isEnabled();
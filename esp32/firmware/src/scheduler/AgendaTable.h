@@ -0,0 +1,80 @@
+#ifndef AGENDA_TABLE_H
+#define AGENDA_TABLE_H
+
+#include <stdint.h>
+#include "../config/Config.h"
+
+// ============================================================================
+// AgendaTable - Tabla compilada de agendas en RAM
+// ============================================================================
+// Representación compacta (POD, tamaño fijo) de /agenda.json. Se compila una
+// sola vez al iniciar o al recibir una sincronización, y la verificación
+// por minuto trabaja solo contra esta tabla (sin heap ni acceso a flash).
+
+// Bits de diasMask: bit 0 = Lunes ... bit 6 = Domingo (mismo orden que DIAS_SEMANA)
+#define AGENDA_DIAS_TODOS 0x7F
+
+struct AgendaSlot {
+    uint32_t version;      // Versión de la agenda (por registro o global del sync)
+    uint16_t minutoDia;    // Hora de inicio en minutos desde 00:00 (0-1439)
+    uint16_t duracionMin;  // Duración en minutos
+    uint8_t zona;          // Número de zona (1-MAX_ZONES)
+    uint8_t diasMask;      // Días activos (ver AGENDA_DIAS_TODOS)
+
+    // Verificar si corre en un día (dayIndex: 0=Lunes ... 6=Domingo)
+    bool runsOnDay(int dayIndex) const {
+        return (diasMask >> dayIndex) & 0x01;
+    }
+};
+
+struct AgendaTable {
+    AgendaSlot slots[MAX_AGENDAS];  // Solo agendas activas y válidas
+    uint8_t count;                  // Slots ocupados
+    uint8_t totalAgendas;           // Agendas presentes en el JSON (activas o no)
+    int32_t version;                // Versión global del sync (0 si no vino)
+
+    AgendaTable() : count(0), totalAgendas(0), version(0) {}
+
+    void clear() {
+        count = 0;
+        totalAgendas = 0;
+        version = 0;
+    }
+};
+
+// Convertir tm_wday (0=Domingo) a índice de día (0=Lunes)
+inline int agendaDayIndex(int wday) {
+    return (wday == 0) ? 6 : wday - 1;
+}
+
+// Convertir nombre de día ("LUN", "mar", ...) a índice (0=Lunes), -1 si no es válido
+inline int agendaDayIndexFromName(const char* name) {
+    if (name == nullptr) return -1;
+    for (int i = 0; i < 7; i++) {
+        const char* dia = DIAS_SEMANA[i];
+        int j = 0;
+        while (dia[j] != '\0' && name[j] != '\0' &&
+               (name[j] == dia[j] || name[j] == dia[j] + ('a' - 'A'))) {
+            j++;
+        }
+        if (dia[j] == '\0' && name[j] == '\0') return i;
+    }
+    return -1;
+}
+
+// Parsear "HH:MM" (o "HH:MM:SS") a minutos del día, -1 si no es válido
+inline int agendaMinuteFromHora(const char* hora) {
+    if (hora == nullptr) return -1;
+    int h = 0;
+    int m = 0;
+    int i = 0;
+    if (hora[i] < '0' || hora[i] > '9') return -1;
+    while (hora[i] >= '0' && hora[i] <= '9') h = h * 10 + (hora[i++] - '0');
+    if (hora[i++] != ':') return -1;
+    if (hora[i] < '0' || hora[i] > '9') return -1;
+    while (hora[i] >= '0' && hora[i] <= '9') m = m * 10 + (hora[i++] - '0');
+    if (h > 23 || m > 59) return -1;
+    return h * 60 + m;
+}
+
+#endif // AGENDA_TABLE_H
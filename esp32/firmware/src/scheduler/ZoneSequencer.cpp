@@ -0,0 +1,202 @@
+#include "ZoneSequencer.h"
+#include "../utils/Logger.h"
+
+static const uint8_t DEFAULT_FLOW_WEIGHTS[MAX_ZONES] = SEQUENCER_FLOW_WEIGHTS;
+
+// ============================================================================
+// Constructor y configuración
+// ============================================================================
+ZoneSequencer::ZoneSequencer(RelayController* relays)
+    : relays(relays), riegoEventCallback(nullptr), nextOrden(1) {
+    memset(&queue, 0, sizeof(queue));
+    setMaxActive(SEQUENCER_MAX_ACTIVE_ZONES);
+    setFlow(SEQUENCER_FLOW_CAPACITY, DEFAULT_FLOW_WEIGHTS);
+}
+
+void ZoneSequencer::setMaxActive(uint8_t zones) {
+    maxActive = zones == 0 ? 1 : zones;
+}
+
+void ZoneSequencer::setFlow(uint8_t capacity, const uint8_t* weights) {
+    flowCapacity = capacity;
+    for (int i = 0; i < MAX_ZONES; i++) {
+        // Sin peso (0 o sin lista): caudal 1
+        flowWeight[i] = weights != nullptr && weights[i] != 0 ? weights[i] : 1;
+    }
+}
+
+void ZoneSequencer::setRiegoEventCallback(RiegoEventCallback callback) {
+    riegoEventCallback = callback;
+}
+
+// ============================================================================
+// Pedidos
+// ============================================================================
+SequencerResult ZoneSequencer::request(int zona, int duracionSeg, RiegoOrigen origen, int versionAgenda) {
+    if (zona < 1 || zona > MAX_ZONES) return SEQ_REJECTED;
+    if (duracionSeg < MIN_RIEGO_DURATION || duracionSeg > MAX_RIEGO_DURATION) {
+        LOG_WARN("Duracion invalida para zona %d: %d seg", zona, duracionSeg);
+        return SEQ_REJECTED;
+    }
+    int idx = zona - 1;
+
+    // Zona regando: reemplazar su duración sin ocupar otro lugar
+    if (relays->isActive(zona)) {
+        relays->turnOn(zona, duracionSeg, origen, versionAgenda);
+        return SEQ_UPDATED;
+    }
+
+    // Ya en cola: actualizar el pedido (un manual sube de prioridad)
+    if (queue.orden[idx] != 0) {
+        queue.duracion[idx] = (uint16_t)duracionSeg;
+        queue.versionAgenda[idx] = versionAgenda;
+        if (origen == ORIGEN_MANUAL) queue.origen[idx] = ORIGEN_MANUAL;
+        return SEQ_UPDATED;
+    }
+
+    // Encolar y atender: si no hay nadie antes y entra, arranca ya
+    queue.orden[idx] = nextOrden++;
+    queue.duracion[idx] = (uint16_t)duracionSeg;
+    queue.versionAgenda[idx] = versionAgenda;
+    queue.origen[idx] = (uint8_t)origen;
+    dispatch();
+    if (queue.orden[idx] == 0) return SEQ_STARTED;
+
+    LOG_INFO("Zona %d en cola (%s, %d seg): %u activas, %u en cola",
+             zona, riegoOrigenName(origen), duracionSeg, getActiveCount(), getQueuedCount());
+    if (riegoEventCallback != nullptr) {
+        riegoEventCallback(zona, RIEGO_EN_COLA, origen, duracionSeg, versionAgenda);
+    }
+    return SEQ_QUEUED;
+}
+
+bool ZoneSequencer::cancel(int zona) {
+    if (zona < 1 || zona > MAX_ZONES) return false;
+    int idx = zona - 1;
+
+    if (queue.orden[idx] != 0) {
+        RiegoOrigen origen = (RiegoOrigen)queue.origen[idx];
+        int duracion = queue.duracion[idx];
+        int versionAgenda = queue.versionAgenda[idx];
+        dequeue(idx);
+        LOG_INFO("Zona %d sale de la cola sin regar", zona);
+        if (riegoEventCallback != nullptr) {
+            riegoEventCallback(zona, RIEGO_CANCELADO, origen, duracion, versionAgenda);
+        }
+        return true;
+    }
+
+    if (!relays->isActive(zona)) return false;
+    relays->turnOff(zona);
+    dispatch();
+    return true;
+}
+
+void ZoneSequencer::loop() {
+    if (getQueuedCount() == 0) return;
+    dispatch();
+}
+
+// ============================================================================
+// Cola
+// ============================================================================
+bool ZoneSequencer::fits(int idx) {
+    uint8_t active = 0;
+    uint16_t flow = 0;
+    for (int i = 0; i < MAX_ZONES; i++) {
+        if (!relays->isActive(i + 1)) continue;
+        active++;
+        flow += flowWeight[i];
+    }
+    if (active >= maxActive) return false;
+    if (flowCapacity == 0) return true;
+    // Una zona que sola supera el caudal riega sin compañía
+    return flow == 0 || flow + flowWeight[idx] <= flowCapacity;
+}
+
+int ZoneSequencer::nextQueued() const {
+    int best = -1;
+    for (int i = 0; i < MAX_ZONES; i++) {
+        if (queue.orden[i] == 0) continue;
+        if (best < 0 ||
+            queue.origen[i] < queue.origen[best] ||
+            (queue.origen[i] == queue.origen[best] && queue.orden[i] < queue.orden[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void ZoneSequencer::dispatch() {
+    int idx;
+    while ((idx = nextQueued()) >= 0 && fits(idx)) {
+        RiegoOrigen origen = (RiegoOrigen)queue.origen[idx];
+        int duracion = queue.duracion[idx];
+        int versionAgenda = queue.versionAgenda[idx];
+        dequeue(idx);
+        relays->turnOn(idx + 1, duracion, origen, versionAgenda);
+    }
+}
+
+void ZoneSequencer::dequeue(int idx) {
+    queue.orden[idx] = 0;
+    queue.duracion[idx] = 0;
+    queue.versionAgenda[idx] = 0;
+    queue.origen[idx] = 0;
+}
+
+// ============================================================================
+// Consultas
+// ============================================================================
+bool ZoneSequencer::isQueued(int zona) const {
+    return zona >= 1 && zona <= MAX_ZONES && queue.orden[zona - 1] != 0;
+}
+
+bool ZoneSequencer::isBusy(int zona) {
+    return isQueued(zona) || relays->isActive(zona);
+}
+
+uint8_t ZoneSequencer::getQueuedCount() const {
+    uint8_t count = 0;
+    for (int i = 0; i < MAX_ZONES; i++) {
+        if (queue.orden[i] != 0) count++;
+    }
+    return count;
+}
+
+uint8_t ZoneSequencer::getActiveCount() {
+    uint8_t count = 0;
+    for (int i = 0; i < MAX_ZONES; i++) {
+        if (relays->isActive(i + 1)) count++;
+    }
+    return count;
+}
+
+// ============================================================================
+// Foto y reanudación (reinicio en caliente)
+// ============================================================================
+void ZoneSequencer::snapshot(SequencerSnapshot& out) const {
+    out = queue;
+}
+
+uint8_t ZoneSequencer::restore(const SequencerSnapshot& in) {
+    uint8_t restored = 0;
+    nextOrden = 1;
+    for (int i = 0; i < MAX_ZONES; i++) {
+        bool valid = in.orden[i] != 0 && in.duracion[i] >= MIN_RIEGO_DURATION &&
+                     in.duracion[i] <= MAX_RIEGO_DURATION && !relays->isActive(i + 1);
+        if (!valid) {
+            dequeue(i);
+            continue;
+        }
+        queue.orden[i] = in.orden[i];
+        queue.duracion[i] = in.duracion[i];
+        queue.versionAgenda[i] = in.versionAgenda[i];
+        queue.origen[i] = in.origen[i] == ORIGEN_AGENDA ? ORIGEN_AGENDA : ORIGEN_MANUAL;
+        if (in.orden[i] >= nextOrden) nextOrden = in.orden[i] + 1;
+        restored++;
+        LOG_INFO("Zona %d sigue en cola (%s, %u seg)",
+                 i + 1, riegoOrigenName((RiegoOrigen)queue.origen[i]), queue.duracion[i]);
+    }
+    return restored;
+}
@@ -0,0 +1,99 @@
+#ifndef ZONE_SEQUENCER_H
+#define ZONE_SEQUENCER_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "../config/EventTypes.h"
+#include "../hardware/RelayController.h"
+
+// ============================================================================
+// ZoneSequencer - Turnos de riego según la capacidad hidráulica
+// ============================================================================
+// Entre los pedidos de riego (comandos MQTT, AgendaManager) y RelayController.
+// La bomba y la presión solo alcanzan para SEQUENCER_MAX_ACTIVE_ZONES zonas a
+// la vez y, opcionalmente, para un caudal total (SEQUENCER_FLOW_CAPACITY) con
+// un peso por zona. Un pedido que no entra queda en cola y arranca en cuanto
+// se libera lugar, en orden de prioridad: manual antes que agenda y, dentro
+// de cada origen, por orden de llegada. La cola es estricta: si el primero no
+// entra, los siguientes esperan (una zona de mucho caudal no queda relegada).
+//
+// Un pedido por zona: pedir una zona ya activa reemplaza su duración (como
+// RelayController::turnOn) y pedir una zona en cola actualiza el pedido. Los
+// eventos inicio/fin los publica RelayController; acá se agregan "en_cola" y
+// "cancelado" (pedido en cola que se apagó antes de arrancar).
+
+enum SequencerResult {
+    SEQ_STARTED = 0,   // Encendida ahora
+    SEQ_QUEUED,        // En cola hasta que haya lugar
+    SEQ_UPDATED,       // Ya estaba activa o en cola: pedido reemplazado
+    SEQ_REJECTED       // Zona o duración inválida
+};
+
+// Pedidos en cola por zona (se guarda en memoria RTC junto con los riegos en
+// curso, ver WarmRestart). Tamaño fijo, múltiplo de 4 bytes.
+struct SequencerSnapshot {
+    uint32_t orden[MAX_ZONES];           // Orden de llegada (0 = sin pedido)
+    int32_t versionAgenda[MAX_ZONES];
+    uint16_t duracion[MAX_ZONES];
+    uint8_t origen[MAX_ZONES];           // RiegoOrigen
+};
+
+class ZoneSequencer {
+private:
+    RelayController* relays;
+    RiegoEventCallback riegoEventCallback;
+
+    uint8_t maxActive;
+    uint8_t flowCapacity;                // 0 = solo límite de zonas
+    uint8_t flowWeight[MAX_ZONES];
+
+    SequencerSnapshot queue;
+    uint32_t nextOrden;
+
+    // Hay lugar para encender la zona `idx` con las activas ahora
+    bool fits(int idx);
+
+    // Índice del próximo pedido a atender (-1 si la cola está vacía)
+    int nextQueued() const;
+
+    // Arrancar pedidos de la cola mientras haya lugar
+    void dispatch();
+
+    void dequeue(int idx);
+
+public:
+    ZoneSequencer(RelayController* relays);
+
+    // Límites hidráulicos (por defecto los de Config.h)
+    void setMaxActive(uint8_t zones);
+    void setFlow(uint8_t capacity, const uint8_t* weights);
+
+    // Eventos "en_cola" y "cancelado" (mismo callback que RelayController)
+    void setRiegoEventCallback(RiegoEventCallback callback);
+
+    // Pedir riego de `zona` por `duracionSeg` segundos
+    SequencerResult request(int zona, int duracionSeg, RiegoOrigen origen = ORIGEN_MANUAL, int versionAgenda = 0);
+
+    // Apagar la zona o sacarla de la cola. Devuelve false si no estaba
+    // activa ni en cola.
+    bool cancel(int zona);
+
+    // Arrancar pedidos en cola si se liberó lugar (llamar en cada vuelta,
+    // después de RelayController::loop())
+    void loop();
+
+    bool isQueued(int zona) const;
+
+    // Activa o en cola
+    bool isBusy(int zona);
+
+    uint8_t getQueuedCount() const;
+    uint8_t getActiveCount();
+
+    // Copiar la cola a `out` / retomarla tras un reinicio en caliente.
+    // restore() devuelve cuántos pedidos quedaron en cola.
+    void snapshot(SequencerSnapshot& out) const;
+    uint8_t restore(const SequencerSnapshot& in);
+};
+
+#endif // ZONE_SEQUENCER_H
@@ -0,0 +1,331 @@
+#include "EventJournal.h"
+#include "SPIFFSManager.h"
+#include "../utils/Crc32.h"
+#include "../utils/Logger.h"
+
+// ============================================================================
+// Constructor
+// ============================================================================
+EventJournal::EventJournal(SPIFFSManager* spiffs) {
+    spiffsManager = spiffs;
+    initialized = false;
+    lastSeq = 0;
+    ackedSeq = 0;
+    pending = 0;
+    dropped = 0;
+    headSegment = 0;
+    headCount = 0;
+    for (uint8_t i = 0; i < EVENT_JOURNAL_SEGMENTS; i++) {
+        segmentFirstSeq[i] = 0;
+    }
+}
+
+// ============================================================================
+// Inicialización - reconstruir estado desde flash
+// ============================================================================
+bool EventJournal::init() {
+    if (spiffsManager == nullptr || !spiffsManager->isInitialized()) {
+        LOG_ERROR("EventJournal: SPIFFS no inicializado, eventos sin respaldo local");
+        return false;
+    }
+
+    loadState();
+
+    uint32_t headMaxSeq = 0;
+    bool headClean = true;
+    bool anySegment = false;
+    pending = 0;
+    headSegment = 0;
+    headCount = 0;
+
+    for (uint8_t s = 0; s < EVENT_JOURNAL_SEGMENTS; s++) {
+        uint32_t firstSeq = 0;
+        uint32_t maxSeq = 0;
+        uint16_t segmentPending = 0;
+        bool clean = true;
+        uint16_t count = scanSegment(s, firstSeq, maxSeq, segmentPending, clean);
+
+        segmentFirstSeq[s] = count > 0 ? firstSeq : 0;
+        if (count == 0) continue;
+
+        anySegment = true;
+        pending += segmentPending;
+        if (maxSeq > lastSeq) lastSeq = maxSeq;
+
+        // El segmento activo es el de la secuencia más alta
+        if (maxSeq > headMaxSeq) {
+            headMaxSeq = maxSeq;
+            headSegment = s;
+            headCount = count;
+            headClean = clean;
+        }
+    }
+
+    // Cola dañada (registro cortado): no agregar detrás, pasar al siguiente
+    if (!headClean) {
+        LOG_WARN("EventJournal: segmento %u con registro incompleto, se cierra", headSegment);
+        headCount = EVENT_JOURNAL_SEGMENT_RECORDS;
+    }
+
+    initialized = true;
+
+    if (anySegment && pending == 0) {
+        clearSegments();
+    }
+
+    LOG_INFO("EventJournal: %u eventos pendientes (seq %lu, publicada %lu)",
+             pending, (unsigned long)lastSeq, (unsigned long)ackedSeq);
+    return true;
+}
+
+// ============================================================================
+// Registrar evento: directo si se puede, al diario si no
+// ============================================================================
+bool EventJournal::record(EventJournalPublisher publisher, int zona, RiegoEvento evento, RiegoOrigen origen,
+                          int duracion, int versionAgenda, uint32_t timestamp) {
+    // Con pendientes se encola detrás para respetar el orden
+    if (publisher != nullptr && pending == 0) {
+        RiegoEventRecord direct;
+        memset(&direct, 0, sizeof(direct));
+        direct.timestamp = timestamp;
+        direct.versionAgenda = versionAgenda;
+        direct.duracion = (uint16_t)constrain(duracion, 0, 0xFFFF);
+        direct.zona = (uint8_t)zona;
+        direct.evento = (uint8_t)evento;
+        direct.origen = (uint8_t)origen;
+        // seq 0: no pasó por el diario, no se reenvía
+        if (publisher(direct)) return true;
+    }
+    return append(zona, evento, origen, duracion, versionAgenda, timestamp);
+}
+
+// ============================================================================
+// Agregar evento
+// ============================================================================
+bool EventJournal::append(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion,
+                          int versionAgenda, uint32_t timestamp) {
+    if (!initialized) return false;
+
+    if (headCount >= EVENT_JOURNAL_SEGMENT_RECORDS) {
+        rotate();
+    }
+
+    RiegoEventRecord record;
+    memset(&record, 0, sizeof(record));
+    record.seq = ++lastSeq;
+    record.timestamp = timestamp;
+    record.versionAgenda = versionAgenda;
+    record.duracion = (uint16_t)constrain(duracion, 0, 0xFFFF);
+    record.zona = (uint8_t)zona;
+    record.evento = (uint8_t)evento;
+    record.origen = (uint8_t)origen;
+    record.crc = recordCrc(record);
+
+    char path[24];
+    segmentPath(headSegment, path, sizeof(path));
+    File file = spiffsManager->openFile(path, "a");
+    size_t written = 0;
+    if (file) {
+        written = file.write((const uint8_t*)&record, sizeof(record));
+        file.close();
+    }
+
+    if (written != sizeof(record)) {
+        // Un registro parcial invalida la cola: el próximo va a otro segmento
+        LOG_ERROR("EventJournal: error escribiendo evento seq %lu en %s",
+                  (unsigned long)record.seq, path);
+        headCount = EVENT_JOURNAL_SEGMENT_RECORDS;
+        return false;
+    }
+
+    if (headCount == 0) {
+        segmentFirstSeq[headSegment] = record.seq;
+    }
+    headCount++;
+    pending++;
+    return true;
+}
+
+// ============================================================================
+// Publicar pendientes en orden
+// ============================================================================
+uint16_t EventJournal::drain(EventJournalPublisher publisher, uint16_t maxRecords) {
+    if (!initialized || pending == 0 || publisher == nullptr || maxRecords == 0) return 0;
+
+    uint16_t published = 0;
+    bool stop = false;
+    uint32_t previousFirst = 0;
+
+    // Segmentos en orden de secuencia (pocos: selección simple)
+    for (uint8_t pass = 0; pass < EVENT_JOURNAL_SEGMENTS && !stop; pass++) {
+        int8_t segment = -1;
+        for (uint8_t s = 0; s < EVENT_JOURNAL_SEGMENTS; s++) {
+            uint32_t first = segmentFirstSeq[s];
+            if (first == 0 || first <= previousFirst) continue;
+            if (segment < 0 || first < segmentFirstSeq[segment]) segment = (int8_t)s;
+        }
+        if (segment < 0) break;
+        previousFirst = segmentFirstSeq[segment];
+
+        char path[24];
+        segmentPath((uint8_t)segment, path, sizeof(path));
+        File file = spiffsManager->openFile(path, "r");
+        if (!file) continue;
+
+        RiegoEventRecord record;
+        while (file.read((uint8_t*)&record, sizeof(record)) == sizeof(record)) {
+            if (record.crc != recordCrc(record)) break;
+            if (record.seq <= ackedSeq) continue;
+
+            if (published >= maxRecords || !publisher(record)) {
+                stop = true;
+                break;
+            }
+            published++;
+            ackedSeq = record.seq;
+            if (pending > 0) pending--;
+        }
+        file.close();
+    }
+
+    if (published > 0) {
+        if (pending == 0) {
+            clearSegments();
+        }
+        saveState();
+    }
+
+    return published;
+}
+
+// ============================================================================
+// Rotación de segmentos
+// ============================================================================
+void EventJournal::rotate() {
+    uint8_t next = (headSegment + 1) % EVENT_JOURNAL_SEGMENTS;
+    char path[24];
+    segmentPath(next, path, sizeof(path));
+
+    if (segmentFirstSeq[next] != 0) {
+        uint32_t firstSeq = 0;
+        uint32_t maxSeq = 0;
+        uint16_t lost = 0;
+        bool clean = true;
+        scanSegment(next, firstSeq, maxSeq, lost, clean);
+        if (lost > 0) {
+            dropped += lost;
+            pending = pending > lost ? pending - lost : 0;
+            LOG_WARN("EventJournal lleno: se descartan %u eventos sin publicar (seq %lu-%lu)",
+                     lost, (unsigned long)firstSeq, (unsigned long)maxSeq);
+        }
+    }
+
+    if (spiffsManager->exists(path)) {
+        spiffsManager->deleteFile(path);
+    }
+
+    headSegment = next;
+    headCount = 0;
+    segmentFirstSeq[next] = 0;
+}
+
+void EventJournal::clearSegments() {
+    char path[24];
+    for (uint8_t s = 0; s < EVENT_JOURNAL_SEGMENTS; s++) {
+        segmentPath(s, path, sizeof(path));
+        if (spiffsManager->exists(path)) {
+            spiffsManager->deleteFile(path);
+        }
+        segmentFirstSeq[s] = 0;
+    }
+    headSegment = 0;
+    headCount = 0;
+}
+
+// ============================================================================
+// Lectura de un segmento
+// ============================================================================
+uint16_t EventJournal::scanSegment(uint8_t segment, uint32_t& firstSeq, uint32_t& maxSeq,
+                                   uint16_t& pendingOut, bool& clean) {
+    firstSeq = 0;
+    maxSeq = 0;
+    pendingOut = 0;
+    clean = true;
+
+    char path[24];
+    segmentPath(segment, path, sizeof(path));
+    if (!spiffsManager->exists(path)) return 0;
+
+    File file = spiffsManager->openFile(path, "r");
+    if (!file) return 0;
+
+    size_t size = file.size();
+    uint16_t count = 0;
+    RiegoEventRecord record;
+    while (count < EVENT_JOURNAL_SEGMENT_RECORDS &&
+           file.read((uint8_t*)&record, sizeof(record)) == sizeof(record)) {
+        if (record.crc != recordCrc(record) || record.seq == 0) break;
+        if (count == 0) firstSeq = record.seq;
+        if (record.seq > maxSeq) maxSeq = record.seq;
+        if (record.seq > ackedSeq) pendingOut++;
+        count++;
+    }
+    file.close();
+
+    clean = size == (size_t)count * sizeof(RiegoEventRecord);
+    return count;
+}
+
+// ============================================================================
+// Estado persistente (última secuencia publicada)
+// ============================================================================
+void EventJournal::loadState() {
+    ackedSeq = 0;
+    lastSeq = 0;
+    if (!spiffsManager->exists(EVENT_JOURNAL_STATE_FILE)) return;
+
+    File file = spiffsManager->openFile(EVENT_JOURNAL_STATE_FILE, "r");
+    if (!file) return;
+
+    EventJournalState state;
+    size_t n = file.read((uint8_t*)&state, sizeof(state));
+    file.close();
+
+    uint32_t expected = Crc32::update(0, &state, sizeof(state) - sizeof(state.crc));
+    if (n != sizeof(state) || state.magic != EVENT_JOURNAL_STATE_MAGIC || state.crc != expected) {
+        // Sin estado se reenvía todo lo que haya en flash (el backend deduplica)
+        LOG_WARN("EventJournal: estado invalido, se reenvian los eventos guardados");
+        return;
+    }
+
+    ackedSeq = state.ackedSeq;
+    lastSeq = state.lastSeq > state.ackedSeq ? state.lastSeq : state.ackedSeq;
+}
+
+bool EventJournal::saveState() {
+    EventJournalState state;
+    state.magic = EVENT_JOURNAL_STATE_MAGIC;
+    state.ackedSeq = ackedSeq;
+    state.lastSeq = lastSeq;
+    state.crc = Crc32::update(0, &state, sizeof(state) - sizeof(state.crc));
+
+    File file = spiffsManager->openFile(EVENT_JOURNAL_STATE_FILE, "w");
+    if (!file) {
+        LOG_ERROR("EventJournal: no se pudo escribir %s", EVENT_JOURNAL_STATE_FILE);
+        return false;
+    }
+    size_t written = file.write((const uint8_t*)&state, sizeof(state));
+    file.close();
+    return written == sizeof(state);
+}
+
+// ============================================================================
+// Utilidades
+// ============================================================================
+void EventJournal::segmentPath(uint8_t segment, char* out, size_t size) {
+    snprintf(out, size, EVENT_JOURNAL_FILE_PATTERN, (unsigned)segment);
+}
+
+uint32_t EventJournal::recordCrc(const RiegoEventRecord& record) {
+    return Crc32::update(0, &record, sizeof(record) - sizeof(record.crc));
+}
@@ -0,0 +1,108 @@
+#ifndef EVENT_JOURNAL_H
+#define EVENT_JOURNAL_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+#include "../config/EventTypes.h"
+
+class SPIFFSManager;
+
+// ============================================================================
+// EventJournal - Diario circular de eventos de riego en LittleFS
+// ============================================================================
+// Con MQTT conectado y nada pendiente, record() publica el evento directo
+// (sin seq, sin tocar la flash). Si no hay conexión, la publicación falla o
+// quedan pendientes (para no adelantarlos), el evento se agrega al diario
+// con un número de secuencia persistente y se publica desde ahí (drain) en
+// lotes, con su timestamp NTP original. El backend descarta reenvíos por
+// (nodo, seq, timestamp), o por (nodo, seq) si se registró sin NTP (0).
+//
+// Layout: EVENT_JOURNAL_SEGMENTS archivos de hasta
+// EVENT_JOURNAL_SEGMENT_RECORDS registros de 24 bytes, solo se agrega al
+// final (LittleFS reescribe únicamente el bloque de cola). Con el segmento
+// activo lleno se pasa al siguiente, descartando el más viejo si todavía
+// tenía pendientes. Cada registro lleva CRC32: un registro cortado por un
+// corte de energía se ignora y el segmento se da por cerrado.
+// EVENT_JOURNAL_STATE_FILE guarda la última secuencia publicada (se
+// escribe una vez por lote). Con todo publicado se borran los segmentos.
+
+#define EVENT_JOURNAL_STATE_MAGIC 0x4C4A5645UL  // "EVJL"
+
+struct RiegoEventRecord {
+    uint32_t seq;
+    uint32_t timestamp;      // Epoch UTC en segundos (0 = sin NTP al registrar)
+    int32_t versionAgenda;   // 0 si es manual
+    uint16_t duracion;       // Segundos (programada en inicio, real en fin)
+    uint8_t zona;
+    uint8_t evento;          // RiegoEvento
+    uint8_t origen;          // RiegoOrigen
+    uint8_t reserved[3];
+    uint32_t crc;            // CRC32 de los campos anteriores
+};
+
+struct EventJournalState {
+    uint32_t magic;          // EVENT_JOURNAL_STATE_MAGIC
+    uint32_t ackedSeq;       // Última secuencia publicada
+    uint32_t lastSeq;        // Última secuencia asignada
+    uint32_t crc;
+};
+
+// Publica un registro; false corta el lote (se reintenta en el próximo drain)
+typedef bool (*EventJournalPublisher)(const RiegoEventRecord& record);
+
+class EventJournal {
+private:
+    SPIFFSManager* spiffsManager;
+    bool initialized;
+
+    uint32_t lastSeq;        // Última secuencia asignada
+    uint32_t ackedSeq;       // Última secuencia publicada
+    uint16_t pending;        // Registros en flash con seq > ackedSeq
+    uint32_t dropped;        // Pendientes perdidos por rotación (desde el arranque)
+
+    uint8_t headSegment;     // Segmento donde se agrega
+    uint16_t headCount;      // Registros en el segmento activo
+    uint32_t segmentFirstSeq[EVENT_JOURNAL_SEGMENTS];  // 0 = segmento vacío
+
+    static void segmentPath(uint8_t segment, char* out, size_t size);
+    static uint32_t recordCrc(const RiegoEventRecord& record);
+
+    // Leer un segmento: registros válidos consecutivos, primera/última
+    // secuencia, pendientes y si el archivo termina limpio
+    uint16_t scanSegment(uint8_t segment, uint32_t& firstSeq, uint32_t& maxSeq,
+                         uint16_t& pendingOut, bool& clean);
+
+    // Pasar al siguiente segmento (descarta el más viejo)
+    void rotate();
+
+    // Borrar todos los segmentos (todo publicado)
+    void clearSegments();
+
+    void loadState();
+    bool saveState();
+
+public:
+    EventJournal(SPIFFSManager* spiffs);
+
+    // Reconstruir secuencias y pendientes desde flash
+    bool init();
+
+    // Publicar directo (publisher != nullptr y nada pendiente) o agregar al
+    // diario; false si el evento no se publicó ni se pudo guardar
+    bool record(EventJournalPublisher publisher, int zona, RiegoEvento evento, RiegoOrigen origen,
+                int duracion, int versionAgenda, uint32_t timestamp);
+
+    // Agregar evento (asigna seq); false si no se pudo escribir
+    bool append(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion,
+                int versionAgenda, uint32_t timestamp);
+
+    // Publicar hasta `maxRecords` pendientes en orden; devuelve los publicados
+    uint16_t drain(EventJournalPublisher publisher, uint16_t maxRecords);
+
+    uint16_t getPending() const { return pending; }
+    uint32_t getDropped() const { return dropped; }
+    uint32_t getLastSeq() const { return lastSeq; }
+    uint32_t getAckedSeq() const { return ackedSeq; }
+};
+
+#endif // EVENT_JOURNAL_H
@@ -0,0 +1,259 @@
+#include "LogRecorder.h"
+
+static_assert(LOG_RECORD_MAX <= 256 && LOG_RECORD_MAX <= LOG_RECORD_BATCH_BYTES,
+              "LOG_RECORD_MAX: el largo va en un byte y debe entrar en el lote");
+static_assert(LOG_RECORD_BATCH_BYTES <= 65535, "LOG_RECORD_BATCH_BYTES debe entrar en uint16_t");
+static_assert(LOG_RECORD_STRING_MAX <= 255, "LOG_RECORD_STRING_MAX: el largo va en un byte");
+
+// ============================================================================
+// Codificación
+// ============================================================================
+// Escritor acotado: si algo no entra, deja de escribir y queda marcado
+struct RecordWriter {
+    uint8_t* out;
+    size_t capacity;
+    size_t length;
+    bool full;
+
+    bool put(uint8_t b) {
+        if (full || length >= capacity) {
+            full = true;
+            return false;
+        }
+        out[length++] = b;
+        return true;
+    }
+
+    void putLE(uint32_t value, uint8_t bytes) {
+        for (uint8_t i = 0; i < bytes; i++) put((uint8_t)(value >> (8 * i)));
+    }
+
+    void putVarint(uint64_t value) {
+        // Todo el varint o nada: un argumento a medias no se puede decodificar
+        uint8_t bytes[10];
+        uint8_t n = 0;
+        do {
+            uint8_t b = value & 0x7F;
+            value >>= 7;
+            bytes[n++] = value != 0 ? (b | 0x80) : b;
+        } while (value != 0);
+        putAll(bytes, n);
+    }
+
+    void putSigned(int64_t value) {
+        putVarint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+    }
+
+    // `maxLength` < 0: sin precisión (hasta el '\0'); si no, como printf no
+    // lee más allá de esos bytes (%.*s con textos sin terminar)
+    void putString(const char* s, bool inFlash, int maxLength) {
+        if (s == nullptr) {
+            s = "(null)";
+            inFlash = false;
+        }
+        int limit = LOG_RECORD_STRING_MAX;
+        if (maxLength >= 0 && maxLength < limit) limit = maxLength;
+        uint8_t bytes[LOG_RECORD_STRING_MAX + 1];
+        uint8_t n = 0;
+        while (n < limit) {
+            char c = inFlash ? (char)pgm_read_byte(s + n) : s[n];
+            if (c == '\0') break;
+            bytes[1 + n++] = (uint8_t)c;
+        }
+        bytes[0] = n;
+        putAll(bytes, n + 1);
+    }
+
+    void putFloat(double value) {
+        float f = (float)value;
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        uint8_t bytes[4] = {(uint8_t)bits, (uint8_t)(bits >> 8), (uint8_t)(bits >> 16), (uint8_t)(bits >> 24)};
+        putAll(bytes, sizeof(bytes));
+    }
+
+    void putAll(const uint8_t* data, size_t n) {
+        if (full || length + n > capacity) {
+            full = true;
+            return;
+        }
+        memcpy(out + length, data, n);
+        length += n;
+    }
+};
+
+size_t LogRecorder::encode(uint8_t* out, size_t capacity, unsigned long timestamp,
+                           int level, uint32_t id, PGM_P format, va_list args) {
+    if (capacity > LOG_RECORD_MAX) capacity = LOG_RECORD_MAX;
+    if (capacity < LOG_RECORD_HEADER) return 0;
+
+    RecordWriter w = {out, capacity, 0, false};
+    w.put(0);                              // Largo, se completa al final
+    w.putLE((uint32_t)timestamp, 4);
+    w.put((uint8_t)level);
+    w.putLE(id, 4);
+
+    // Recorrer el formato como printf: cada conversión consume su argumento
+    for (PGM_P p = format; format != nullptr && !w.full; p++) {
+        char c = (char)pgm_read_byte(p);
+        if (c == '\0') break;
+        if (c != '%') continue;
+
+        c = (char)pgm_read_byte(++p);
+        if (c == '%') continue;
+        while (c == '-' || c == '+' || c == ' ' || c == '#' || c == '0') c = (char)pgm_read_byte(++p);
+        if (c == '*') {
+            w.putSigned(va_arg(args, int));
+            c = (char)pgm_read_byte(++p);
+        }
+        while (c >= '0' && c <= '9') c = (char)pgm_read_byte(++p);
+        int precision = -1;
+        if (c == '.') {
+            precision = 0;
+            c = (char)pgm_read_byte(++p);
+            if (c == '*') {
+                precision = va_arg(args, int);    // Negativa: como si no hubiera
+                w.putSigned(precision);
+                c = (char)pgm_read_byte(++p);
+            }
+            while (c >= '0' && c <= '9') {
+                if (precision < 10000) precision = precision * 10 + (c - '0');
+                c = (char)pgm_read_byte(++p);
+            }
+        }
+
+        // Modificador de largo: 0 = int, 1 = long, 2 = long long, 3 = size_t
+        uint8_t size = 0;
+        while (c == 'h' || c == 'l' || c == 'z' || c == 'j' || c == 't' || c == 'L') {
+            if (c == 'l') size = size == 1 ? 2 : 1;
+            else if (c == 'z' || c == 't') size = 3;
+            else if (c == 'j') size = 2;
+            c = (char)pgm_read_byte(++p);
+        }
+
+        if (c == '\0') break;
+        switch (c) {
+            case 'd':
+            case 'i':
+                if (size == 2) w.putSigned(va_arg(args, long long));
+                else if (size == 1 || size == 3) w.putSigned(va_arg(args, long));
+                else w.putSigned(va_arg(args, int));
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                if (size == 2) w.putVarint(va_arg(args, unsigned long long));
+                else if (size == 1) w.putVarint(va_arg(args, unsigned long));
+                else if (size == 3) w.putVarint(va_arg(args, size_t));
+                else w.putVarint(va_arg(args, unsigned int));
+                break;
+            case 'c':
+                w.putVarint((uint8_t)va_arg(args, int));
+                break;
+            case 'p':
+                w.putVarint((uintptr_t)va_arg(args, void*));
+                break;
+            case 's':
+                w.putString(va_arg(args, const char*), false, precision);
+                break;
+            case 'S':
+                w.putString(va_arg(args, const char*), true, precision);
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                w.putFloat(va_arg(args, double));
+                break;
+            default:
+                // Conversión desconocida (o %n): no se sabe qué argumento sigue
+                w.full = true;
+                break;
+        }
+    }
+
+    if (w.full) out[5] |= LOG_RECORD_TRUNCATED;
+    out[0] = (uint8_t)(w.length - 1);
+    return w.length;
+}
+
+// ============================================================================
+// Constructor
+// ============================================================================
+LogRecorder::LogRecorder(SPIFFSManager* storage)
+    : storage(storage), batchLength(0), lastFlushAt(0), writing(false), recorded(0), dropped(0) {
+}
+
+void LogRecorder::begin() {
+    // Registro sin argumentos con nivel e id en cero
+    uint8_t marker[LOG_RECORD_HEADER] = {LOG_RECORD_HEADER - 1};
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < 4; i++) marker[1 + i] = (uint8_t)(now >> (8 * i));
+    add(marker, sizeof(marker));
+    lastFlushAt = now;
+}
+
+// ============================================================================
+// Registro
+// ============================================================================
+void LogRecorder::record(int level, uint32_t id, PGM_P format, va_list args) {
+    if (writing || level > LOG_RECORD_LEVEL) return;
+
+    uint8_t data[LOG_RECORD_MAX];
+    size_t length = encode(data, sizeof(data), millis(), level, id, format, args);
+    add(data, length);
+
+    // Lo que precede a un error es lo más valioso si el nodo se cuelga
+    if (level <= LOG_LEVEL_ERROR) flush();
+}
+
+void LogRecorder::add(const uint8_t* data, size_t length) {
+    if (length == 0) return;
+    if (batchLength + length > sizeof(batch)) flush();
+    if (batchLength + length > sizeof(batch)) {
+        dropped++;                         // La escritura anterior falló
+        return;
+    }
+    memcpy(batch + batchLength, data, length);
+    batchLength += (uint16_t)length;
+    recorded++;
+}
+
+void LogRecorder::loop() {
+    if (batchLength == 0 || millis() - lastFlushAt < LOG_RECORD_FLUSH_MS) return;
+    flush();
+}
+
+// ============================================================================
+// Escritura a flash
+// ============================================================================
+bool LogRecorder::flush() {
+    lastFlushAt = millis();
+    if (batchLength == 0 || writing) return true;
+    if (storage == nullptr || !storage->isInitialized()) return false;
+
+    // Los errores de LittleFS se loguean: que no vuelvan a entrar acá
+    writing = true;
+    File file = storage->openFile(LOG_RECORD_FILE, "a");
+    if (file && file.size() + batchLength > LOG_RECORD_FILE_MAX) {
+        // Rotar: el archivo lleno pasa a ser el anterior (reemplaza al viejo)
+        file.close();
+        storage->renameFile(LOG_RECORD_FILE, LOG_RECORD_FILE_OLD);
+        file = storage->openFile(LOG_RECORD_FILE, "a");
+    }
+    bool ok = false;
+    if (file) {
+        ok = file.write(batch, batchLength) == batchLength;
+        file.close();
+    }
+    writing = false;
+
+    // Fallida: el lote queda para el próximo intento
+    if (ok) batchLength = 0;
+    return ok;
+}
@@ -0,0 +1,73 @@
+#ifndef LOG_RECORDER_H
+#define LOG_RECORDER_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include "../config/Config.h"
+#include "SPIFFSManager.h"
+
+// ============================================================================
+// LogRecorder - Registro binario de logs en LittleFS
+// ============================================================================
+// Sumidero de Logger: cada línea hasta LOG_RECORD_LEVEL se guarda como un
+// registro compacto en vez de texto, así un nodo de campo conserva su
+// historia sin nadie conectado al serial:
+//
+//   [largo u8][millis u32][nivel u8][id u32][argumentos]     (little endian)
+//
+// `largo` cuenta los bytes que siguen. `id` es el hash del formato
+// (Logger::formatId); el texto no se guarda, tools/log_formats.py arma en
+// compilación la tabla id -> formato y tools/log_decode.py reconstruye las
+// líneas. Los argumentos se codifican según el formato: enteros como varint
+// (con signo en zigzag), %s con largo u8 y hasta LOG_RECORD_STRING_MAX bytes,
+// flotantes como float32. Si no entran, el nivel lleva LOG_RECORD_TRUNCATED.
+// Un registro con id 0 marca cada arranque (millis vuelve a cero).
+//
+// Los registros se juntan en un lote en RAM (LOG_RECORD_BATCH_BYTES) que se
+// agrega al archivo cuando se llena, cada LOG_RECORD_FLUSH_MS o enseguida
+// ante un ERROR: pocas escrituras grandes en vez de una por línea (desgaste
+// y latencia de flash). Al pasar LOG_RECORD_FILE_MAX el archivo rota a
+// LOG_RECORD_FILE_OLD, así el registro nunca ocupa más de dos archivos.
+
+#define LOG_RECORD_HEADER 10            // largo + millis + nivel + id
+#define LOG_RECORD_MAX 128              // Registro más largo (el resto de args se corta)
+#define LOG_RECORD_TRUNCATED 0x80       // Bit del nivel: faltan argumentos
+
+class LogRecorder {
+private:
+    SPIFFSManager* storage;
+    uint8_t batch[LOG_RECORD_BATCH_BYTES];
+    uint16_t batchLength;
+    unsigned long lastFlushAt;
+    bool writing;          // Guardando: lo que se loguee mientras tanto no entra
+    uint32_t recorded;
+    uint32_t dropped;
+
+    // Agregar un registro ya codificado al lote (escribe el lote si no entra)
+    void add(const uint8_t* data, size_t length);
+
+public:
+    explicit LogRecorder(SPIFFSManager* storage);
+
+    // Marca de arranque (llamar una vez, con LittleFS ya inicializado)
+    void begin();
+
+    // Sumidero de Logger (ver Logger::setRecordSink)
+    void record(int level, uint32_t id, PGM_P format, va_list args);
+
+    // Escribir el lote parcial cada LOG_RECORD_FLUSH_MS
+    void loop();
+
+    // Escribir el lote ya (antes de reiniciar); false si falló la escritura
+    bool flush();
+
+    // Codificar un registro en `out`; devuelve los bytes usados
+    static size_t encode(uint8_t* out, size_t capacity, unsigned long timestamp,
+                         int level, uint32_t id, PGM_P format, va_list args);
+
+    uint16_t getBatchLength() const { return batchLength; }
+    uint32_t getRecorded() const { return recorded; }
+    uint32_t getDropped() const { return dropped; }
+};
+
+#endif // LOG_RECORDER_H
@@ -13,30 +13,30 @@ SPIFFSManager::SPIFFSManager() {
 // Inicializar LittleFS
 // ============================================================================
 bool SPIFFSManager::init() {
-    Logger::info("Inicializando sistema de archivos LittleFS...");
+    LOG_INFO("Inicializando sistema de archivos LittleFS...");
     
     if (!LittleFS.begin()) {
-        Logger::error("Fallo al montar LittleFS");
+        LOG_ERROR("Fallo al montar LittleFS");
         
         // Intentar formatear y reinicializar
-        Logger::warn("Intentando formatear LittleFS...");
+        LOG_WARN("Intentando formatear LittleFS...");
         if (format()) {
             if (LittleFS.begin()) {
-                Logger::info("LittleFS formateado y montado exitosamente");
+                LOG_INFO("LittleFS formateado y montado exitosamente");
                 initialized = true;
                 updateStorageInfo();
                 return true;
             }
         }
         
-        Logger::error("No se pudo inicializar LittleFS");
+        LOG_ERROR("No se pudo inicializar LittleFS");
         initialized = false;
         return false;
     }
     
     initialized = true;
     updateStorageInfo();
-    Logger::info("LittleFS montado correctamente");
+    LOG_INFO("LittleFS montado correctamente");
     
     return true;
 }
@@ -52,15 +52,15 @@ bool SPIFFSManager::isInitialized() {
 // Formatear sistema de archivos
 // ============================================================================
 bool SPIFFSManager::format() {
-    Logger::warn("Formateando LittleFS... (esto puede tardar)");
+    LOG_WARN("Formateando LittleFS... (esto puede tardar)");
     
     bool result = LittleFS.format();
     
     if (result) {
-        Logger::info("LittleFS formateado exitosamente");
+        LOG_INFO("LittleFS formateado exitosamente");
         usedBytes = 0;
     } else {
-        Logger::error("Fallo al formatear LittleFS");
+        LOG_ERROR("Fallo al formatear LittleFS");
     }
     
     return result;
@@ -71,25 +71,25 @@ bool SPIFFSManager::format() {
 // ============================================================================
 String SPIFFSManager::readFile(const char* path) {
     if (!initialized) {
-        Logger::error("LittleFS no inicializado");
+        LOG_ERROR("LittleFS no inicializado");
         return "";
     }
     
     if (!LittleFS.exists(path)) {
-        Logger::logf(LOG_LEVEL_WARN, "Archivo no existe: %s", path);
+        LOG_WARN("Archivo no existe: %s", path);
         return "";
     }
     
     File file = LittleFS.open(path, "r");
     if (!file) {
-        Logger::logf(LOG_LEVEL_ERROR, "Error al abrir archivo: %s", path);
+        LOG_ERROR("Error al abrir archivo: %s", path);
         return "";
     }
     
     String content = file.readString();
     file.close();
     
-    Logger::logf(LOG_LEVEL_DEBUG, "Leido archivo: %s (%d bytes)", path, content.length());
+    LOG_DEBUG("Leido archivo: %s (%u bytes)", path, (unsigned)content.length());
     
     return content;
 }
@@ -99,13 +99,13 @@ String SPIFFSManager::readFile(const char* path) {
 // ============================================================================
 bool SPIFFSManager::writeFile(const char* path, const String& content) {
     if (!initialized) {
-        Logger::error("LittleFS no inicializado");
+        LOG_ERROR("LittleFS no inicializado");
         return false;
     }
     
     File file = LittleFS.open(path, "w");
     if (!file) {
-        Logger::logf(LOG_LEVEL_ERROR, "Error al crear archivo: %s", path);
+        LOG_ERROR("Error al crear archivo: %s", path);
         return false;
     }
     
@@ -115,11 +115,11 @@ bool SPIFFSManager::writeFile(const char* path, const String& content) {
     updateStorageInfo();
     
     if (bytesWritten == content.length()) {
-        Logger::logf(LOG_LEVEL_DEBUG, "Archivo escrito: %s (%d bytes)", path, bytesWritten);
+        LOG_DEBUG("Archivo escrito: %s (%u bytes)", path, (unsigned)bytesWritten);
         return true;
     } else {
-        Logger::logf(LOG_LEVEL_ERROR, "Escritura incompleta: %s (%d/%d bytes)", 
-                   path, bytesWritten, content.length());
+        LOG_ERROR("Escritura incompleta: %s (%u/%u bytes)", 
+                  path, (unsigned)bytesWritten, (unsigned)content.length());
         return false;
     }
 }
@@ -129,13 +129,13 @@ bool SPIFFSManager::writeFile(const char* path, const String& content) {
 // ============================================================================
 bool SPIFFSManager::appendFile(const char* path, const String& content) {
     if (!initialized) {
-        Logger::error("LittleFS no inicializado");
+        LOG_ERROR("LittleFS no inicializado");
         return false;
     }
     
     File file = LittleFS.open(path, "a");
     if (!file) {
-        Logger::logf(LOG_LEVEL_ERROR, "Error al abrir archivo para append: %s", path);
+        LOG_ERROR("Error al abrir archivo para append: %s", path);
         return false;
     }
     
@@ -145,11 +145,11 @@ bool SPIFFSManager::appendFile(const char* path, const String& content) {
     updateStorageInfo();
     
     if (bytesWritten == content.length()) {
-        Logger::logf(LOG_LEVEL_DEBUG, "Contenido agregado: %s (%d bytes)", path, bytesWritten);
+        LOG_DEBUG("Contenido agregado: %s (%u bytes)", path, (unsigned)bytesWritten);
         return true;
     } else {
-        Logger::logf(LOG_LEVEL_ERROR, "Append incompleto: %s (%d/%d bytes)", 
-                   path, bytesWritten, content.length());
+        LOG_ERROR("Append incompleto: %s (%u/%u bytes)", 
+                  path, (unsigned)bytesWritten, (unsigned)content.length());
         return false;
     }
 }
@@ -167,33 +167,76 @@ bool SPIFFSManager::exists(const char* path) {
 // ============================================================================
 bool SPIFFSManager::deleteFile(const char* path) {
     if (!initialized) {
-        Logger::error("LittleFS no inicializado");
+        LOG_ERROR("LittleFS no inicializado");
         return false;
     }
     
     if (!LittleFS.exists(path)) {
-        Logger::logf(LOG_LEVEL_WARN, "Archivo no existe: %s", path);
+        LOG_WARN("Archivo no existe: %s", path);
         return false;
     }
     
     bool result = LittleFS.remove(path);
     
     if (result) {
-        Logger::logf(LOG_LEVEL_INFO, "Archivo eliminado: %s", path);
+        LOG_INFO("Archivo eliminado: %s", path);
         updateStorageInfo();
     } else {
-        Logger::logf(LOG_LEVEL_ERROR, "Error al eliminar archivo: %s", path);
+        LOG_ERROR("Error al eliminar archivo: %s", path);
     }
     
     return result;
 }
 
+// ============================================================================
+// Renombrar archivo
+// ============================================================================
+bool SPIFFSManager::renameFile(const char* pathFrom, const char* pathTo) {
+    if (!initialized) {
+        LOG_ERROR("LittleFS no inicializado");
+        return false;
+    }
+    
+    if (!LittleFS.exists(pathFrom)) {
+        LOG_WARN("Archivo no existe: %s", pathFrom);
+        return false;
+    }
+    
+    bool result = LittleFS.rename(pathFrom, pathTo);
+    
+    if (result) {
+        LOG_DEBUG("Archivo renombrado: %s -> %s", pathFrom, pathTo);
+        updateStorageInfo();
+    } else {
+        LOG_ERROR("Error al renombrar archivo: %s -> %s", pathFrom, pathTo);
+    }
+    
+    return result;
+}
+
+// ============================================================================
+// Abrir archivo
+// ============================================================================
+File SPIFFSManager::openFile(const char* path, const char* mode) {
+    if (!initialized) {
+        LOG_ERROR("LittleFS no inicializado");
+        return File();
+    }
+    
+    File file = LittleFS.open(path, mode);
+    if (!file) {
+        LOG_ERROR("Error al abrir archivo: %s (%s)", path, mode);
+    }
+    
+    return file;
+}
+
 // ============================================================================
 // Listar archivos
 // ============================================================================
 void SPIFFSManager::listFiles() {
     if (!initialized) {
-        Logger::error("LittleFS no inicializado");
+        LOG_ERROR("LittleFS no inicializado");
         return;
     }
     
@@ -49,6 +49,12 @@ public:
     // Eliminar archivo
     bool deleteFile(const char* path);
     
+    // Renombrar archivo (reemplaza el destino de forma atómica en LittleFS)
+    bool renameFile(const char* pathFrom, const char* pathTo);
+    
+    // Abrir archivo para lectura/escritura por bloques ("r", "w", "a")
+    File openFile(const char* path, const char* mode);
+    
     // Listar todos los archivos
     void listFiles();
     
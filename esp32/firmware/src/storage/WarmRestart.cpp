@@ -0,0 +1,89 @@
+#include "WarmRestart.h"
+#include "../utils/Crc32.h"
+
+static_assert(sizeof(WarmRestartBlock) % 4 == 0, "El bloque RTC debe ser multiplo de 4 bytes");
+static_assert(WARM_RESTART_RTC_OFFSET * 4 + sizeof(WarmRestartBlock) <= 512, "El bloque no entra en la memoria RTC de usuario");
+static_assert(WARM_RESTART_RTC_OFFSET >= 32, "Los bloques RTC 0-31 los usa el comando de eboot (OTA)");
+
+// ============================================================================
+// Constructor
+// ============================================================================
+WarmRestart::WarmRestart() : lastWatermark(0), hasWritten(false), writeCount(0) {
+    memset(&lastRelays, 0, sizeof(lastRelays));
+    memset(&lastQueue, 0, sizeof(lastQueue));
+}
+
+// ============================================================================
+// CRC
+// ============================================================================
+uint32_t WarmRestart::computeCrc(const WarmRestartBlock& block) {
+    WarmRestartBlock copy = block;
+    copy.crc = 0;
+    return Crc32::compute(&copy, sizeof(copy));
+}
+
+// ============================================================================
+// Escritura
+// ============================================================================
+bool WarmRestart::write(const RelaySnapshot& relays, const SequencerSnapshot& queue,
+                        uint32_t agendaWatermark, uint8_t reason, uint32_t offlineMs) {
+    WarmRestartBlock block;
+    memset(&block, 0, sizeof(block));
+    block.magic = WARM_RESTART_MAGIC;
+    block.format = WARM_RESTART_FORMAT;
+    block.reason = reason;
+    block.offlineMs = offlineMs;
+    block.agendaWatermark = agendaWatermark;
+    block.relays = relays;
+    block.queue = queue;
+    block.crc = computeCrc(block);
+    return ESP.rtcUserMemoryWrite(WARM_RESTART_RTC_OFFSET, (uint32_t*)&block, sizeof(block));
+}
+
+bool WarmRestart::update(const RelaySnapshot& relays, const SequencerSnapshot& queue,
+                         uint32_t agendaWatermark) {
+    if (hasWritten && agendaWatermark == lastWatermark &&
+        memcmp(&relays, &lastRelays, sizeof(relays)) == 0 &&
+        memcmp(&queue, &lastQueue, sizeof(queue)) == 0) {
+        return false;
+    }
+    if (!write(relays, queue, agendaWatermark, WARM_RESTART_REASON_STATE, 0)) return false;
+    remember(relays, queue, agendaWatermark);
+    return true;
+}
+
+bool WarmRestart::save(const RelaySnapshot& relays, const SequencerSnapshot& queue,
+                       uint32_t agendaWatermark, uint8_t reason, uint32_t offlineMs) {
+    if (!write(relays, queue, agendaWatermark, reason, offlineMs)) return false;
+    remember(relays, queue, agendaWatermark);
+    return true;
+}
+
+void WarmRestart::remember(const RelaySnapshot& relays, const SequencerSnapshot& queue,
+                           uint32_t agendaWatermark) {
+    lastRelays = relays;
+    lastQueue = queue;
+    lastWatermark = agendaWatermark;
+    hasWritten = true;
+    writeCount++;
+}
+
+// ============================================================================
+// Lectura al arrancar
+// ============================================================================
+bool WarmRestart::take(WarmRestartBlock& out) {
+    if (!ESP.rtcUserMemoryRead(WARM_RESTART_RTC_OFFSET, (uint32_t*)&out, sizeof(out))) {
+        return false;
+    }
+    bool valid = out.magic == WARM_RESTART_MAGIC &&
+                 out.format == WARM_RESTART_FORMAT &&
+                 out.crc == computeCrc(out);
+
+    if (out.magic != 0) {
+        // Consumir: un reinicio posterior (o basura de un arranque en frío)
+        // no debe reanudar riegos
+        uint32_t cleared = 0;
+        ESP.rtcUserMemoryWrite(WARM_RESTART_RTC_OFFSET, &cleared, sizeof(cleared));
+    }
+    return valid;
+}
@@ -0,0 +1,84 @@
+#ifndef WARM_RESTART_H
+#define WARM_RESTART_H
+
+#include <Arduino.h>
+#include "../hardware/RelayController.h"
+#include "../scheduler/ZoneSequencer.h"
+
+// ============================================================================
+// WarmRestart - Estado que sobrevive a un reinicio en caliente
+// ============================================================================
+// Bloque en la memoria RTC de usuario (WARM_RESTART_RTC_OFFSET, después de
+// los 128 bytes que usa el comando de eboot para aplicar una OTA) con los
+// riegos en curso, los pedidos en cola y el último minuto de agenda evaluado. Se reescribe cada
+// vez que cambia (update() en cada vuelta del loop: encendidos, apagados y la
+// cuenta regresiva de cada segundo); la memoria RTC no se gasta como la
+// flash. Cualquier reinicio que no corte la energía (OTA, watchdog,
+// excepción, reinicio de recuperación de MQTT) la conserva: al arrancar se
+// lee una sola vez con take() y los riegos se reanudan antes del primer
+// loop. Tras un corte de energía la memoria queda con basura: magic +
+// formato + CRC32 la descartan y el arranque es en frío (todo apagado).
+//
+// Layout (little-endian, múltiplo de 4 bytes como exige rtcUserMemory*):
+//   magic, formato, motivo, tiempo sin MQTT, watermark de agendas,
+//   RelaySnapshot, SequencerSnapshot, CRC32
+// El CRC cubre todo el bloque con crc = 0.
+
+#define WARM_RESTART_MAGIC 0x4D524157UL  // "WARM"
+#define WARM_RESTART_FORMAT 3            // Incrementar al cambiar el layout
+
+// Motivo de la última escritura
+#define WARM_RESTART_REASON_STATE 0      // Estado corriente (reinicio no pedido)
+// Valores > 0: RecoveryTier que pidió el reinicio (ver ConnectionRecovery)
+
+struct WarmRestartBlock {
+    uint32_t magic;             // WARM_RESTART_MAGIC
+    uint16_t format;            // WARM_RESTART_FORMAT
+    uint8_t reason;             // WARM_RESTART_REASON_STATE o RecoveryTier
+    uint8_t reserved;
+    uint32_t offlineMs;         // Tiempo sin MQTT hasta el reinicio pedido
+    uint32_t agendaWatermark;   // AgendaManager: inicio del último minuto evaluado
+    RelaySnapshot relays;
+    SequencerSnapshot queue;    // Pedidos esperando lugar (ZoneSequencer)
+    uint32_t crc;
+};
+
+class WarmRestart {
+private:
+    // Última foto escrita (para escribir solo si cambió)
+    RelaySnapshot lastRelays;
+    SequencerSnapshot lastQueue;
+    uint32_t lastWatermark;
+    bool hasWritten;
+    uint32_t writeCount;
+
+    static bool write(const RelaySnapshot& relays, const SequencerSnapshot& queue,
+                      uint32_t agendaWatermark, uint8_t reason, uint32_t offlineMs);
+
+    void remember(const RelaySnapshot& relays, const SequencerSnapshot& queue,
+                  uint32_t agendaWatermark);
+
+public:
+    WarmRestart();
+
+    // Reescribir el bloque si los riegos, la cola o el watermark cambiaron
+    // desde la última escritura. Devuelve true si escribió.
+    bool update(const RelaySnapshot& relays, const SequencerSnapshot& queue,
+                uint32_t agendaWatermark);
+
+    // Escribir siempre, con el motivo de un reinicio pedido
+    bool save(const RelaySnapshot& relays, const SequencerSnapshot& queue,
+              uint32_t agendaWatermark, uint8_t reason, uint32_t offlineMs);
+
+    uint32_t getWriteCount() const { return writeCount; }
+
+    // Leer y consumir el bloque: devuelve false si no hay uno válido. Siempre
+    // lo invalida, así un reinicio en el arranque (antes del primer update())
+    // no vuelve a reanudar los mismos riegos una y otra vez.
+    static bool take(WarmRestartBlock& out);
+
+    // CRC del bloque (con crc = 0)
+    static uint32_t computeCrc(const WarmRestartBlock& block);
+};
+
+#endif // WARM_RESTART_H
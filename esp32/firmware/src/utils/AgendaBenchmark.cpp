@@ -0,0 +1,305 @@
+#include "AgendaBenchmark.h"
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "../scheduler/AgendaCompiler.h"
+#include "../scheduler/AgendaEvaluator.h"
+#include "../scheduler/AgendaImage.h"
+
+// Tablas fuera del stack (AgendaIndex ocupa ~900 bytes)
+static AgendaTable benchTable;
+static AgendaIndex benchIndex;
+
+static const uint16_t BENCH_SIZES[] = { 8, 32, 128 };
+
+// Lunes 2026-01-05 00:00 (epoch local, como TimeSync)
+#define BENCH_WEEK_START 1767571200UL
+
+#ifdef ARDUINO_ARCH_ESP8266
+#define BENCH_PLATFORM "esp8266"
+#define BENCH_HEAP_MEASURED true
+#else
+#define BENCH_PLATFORM "native"
+#define BENCH_HEAP_MEASURED false  // ESP.getFreeHeap() del shim es constante
+#endif
+
+static void trackHeap(AgendaBenchResult& result) {
+    uint32_t freeHeap = ESP.getFreeHeap();
+    if (freeHeap < result.heapFreeMin) {
+        result.heapFreeMin = freeHeap;
+    }
+}
+
+// ============================================================================
+// Generar payload
+// ============================================================================
+bool AgendaBenchmark::buildPayload(uint16_t agendas, String& payload) {
+    payload = "";
+    if (!payload.reserve(64 + (size_t)agendas * 160)) {
+        return false;
+    }
+    
+    payload += "{\"version\":42,\"updatedAt\":\"2026-01-05T00:00:00Z\",\"agendas\":[";
+    
+    char item[192];
+    for (uint16_t i = 0; i < agendas; i++) {
+        // Días variados (nunca vacío), horas repartidas en el día
+        uint8_t diasMask = (uint8_t)(((i * 37U) + 11U) % 127U) + 1;
+        char dias[48];
+        size_t len = 0;
+        dias[0] = '\0';
+        for (int d = 0; d < 7; d++) {
+            if (diasMask & (1 << d)) {
+                len += snprintf(dias + len, sizeof(dias) - len, "%s\"%s\"", len > 0 ? "," : "", DIAS_SEMANA[d]);
+            }
+        }
+        
+        snprintf(item, sizeof(item),
+                 "%s{\"id\":\"6f1c%04x-2b7e-4c1a-9d3e-%012x\",\"zona\":%u,\"diasSemana\":[%s],"
+                 "\"horaInicio\":\"%02u:%02u\",\"duracionMin\":%u,\"activa\":%s}",
+                 i > 0 ? "," : "", i, (unsigned int)(i * 7919U),
+                 (unsigned int)(i % MAX_ZONES) + 1, dias,
+                 (unsigned int)((5 + i * 7) % 24), (unsigned int)((i * 13) % 60),
+                 (unsigned int)(5 + (i % 6) * 5), (i % 8 == 7) ? "false" : "true");
+        
+        if (!payload.concat(item)) {
+            return false;
+        }
+    }
+    
+    return payload.concat("]}");
+}
+
+// ============================================================================
+// Ejecutar benchmark para un tamaño
+// ============================================================================
+bool AgendaBenchmark::run(uint16_t agendas, AgendaBenchResult& result) {
+    memset(&result, 0, sizeof(result));
+    result.agendas = agendas;
+    result.active = agendas - agendas / 8;  // buildPayload: 1 de cada 8 inactiva
+    result.heapFreeBefore = ESP.getFreeHeap();
+    result.heapFreeMin = result.heapFreeBefore;
+    
+    String payload;
+    if (!buildPayload(agendas, payload)) {
+        result.error = "payload_alloc";
+        return false;
+    }
+    result.payloadBytes = payload.length();
+    trackHeap(result);
+    
+    // ---------- Parseo ----------
+    size_t docSize = AgendaCompiler::docCapacityFor(payload.length());
+    DynamicJsonDocument doc(docSize);
+    if (doc.capacity() == 0) {
+        result.error = "doc_alloc";
+        return false;
+    }
+    result.docCapacity = doc.capacity();
+    result.peakAllocBytes = result.payloadBytes + 1 + result.docCapacity;
+    trackHeap(result);
+    
+    uint32_t totalUs = 0;
+    uint32_t totalCycles = 0;
+    for (uint8_t i = 0; i < AGENDA_BENCH_ITERATIONS; i++) {
+        uint32_t startUs = micros();
+        uint32_t startCycles = ESP.getCycleCount();
+        DeserializationError error = deserializeJson(doc, payload);
+        totalCycles += ESP.getCycleCount() - startCycles;
+        totalUs += micros() - startUs;
+        
+        if (error) {
+            result.error = error.c_str();
+            return false;
+        }
+        yield();
+    }
+    result.parseUs = totalUs / AGENDA_BENCH_ITERATIONS;
+    result.parseCycles = totalCycles / AGENDA_BENCH_ITERATIONS;
+    result.docUsed = doc.memoryUsage();
+    trackHeap(result);
+    
+    // ---------- Compilación (tabla + índice) ----------
+    totalUs = 0;
+    totalCycles = 0;
+    for (uint8_t i = 0; i < AGENDA_BENCH_ITERATIONS; i++) {
+        uint32_t startUs = micros();
+        uint32_t startCycles = ESP.getCycleCount();
+        AgendaCompiler::compile(doc, benchTable);
+        benchIndex.build(benchTable);
+        totalCycles += ESP.getCycleCount() - startCycles;
+        totalUs += micros() - startUs;
+        yield();
+    }
+    result.compileUs = totalUs / AGENDA_BENCH_ITERATIONS;
+    result.compileCycles = totalCycles / AGENDA_BENCH_ITERATIONS;
+    result.compiled = benchTable.count;
+    result.capped = result.active > benchTable.count;
+    result.firingsPerWeek = benchIndex.size();
+    
+    // Liberar el documento: la compilación en streaming no lo necesita
+    doc.clear();
+    
+    // ---------- Compilación en streaming desde flash ----------
+    File benchFile = LittleFS.open(AGENDA_BENCH_FILE, "w");
+    bool stored = benchFile && benchFile.print(payload) == payload.length();
+    benchFile.close();
+    payload = String();
+    if (!stored) {
+        LittleFS.remove(AGENDA_BENCH_FILE);
+        result.error = "bench_file";
+        return false;
+    }
+    
+    totalUs = 0;
+    totalCycles = 0;
+    for (uint8_t i = 0; i < AGENDA_BENCH_ITERATIONS; i++) {
+        DeserializationError error;
+        uint32_t startUs = micros();
+        uint32_t startCycles = ESP.getCycleCount();
+        benchFile = LittleFS.open(AGENDA_BENCH_FILE, "r");
+        AgendaCompileResult compiled = AgendaCompiler::compileFile(benchFile, benchTable, error);
+        benchFile.close();
+        benchIndex.build(benchTable);
+        totalCycles += ESP.getCycleCount() - startCycles;
+        totalUs += micros() - startUs;
+        
+        if (compiled != AGENDA_COMPILE_OK) {
+            LittleFS.remove(AGENDA_BENCH_FILE);
+            result.error = error ? error.c_str() : "stream_compile";
+            return false;
+        }
+        trackHeap(result);
+        yield();
+    }
+    LittleFS.remove(AGENDA_BENCH_FILE);
+    result.streamCompileUs = totalUs / AGENDA_BENCH_ITERATIONS;
+    result.streamCompileCycles = totalCycles / AGENDA_BENCH_ITERATIONS;
+    
+    // ---------- Carga de la imagen binaria (arranque) ----------
+    static AgendaImageBuffer imageBuffer;
+    size_t imageLength = AgendaImage::encode(benchTable, result.payloadBytes, imageBuffer);
+    benchFile = LittleFS.open(AGENDA_BENCH_IMAGE_FILE, "w");
+    stored = benchFile && benchFile.write((const uint8_t*)&imageBuffer, imageLength) == imageLength;
+    benchFile.close();
+    if (!stored) {
+        LittleFS.remove(AGENDA_BENCH_IMAGE_FILE);
+        result.error = "bench_image";
+        return false;
+    }
+    result.imageBytes = imageLength;
+    
+    totalUs = 0;
+    totalCycles = 0;
+    for (uint8_t i = 0; i < AGENDA_BENCH_ITERATIONS; i++) {
+        uint32_t startUs = micros();
+        uint32_t startCycles = ESP.getCycleCount();
+        benchFile = LittleFS.open(AGENDA_BENCH_IMAGE_FILE, "r");
+        size_t readBytes = benchFile.read((uint8_t*)&imageBuffer, sizeof(imageBuffer));
+        benchFile.close();
+        AgendaImageResult loaded = AgendaImage::decode(imageBuffer, readBytes, benchTable);
+        benchIndex.build(benchTable);
+        totalCycles += ESP.getCycleCount() - startCycles;
+        totalUs += micros() - startUs;
+        
+        if (loaded != AGENDA_IMAGE_OK) {
+            LittleFS.remove(AGENDA_BENCH_IMAGE_FILE);
+            result.error = AgendaImage::resultName(loaded);
+            return false;
+        }
+        yield();
+    }
+    LittleFS.remove(AGENDA_BENCH_IMAGE_FILE);
+    result.imageLoadUs = totalUs / AGENDA_BENCH_ITERATIONS;
+    result.imageLoadCycles = totalCycles / AGENDA_BENCH_ITERATIONS;
+    
+    // ---------- Evaluación por minuto (una semana) ----------
+    // Cada tick evalúa el minuto recién comenzado, como el poll de
+    // AgendaManager. Ciclos acumulados en 64 bits por bloques (CCOUNT desborda
+    // a los ~53 s a 80 MHz).
+    AgendaEvaluator evaluator;
+    AgendaRun runs[MAX_AGENDAS];
+    uint64_t evalUs = 0;
+    uint64_t evalCycles = 0;
+    uint32_t fired = 0;
+    
+    for (uint32_t block = 0; block < MINUTOS_POR_SEMANA; block += 256) {
+        uint32_t end = block + 256 < MINUTOS_POR_SEMANA ? block + 256 : MINUTOS_POR_SEMANA;
+        uint32_t startUs = micros();
+        uint32_t startCycles = ESP.getCycleCount();
+        for (uint32_t m = block; m < end; m++) {
+            uint32_t now = BENCH_WEEK_START + m * 60 + 5;
+            uint32_t watermark = minuteStart(now) - 60;
+            fired += evaluator.evaluate(benchTable, benchIndex, watermark, now, runs, MAX_AGENDAS);
+        }
+        evalCycles += (uint32_t)(ESP.getCycleCount() - startCycles);
+        evalUs += (uint32_t)(micros() - startUs);
+        yield();
+    }
+    
+    result.evalTicks = MINUTOS_POR_SEMANA;
+    result.evalNsPerTick = (uint32_t)(evalUs * 1000 / MINUTOS_POR_SEMANA);
+    result.evalCyclesPerTick = (uint32_t)(evalCycles / MINUTOS_POR_SEMANA);
+    result.firedPerWeek = (uint16_t)fired;
+    trackHeap(result);
+    
+    return true;
+}
+
+static void printHeap(Print& out, const AgendaBenchResult& result, bool withMin) {
+    if (!BENCH_HEAP_MEASURED) {
+        out.print(withMin ? ",\"heapMeasured\":false,\"heapFreeBefore\":null,\"heapFreeMin\":null"
+                          : ",\"heapMeasured\":false,\"heapFreeBefore\":null");
+        return;
+    }
+    out.printf(",\"heapMeasured\":true,\"heapFreeBefore\":%lu", (unsigned long)result.heapFreeBefore);
+    if (withMin) {
+        out.printf(",\"heapFreeMin\":%lu", (unsigned long)result.heapFreeMin);
+    }
+}
+
+// ============================================================================
+// Imprimir resultado (una línea JSON)
+// ============================================================================
+void AgendaBenchmark::printResult(Print& out, const AgendaBenchResult& result) {
+    out.printf("{\"bench\":\"agenda\",\"platform\":\"%s\",\"fw\":\"%s\",\"cpuMHz\":%u,\"agendas\":%u",
+               BENCH_PLATFORM, FIRMWARE_VERSION, (unsigned int)ESP.getCpuFreqMHz(), (unsigned int)result.agendas);
+    
+    if (result.error != nullptr) {
+        out.printf(",\"error\":\"%s\",\"payloadBytes\":%lu",
+                   result.error, (unsigned long)result.payloadBytes);
+        printHeap(out, result, false);
+        out.print("}\n");
+        return;
+    }
+    
+    out.printf(",\"active\":%u,\"maxAgendas\":%u,\"capped\":%s",
+               (unsigned int)result.active, (unsigned int)MAX_AGENDAS, result.capped ? "true" : "false");
+    out.printf(",\"compiled\":%u,\"firingsPerWeek\":%u,\"firedPerWeek\":%u",
+               (unsigned int)result.compiled, (unsigned int)result.firingsPerWeek, (unsigned int)result.firedPerWeek);
+    out.printf(",\"payloadBytes\":%lu,\"docCapacity\":%lu,\"docUsed\":%lu,\"peakAllocBytes\":%lu",
+               (unsigned long)result.payloadBytes, (unsigned long)result.docCapacity,
+               (unsigned long)result.docUsed, (unsigned long)result.peakAllocBytes);
+    printHeap(out, result, true);
+    out.printf(",\"parseUs\":%lu,\"parseCycles\":%lu,\"compileUs\":%lu,\"compileCycles\":%lu",
+               (unsigned long)result.parseUs, (unsigned long)result.parseCycles,
+               (unsigned long)result.compileUs, (unsigned long)result.compileCycles);
+    out.printf(",\"streamCompileUs\":%lu,\"streamCompileCycles\":%lu",
+               (unsigned long)result.streamCompileUs, (unsigned long)result.streamCompileCycles);
+    out.printf(",\"imageBytes\":%lu,\"imageLoadUs\":%lu,\"imageLoadCycles\":%lu",
+               (unsigned long)result.imageBytes, (unsigned long)result.imageLoadUs,
+               (unsigned long)result.imageLoadCycles);
+    out.printf(",\"evalTicks\":%lu,\"evalNsPerTick\":%lu,\"evalCyclesPerTick\":%lu}\n",
+               (unsigned long)result.evalTicks, (unsigned long)result.evalNsPerTick,
+               (unsigned long)result.evalCyclesPerTick);
+}
+
+// ============================================================================
+// Suite completa
+// ============================================================================
+void AgendaBenchmark::runSuite(Print& out) {
+    AgendaBenchResult result;
+    for (size_t i = 0; i < sizeof(BENCH_SIZES) / sizeof(BENCH_SIZES[0]); i++) {
+        run(BENCH_SIZES[i], result);
+        printResult(out, result);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef AGENDA_BENCHMARK_H
+#define AGENDA_BENCHMARK_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// AgendaBenchmark - Microbenchmark de parseo y evaluación de agendas
+// ============================================================================
+// Genera un /agenda.json representativo (formato del backend) con N agendas
+// y mide: deserializeJson del documento completo y su compilación, la
+// compilación en streaming desde flash (camino de AgendaManager::reload), la
+// carga de la imagen binaria (camino de arranque, ver AgendaImage.h) y
+// la evaluación por minuto durante una semana completa (10080 ticks).
+// Reporta tiempo (micros) y ciclos (ESP.getCycleCount) como una línea JSON
+// por tamaño. Corre en el dispositivo (comando serial "bench") y en host
+// (pio run -e native_bench -t exec).
+// La tabla se compila con el MAX_AGENDAS del build: si el payload tiene más
+// agendas activas, la línea lo marca con "maxAgendas" y "capped":true (los
+// tiempos de compilación y evaluación son los de MAX_AGENDAS slots). En host
+// el heap no se mide (el shim devuelve un valor fijo): esos campos salen
+// null con "heapMeasured":false.
+
+#define AGENDA_BENCH_ITERATIONS 5  // Repeticiones de parseo/compilación a promediar
+#define AGENDA_BENCH_FILE "/bench.json"  // Payload temporal para la compilación en streaming
+#define AGENDA_BENCH_IMAGE_FILE "/bench.bin"  // Imagen binaria temporal
+
+struct AgendaBenchResult {
+    uint16_t agendas;          // Agendas en el payload
+    uint16_t active;           // Agendas activas en el payload
+    uint8_t compiled;          // Slots compilados (acotado a MAX_AGENDAS)
+    bool capped;               // active > MAX_AGENDAS: se compiló solo una parte
+    uint16_t firingsPerWeek;   // Entradas del índice (disparos semanales)
+    uint16_t firedPerWeek;     // Ejecuciones que produjo la evaluación de la semana
+    uint32_t payloadBytes;
+    uint32_t docCapacity;      // Capacidad reservada (misma fórmula que reload)
+    uint32_t docUsed;          // memoryUsage() tras el parseo
+    uint32_t peakAllocBytes;   // Payload + documento vivos durante el parseo
+    uint32_t heapFreeBefore;
+    uint32_t heapFreeMin;      // Mínimo de heap libre observado durante la corrida
+    uint32_t parseUs;          // Promedio por parseo
+    uint32_t parseCycles;
+    uint32_t compileUs;        // Promedio por compilación (tabla + índice)
+    uint32_t compileCycles;
+    uint32_t streamCompileUs;  // Promedio de compileFile() desde flash (tabla + índice)
+    uint32_t streamCompileCycles;
+    uint32_t imageBytes;       // Tamaño de la imagen binaria de la tabla
+    uint32_t imageLoadUs;      // Promedio de lectura + validación de la imagen (tabla + índice)
+    uint32_t imageLoadCycles;
+    uint32_t evalTicks;
+    uint32_t evalNsPerTick;
+    uint32_t evalCyclesPerTick;
+    const char* error;         // nullptr si la corrida fue completa
+};
+
+class AgendaBenchmark {
+public:
+    // Payload determinístico con `agendas` agendas (zonas 1-8, ~1/8 inactivas)
+    static bool buildPayload(uint16_t agendas, String& payload);
+    
+    // Ejecutar el benchmark para un tamaño
+    static bool run(uint16_t agendas, AgendaBenchResult& result);
+    
+    // Imprimir resultado como una línea JSON
+    static void printResult(Print& out, const AgendaBenchResult& result);
+    
+    // Suite completa: 8, 32 y 128 agendas
+    static void runSuite(Print& out);
+};
+
+#endif // AGENDA_BENCHMARK_H
@@ -0,0 +1,39 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// Crc32 - CRC-32 IEEE 802.3 (polinomio reflejado 0xEDB88320)
+// ============================================================================
+// Tabla de 16 entradas (un nibble por paso): 64 bytes de flash en lugar de
+// los 1 KB de la tabla completa, suficiente para validar archivos chicos.
+// Mismo resultado que zlib/binascii.crc32 (crc32("123456789") = 0xCBF43926).
+
+class Crc32 {
+public:
+    // Continuar un CRC (arrancar con crc = 0)
+    static uint32_t update(uint32_t crc, const void* data, size_t length) {
+        static const uint32_t NIBBLE_TABLE[16] = {
+            0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+            0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+            0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+            0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+        };
+        const uint8_t* bytes = (const uint8_t*)data;
+        crc = ~crc;
+        for (size_t i = 0; i < length; i++) {
+            crc ^= bytes[i];
+            crc = (crc >> 4) ^ NIBBLE_TABLE[crc & 0x0F];
+            crc = (crc >> 4) ^ NIBBLE_TABLE[crc & 0x0F];
+        }
+        return ~crc;
+    }
+
+    static uint32_t compute(const void* data, size_t length) {
+        return update(0, data, length);
+    }
+};
+
+#endif // CRC32_H
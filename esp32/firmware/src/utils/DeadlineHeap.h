@@ -0,0 +1,134 @@
+#ifndef DEADLINE_HEAP_H
+#define DEADLINE_HEAP_H
+
+#include <stdint.h>
+
+// ============================================================================
+// DeadlineHeap - Min-heap de vencimientos absolutos (ms de millis())
+// ============================================================================
+// Cada entrada es un id (0..CAPACITY-1) con su vencimiento absoluto. El
+// próximo vencimiento se consulta en O(1) y agregar, reprogramar o cancelar
+// cuesta O(log n). Un índice por id permite reprogramar o cancelar sin
+// buscar. Las comparaciones son por diferencia con signo, así que el
+// desborde de millis() (~49 días) no altera el orden mientras los
+// vencimientos pendientes estén a menos de ~24 días entre sí.
+
+template <uint8_t CAPACITY>
+class DeadlineHeap {
+private:
+    static const uint8_t NONE = 0xFF;
+
+    struct Entry {
+        uint32_t deadline;
+        uint8_t id;
+    };
+
+    Entry heap[CAPACITY];
+    uint8_t position[CAPACITY];  // Posición de cada id en el heap (NONE = ausente)
+    uint8_t count;
+
+    static bool before(uint32_t a, uint32_t b) {
+        return (int32_t)(a - b) < 0;
+    }
+
+    void place(uint8_t index, const Entry& entry) {
+        heap[index] = entry;
+        position[entry.id] = index;
+    }
+
+    void siftUp(uint8_t index) {
+        Entry entry = heap[index];
+        while (index > 0) {
+            uint8_t parent = (index - 1) / 2;
+            if (!before(entry.deadline, heap[parent].deadline)) break;
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, entry);
+    }
+
+    void siftDown(uint8_t index) {
+        Entry entry = heap[index];
+        while (true) {
+            uint8_t child = index * 2 + 1;
+            if (child >= count) break;
+            if (child + 1 < count && before(heap[child + 1].deadline, heap[child].deadline)) child++;
+            if (!before(heap[child].deadline, entry.deadline)) break;
+            place(index, heap[child]);
+            index = child;
+        }
+        place(index, entry);
+    }
+
+    void removeAt(uint8_t index) {
+        position[heap[index].id] = NONE;
+        count--;
+        if (index == count) return;
+        // El último ocupa el hueco y puede tener que subir o bajar
+        uint8_t moved = heap[count].id;
+        place(index, heap[count]);
+        siftDown(index);
+        siftUp(position[moved]);
+    }
+
+public:
+    DeadlineHeap() {
+        clear();
+    }
+
+    void clear() {
+        count = 0;
+        for (uint8_t i = 0; i < CAPACITY; i++) position[i] = NONE;
+    }
+
+    // Agregar o reprogramar el vencimiento de `id`
+    bool schedule(uint8_t id, uint32_t deadline) {
+        if (id >= CAPACITY) return false;
+        uint8_t index = position[id];
+        if (index == NONE) {
+            index = count++;
+            place(index, Entry{deadline, id});
+            siftUp(index);
+            return true;
+        }
+        uint32_t previous = heap[index].deadline;
+        heap[index].deadline = deadline;
+        if (before(deadline, previous)) siftUp(index);
+        else siftDown(index);
+        return true;
+    }
+
+    bool cancel(uint8_t id) {
+        if (id >= CAPACITY || position[id] == NONE) return false;
+        removeAt(position[id]);
+        return true;
+    }
+
+    // Sacar el próximo id ya vencido a `nowMs` (false si no hay ninguno)
+    bool popExpired(uint32_t nowMs, uint8_t& id) {
+        if (count == 0 || before(nowMs, heap[0].deadline)) return false;
+        id = heap[0].id;
+        removeAt(0);
+        return true;
+    }
+
+    bool isEmpty() const { return count == 0; }
+    uint8_t size() const { return count; }
+    bool contains(uint8_t id) const { return id < CAPACITY && position[id] != NONE; }
+
+    // Próximo vencimiento (solo si !isEmpty())
+    uint32_t nextDeadline() const { return heap[0].deadline; }
+    uint8_t nextId() const { return heap[0].id; }
+
+    // Vencimiento de `id` (solo si contains(id))
+    uint32_t deadlineOf(uint8_t id) const { return heap[position[id]].deadline; }
+
+    // Ms hasta el próximo vencimiento (0 si ya venció, -1 si está vacío)
+    long msUntilNext(uint32_t nowMs) const {
+        if (count == 0) return -1;
+        int32_t ms = (int32_t)(heap[0].deadline - nowMs);
+        return ms > 0 ? (long)ms : 0;
+    }
+};
+
+#endif // DEADLINE_HEAP_H
@@ -0,0 +1,140 @@
+#include "JsonWriter.h"
+
+// ============================================================================
+// Constructor
+// ============================================================================
+JsonWriter::JsonWriter(char* buffer, size_t capacity)
+    : buffer(buffer), capacity(capacity), pos(0), overflow(capacity == 0), firstField(true) {
+    if (capacity > 0) buffer[0] = '\0';
+}
+
+// ============================================================================
+// Objeto
+// ============================================================================
+void JsonWriter::begin() {
+    pos = 0;
+    overflow = capacity == 0;
+    firstField = true;
+    put('{');
+}
+
+void JsonWriter::end() {
+    put('}');
+    if (capacity == 0) return;
+    // Con overflow el contenido queda truncado pero terminado
+    buffer[pos < capacity ? pos : capacity - 1] = '\0';
+}
+
+// ============================================================================
+// Campos
+// ============================================================================
+void JsonWriter::fieldInt(const char* key, int32_t value) {
+    putKey(key);
+    if (value < 0) {
+        put('-');
+        putUnsigned((uint32_t)0 - (uint32_t)value);
+    } else {
+        putUnsigned((uint32_t)value);
+    }
+}
+
+void JsonWriter::fieldUInt(const char* key, uint32_t value) {
+    putKey(key);
+    putUnsigned(value);
+}
+
+void JsonWriter::fieldBool(const char* key, bool value) {
+    putKey(key);
+    putRaw(value ? "true" : "false");
+}
+
+void JsonWriter::fieldString(const char* key, const char* value) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    if (value == nullptr) {
+        fieldNull(key);
+        return;
+    }
+
+    putKey(key);
+    put('"');
+    for (const char* p = value; *p != '\0'; p++) {
+        char c = *p;
+        switch (c) {
+            case '"':  put('\\'); put('"'); break;
+            case '\\': put('\\'); put('\\'); break;
+            case '\n': put('\\'); put('n'); break;
+            case '\r': put('\\'); put('r'); break;
+            case '\t': put('\\'); put('t'); break;
+            default:
+                if ((uint8_t)c < 0x20) {
+                    putRaw("\\u00");
+                    put(HEX_DIGITS[(c >> 4) & 0x0F]);
+                    put(HEX_DIGITS[c & 0x0F]);
+                } else {
+                    put(c);
+                }
+        }
+    }
+    put('"');
+}
+
+void JsonWriter::fieldNull(const char* key) {
+    putKey(key);
+    putRaw("null");
+}
+
+void JsonWriter::fieldUIntArray(const char* key, const uint16_t* values, uint8_t count) {
+    putKey(key);
+    put('[');
+    for (uint8_t i = 0; i < count; i++) {
+        if (i > 0) put(',');
+        putUnsigned(values[i]);
+    }
+    put(']');
+}
+
+void JsonWriter::fieldUIntArray(const char* key, const uint32_t* values, uint8_t count) {
+    putKey(key);
+    put('[');
+    for (uint8_t i = 0; i < count; i++) {
+        if (i > 0) put(',');
+        putUnsigned(values[i]);
+    }
+    put(']');
+}
+
+// ============================================================================
+// Escritura de bajo nivel
+// ============================================================================
+void JsonWriter::put(char c) {
+    // Reservar siempre un byte para el terminador
+    if (pos + 1 >= capacity) {
+        overflow = true;
+        return;
+    }
+    buffer[pos++] = c;
+}
+
+void JsonWriter::putRaw(const char* text) {
+    while (*text != '\0') put(*text++);
+}
+
+void JsonWriter::putKey(const char* key) {
+    if (!firstField) put(',');
+    firstField = false;
+    put('"');
+    putRaw(key);
+    put('"');
+    put(':');
+}
+
+void JsonWriter::putUnsigned(uint32_t value) {
+    char digits[10];
+    uint8_t count = 0;
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (count > 0) put(digits[--count]);
+}
@@ -0,0 +1,53 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// JsonWriter - Codificador JSON de esquema fijo sobre un buffer externo
+// ============================================================================
+// Escribe un objeto plano ({"k":v,...}, a lo sumo con arreglos de enteros)
+// directo en el buffer, sin documento intermedio ni heap: alcanza para los
+// payloads salientes de MQTT, que tienen campos fijos. Los strings se
+// escapan; los enteros se formatean a mano (sin printf). Si el buffer no
+// alcanza, overflowed() queda en true y el contenido no debe publicarse.
+
+class JsonWriter {
+private:
+    char* buffer;
+    size_t capacity;
+    size_t pos;
+    bool overflow;
+    bool firstField;
+
+    void put(char c);
+    void putRaw(const char* text);
+    void putKey(const char* key);
+    void putUnsigned(uint32_t value);
+
+public:
+    // `capacity` incluye el terminador '\0'
+    JsonWriter(char* buffer, size_t capacity);
+
+    // Reiniciar y abrir el objeto
+    void begin();
+
+    // Cerrar el objeto (deja el buffer terminado en '\0')
+    void end();
+
+    void fieldInt(const char* key, int32_t value);
+    void fieldUInt(const char* key, uint32_t value);
+    void fieldBool(const char* key, bool value);
+    void fieldString(const char* key, const char* value);
+    void fieldNull(const char* key);
+    // Arreglo de enteros sin signo ("k":[v0,v1,...])
+    void fieldUIntArray(const char* key, const uint16_t* values, uint8_t count);
+    void fieldUIntArray(const char* key, const uint32_t* values, uint8_t count);
+
+    const char* c_str() const { return buffer; }
+    size_t length() const { return pos; }
+    bool overflowed() const { return overflow; }
+};
+
+#endif // JSON_WRITER_H
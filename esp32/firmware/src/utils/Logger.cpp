@@ -0,0 +1,156 @@
+#include "Logger.h"
+#include <stdarg.h>
+
+static_assert(LOG_BUFFER_SIZE <= 65535, "LOG_BUFFER_SIZE debe entrar en uint16_t");
+static_assert(LOG_LINE_MAX >= 32 && LOG_LINE_MAX < LOG_BUFFER_SIZE, "LOG_LINE_MAX fuera de rango");
+
+char Logger::ring[LOG_BUFFER_SIZE];
+char Logger::line[LOG_LINE_MAX];
+volatile uint16_t Logger::head = 0;
+volatile uint16_t Logger::tail = 0;
+uint32_t Logger::dropped = 0;
+uint32_t Logger::droppedReported = 0;
+bool Logger::deferred = false;
+LogRecordSink Logger::recordSink = nullptr;
+LogLineSink Logger::lineSink = nullptr;
+
+// ============================================================================
+// Formato
+// ============================================================================
+const char* Logger::prefix(int level) {
+    switch (level) {
+        case LOG_LEVEL_ERROR: return "[ERROR] ";
+        case LOG_LEVEL_WARN:  return "[WARN] ";
+        case LOG_LEVEL_INFO:  return "[INFO] ";
+        case LOG_LEVEL_DEBUG: return "[DEBUG] ";
+        default: return "";
+    }
+}
+
+// Cerrar la línea con CRLF (como Serial.println), truncando si hace falta
+size_t Logger::terminate(size_t length) {
+    if (length > LOG_LINE_MAX - 3) length = LOG_LINE_MAX - 3;
+    line[length++] = '\r';
+    line[length++] = '\n';
+    line[length] = '\0';
+    return length;
+}
+
+// Copiar el prefijo del nivel al inicio de la línea
+size_t Logger::begin(int level) {
+    size_t length = strlen(prefix(level));
+    memcpy(line, prefix(level), length);
+    return length;
+}
+
+void Logger::logf_P(int level, uint32_t id, PGM_P format, ...) {
+    if (LOG_LEVEL < level) return;
+    size_t length = begin(level);
+    
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf_P(line + length, sizeof(line) - length, format, args);
+    va_end(args);
+    
+    if (written > 0) length += (size_t)written;
+    enqueue(level, terminate(length));
+    
+    // Después del texto: el sumidero puede loguear sin pisar la línea
+    if (recordSink != nullptr) {
+        va_start(args, format);
+        recordSink(level, id, format, args);
+        va_end(args);
+    }
+}
+
+void Logger::logf(int level, const char* format, ...) {
+    if (LOG_LEVEL < level) return;
+    size_t length = begin(level);
+    
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(line + length, sizeof(line) - length, format, args);
+    va_end(args);
+    
+    if (written > 0) length += (size_t)written;
+    enqueue(level, terminate(length));
+    
+    if (recordSink != nullptr) {
+        va_start(args, format);
+        recordSink(level, formatId(format), format, args);
+        va_end(args);
+    }
+}
+
+// ============================================================================
+// Buffer circular
+// ============================================================================
+size_t Logger::pending() {
+    uint16_t h = head;
+    uint16_t t = tail;
+    return h >= t ? (size_t)(h - t) : (size_t)(LOG_BUFFER_SIZE - t + h);
+}
+
+bool Logger::push(const char* data, size_t length) {
+    // Un byte libre siempre: head == tail significa vacío
+    if (length > LOG_BUFFER_SIZE - 1 - pending()) return false;
+    
+    uint16_t h = head;
+    size_t first = LOG_BUFFER_SIZE - h;
+    if (first > length) first = length;
+    memcpy(ring + h, data, first);
+    memcpy(ring, data + first, length - first);
+    head = (uint16_t)((h + length) % LOG_BUFFER_SIZE);
+    return true;
+}
+
+void Logger::enqueue(int level, size_t length) {
+    // Antes de push/drain: el aviso de líneas perdidas reusa `line`
+    if (lineSink != nullptr) lineSink(level, line, length - 2);
+    if (!push(line, length)) dropped++;
+    if (!deferred) drain(Serial, (size_t)-1);
+}
+
+// ============================================================================
+// Envío al UART
+// ============================================================================
+size_t Logger::drain(Print& out, size_t budget) {
+    size_t sent = 0;
+    while (budget > 0) {
+        uint16_t t = tail;
+        uint16_t h = head;
+        
+        if (h == t) {
+            // Vacío: avisar las líneas perdidas, si hubo
+            if (dropped == droppedReported) break;
+            uint32_t lost = dropped - droppedReported;
+            droppedReported = dropped;
+            size_t length = begin(LOG_LEVEL_WARN);
+            int written = snprintf_P(line + length, sizeof(line) - length,
+                                     PSTR("Log: %lu lineas descartadas (buffer lleno)"), (unsigned long)lost);
+            if (written > 0) length += (size_t)written;
+            push(line, terminate(length));
+            continue;
+        }
+        
+        // Tramo contiguo hasta head o hasta el final del buffer
+        size_t chunk = h > t ? (size_t)(h - t) : (size_t)(LOG_BUFFER_SIZE - t);
+        if (chunk > budget) chunk = budget;
+        size_t written = out.write((const uint8_t*)ring + t, chunk);
+        tail = (uint16_t)((t + written) % LOG_BUFFER_SIZE);
+        sent += written;
+        budget -= chunk;
+        if (written < chunk) break;
+    }
+    return sent;
+}
+
+size_t Logger::drain() {
+    int room = Serial.availableForWrite();
+    return room > 0 ? drain(Serial, (size_t)room) : 0;
+}
+
+void Logger::flush() {
+    drain(Serial, (size_t)-1);
+    Serial.flush();
+}
@@ -2,71 +2,140 @@
 #define LOGGER_H
 
 #include <Arduino.h>
+#include <stdarg.h>
 #include "../config/Config.h"
 
 // ============================================================================
 // Logger - Sistema de logging con niveles
 // ============================================================================
-// Proporciona funciones de logging con diferentes niveles de verbosidad
-// controlados por LOG_LEVEL en Config.h
+// Se usa por macros: LOG_ERROR, LOG_WARN, LOG_INFO y LOG_DEBUG, con formato
+// printf literal. Los niveles por encima de LOG_LEVEL (Config.h, o
+// -DLOG_LEVEL=...) no generan código: ni la llamada, ni la evaluación de los
+// argumentos, ni el texto. El formato de los niveles activos queda en flash
+// (PSTR): en el ESP8266 un literal común ocupa DRAM. Ver
+// tools/log_size_report.py para el costo de cada nivel.
+//
+// Cada línea se formatea en un buffer estático y se copia a un buffer
+// circular (LOG_BUFFER_SIZE). En modo diferido (setDeferred(true), desde el
+// loop) nada escribe al UART al loguear: drain() vacía lo que entra en la
+// FIFO de transmisión sin bloquear y se llama en tiempo ocioso. Un productor
+// (el código que loguea) y un consumidor (drain), sin locks ni heap. Si el
+// buffer está lleno la línea nueva se descarta y se cuenta; al vaciarse se
+// publica un aviso con la cantidad perdida.
+//
+// Además del texto, cada línea puede ir a un sumidero de registros
+// (setRecordSink, ver storage/LogRecorder.h) con su id de formato: un hash
+// FNV-1a del literal calculado en compilación. tools/log_formats.py calcula
+// el mismo hash sobre las fuentes y arma la tabla id -> formato del host.
+// Un sumidero de líneas (setLineSink, ver network/LogStreamer.h) recibe en
+// cambio el texto ya formateado; no debe loguear (comparte el buffer).
+
+// Sumidero de registros: nivel, id del formato, formato (en flash) y argumentos
+typedef void (*LogRecordSink)(int level, uint32_t id, PGM_P format, va_list args);
+// Sumidero de líneas: nivel y línea con prefijo, sin CRLF ni terminador
+typedef void (*LogLineSink)(int level, const char* line, size_t length);
 
 class Logger {
+private:
+    static char ring[LOG_BUFFER_SIZE];
+    static char line[LOG_LINE_MAX];      // Línea en formato (no reentrante)
+    static volatile uint16_t head;       // Próximo byte a escribir (productor)
+    static volatile uint16_t tail;       // Próximo byte a enviar (consumidor)
+    static uint32_t dropped;
+    static uint32_t droppedReported;
+    static bool deferred;
+    static LogRecordSink recordSink;
+    static LogLineSink lineSink;
+
+    static const char* prefix(int level);
+    static bool push(const char* data, size_t length);
+    static void enqueue(int level, size_t length);
+    static size_t terminate(size_t length);
+    static size_t begin(int level);
+
 public:
-    // Log de error (nivel 1)
-    static void error(String message) {
-        if (LOG_LEVEL >= LOG_LEVEL_ERROR) {
-            Serial.print("[ERROR] ");
-            Serial.println(message);
-        }
-    }
+    // Línea con formato en flash (usar las macros LOG_*)
+    static void logf_P(int level, uint32_t id, PGM_P format, ...);
     
-    // Log de warning (nivel 2)
-    static void warn(String message) {
-        if (LOG_LEVEL >= LOG_LEVEL_WARN) {
-            Serial.print("[WARN] ");
-            Serial.println(message);
-        }
-    }
+    // Línea con formato en RAM y nivel decidido en ejecución (id calculado acá)
+    static void logf(int level, const char* format, ...) __attribute__((format(printf, 2, 3)));
     
-    // Log de info (nivel 3)
-    static void info(String message) {
-        if (LOG_LEVEL >= LOG_LEVEL_INFO) {
-            Serial.print("[INFO] ");
-            Serial.println(message);
-        }
+    // Id de un formato: FNV-1a de 32 bits sobre sus bytes (0 queda reservado
+    // para la marca de arranque del registro binario)
+    static constexpr uint32_t formatId(const char* format, uint32_t hash = 2166136261UL) {
+        return *format == '\0' ? hash
+                               : formatId(format + 1, (uint32_t)((hash ^ (uint8_t)*format) * 16777619UL));
     }
     
-    // Log de debug (nivel 4)
-    static void debug(String message) {
-        if (LOG_LEVEL >= LOG_LEVEL_DEBUG) {
-            Serial.print("[DEBUG] ");
-            Serial.println(message);
-        }
-    }
+    // Recibir cada línea también como registro (nullptr = ninguno)
+    static void setRecordSink(LogRecordSink sink) { recordSink = sink; }
+    
+    // Recibir cada línea formateada (nullptr = ninguno)
+    static void setLineSink(LogLineSink sink) { lineSink = sink; }
     
-    // Log con formato printf
-    static void logf(int level, const char* format, ...) {
-        if (LOG_LEVEL < level) return;
-        
-        const char* prefix;
-        switch (level) {
-            case LOG_LEVEL_ERROR: prefix = "[ERROR] "; break;
-            case LOG_LEVEL_WARN:  prefix = "[WARN] ";  break;
-            case LOG_LEVEL_INFO:  prefix = "[INFO] ";  break;
-            case LOG_LEVEL_DEBUG: prefix = "[DEBUG] "; break;
-            default: prefix = ""; break;
-        }
-        
-        Serial.print(prefix);
-        
-        va_list args;
-        va_start(args, format);
-        char buffer[256];
-        vsnprintf(buffer, sizeof(buffer), format, args);
-        va_end(args);
-        
-        Serial.println(buffer);
+    // Nunca se llama: solo verifica formato y argumentos de un nivel deshabilitado
+    static inline void checkFormat(const char* format, ...) __attribute__((format(printf, 1, 2))) {
+        (void)format;
     }
+    
+    // false (arranque): cada línea sale al UART al loguear, como antes.
+    // true (loop): las líneas esperan a drain()
+    static void setDeferred(bool enabled) { deferred = enabled; }
+    
+    // Enviar lo que entre en la FIFO del UART sin bloquear (tiempo ocioso)
+    static size_t drain();
+    
+    // Enviar hasta `budget` bytes a `out` (drain() con Serial y su espacio libre)
+    static size_t drain(Print& out, size_t budget);
+    
+    // Enviar todo, bloqueando (antes de reiniciar)
+    static void flush();
+    
+    // Bytes esperando en el buffer
+    static size_t pending();
+    
+    // Líneas descartadas por buffer lleno (desde el arranque)
+    static uint32_t getDropped() { return dropped; }
 };
 
+// Id del formato forzado en compilación (el argumento del template)
+template <uint32_t ID> struct LogFormatId { static const uint32_t value = ID; };
+#define LOG_ID(format) (LogFormatId<Logger::formatId(format)>::value)
+
+// ============= Macros por nivel =============
+// logf_P no puede verificar el formato (va en flash, sin atributo printf):
+// checkFormat lo hace en compilación en los niveles activos también. Un
+// argumento que no coincide rompería además el registro binario (LogRecorder)
+#define LOG_ENABLED(level, format, ...) \
+    do { \
+        if (0) Logger::checkFormat(format, ##__VA_ARGS__); \
+        Logger::logf_P(level, LOG_ID(format), PSTR(format), ##__VA_ARGS__); \
+    } while (0)
+#define LOG_DISABLED(format, ...) \
+    do { if (0) Logger::checkFormat(format, ##__VA_ARGS__); } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) LOG_ENABLED(LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(format, ...) LOG_ENABLED(LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(format, ...) LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...) LOG_ENABLED(LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) LOG_ENABLED(LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
 #endif // LOGGER_H
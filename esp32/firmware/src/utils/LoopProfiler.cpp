@@ -0,0 +1,153 @@
+#include "LoopProfiler.h"
+
+static const char* const CHANNEL_NAMES[PROF_CHANNELS] = {
+    "wifi", "mqtt", "ota", "reles", "cola", "hora", "agenda", "display",
+    "principal", "log", "otros", "vuelta", "periodo", "retraso"
+};
+
+// ============================================================================
+// Constructor y ventana
+// ============================================================================
+LoopProfiler::LoopProfiler()
+    : loopStartUs(0), lastMarkUs(0), loopEndUs(0), plannedSleepUs(0), hasLoop(false),
+      slowLoops(0), loopSlowestUs(0), loopSlowestChannel(PROF_OTHER), windowStart(0) {
+    reset(0);
+}
+
+void LoopProfiler::reset(unsigned long nowMs) {
+    memset(channels, 0, sizeof(channels));
+    slowLoops = 0;
+    windowStart = nowMs;
+}
+
+const char* LoopProfiler::channelName(uint8_t channel) {
+    return channel < PROF_CHANNELS ? CHANNEL_NAMES[channel] : "?";
+}
+
+// ============================================================================
+// Cubetas de media octava
+// ============================================================================
+// 0 y 1 tienen cubeta propia; desde 2, la octava [2^o, 2^(o+1)) se parte en
+// [2^o, 1.5·2^o) y [1.5·2^o, 2^(o+1)): cubetas 2o y 2o+1
+uint8_t LoopProfiler::bucketOf(uint32_t us) {
+    if (us < 2) return (uint8_t)us;
+    uint8_t octave = (uint8_t)(31 - __builtin_clz(us));
+    uint32_t bucket = octave * 2u + ((us >> (octave - 1)) & 1u);
+    return bucket < LOOP_PROFILER_BUCKETS ? (uint8_t)bucket : LOOP_PROFILER_BUCKETS - 1;
+}
+
+uint32_t LoopProfiler::bucketLower(uint8_t bucket) {
+    if (bucket < 2) return bucket;
+    uint8_t octave = bucket / 2;
+    return (1UL << octave) + ((bucket & 1) ? (1UL << (octave - 1)) : 0);
+}
+
+uint32_t LoopProfiler::bucketUpper(uint8_t bucket) {
+    if (bucket + 1 >= LOOP_PROFILER_BUCKETS) return UINT32_MAX;
+    return bucketLower(bucket + 1) - 1;
+}
+
+void LoopProfiler::add(ProfileHistogram& histogram, uint32_t us) {
+    uint16_t& slot = histogram.buckets[bucketOf(us)];
+    if (slot == UINT16_MAX) {
+        for (uint8_t i = 0; i < LOOP_PROFILER_BUCKETS; i++) {
+            histogram.buckets[i] = (uint16_t)((histogram.buckets[i] + 1) / 2);
+        }
+    }
+    slot++;
+    if (histogram.count == 0 || us < histogram.minUs) histogram.minUs = us;
+    if (us > histogram.maxUs) histogram.maxUs = us;
+    histogram.count++;
+}
+
+// ============================================================================
+// Vuelta del loop
+// ============================================================================
+void LoopProfiler::startLoop(uint32_t nowUs) {
+    if (hasLoop) {
+        record(PROF_LOOP_PERIOD, nowUs - loopStartUs);
+        uint32_t slept = nowUs - loopEndUs;
+        record(PROF_LOOP_LATE, slept > plannedSleepUs ? slept - plannedSleepUs : 0);
+    }
+    loopStartUs = nowUs;
+    lastMarkUs = nowUs;
+    loopSlowestUs = 0;
+    loopSlowestChannel = PROF_OTHER;
+}
+
+bool LoopProfiler::endLoop(uint32_t nowUs, unsigned long plannedSleepMs) {
+    uint32_t busy = nowUs - loopStartUs;
+    record(PROF_LOOP_BUSY, busy);
+    loopEndUs = nowUs;
+    plannedSleepUs = (uint32_t)plannedSleepMs * 1000UL;
+    hasLoop = true;
+
+    if (busy < LOOP_PROFILER_SLOW_MS * 1000UL) return false;
+    slowLoops++;
+    return true;
+}
+
+// ============================================================================
+// Resumen y reporte
+// ============================================================================
+void LoopProfiler::summarize(uint8_t channel, ProfileSummary& out) const {
+    const ProfileHistogram& histogram = channels[channel];
+    out.count = histogram.count;
+    out.minUs = histogram.minUs;
+    out.maxUs = histogram.maxUs;
+    out.p50Us = 0;
+    out.p99Us = 0;
+    if (histogram.count == 0) return;
+
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < LOOP_PROFILER_BUCKETS; i++) total += histogram.buckets[i];
+
+    // Percentil = cota superior de la cubeta donde cae la muestra ceil(total·p)
+    uint32_t target50 = (total + 1) / 2;
+    uint32_t target99 = (total * 99 + 99) / 100;
+    uint32_t seen = 0;
+    bool found50 = false;
+    for (uint8_t i = 0; i < LOOP_PROFILER_BUCKETS; i++) {
+        seen += histogram.buckets[i];
+        uint32_t upper = bucketUpper(i);
+        if (upper > histogram.maxUs) upper = histogram.maxUs;
+        if (upper < histogram.minUs) upper = histogram.minUs;
+        if (!found50 && seen >= target50) {
+            out.p50Us = upper;
+            found50 = true;
+        }
+        if (seen >= target99) {
+            out.p99Us = upper;
+            return;
+        }
+    }
+}
+
+uint32_t LoopProfiler::measureSampleCostNs() {
+    static const uint16_t SAMPLES = 256;
+    ProfileHistogram scratch;
+    memset(&scratch, 0, sizeof(scratch));
+    uint32_t start = micros();
+    uint32_t last = start;
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        uint32_t now = micros();
+        add(scratch, now - last);
+        last = now;
+    }
+    return (uint32_t)(((uint32_t)micros() - start) * 1000UL / SAMPLES);
+}
+
+void LoopProfiler::printReport(Print& out, unsigned long nowMs) const {
+    out.printf("Perfil del loop: ventana %lu s, %lu vueltas lentas (>= %u ms), %lu ns por muestra\n",
+               (unsigned long)(getWindowMs(nowMs) / 1000), (unsigned long)slowLoops,
+               (unsigned int)LOOP_PROFILER_SLOW_MS, (unsigned long)measureSampleCostNs());
+    out.printf("%-10s %8s %8s %8s %8s %8s  (us)\n", "canal", "n", "min", "p50", "p99", "max");
+    ProfileSummary summary;
+    for (uint8_t i = 0; i < PROF_CHANNELS; i++) {
+        summarize(i, summary);
+        if (summary.count == 0) continue;
+        out.printf("%-10s %8lu %8lu %8lu %8lu %8lu\n", channelName(i), (unsigned long)summary.count,
+                   (unsigned long)summary.minUs, (unsigned long)summary.p50Us,
+                   (unsigned long)summary.p99Us, (unsigned long)summary.maxUs);
+    }
+}
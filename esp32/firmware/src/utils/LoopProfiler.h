@@ -0,0 +1,121 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+#include "../config/Config.h"
+
+// ============================================================================
+// LoopProfiler - Tiempos del loop principal por módulo
+// ============================================================================
+// Histogramas de microsegundos con cubetas fijas de media octava (1, 2, 3,
+// 4, 6, 8, 12, 16, 24...: error de a lo sumo ~25% en los percentiles), sin
+// heap ni punto flotante. loop() marca startLoop() al entrar, mark(canal)
+// después de cada módulo (el tiempo desde la marca anterior va a ese canal) y
+// endLoop() antes de dormir. Además de los módulos se registran la vuelta
+// completa (trabajo), el período entre vueltas y el retraso al despertar
+// respecto del sueño planificado (jitter del loop). Una marca cuesta una
+// lectura de micros() y unas pocas operaciones enteras.
+//
+// Las cubetas son uint16_t: al saturarse una se dividen a la mitad todas las
+// del canal (los percentiles no cambian). La ventana se reinicia con reset()
+// después de cada reporte publicado.
+
+enum ProfileChannel : uint8_t {
+    PROF_WIFI = 0,
+    PROF_MQTT,
+    PROF_OTA,
+    PROF_RELAY,
+    PROF_SEQUENCER,
+    PROF_TIME,
+    PROF_AGENDA,
+    PROF_DISPLAY,
+    PROF_MAIN,         // mainLoop()
+    PROF_LOG,          // Registro en flash y log remoto
+    PROF_OTHER,        // Botón, estado RTC, consola, reporte
+    PROF_LOOP_BUSY,    // Vuelta completa sin el sueño
+    PROF_LOOP_PERIOD,  // Entre comienzos de vuelta
+    PROF_LOOP_LATE,    // Sueño real menos el planificado
+    PROF_CHANNELS
+};
+
+// Cubetas de media octava: la última junta todo lo que pasa de ~3 s
+#define LOOP_PROFILER_BUCKETS 44
+
+struct ProfileHistogram {
+    uint16_t buckets[LOOP_PROFILER_BUCKETS];
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+};
+
+struct ProfileSummary {
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t p50Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+};
+
+class LoopProfiler {
+private:
+    ProfileHistogram channels[PROF_CHANNELS];
+    uint32_t loopStartUs;
+    uint32_t lastMarkUs;
+    uint32_t loopEndUs;
+    uint32_t plannedSleepUs;
+    bool hasLoop;          // Hubo un endLoop(): período y retraso válidos
+    uint32_t slowLoops;
+    uint32_t loopSlowestUs;
+    uint8_t loopSlowestChannel;
+    unsigned long windowStart;
+
+public:
+    LoopProfiler();
+
+    // Vaciar los histogramas y empezar una ventana nueva en `nowMs`
+    void reset(unsigned long nowMs);
+
+    void startLoop(uint32_t nowUs);
+
+    // Atribuir a `channel` el tiempo desde la marca anterior
+    void mark(uint8_t channel, uint32_t nowUs) {
+        uint32_t elapsed = nowUs - lastMarkUs;
+        lastMarkUs = nowUs;
+        record(channel, elapsed);
+        if (elapsed > loopSlowestUs) {
+            loopSlowestUs = elapsed;
+            loopSlowestChannel = channel;
+        }
+    }
+
+    // Cierra la vuelta; true si tardó LOOP_PROFILER_SLOW_MS o más (el módulo
+    // más lento de esa vuelta queda en getSlowestChannel/getSlowestUs)
+    bool endLoop(uint32_t nowUs, unsigned long plannedSleepMs);
+
+    void record(uint8_t channel, uint32_t us) { add(channels[channel], us); }
+
+    // Resumen de un canal (percentiles desde las cubetas, acotados a min/max)
+    void summarize(uint8_t channel, ProfileSummary& out) const;
+
+    // Tabla legible para la consola serial (comando "perfil")
+    void printReport(Print& out, unsigned long nowMs) const;
+
+    uint32_t getSlowLoops() const { return slowLoops; }
+    uint8_t getSlowestChannel() const { return loopSlowestChannel; }
+    uint32_t getSlowestUs() const { return loopSlowestUs; }
+    unsigned long getWindowMs(unsigned long nowMs) const { return nowMs - windowStart; }
+
+    static const char* channelName(uint8_t channel);
+
+    // Cubeta de un valor y su rango [lower, upper]
+    static uint8_t bucketOf(uint32_t us);
+    static uint32_t bucketLower(uint8_t bucket);
+    static uint32_t bucketUpper(uint8_t bucket);
+
+    static void add(ProfileHistogram& histogram, uint32_t us);
+
+    // Costo medio de micros() + add() en ns (se muestra en el reporte)
+    static uint32_t measureSampleCostNs();
+};
+
+#endif // LOOP_PROFILER_H
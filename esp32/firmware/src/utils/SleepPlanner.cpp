@@ -0,0 +1,43 @@
+#include "SleepPlanner.h"
+
+// ============================================================================
+// Constructor
+// ============================================================================
+SleepPlanner::SleepPlanner(uint32_t minSleep, uint32_t maxSleep) {
+    minSleepMs = minSleep;
+    maxSleepMs = maxSleep < minSleep ? minSleep : maxSleep;
+    begin();
+}
+
+// ============================================================================
+// Registro de plazos
+// ============================================================================
+void SleepPlanner::begin() {
+    earliestMs = maxSleepMs;
+    reason = WAKE_NONE;
+}
+
+void SleepPlanner::addDeadline(WakeReason source, int32_t msFromNow) {
+    if (msFromNow < 0) return;
+    
+    if ((uint32_t)msFromNow < earliestMs) {
+        earliestMs = (uint32_t)msFromNow;
+        reason = source;
+    }
+}
+
+void SleepPlanner::addPeriodic(WakeReason source, uint32_t nowMs, uint32_t lastRunMs, uint32_t periodMs) {
+    uint32_t elapsed = nowMs - lastRunMs;
+    addDeadline(source, elapsed >= periodMs ? 0 : (int32_t)(periodMs - elapsed));
+}
+
+// ============================================================================
+// Resultado
+// ============================================================================
+uint32_t SleepPlanner::sleepMs() const {
+    return earliestMs < minSleepMs ? minSleepMs : earliestMs;
+}
+
+WakeReason SleepPlanner::getReason() const {
+    return reason;
+}
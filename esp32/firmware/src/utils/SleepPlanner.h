@@ -0,0 +1,55 @@
+#ifndef SLEEP_PLANNER_H
+#define SLEEP_PLANNER_H
+
+#include <stdint.h>
+
+// ============================================================================
+// SleepPlanner - Planificación de sueño entre eventos del loop
+// ============================================================================
+// Recibe los plazos de cada módulo (ms hasta su próximo evento) y calcula
+// cuánto puede dormir el loop principal sin atrasar ninguno. No depende de
+// Arduino: la hora la aporta quien llama, lo que permite testearlo en host.
+
+enum WakeReason {
+    WAKE_NONE = 0,     // Sin plazos: se duerme el máximo permitido
+    WAKE_AGENDA,       // Próximo inicio de agenda
+    WAKE_RELAY,        // Vencimiento de timer de zona
+    WAKE_MQTT,         // Keepalive MQTT o próximo paso de la conexión
+    WAKE_DISPLAY,      // Refresco de display
+    WAKE_STATUS,       // Keepalive del estado de zonas
+    WAKE_JOURNAL,      // Próximo lote del diario de eventos
+    WAKE_LOG,          // Próximo mensaje del log remoto
+    WAKE_REASON_COUNT
+};
+
+static const char* const WAKE_REASON_NAMES[] = {
+    "max", "agenda", "rele", "mqtt", "display", "status", "journal", "log"
+};
+
+class SleepPlanner {
+private:
+    uint32_t minSleepMs;
+    uint32_t maxSleepMs;
+    uint32_t earliestMs;
+    WakeReason reason;
+
+public:
+    SleepPlanner(uint32_t minSleepMs, uint32_t maxSleepMs);
+    
+    // Comenzar un nuevo cálculo (llamar una vez por iteración del loop)
+    void begin();
+    
+    // Registrar un plazo en ms desde ahora (negativo = sin plazo pendiente)
+    void addDeadline(WakeReason source, int32_t msFromNow);
+    
+    // Registrar un evento periódico: último disparo y período (wrap-safe de millis)
+    void addPeriodic(WakeReason source, uint32_t nowMs, uint32_t lastRunMs, uint32_t periodMs);
+    
+    // Duración del sueño, acotada a [minSleepMs, maxSleepMs]
+    uint32_t sleepMs() const;
+    
+    // Plazo que determinó la duración (WAKE_NONE si se usó el máximo)
+    WakeReason getReason() const;
+};
+
+#endif // SLEEP_PLANNER_H
@@ -0,0 +1,104 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "utils/AgendaBenchmark.h"
+#include "scheduler/AgendaCompiler.h"
+#include "scheduler/AgendaIndex.h"
+
+// ============================================================================
+// Test AgendaBenchmark - payload válido y métricas coherentes (env:native)
+// ============================================================================
+
+// Print sobre un String para inspeccionar la línea JSON
+class StringPrint : public Print {
+public:
+    String output;
+    
+    size_t write(uint8_t c) override {
+        output += (char)c;
+        return 1;
+    }
+};
+
+void setUp() {
+    NativeShim::setSerialQuiet(true);
+}
+
+void test_payload_is_backend_format() {
+    String payload;
+    TEST_ASSERT_TRUE(AgendaBenchmark::buildPayload(32, payload));
+    
+    DynamicJsonDocument doc(AgendaCompiler::docCapacityFor(payload.length()));
+    TEST_ASSERT_FALSE(deserializeJson(doc, payload));
+    
+    JsonArray agendas = doc["agendas"];
+    TEST_ASSERT_EQUAL(32, agendas.size());
+    for (JsonObject agenda : agendas) {
+        TEST_ASSERT_EQUAL(36, strlen(agenda["id"] | ""));
+        TEST_ASSERT_TRUE(agenda["diasSemana"].size() > 0);
+        TEST_ASSERT_TRUE((agenda["zona"] | 0) >= 1 && (agenda["zona"] | 0) <= MAX_ZONES);
+    }
+}
+
+void test_run_small_payload() {
+    AgendaBenchResult result;
+    TEST_ASSERT_TRUE(AgendaBenchmark::run(8, result));
+    TEST_ASSERT_NULL(result.error);
+    TEST_ASSERT_EQUAL(7, result.compiled);  // 1 de cada 8 inactiva
+    TEST_ASSERT_EQUAL(7, result.active);
+    TEST_ASSERT_FALSE(result.capped);
+    TEST_ASSERT_TRUE(result.firingsPerWeek > 0);
+    TEST_ASSERT_EQUAL(result.firingsPerWeek, result.firedPerWeek);
+    TEST_ASSERT_EQUAL_UINT32(MINUTOS_POR_SEMANA, result.evalTicks);
+    TEST_ASSERT_TRUE(result.docUsed > 0 && result.docUsed <= result.docCapacity);
+}
+
+void test_run_caps_at_max_agendas() {
+    AgendaBenchResult result;
+    TEST_ASSERT_TRUE(AgendaBenchmark::run(128, result));
+    TEST_ASSERT_EQUAL(MAX_AGENDAS, result.compiled);
+    TEST_ASSERT_EQUAL(112, result.active);
+    TEST_ASSERT_TRUE(result.capped);
+    TEST_ASSERT_EQUAL(result.firingsPerWeek, result.firedPerWeek);
+    
+    // La línea dice cuántas se compilaron de verdad
+    StringPrint out;
+    AgendaBenchmark::printResult(out, result);
+    StaticJsonDocument<JSON_OBJECT_SIZE(40) + 512> doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, out.output));
+    TEST_ASSERT_EQUAL(128, doc["agendas"] | 0);
+    TEST_ASSERT_EQUAL(MAX_AGENDAS, doc["compiled"] | 0);
+    TEST_ASSERT_EQUAL(MAX_AGENDAS, doc["maxAgendas"] | 0);
+    TEST_ASSERT_TRUE(doc["capped"] | false);
+}
+
+void test_result_line_is_json() {
+    AgendaBenchResult result;
+    TEST_ASSERT_TRUE(AgendaBenchmark::run(8, result));
+    
+    StringPrint out;
+    AgendaBenchmark::printResult(out, result);
+    TEST_ASSERT_TRUE(out.output.endsWith("\n"));
+    
+    StaticJsonDocument<JSON_OBJECT_SIZE(40) + 512> doc;  // ~33 campos + claves y strings
+    TEST_ASSERT_FALSE(deserializeJson(doc, out.output));
+    TEST_ASSERT_EQUAL_STRING("agenda", doc["bench"] | "");
+    TEST_ASSERT_EQUAL(8, doc["agendas"] | 0);
+    TEST_ASSERT_EQUAL(7, doc["compiled"] | 0);
+    TEST_ASSERT_TRUE(doc.containsKey("parseCycles"));
+    TEST_ASSERT_TRUE(doc.containsKey("evalNsPerTick"));
+    TEST_ASSERT_FALSE(doc["capped"] | true);
+    
+    // Host: heap sin medir, no un número engañoso
+    TEST_ASSERT_FALSE(doc["heapMeasured"] | true);
+    TEST_ASSERT_TRUE(doc["heapFreeMin"].isNull());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_payload_is_backend_format);
+    RUN_TEST(test_run_small_payload);
+    RUN_TEST(test_run_caps_at_max_agendas);
+    RUN_TEST(test_result_line_is_json);
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+#include <unity.h>
+#include "scheduler/AgendaEvaluator.h"
+
+// ============================================================================
+// Test AgendaEvaluator - recuperación de agendas perdidas con reloj simulado
+// ============================================================================
+
+// Lunes 2024-01-01 00:00:00 (epoch local)
+static const uint32_t LUNES = 1704067200UL;
+
+static AgendaTable table;
+static AgendaIndex agendaIndex;
+
+static CatchUpPolicy makePolicy(uint32_t maxLate, uint32_t minRemaining, bool shorten) {
+    CatchUpPolicy policy;
+    policy.maxLateSec = maxLate;
+    policy.minRemainingSec = minRemaining;
+    policy.shortenDuration = shorten;
+    return policy;
+}
+
+static uint32_t at(int dayIndex, int h, int m, int s) {
+    return LUNES + (uint32_t)dayIndex * 86400UL + h * 3600UL + m * 60UL + s;
+}
+
+// Agenda diaria zona 1 a las 06:00 por 20 minutos
+static void setupDailyAgenda() {
+    table.clear();
+    AgendaSlot& slot = table.slots[0];
+    slot.version = 7;
+    slot.minutoDia = 6 * 60;
+    slot.duracionMin = 20;
+    slot.zona = 1;
+    slot.diasMask = AGENDA_DIAS_TODOS;
+    table.count = 1;
+    table.totalAgendas = 1;
+    agendaIndex.build(table);
+}
+
+void setUp() {
+    setupDailyAgenda();
+}
+
+void tearDown() {}
+
+void test_epoch_minute_of_week() {
+    TEST_ASSERT_EQUAL_UINT16(0, epochMinuteOfWeek(LUNES));
+    TEST_ASSERT_EQUAL_UINT16(6 * 60, epochMinuteOfWeek(at(0, 6, 0, 59)));
+    TEST_ASSERT_EQUAL_UINT16(MINUTOS_POR_SEMANA - 1, epochMinuteOfWeek(at(6, 23, 59, 0)));
+}
+
+void test_on_time_fires_full_duration() {
+    AgendaEvaluator evaluator(makePolicy(1800, 60, true));
+    AgendaRun runs[MAX_AGENDAS];
+    uint8_t n = evaluator.evaluate(table, agendaIndex, at(0, 5, 59, 0), at(0, 6, 0, 2), runs, MAX_AGENDAS);
+    TEST_ASSERT_EQUAL_UINT8(1, n);
+    TEST_ASSERT_EQUAL_UINT8(1, runs[0].zona);
+    TEST_ASSERT_EQUAL_UINT32(20 * 60, runs[0].duracionSeg);
+    TEST_ASSERT_EQUAL_UINT32(2, runs[0].lateSec);
+    TEST_ASSERT_EQUAL_UINT32(7, runs[0].version);
+}
+
+void test_same_minute_does_not_refire() {
+    AgendaEvaluator evaluator(makePolicy(1800, 60, true));
+    AgendaRun runs[MAX_AGENDAS];
+    uint8_t n = evaluator.evaluate(table, agendaIndex, at(0, 6, 0, 0), at(0, 6, 0, 40), runs, MAX_AGENDAS);
+    TEST_ASSERT_EQUAL_UINT8(0, n);
+}
+
+void test_reboot_inside_window_shortens() {
+    // Watermark persistido 05:55, reinicio y reloj válido a las 06:05:30
+    AgendaEvaluator evaluator(makePolicy(1800, 60, true));
+    AgendaRun runs[MAX_AGENDAS];
+    uint8_t n = evaluator.evaluate(table, agendaIndex, at(0, 5, 55, 0), at(0, 6, 5, 30), runs, MAX_AGENDAS);
+    TEST_ASSERT_EQUAL_UINT8(1, n);
+    TEST_ASSERT_EQUAL_UINT32(330, runs[0].lateSec);
+    TEST_ASSERT_EQUAL_UINT32(20 * 60 - 330, runs[0].duracionSeg);
+}
+
+void test_reboot_without_shorten_runs_full() {
+    AgendaEvaluator evaluator(makePolicy(1800, 60, false));
+    AgendaRun runs[MAX_AGENDAS];
+    uint8_t n = evaluator.evaluate(table, agendaIndex, at(0, 5, 55, 0), at(0, 6, 5, 30), runs, MAX_AGENDAS);
+    TEST_ASSERT_EQUAL_UINT8(1, n);
+    TEST_ASSERT_EQUAL_UINT32(20 * 60, runs[0].duracionSeg);
+}
+
+void test_beyond_grace_is_skipped() {
+    // Ventana larga (90 min) pero gracia de 10 min
+    table.slots[0].duracionMin = 90;
+    agendaIndex.build(table);
+    AgendaEvaluator evaluator(makePolicy(600, 60, true));
+    AgendaRun runs[MAX_AGENDAS];
+    uint8_t n = evaluator.evaluate(table, agendaIndex, at(0, 5, 0, 0), at(0, 6, 15, 0), runs, MAX_AGENDAS);
+    TEST_ASSERT_EQUAL_UINT8(0, n);
+}
+
+void test_window_closed_is_skipped() {
+    AgendaEvaluator evaluator(makePolicy(1800, 60, true));
+    AgendaRun runs[MAX_AGENDAS];
+    uint8_t n = evaluator.evaluate(table, agendaIndex, at(0, 5, 55, 0), at(0, 6, 25, 0), runs, MAX_AGENDAS);
+    TEST_ASSERT_EQUAL_UINT8(0, n);
+}
+
+void test_min_remaining_is_respected() {
+    // Quedan 40 s de ventana, mínimo 60 s
+    AgendaEvaluator evaluator(makePolicy(1800, 60, true));
+    AgendaRun runs[MAX_AGENDAS];
+    uint8_t n = evaluator.evaluate(table, agendaIndex, at(0, 5, 55, 0), at(0, 6, 19, 20), runs, MAX_AGENDAS);
+    TEST_ASSERT_EQUAL_UINT8(0, n);
+}
+
+void test_skipped_poll_minute_still_fires() {
+    // El loop estuvo bloqueado y la última verificación fue 05:59; ahora 06:01:10
+    AgendaEvaluator evaluator(makePolicy(1800, 60, true));
+    AgendaRun runs[MAX_AGENDAS];
+    uint8_t n = evaluator.evaluate(table, agendaIndex, at(0, 5, 59, 0), at(0, 6, 1, 10), runs, MAX_AGENDAS);
+    TEST_ASSERT_EQUAL_UINT8(1, n);
+    TEST_ASSERT_EQUAL_UINT32(70, runs[0].lateSec);
+    TEST_ASSERT_EQUAL_UINT32(20 * 60 - 70, runs[0].duracionSeg);
+}
+
+void test_watermark_ahead_evaluates_current_minute_only() {
+    // Reloj corrigió hacia atrás: watermark en el futuro
+    AgendaEvaluator evaluator(makePolicy(1800, 60, true));
+    AgendaRun runs[MAX_AGENDAS];
+    uint8_t n = evaluator.evaluate(table, agendaIndex, at(0, 7, 0, 0), at(0, 6, 0, 5), runs, MAX_AGENDAS);
+    TEST_ASSERT_EQUAL_UINT8(1, n);
+    TEST_ASSERT_EQUAL_UINT32(5, runs[0].lateSec);
+    n = evaluator.evaluate(table, agendaIndex, at(0, 7, 0, 0), at(0, 6, 3, 0), runs, MAX_AGENDAS);
+    TEST_ASSERT_EQUAL_UINT8(0, n);
+}
+
+void test_simulated_day_fires_once() {
+    // Poll cada 10 s durante un día completo con un apagón de 03:00 a 06:04
+    AgendaEvaluator evaluator(makePolicy(1800, 60, true));
+    AgendaRun runs[MAX_AGENDAS];
+    uint32_t watermark = 0;
+    uint32_t persisted = 0;
+    int fired = 0;
+    uint32_t lastDuration = 0;
+    
+    for (uint32_t now = at(1, 0, 0, 0); now < at(2, 0, 0, 0); now += 10) {
+        if (now >= at(1, 3, 0, 0) && now < at(1, 6, 4, 0)) {
+            watermark = persisted;  // Reinicio: solo sobrevive lo persistido
+            continue;
+        }
+        if (minuteStart(now) == watermark) continue;
+        
+        uint8_t n = evaluator.evaluate(table, agendaIndex, watermark, now, runs, MAX_AGENDAS);
+        watermark = minuteStart(now);
+        if (n > 0 || watermark - persisted >= 600) persisted = watermark;
+        fired += n;
+        if (n > 0) lastDuration = runs[0].duracionSeg;
+    }
+    
+    TEST_ASSERT_EQUAL_INT(1, fired);
+    TEST_ASSERT_EQUAL_UINT32(20 * 60 - 4 * 60, lastDuration);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_epoch_minute_of_week);
+    RUN_TEST(test_on_time_fires_full_duration);
+    RUN_TEST(test_same_minute_does_not_refire);
+    RUN_TEST(test_reboot_inside_window_shortens);
+    RUN_TEST(test_reboot_without_shorten_runs_full);
+    RUN_TEST(test_beyond_grace_is_skipped);
+    RUN_TEST(test_window_closed_is_skipped);
+    RUN_TEST(test_min_remaining_is_respected);
+    RUN_TEST(test_skipped_poll_minute_still_fires);
+    RUN_TEST(test_watermark_ahead_evaluates_current_minute_only);
+    RUN_TEST(test_simulated_day_fires_once);
+    return UNITY_END();
+}
@@ -0,0 +1,230 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "scheduler/AgendaDelta.h"
+#include "scheduler/AgendaCompiler.h"
+
+// ============================================================================
+// Test sync delta - combinar agenda vigente + delta en un archivo nuevo
+// ============================================================================
+
+static const char* CURRENT_FILE = "/agenda_test.json";
+static const char* DELTA_FILE = "/delta_test.tmp";
+static const char* OUT_FILE = "/agenda_test.new";
+
+// Agenda vigente (versión 5): zonas 1, 2 y 3
+static const char* CURRENT_JSON =
+    "{\"version\":5,\"agendas\":["
+    "{\"id\":\"a1\",\"zona\":1,\"diasSemana\":[\"LUN\"],\"horaInicio\":\"06:00\",\"duracionMin\":10,\"activa\":true},"
+    "{\"id\":\"a2\",\"zona\":2,\"diasSemana\":[\"MAR\"],\"horaInicio\":\"07:00\",\"duracionMin\":10,\"activa\":true},"
+    "{\"id\":\"a3\",\"zona\":3,\"diasSemana\":[\"MIE\"],\"horaInicio\":\"08:00\",\"duracionMin\":10,\"activa\":true}"
+    "]}";
+
+void setUp() {
+    NativeShim::setSerialQuiet(true);
+    NativeShim::setFsRoot("native_fs_test_delta");
+    LittleFS.format();
+}
+
+static void writeAll(const char* path, const char* content) {
+    File file = LittleFS.open(path, "w");
+    file.print(content);
+    file.close();
+}
+
+static AgendaDeltaResult mergeFiles(int32_t localVersion, AgendaDeltaInfo& info) {
+    File current = LittleFS.open(CURRENT_FILE, "r");
+    File delta = LittleFS.open(DELTA_FILE, "r");
+    File out = LittleFS.open(OUT_FILE, "w");
+    DeserializationError error;
+    AgendaDeltaResult result = AgendaDelta::merge(current, delta, localVersion, out, info, error);
+    out.close();
+    delta.close();
+    if (current) current.close();
+    return result;
+}
+
+static void compileOut(AgendaTable& table) {
+    DeserializationError error;
+    File file = LittleFS.open(OUT_FILE, "r");
+    TEST_ASSERT_EQUAL_INT(AGENDA_COMPILE_OK, AgendaCompiler::compileFile(file, table, error));
+    file.close();
+}
+
+static int findZona(const AgendaTable& table, uint8_t zona) {
+    for (uint8_t i = 0; i < table.count; i++) {
+        if (table.slots[i].zona == zona) return i;
+    }
+    return -1;
+}
+
+void test_full_snapshot_is_not_delta() {
+    writeAll(CURRENT_FILE, CURRENT_JSON);
+    writeAll(DELTA_FILE, "{\"tipo\":\"completa\",\"version\":6,\"agendas\":[]}");
+    AgendaDeltaInfo info;
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_NOT_DELTA, mergeFiles(5, info));
+    
+    // Payload sin "tipo" (formato anterior): también es lista completa
+    writeAll(DELTA_FILE, "{\"version\":6,\"agendas\":[]}");
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_NOT_DELTA, mergeFiles(5, info));
+}
+
+void test_delta_applies_upsert_and_removal() {
+    writeAll(CURRENT_FILE, CURRENT_JSON);
+    // a2 cambia de hora, a3 se elimina, a4 es nueva
+    writeAll(DELTA_FILE,
+        "{\"tipo\":\"delta\",\"baseVersion\":5,\"version\":7,\"agendas\":["
+        "{\"id\":\"a2\",\"zona\":2,\"diasSemana\":[\"MAR\"],\"horaInicio\":\"09:30\",\"duracionMin\":20,\"activa\":true},"
+        "{\"id\":\"a4\",\"zona\":4,\"diasSemana\":[\"JUE\"],\"horaInicio\":\"10:00\",\"duracionMin\":5,\"activa\":true}"
+        "],\"eliminadas\":[\"a3\"]}");
+    
+    AgendaDeltaInfo info;
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_OK, mergeFiles(5, info));
+    TEST_ASSERT_EQUAL_UINT8(2, info.upserts);
+    TEST_ASSERT_EQUAL_UINT8(1, info.removed);
+    TEST_ASSERT_EQUAL_UINT8(1, info.kept);
+    
+    AgendaTable table;
+    compileOut(table);
+    TEST_ASSERT_EQUAL_INT32(7, table.version);
+    TEST_ASSERT_EQUAL_UINT8(3, table.count);
+    TEST_ASSERT_TRUE(findZona(table, 1) >= 0);
+    TEST_ASSERT_EQUAL_INT(-1, findZona(table, 3));
+    
+    int z2 = findZona(table, 2);
+    TEST_ASSERT_TRUE(z2 >= 0);
+    TEST_ASSERT_EQUAL_UINT16(9 * 60 + 30, table.slots[z2].minutoDia);
+    TEST_ASSERT_EQUAL_UINT16(20, table.slots[z2].duracionMin);
+    TEST_ASSERT_TRUE(findZona(table, 4) >= 0);
+}
+
+void test_version_gap_requests_resync() {
+    writeAll(CURRENT_FILE, CURRENT_JSON);
+    writeAll(DELTA_FILE, "{\"tipo\":\"delta\",\"baseVersion\":6,\"version\":7,\"agendas\":[],\"eliminadas\":[\"a1\"]}");
+    AgendaDeltaInfo info;
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_VERSION_GAP, mergeFiles(5, info));
+}
+
+void test_delta_already_applied_is_up_to_date() {
+    writeAll(CURRENT_FILE, CURRENT_JSON);
+    writeAll(DELTA_FILE, "{\"tipo\":\"delta\",\"baseVersion\":4,\"version\":5,\"agendas\":[],\"eliminadas\":[]}");
+    AgendaDeltaInfo info;
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_UP_TO_DATE, mergeFiles(5, info));
+}
+
+void test_remove_all_leaves_empty_agenda() {
+    writeAll(CURRENT_FILE, CURRENT_JSON);
+    writeAll(DELTA_FILE, "{\"tipo\":\"delta\",\"baseVersion\":5,\"version\":6,\"agendas\":[],\"eliminadas\":[\"a1\",\"a2\",\"a3\"]}");
+    AgendaDeltaInfo info;
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_OK, mergeFiles(5, info));
+    
+    AgendaTable table;
+    compileOut(table);
+    TEST_ASSERT_EQUAL_INT32(6, table.version);
+    TEST_ASSERT_EQUAL_UINT8(0, table.count);
+    TEST_ASSERT_EQUAL_UINT8(0, table.totalAgendas);
+}
+
+void test_without_current_file_only_upserts() {
+    writeAll(DELTA_FILE,
+        "{\"tipo\":\"delta\",\"baseVersion\":0,\"version\":1,\"agendas\":["
+        "{\"id\":\"b1\",\"zona\":5,\"diasSemana\":[\"VIE\"],\"horaInicio\":\"05:00\",\"duracionMin\":15,\"activa\":true}"
+        "]}");
+    AgendaDeltaInfo info;
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_OK, mergeFiles(0, info));
+    
+    AgendaTable table;
+    compileOut(table);
+    TEST_ASSERT_EQUAL_UINT8(1, table.count);
+    TEST_ASSERT_EQUAL_UINT8(5, table.slots[0].zona);
+}
+
+void test_too_many_ids_requests_snapshot() {
+    writeAll(CURRENT_FILE, CURRENT_JSON);
+    String delta = "{\"tipo\":\"delta\",\"baseVersion\":5,\"version\":6,\"agendas\":[],\"eliminadas\":[";
+    for (int i = 0; i <= AGENDA_DELTA_MAX_IDS; i++) {
+        if (i > 0) delta += ",";
+        delta += "\"x" + String(i) + "\"";
+    }
+    delta += "]}";
+    writeAll(DELTA_FILE, delta.c_str());
+    
+    AgendaDeltaInfo info;
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_TOO_LARGE, mergeFiles(5, info));
+}
+
+// Agendas como las manda el backend (AgendaResponse): los campos que no se
+// compilan no se copian y no agotan el documento de cada agenda
+void test_backend_fields_are_filtered_out() {
+    writeAll(CURRENT_FILE,
+        "{\"version\":5,\"agendas\":[{\"id\":\"3f2504e0-4f89-41d3-9a0c-0305e82c3301\","
+        "\"nodeId\":\"9b1deb4d-3b7d-4bad-9bdd-2b0d7b3dcb6d\",\"nombre\":\"Cantero grande junto al porton\","
+        "\"zona\":1,\"diasSemana\":[\"LUN\",\"MAR\",\"MIE\",\"JUE\",\"VIE\",\"SAB\",\"DOM\"],"
+        "\"horaInicio\":\"06:00:00\",\"duracionMin\":10,\"activa\":true,\"version\":4,"
+        "\"updatedAt\":\"2026-01-05T10:15:30.123456-03:00\"}]}");
+    writeAll(DELTA_FILE,
+        "{\"tipo\":\"delta\",\"baseVersion\":5,\"version\":6,\"agendas\":[{\"id\":\"6ba7b810-9dad-11d1-80b4-00c04fd430c8\","
+        "\"nodeId\":\"9b1deb4d-3b7d-4bad-9bdd-2b0d7b3dcb6d\",\"nombre\":\"Huerta\",\"zona\":2,"
+        "\"diasSemana\":[\"LUN\",\"MIE\",\"VIE\"],\"horaInicio\":\"07:30:00\",\"duracionMin\":15,\"activa\":true,"
+        "\"version\":6,\"updatedAt\":\"2026-01-06T08:00:00Z\"}],\"eliminadas\":[]}");
+    
+    AgendaDeltaInfo info;
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_OK, mergeFiles(5, info));
+    TEST_ASSERT_EQUAL_UINT8(1, info.kept);
+    TEST_ASSERT_EQUAL_UINT8(1, info.upserts);
+    
+    File out = LittleFS.open(OUT_FILE, "r");
+    String merged = out.readString();
+    out.close();
+    TEST_ASSERT_EQUAL(-1, merged.indexOf("nombre"));
+    TEST_ASSERT_EQUAL(-1, merged.indexOf("updatedAt"));
+    
+    AgendaTable table;
+    compileOut(table);
+    TEST_ASSERT_EQUAL_UINT8(2, table.count);
+    TEST_ASSERT_EQUAL_UINT8(0x7F, table.slots[findZona(table, 1)].diasMask);
+    TEST_ASSERT_EQUAL_UINT32(4, table.slots[findZona(table, 1)].version);
+}
+
+// "a1039599" y "a1222382" tienen el mismo FNV-1a: eliminar uno no borra el otro
+void test_hash_collision_keeps_untouched_agenda() {
+    TEST_ASSERT_EQUAL_UINT32(AgendaDelta::hashId("a1039599"), AgendaDelta::hashId("a1222382"));
+    writeAll(CURRENT_FILE,
+        "{\"version\":5,\"agendas\":["
+        "{\"id\":\"a1039599\",\"zona\":1,\"diasSemana\":[\"LUN\"],\"horaInicio\":\"06:00\",\"duracionMin\":10,\"activa\":true},"
+        "{\"id\":\"a1222382\",\"zona\":2,\"diasSemana\":[\"MAR\"],\"horaInicio\":\"07:00\",\"duracionMin\":10,\"activa\":true}"
+        "]}");
+    writeAll(DELTA_FILE, "{\"tipo\":\"delta\",\"baseVersion\":5,\"version\":6,\"agendas\":[],\"eliminadas\":[\"a1222382\"]}");
+    
+    AgendaDeltaInfo info;
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_OK, mergeFiles(5, info));
+    TEST_ASSERT_EQUAL_UINT8(1, info.kept);
+    
+    AgendaTable table;
+    compileOut(table);
+    TEST_ASSERT_EQUAL_UINT8(1, table.count);
+    TEST_ASSERT_EQUAL_UINT8(1, table.slots[0].zona);
+}
+
+void test_invalid_delta_is_parse_error() {
+    writeAll(CURRENT_FILE, CURRENT_JSON);
+    writeAll(DELTA_FILE, "{\"tipo\":\"delta\",\"baseVersion\":5,\"version\":6,\"agendas\":[{\"id\":");
+    AgendaDeltaInfo info;
+    TEST_ASSERT_EQUAL_INT(AGENDA_DELTA_PARSE_ERROR, mergeFiles(5, info));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_snapshot_is_not_delta);
+    RUN_TEST(test_delta_applies_upsert_and_removal);
+    RUN_TEST(test_version_gap_requests_resync);
+    RUN_TEST(test_delta_already_applied_is_up_to_date);
+    RUN_TEST(test_remove_all_leaves_empty_agenda);
+    RUN_TEST(test_without_current_file_only_upserts);
+    RUN_TEST(test_too_many_ids_requests_snapshot);
+    RUN_TEST(test_backend_fields_are_filtered_out);
+    RUN_TEST(test_hash_collision_keeps_untouched_agenda);
+    RUN_TEST(test_invalid_delta_is_parse_error);
+    return UNITY_END();
+}
@@ -0,0 +1,134 @@
+#include <unity.h>
+#include <string.h>
+#include "scheduler/AgendaImage.h"
+#include "utils/Crc32.h"
+
+// ============================================================================
+// Test AgendaImage - imagen binaria de la tabla compilada (/agenda.bin)
+// ============================================================================
+// Ida y vuelta tabla -> imagen -> tabla y rechazo de imágenes truncadas,
+// corruptas o de otro formato (el firmware recompila el JSON en esos casos).
+
+static AgendaImageBuffer buffer;
+
+static void fillTable(AgendaTable& table, uint8_t count) {
+    table.clear();
+    for (uint8_t i = 0; i < count; i++) {
+        AgendaSlot& slot = table.slots[i];
+        slot.version = 1000u + i;
+        slot.minutoDia = (uint16_t)((i * 97) % 1440);
+        slot.duracionMin = (uint16_t)(5 + i);
+        slot.zona = (uint8_t)(1 + i % MAX_ZONES);
+        slot.diasMask = (uint8_t)(1 + i % AGENDA_DIAS_TODOS);
+    }
+    table.count = count;
+    table.totalAgendas = count + 2;
+    table.version = 42;
+}
+
+static void assertSameTable(const AgendaTable& expected, const AgendaTable& actual) {
+    TEST_ASSERT_EQUAL_UINT8(expected.count, actual.count);
+    TEST_ASSERT_EQUAL_UINT8(expected.totalAgendas, actual.totalAgendas);
+    TEST_ASSERT_EQUAL_INT32(expected.version, actual.version);
+    for (uint8_t i = 0; i < expected.count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(expected.slots[i].version, actual.slots[i].version);
+        TEST_ASSERT_EQUAL_UINT16(expected.slots[i].minutoDia, actual.slots[i].minutoDia);
+        TEST_ASSERT_EQUAL_UINT16(expected.slots[i].duracionMin, actual.slots[i].duracionMin);
+        TEST_ASSERT_EQUAL_UINT8(expected.slots[i].zona, actual.slots[i].zona);
+        TEST_ASSERT_EQUAL_UINT8(expected.slots[i].diasMask, actual.slots[i].diasMask);
+    }
+}
+
+void test_crc32_check_value() {
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, Crc32::compute("123456789", 9));
+    
+    // update() por partes da lo mismo que de una vez
+    uint32_t crc = Crc32::update(0, "1234", 4);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, Crc32::update(crc, "56789", 5));
+}
+
+void test_roundtrip_sizes() {
+    const uint8_t sizes[] = {0, 1, 8, MAX_AGENDAS};
+    for (uint8_t s = 0; s < sizeof(sizes); s++) {
+        AgendaTable original;
+        fillTable(original, sizes[s]);
+        
+        size_t length = AgendaImage::encode(original, 1234, buffer);
+        TEST_ASSERT_EQUAL_UINT32(sizeof(AgendaImageHeader) + sizes[s] * sizeof(AgendaImageRecord), length);
+        
+        AgendaTable loaded;
+        TEST_ASSERT_EQUAL_INT(AGENDA_IMAGE_OK, AgendaImage::decode(buffer, length, loaded));
+        TEST_ASSERT_EQUAL_UINT32(1234, buffer.header.sourceBytes);
+        assertSameTable(original, loaded);
+    }
+}
+
+void test_rejects_truncated() {
+    AgendaTable original;
+    fillTable(original, 8);
+    size_t length = AgendaImage::encode(original, 0, buffer);
+    
+    AgendaTable loaded;
+    TEST_ASSERT_EQUAL_INT(AGENDA_IMAGE_TRUNCATED, AgendaImage::decode(buffer, 0, loaded));
+    TEST_ASSERT_EQUAL_INT(AGENDA_IMAGE_TRUNCATED, AgendaImage::decode(buffer, sizeof(AgendaImageHeader) - 1, loaded));
+    TEST_ASSERT_EQUAL_INT(AGENDA_IMAGE_TRUNCATED, AgendaImage::decode(buffer, length - 1, loaded));
+    TEST_ASSERT_EQUAL_INT(AGENDA_IMAGE_TRUNCATED, AgendaImage::decode(buffer, length + 1, loaded));
+    TEST_ASSERT_EQUAL_UINT8(0, loaded.count);
+}
+
+void test_rejects_corruption() {
+    AgendaTable original;
+    fillTable(original, 8);
+    size_t length = AgendaImage::encode(original, 0, buffer);
+    
+    // Un bit cambiado en cualquier byte de la imagen se detecta
+    uint8_t* bytes = (uint8_t*)&buffer;
+    for (size_t i = 0; i < length; i++) {
+        bytes[i] ^= 0x10;
+        AgendaTable loaded;
+        AgendaImageResult result = AgendaImage::decode(buffer, length, loaded);
+        TEST_ASSERT_NOT_EQUAL(AGENDA_IMAGE_OK, result);
+        TEST_ASSERT_EQUAL_UINT8(0, loaded.count);
+        bytes[i] ^= 0x10;
+    }
+    
+    AgendaTable loaded;
+    TEST_ASSERT_EQUAL_INT(AGENDA_IMAGE_OK, AgendaImage::decode(buffer, length, loaded));
+}
+
+void test_rejects_other_format() {
+    AgendaTable original;
+    fillTable(original, 4);
+    size_t length = AgendaImage::encode(original, 0, buffer);
+    AgendaTable loaded;
+    
+    buffer.header.magic = 0;
+    TEST_ASSERT_EQUAL_INT(AGENDA_IMAGE_BAD_MAGIC, AgendaImage::decode(buffer, length, loaded));
+    
+    AgendaImage::encode(original, 0, buffer);
+    buffer.header.format = AGENDA_IMAGE_FORMAT + 1;
+    TEST_ASSERT_EQUAL_INT(AGENDA_IMAGE_BAD_FORMAT, AgendaImage::decode(buffer, length, loaded));
+}
+
+void test_rejects_out_of_range_record() {
+    // Registro inválido con CRC correcto (p.ej. imagen escrita por otro firmware)
+    AgendaTable original;
+    fillTable(original, 4);
+    original.slots[2].zona = MAX_ZONES + 1;
+    size_t length = AgendaImage::encode(original, 0, buffer);
+    
+    AgendaTable loaded;
+    TEST_ASSERT_EQUAL_INT(AGENDA_IMAGE_BAD_RECORD, AgendaImage::decode(buffer, length, loaded));
+    TEST_ASSERT_EQUAL_UINT8(0, loaded.count);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_roundtrip_sizes);
+    RUN_TEST(test_rejects_truncated);
+    RUN_TEST(test_rejects_corruption);
+    RUN_TEST(test_rejects_other_format);
+    RUN_TEST(test_rejects_out_of_range_record);
+    return UNITY_END();
+}
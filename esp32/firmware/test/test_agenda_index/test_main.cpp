@@ -0,0 +1,172 @@
+#include <unity.h>
+#include "scheduler/AgendaIndex.h"
+
+// ============================================================================
+// Test AgendaIndex - compara el índice contra la lógica original de Agenda
+// ============================================================================
+// Recorre los 10080 minutos de la semana y verifica que el índice dispare
+// exactamente las mismas agendas que Agenda::shouldRunOnDay/shouldRunAtTime.
+
+// Réplica de la semántica de Agenda.h (sin String/Arduino)
+struct LegacyAgenda {
+    int zona;
+    int hour;
+    int minute;
+    int duracionMin;
+    bool diasSemana[7];
+    bool activa;
+
+    bool shouldRunOnDay(int wday) {
+        int dayIndex = (wday == 0) ? 6 : wday - 1;
+        return diasSemana[dayIndex];
+    }
+
+    bool shouldRunAtTime(int h, int m) {
+        return (hour == h && minute == m);
+    }
+};
+
+static uint32_t rngState = 12345;
+
+static uint32_t nextRandom() {
+    rngState = rngState * 1103515245u + 12345u;
+    return (rngState >> 16) & 0x7FFF;
+}
+
+static void buildTable(LegacyAgenda* legacy, int n, AgendaTable& table, uint8_t* legacyToSlot) {
+    table.clear();
+    for (int i = 0; i < n; i++) {
+        legacyToSlot[i] = 0xFF;
+        if (!legacy[i].activa) continue;
+
+        uint8_t mask = 0;
+        for (int d = 0; d < 7; d++) {
+            if (legacy[i].diasSemana[d]) mask |= (1 << d);
+        }
+        if (mask == 0) continue;
+
+        AgendaSlot& slot = table.slots[table.count];
+        slot.zona = (uint8_t)legacy[i].zona;
+        slot.diasMask = mask;
+        slot.minutoDia = (uint16_t)(legacy[i].hour * 60 + legacy[i].minute);
+        slot.duracionMin = (uint16_t)legacy[i].duracionMin;
+        slot.version = 1;
+        legacyToSlot[i] = table.count;
+        table.count++;
+    }
+}
+
+static void randomAgendas(LegacyAgenda* legacy, int n) {
+    for (int i = 0; i < n; i++) {
+        legacy[i].zona = 1 + nextRandom() % MAX_ZONES;
+        // Concentrar horarios para forzar colisiones en el mismo minuto
+        legacy[i].hour = (nextRandom() % 4 == 0) ? 6 : nextRandom() % 24;
+        legacy[i].minute = (nextRandom() % 3 == 0) ? 0 : nextRandom() % 60;
+        legacy[i].duracionMin = 1 + nextRandom() % 30;
+        legacy[i].activa = nextRandom() % 5 != 0;
+        for (int d = 0; d < 7; d++) {
+            legacy[i].diasSemana[d] = nextRandom() % 2 == 0;
+        }
+    }
+}
+
+static void assertMatchesLegacy(LegacyAgenda* legacy, int n) {
+    static AgendaTable table;
+    static AgendaIndex index;
+    uint8_t legacyToSlot[MAX_AGENDAS];
+
+    buildTable(legacy, n, table, legacyToSlot);
+    index.build(table);
+
+    // Brute force: primer minuto con disparo (para validar minutesUntilNext)
+    int32_t expectedNext[MINUTOS_POR_SEMANA];
+    bool fires[MINUTOS_POR_SEMANA];
+
+    for (int wday = 0; wday < 7; wday++) {
+        for (int h = 0; h < 24; h++) {
+            for (int m = 0; m < 60; m++) {
+                uint16_t mow = agendaMinuteOfWeek(wday, h, m);
+                uint8_t slots[MAX_AGENDAS];
+                uint8_t found = index.firingAt(mow, slots, MAX_AGENDAS);
+
+                uint8_t expected = 0;
+                for (int i = 0; i < n; i++) {
+                    if (!legacy[i].activa) continue;
+                    if (!legacy[i].shouldRunOnDay(wday) || !legacy[i].shouldRunAtTime(h, m)) continue;
+
+                    expected++;
+                    bool present = false;
+                    for (uint8_t k = 0; k < found; k++) {
+                        if (slots[k] == legacyToSlot[i]) present = true;
+                    }
+                    TEST_ASSERT_TRUE_MESSAGE(present, "agenda legacy no disparada por el indice");
+                }
+                TEST_ASSERT_EQUAL_UINT8(expected, found);
+                fires[mow] = expected > 0;
+            }
+        }
+    }
+
+    // Próximo disparo esperado, recorriendo la semana hacia atrás dos veces
+    int32_t next = -1;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int mow = MINUTOS_POR_SEMANA - 1; mow >= 0; mow--) {
+            if (fires[mow]) {
+                next = 0;
+            } else if (next >= 0) {
+                next++;
+            }
+            expectedNext[mow] = next;
+        }
+    }
+
+    for (int mow = 0; mow < MINUTOS_POR_SEMANA; mow++) {
+        TEST_ASSERT_EQUAL_INT32(expectedNext[mow], index.minutesUntilNext((uint16_t)mow));
+    }
+}
+
+void test_empty_index() {
+    AgendaTable table;
+    AgendaIndex index;
+    index.build(table);
+    uint8_t slots[4];
+    TEST_ASSERT_EQUAL_UINT16(0, index.size());
+    TEST_ASSERT_EQUAL_UINT8(0, index.firingAt(0, slots, 4));
+    TEST_ASSERT_EQUAL_INT32(-1, index.minutesUntilNext(500));
+}
+
+void test_week_wraparound() {
+    AgendaTable table;
+    table.slots[0].zona = 1;
+    table.slots[0].diasMask = 0x01;  // Solo lunes
+    table.slots[0].minutoDia = 6 * 60;
+    table.slots[0].duracionMin = 10;
+    table.slots[0].version = 1;
+    table.count = 1;
+
+    AgendaIndex index;
+    index.build(table);
+
+    // Domingo 23:59 -> lunes 06:00
+    TEST_ASSERT_EQUAL_INT32(361, index.minutesUntilNext(agendaMinuteOfWeek(0, 23, 59)));
+    TEST_ASSERT_EQUAL_INT32(0, index.minutesUntilNext(agendaMinuteOfWeek(1, 6, 0)));
+    TEST_ASSERT_EQUAL_INT32(MINUTOS_POR_SEMANA - 1, index.minutesUntilNext(agendaMinuteOfWeek(1, 6, 1)));
+}
+
+void test_brute_force_random_tables() {
+    static LegacyAgenda legacy[MAX_AGENDAS];
+    const int sizes[] = {1, 8, 17, MAX_AGENDAS};
+
+    for (int round = 0; round < 4; round++) {
+        randomAgendas(legacy, sizes[round]);
+        assertMatchesLegacy(legacy, sizes[round]);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_index);
+    RUN_TEST(test_week_wraparound);
+    RUN_TEST(test_brute_force_random_tables);
+    return UNITY_END();
+}
@@ -0,0 +1,241 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "network/MqttPayloadSpool.h"
+#include "scheduler/AgendaCompiler.h"
+#include "utils/AgendaBenchmark.h"
+
+// ============================================================================
+// Test sync en streaming - spool MQTT a flash y compilación desde archivo
+// ============================================================================
+
+static const char* SPOOL_FILE = "/spool_test.tmp";
+static const char* AGENDA_TEST_FILE = "/agenda_test.json";
+
+void setUp() {
+    NativeShim::setSerialQuiet(true);
+    NativeShim::setFsRoot("native_fs_test_stream");
+    LittleFS.format();
+}
+
+static String readAll(const char* path) {
+    File file = LittleFS.open(path, "r");
+    String content = file.readString();
+    file.close();
+    return content;
+}
+
+static void writeAll(const char* path, const String& content) {
+    File file = LittleFS.open(path, "w");
+    file.print(content);
+    file.close();
+}
+
+static AgendaCompileResult compilePath(const char* path, AgendaTable& table) {
+    DeserializationError error;
+    File file = LittleFS.open(path, "r");
+    AgendaCompileResult result = AgendaCompiler::compileFile(file, table, error);
+    file.close();
+    return result;
+}
+
+// ---------- MqttPayloadSpool ----------
+
+void test_spool_small_message_does_not_touch_flash() {
+    MqttPayloadSpool spool(SPOOL_FILE, 4096);
+    spool.reset();
+    spool.write((const uint8_t*)"{\"accion\":\"ON\"}", 15);
+    TEST_ASSERT_EQUAL(15, spool.length());
+    spool.discard();
+    TEST_ASSERT_FALSE(LittleFS.exists(SPOOL_FILE));
+}
+
+void test_spool_large_message_written_in_chunks() {
+    MqttPayloadSpool spool(SPOOL_FILE, 4096);
+    String expected;
+    spool.reset();
+    for (int i = 0; i < 1000; i++) {
+        char c = (char)('a' + (i % 26));
+        spool.write((uint8_t)c);
+        expected += c;
+    }
+    TEST_ASSERT_TRUE(spool.commit());
+    TEST_ASSERT_EQUAL(1000, spool.length());
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), readAll(SPOOL_FILE).c_str());
+}
+
+void test_spool_overflow_is_rejected() {
+    MqttPayloadSpool spool(SPOOL_FILE, 300);
+    spool.reset();
+    for (int i = 0; i < 1000; i++) spool.write((uint8_t)'x');
+    TEST_ASSERT_TRUE(spool.isOverflow());
+    TEST_ASSERT_FALSE(spool.commit());
+    TEST_ASSERT_FALSE(LittleFS.exists(SPOOL_FILE));
+}
+
+void test_spool_reset_starts_new_message() {
+    MqttPayloadSpool spool(SPOOL_FILE, 4096);
+    spool.reset();
+    for (int i = 0; i < 600; i++) spool.write((uint8_t)'x');
+    spool.reset();
+    spool.write((const uint8_t*)"{}", 2);
+    TEST_ASSERT_TRUE(spool.commit());
+    TEST_ASSERT_EQUAL_STRING("{}", readAll(SPOOL_FILE).c_str());
+}
+
+// ---------- AgendaCompiler::compileFile ----------
+
+void test_stream_compile_matches_document_compile() {
+    String payload;
+    TEST_ASSERT_TRUE(AgendaBenchmark::buildPayload(40, payload));
+    writeAll(AGENDA_TEST_FILE, payload);
+    
+    AgendaTable streamed;
+    TEST_ASSERT_EQUAL(AGENDA_COMPILE_OK, compilePath(AGENDA_TEST_FILE, streamed));
+    
+    DynamicJsonDocument doc(AgendaCompiler::docCapacityFor(payload.length()));
+    TEST_ASSERT_FALSE(deserializeJson(doc, payload));
+    AgendaTable parsed;
+    TEST_ASSERT_TRUE(AgendaCompiler::compile(doc, parsed));
+    
+    TEST_ASSERT_EQUAL(parsed.count, streamed.count);
+    TEST_ASSERT_EQUAL(parsed.totalAgendas, streamed.totalAgendas);
+    TEST_ASSERT_EQUAL(42, streamed.version);
+    for (uint8_t i = 0; i < parsed.count; i++) {
+        TEST_ASSERT_EQUAL(parsed.slots[i].zona, streamed.slots[i].zona);
+        TEST_ASSERT_EQUAL(parsed.slots[i].diasMask, streamed.slots[i].diasMask);
+        TEST_ASSERT_EQUAL(parsed.slots[i].minutoDia, streamed.slots[i].minutoDia);
+        TEST_ASSERT_EQUAL(parsed.slots[i].duracionMin, streamed.slots[i].duracionMin);
+        TEST_ASSERT_EQUAL_UINT32(parsed.slots[i].version, streamed.slots[i].version);
+    }
+}
+
+void test_stream_compile_version_after_agendas_and_whitespace() {
+    writeAll(AGENDA_TEST_FILE,
+             "{\n  \"agendas\" : [\n"
+             "    { \"id\": \"a\", \"zona\": 2, \"diasSemana\": [\"LUN\", \"MIE\"],\n"
+             "      \"horaInicio\": \"06:30\", \"duracionMin\": 15, \"activa\": true, \"extra\": {\"x\": [1, 2]} } ,\n"
+             "    { \"id\": \"b\", \"zona\": 3, \"diasSemana\": [\"DOM\"], \"horaInicio\": \"21:00\",\n"
+             "      \"duracionMin\": 5, \"activa\": true, \"version\": 9 }\n"
+             "  ],\n  \"version\": 7\n}\n");
+    
+    AgendaTable table;
+    TEST_ASSERT_EQUAL(AGENDA_COMPILE_OK, compilePath(AGENDA_TEST_FILE, table));
+    TEST_ASSERT_EQUAL(2, table.count);
+    TEST_ASSERT_EQUAL(7, table.version);
+    TEST_ASSERT_EQUAL(2, table.slots[0].zona);
+    TEST_ASSERT_EQUAL(390, table.slots[0].minutoDia);
+    TEST_ASSERT_EQUAL(0x05, table.slots[0].diasMask);
+    TEST_ASSERT_EQUAL_UINT32(7, table.slots[0].version);
+    TEST_ASSERT_EQUAL_UINT32(9, table.slots[1].version);
+}
+
+// Agenda como la serializa el backend (AgendaResponse): campos extra que el
+// filtro descarta, id UUID, los 7 días y hora con segundos
+void test_stream_compile_full_backend_item_fits_item_doc() {
+    writeAll(AGENDA_TEST_FILE,
+             "{\"version\":12,\"agendas\":[{\"id\":\"3f2504e0-4f89-41d3-9a0c-0305e82c3301\","
+             "\"nodeId\":\"9b1deb4d-3b7d-4bad-9bdd-2b0d7b3dcb6d\",\"nombre\":\"Riego del cantero grande junto al portón\","
+             "\"zona\":8,\"diasSemana\":[\"LUN\",\"MAR\",\"MIE\",\"JUE\",\"VIE\",\"SAB\",\"DOM\"],"
+             "\"horaInicio\":\"21:45:00\",\"duracionMin\":90,\"activa\":true,\"version\":11,"
+             "\"updatedAt\":\"2026-01-05T10:15:30.123456-03:00\"}]}");
+    AgendaTable table;
+    TEST_ASSERT_EQUAL(AGENDA_COMPILE_OK, compilePath(AGENDA_TEST_FILE, table));
+    TEST_ASSERT_EQUAL(1, table.count);
+    TEST_ASSERT_EQUAL(0x7F, table.slots[0].diasMask);
+    TEST_ASSERT_EQUAL(21 * 60 + 45, table.slots[0].minutoDia);
+    TEST_ASSERT_EQUAL_UINT32(11, table.slots[0].version);
+}
+
+void test_stream_compile_empty_array() {
+    writeAll(AGENDA_TEST_FILE, "{\"agendas\":[ ]}");
+    AgendaTable table;
+    TEST_ASSERT_EQUAL(AGENDA_COMPILE_OK, compilePath(AGENDA_TEST_FILE, table));
+    TEST_ASSERT_EQUAL(0, table.count);
+}
+
+void test_stream_compile_missing_agendas() {
+    writeAll(AGENDA_TEST_FILE, "{\"version\":3}");
+    AgendaTable table;
+    TEST_ASSERT_EQUAL(AGENDA_COMPILE_NO_AGENDAS, compilePath(AGENDA_TEST_FILE, table));
+}
+
+void test_stream_compile_truncated_payload() {
+    String payload;
+    TEST_ASSERT_TRUE(AgendaBenchmark::buildPayload(8, payload));
+    writeAll(AGENDA_TEST_FILE, payload.substring(0, payload.length() / 2));
+    AgendaTable table;
+    TEST_ASSERT_EQUAL(AGENDA_COMPILE_PARSE_ERROR, compilePath(AGENDA_TEST_FILE, table));
+}
+
+// "agendas" dentro de strings u objetos anidados no es la clave raíz
+void test_stream_compile_ignores_agendas_inside_other_values() {
+    const char* agenda = "{\"id\":\"a\",\"zona\":1,\"diasSemana\":[\"LUN\"],\"horaInicio\":\"06:00\","
+                         "\"duracionMin\":5,\"activa\":true}";
+    writeAll(AGENDA_TEST_FILE, String("{\"tipo\":\"agendas\",\"otras\":[") + agenda + "],\"version\":3}");
+    AgendaTable table;
+    TEST_ASSERT_EQUAL(AGENDA_COMPILE_NO_AGENDAS, compilePath(AGENDA_TEST_FILE, table));
+    
+    writeAll(AGENDA_TEST_FILE, String("{\"meta\":{\"agendas\":[") + agenda + "]},\"version\":3}");
+    TEST_ASSERT_EQUAL(AGENDA_COMPILE_NO_AGENDAS, compilePath(AGENDA_TEST_FILE, table));
+    
+    writeAll(AGENDA_TEST_FILE, "{\"agendas\":{\"zona\":1},\"version\":3}");
+    TEST_ASSERT_EQUAL(AGENDA_COMPILE_NO_AGENDAS, compilePath(AGENDA_TEST_FILE, table));
+}
+
+static int seekPath(const char* path, const char* key, String* rest) {
+    File file = LittleFS.open(path, "r");
+    int found = AgendaCompiler::seekArray(file, key);
+    if (rest != nullptr) *rest = file.readString();
+    file.close();
+    return found;
+}
+
+void test_seek_array_walks_top_level_keys() {
+    writeAll(AGENDA_TEST_FILE,
+             "{ \"nota\": \"\\\"agendas\\\": [1] \\\\\", \"meta\": {\"agendas\": [9], \"x\": \"]}\"},\n"
+             "  \"lista\": [{\"agendas\": []}], \"n\": -1.5e3, \"ok\": true, \"nada\": null,\n"
+             "  \"agendas\" : [ {\"id\": \"x\"}]}");
+    String rest;
+    TEST_ASSERT_EQUAL(1, seekPath(AGENDA_TEST_FILE, "agendas", &rest));
+    TEST_ASSERT_EQUAL_STRING("{\"id\": \"x\"}]}", rest.c_str());
+    
+    // Clave con escape o prefijo de la buscada: no coincide
+    writeAll(AGENDA_TEST_FILE, "{\"agenda\":[1],\"agendas2\":[2],\"agend\\u0061s\":[3]}");
+    TEST_ASSERT_EQUAL(0, seekPath(AGENDA_TEST_FILE, "agendas", nullptr));
+}
+
+void test_seek_array_rejects_non_array_and_bad_json() {
+    writeAll(AGENDA_TEST_FILE, "{\"agendas\":\"[]\"}");
+    TEST_ASSERT_EQUAL(0, seekPath(AGENDA_TEST_FILE, "agendas", nullptr));
+    writeAll(AGENDA_TEST_FILE, "{\"agendas\":null}");
+    TEST_ASSERT_EQUAL(0, seekPath(AGENDA_TEST_FILE, "agendas", nullptr));
+    writeAll(AGENDA_TEST_FILE, "{}");
+    TEST_ASSERT_EQUAL(0, seekPath(AGENDA_TEST_FILE, "agendas", nullptr));
+    
+    writeAll(AGENDA_TEST_FILE, "[{\"agendas\":[]}]");
+    TEST_ASSERT_EQUAL(-1, seekPath(AGENDA_TEST_FILE, "agendas", nullptr));
+    writeAll(AGENDA_TEST_FILE, "{\"version\" 3, \"agendas\":[]}");
+    TEST_ASSERT_EQUAL(-1, seekPath(AGENDA_TEST_FILE, "agendas", nullptr));
+    writeAll(AGENDA_TEST_FILE, "{\"meta\":{\"a\":\"sin cierre");
+    TEST_ASSERT_EQUAL(-1, seekPath(AGENDA_TEST_FILE, "agendas", nullptr));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_spool_small_message_does_not_touch_flash);
+    RUN_TEST(test_spool_large_message_written_in_chunks);
+    RUN_TEST(test_spool_overflow_is_rejected);
+    RUN_TEST(test_spool_reset_starts_new_message);
+    RUN_TEST(test_stream_compile_matches_document_compile);
+    RUN_TEST(test_stream_compile_version_after_agendas_and_whitespace);
+    RUN_TEST(test_stream_compile_full_backend_item_fits_item_doc);
+    RUN_TEST(test_stream_compile_empty_array);
+    RUN_TEST(test_stream_compile_missing_agendas);
+    RUN_TEST(test_stream_compile_truncated_payload);
+    RUN_TEST(test_stream_compile_ignores_agendas_inside_other_values);
+    RUN_TEST(test_seek_array_walks_top_level_keys);
+    RUN_TEST(test_seek_array_rejects_non_array_and_bad_json);
+    return UNITY_END();
+}
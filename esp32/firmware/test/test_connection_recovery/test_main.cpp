@@ -0,0 +1,148 @@
+#include <unity.h>
+#include "network/ConnectionRecovery.h"
+
+// ============================================================================
+// Test ConnectionRecovery - escalado por tiempo sin MQTT y tiempos por nivel
+// ============================================================================
+
+static const uint32_t SOCKET_MS = 60000;
+static const uint32_t WIFI_MS = 150000;
+static const uint32_t RESTART_MS = 300000;
+
+static ConnectionRecovery makeRecovery() {
+    ConnectionRecovery recovery;
+    recovery.setThresholds(SOCKET_MS, WIFI_MS, RESTART_MS);
+    return recovery;
+}
+
+// Simular el loop sin conexión de a un segundo; devuelve el primer nivel
+// pedido (o RECOVERY_NONE) y deja `now` donde se pidió
+static RecoveryTier runOffline(ConnectionRecovery& recovery, uint32_t& now, uint32_t seconds) {
+    for (uint32_t i = 0; i < seconds; i++) {
+        now += 1000;
+        RecoveryTier tier = recovery.update(now, false);
+        if (tier != RECOVERY_NONE) return tier;
+    }
+    return RECOVERY_NONE;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_no_escalation_before_first_connection() {
+    ConnectionRecovery recovery = makeRecovery();
+    uint32_t now = 0;
+    // Arranque con el broker caído: sin sesión previa no se reinicia
+    TEST_ASSERT_EQUAL(RECOVERY_NONE, runOffline(recovery, now, 3600));
+
+    RecoveryReport report;
+    recovery.update(now, true);
+    TEST_ASSERT_FALSE(recovery.takeReport(report));
+}
+
+void test_tiers_escalate_once_each_in_order() {
+    ConnectionRecovery recovery = makeRecovery();
+    uint32_t now = 1000;
+    recovery.update(now, true);
+
+    // Se cae: la caída cuenta desde la primera vuelta sin conexión
+    recovery.update(now, false);
+    uint32_t dropAt = now;
+    TEST_ASSERT_EQUAL(RECOVERY_SOCKET, runOffline(recovery, now, 3600));
+    TEST_ASSERT_EQUAL_UINT32(dropAt + SOCKET_MS, now);
+    TEST_ASSERT_EQUAL(RECOVERY_WIFI, runOffline(recovery, now, 3600));
+    TEST_ASSERT_EQUAL_UINT32(dropAt + WIFI_MS, now);
+    TEST_ASSERT_EQUAL(RECOVERY_RESTART, runOffline(recovery, now, 3600));
+    TEST_ASSERT_EQUAL_UINT32(dropAt + RESTART_MS, now);
+
+    // Nada más que hacer en esta caída
+    TEST_ASSERT_EQUAL(RECOVERY_NONE, runOffline(recovery, now, 3600));
+    TEST_ASSERT_EQUAL(RECOVERY_RESTART, recovery.getAppliedTier());
+}
+
+void test_recovery_time_measured_per_tier() {
+    ConnectionRecovery recovery = makeRecovery();
+    uint32_t now = 1000;
+    recovery.update(now, true);
+
+    // Caída corta: vuelve sola con el backoff
+    recovery.update(now, false);
+    runOffline(recovery, now, 20);
+    recovery.update(now, true);
+    RecoveryReport report;
+    TEST_ASSERT_TRUE(recovery.takeReport(report));
+    TEST_ASSERT_EQUAL(RECOVERY_NONE, report.tier);
+    TEST_ASSERT_EQUAL_UINT32(20000, report.offlineMs);
+    TEST_ASSERT_FALSE(recovery.takeReport(report));  // Se informa una sola vez
+
+    // Caída que necesita reasociar el WiFi: vuelve 12 s después
+    recovery.update(now, false);
+    runOffline(recovery, now, 3600);   // SOCKET
+    runOffline(recovery, now, 3600);   // WIFI
+    now += 12000;
+    recovery.update(now, true);
+    TEST_ASSERT_TRUE(recovery.takeReport(report));
+    TEST_ASSERT_EQUAL(RECOVERY_WIFI, report.tier);
+    TEST_ASSERT_EQUAL_UINT32(12000, report.tierMs);
+    TEST_ASSERT_EQUAL_UINT32(WIFI_MS + 12000, report.offlineMs);
+
+    // Otra con el mismo nivel: se acumulan
+    recovery.update(now, false);
+    runOffline(recovery, now, 3600);
+    runOffline(recovery, now, 3600);
+    now += 4000;
+    recovery.update(now, true);
+
+    const RecoveryStats& wifi = recovery.getStats(RECOVERY_WIFI);
+    TEST_ASSERT_EQUAL(2, wifi.count);
+    TEST_ASSERT_EQUAL_UINT32(4000, wifi.lastMs);
+    TEST_ASSERT_EQUAL_UINT32(12000, wifi.maxMs);
+    TEST_ASSERT_EQUAL_UINT32(16000, wifi.totalMs);
+    TEST_ASSERT_EQUAL(1, recovery.getStats(RECOVERY_NONE).count);
+    TEST_ASSERT_EQUAL(0, recovery.getStats(RECOVERY_SOCKET).count);
+}
+
+void test_restart_tier_measured_across_reboot() {
+    // Después del reinicio millis() arranca en 0
+    ConnectionRecovery recovery = makeRecovery();
+    recovery.resumeAfterRestart(RESTART_MS);
+    TEST_ASSERT_FALSE(recovery.isOnline());
+
+    // El reinicio no vuelve a escalar mientras la caída siga abierta
+    uint32_t now = 0;
+    TEST_ASSERT_EQUAL(RECOVERY_NONE, runOffline(recovery, now, 30));
+
+    recovery.update(now, true);
+    RecoveryReport report;
+    TEST_ASSERT_TRUE(recovery.takeReport(report));
+    TEST_ASSERT_EQUAL(RECOVERY_RESTART, report.tier);
+    TEST_ASSERT_EQUAL_UINT32(30000, report.tierMs);
+    TEST_ASSERT_EQUAL_UINT32(RESTART_MS + 30000, report.offlineMs);
+    TEST_ASSERT_EQUAL(1, recovery.getStats(RECOVERY_RESTART).count);
+
+    // La próxima caída escala desde cero
+    recovery.update(now, false);
+    uint32_t dropAt = now;
+    TEST_ASSERT_EQUAL(RECOVERY_SOCKET, runOffline(recovery, now, 3600));
+    TEST_ASSERT_EQUAL_UINT32(dropAt + SOCKET_MS, now);
+}
+
+void test_millis_rollover_during_outage() {
+    ConnectionRecovery recovery = makeRecovery();
+    uint32_t now = 0xFFFFFFFFUL - 30000;
+    recovery.update(now, true);
+    recovery.update(now, false);
+    uint32_t dropAt = now;
+    TEST_ASSERT_EQUAL(RECOVERY_SOCKET, runOffline(recovery, now, 3600));
+    TEST_ASSERT_EQUAL_UINT32(dropAt + SOCKET_MS, now);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_escalation_before_first_connection);
+    RUN_TEST(test_tiers_escalate_once_each_in_order);
+    RUN_TEST(test_recovery_time_measured_per_tier);
+    RUN_TEST(test_restart_tier_measured_across_reboot);
+    RUN_TEST(test_millis_rollover_during_outage);
+    return UNITY_END();
+}
@@ -0,0 +1,247 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "storage/SPIFFSManager.h"
+#include "storage/EventJournal.h"
+
+// ============================================================================
+// Test diario de eventos - orden, persistencia, rotación y registros dañados
+// ============================================================================
+
+static SPIFFSManager storage;
+
+// Publicador simulado: registra las secuencias y puede fallar a pedido
+static uint32_t publishedSeqs[512];
+static uint16_t publishedCount = 0;
+static int16_t failAfter = -1;  // Publicaciones aceptadas antes de fallar (-1 = nunca)
+
+static bool recordPublish(const RiegoEventRecord& record) {
+    if (failAfter >= 0 && publishedCount >= failAfter) return false;
+    publishedSeqs[publishedCount++] = record.seq;
+    return true;
+}
+
+static void appendEvents(EventJournal& journal, int count) {
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(journal.append(1 + i % MAX_ZONES, (i & 1) ? RIEGO_FIN : RIEGO_INICIO,
+                                        ORIGEN_AGENDA, 60, 3, 1735415280UL + i));
+    }
+}
+
+static void drainAll(EventJournal& journal) {
+    while (journal.drain(recordPublish, EVENT_JOURNAL_DRAIN_BATCH) > 0) {}
+}
+
+void setUp() {
+    NativeShim::setSerialQuiet(true);
+    NativeShim::setFsRoot("native_fs_test_journal");
+    LittleFS.format();
+    storage.init();
+    publishedCount = 0;
+    failAfter = -1;
+}
+
+void tearDown() {}
+
+void test_events_are_published_in_order_and_cleared() {
+    EventJournal journal(&storage);
+    TEST_ASSERT_TRUE(journal.init());
+    appendEvents(journal, 20);
+    TEST_ASSERT_EQUAL(20, journal.getPending());
+
+    // Lotes acotados
+    TEST_ASSERT_EQUAL(EVENT_JOURNAL_DRAIN_BATCH, journal.drain(recordPublish, EVENT_JOURNAL_DRAIN_BATCH));
+    drainAll(journal);
+
+    TEST_ASSERT_EQUAL(20, publishedCount);
+    for (uint16_t i = 0; i < publishedCount; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i + 1, publishedSeqs[i]);
+    }
+    TEST_ASSERT_EQUAL(0, journal.getPending());
+    TEST_ASSERT_FALSE(LittleFS.exists("/evj0.bin"));
+}
+
+void test_record_fields_round_trip() {
+    static RiegoEventRecord last;
+    struct Capture {
+        static bool publish(const RiegoEventRecord& record) {
+            last = record;
+            return true;
+        }
+    };
+
+    EventJournal journal(&storage);
+    journal.init();
+    TEST_ASSERT_TRUE(journal.append(4, RIEGO_FIN, ORIGEN_MANUAL, 125, 0, 1735415999UL));
+    TEST_ASSERT_EQUAL(1, journal.drain(Capture::publish, 8));
+    TEST_ASSERT_EQUAL(4, last.zona);
+    TEST_ASSERT_EQUAL(RIEGO_FIN, last.evento);
+    TEST_ASSERT_EQUAL(ORIGEN_MANUAL, last.origen);
+    TEST_ASSERT_EQUAL(125, last.duracion);
+    TEST_ASSERT_EQUAL(0, last.versionAgenda);
+    TEST_ASSERT_EQUAL_UINT32(1735415999UL, last.timestamp);
+}
+
+void test_publish_failure_keeps_events_pending() {
+    EventJournal journal(&storage);
+    journal.init();
+    appendEvents(journal, 5);
+
+    failAfter = 2;
+    TEST_ASSERT_EQUAL(2, journal.drain(recordPublish, 8));
+    TEST_ASSERT_EQUAL(3, journal.getPending());
+
+    failAfter = -1;
+    drainAll(journal);
+    TEST_ASSERT_EQUAL(5, publishedCount);
+    TEST_ASSERT_EQUAL_UINT32(3, publishedSeqs[2]);
+    TEST_ASSERT_EQUAL_UINT32(5, publishedSeqs[4]);
+}
+
+void test_record_publishes_directly_without_flash() {
+    EventJournal journal(&storage);
+    journal.init();
+    TEST_ASSERT_TRUE(journal.record(recordPublish, 2, RIEGO_FIN, ORIGEN_AGENDA, 60, 3, 1735415280UL));
+
+    TEST_ASSERT_EQUAL(1, publishedCount);
+    TEST_ASSERT_EQUAL_UINT32(0, publishedSeqs[0]);
+    TEST_ASSERT_EQUAL(0, journal.getPending());
+    TEST_ASSERT_EQUAL_UINT32(0, journal.getLastSeq());
+    TEST_ASSERT_FALSE(LittleFS.exists("/evj0.bin"));
+}
+
+void test_record_journals_when_offline_or_publish_fails() {
+    EventJournal journal(&storage);
+    journal.init();
+    TEST_ASSERT_TRUE(journal.record(nullptr, 1, RIEGO_INICIO, ORIGEN_AGENDA, 60, 3, 1735415280UL));
+    failAfter = 0;
+    TEST_ASSERT_TRUE(journal.record(recordPublish, 1, RIEGO_FIN, ORIGEN_AGENDA, 60, 3, 1735415340UL));
+
+    TEST_ASSERT_EQUAL(0, publishedCount);
+    TEST_ASSERT_EQUAL(2, journal.getPending());
+    TEST_ASSERT_TRUE(LittleFS.exists("/evj0.bin"));
+}
+
+void test_record_queues_behind_pending_events() {
+    EventJournal journal(&storage);
+    journal.init();
+    appendEvents(journal, 3);
+
+    // Conectado pero con pendientes: no se adelanta a ellos
+    TEST_ASSERT_TRUE(journal.record(recordPublish, 4, RIEGO_FIN, ORIGEN_MANUAL, 30, 0, 1735415999UL));
+    TEST_ASSERT_EQUAL(0, publishedCount);
+    TEST_ASSERT_EQUAL(4, journal.getPending());
+
+    drainAll(journal);
+    TEST_ASSERT_EQUAL(4, publishedCount);
+    TEST_ASSERT_EQUAL_UINT32(4, publishedSeqs[3]);
+
+    // Al día: el siguiente sale directo
+    TEST_ASSERT_TRUE(journal.record(recordPublish, 4, RIEGO_INICIO, ORIGEN_MANUAL, 30, 0, 1735416000UL));
+    TEST_ASSERT_EQUAL(5, publishedCount);
+    TEST_ASSERT_EQUAL_UINT32(0, publishedSeqs[4]);
+    TEST_ASSERT_EQUAL(0, journal.getPending());
+}
+
+void test_pending_and_sequence_survive_restart() {
+    {
+        EventJournal journal(&storage);
+        journal.init();
+        appendEvents(journal, 5);
+        TEST_ASSERT_EQUAL(2, journal.drain(recordPublish, 2));
+    }
+
+    EventJournal restarted(&storage);
+    TEST_ASSERT_TRUE(restarted.init());
+    TEST_ASSERT_EQUAL(3, restarted.getPending());
+    TEST_ASSERT_EQUAL_UINT32(2, restarted.getAckedSeq());
+    TEST_ASSERT_EQUAL_UINT32(5, restarted.getLastSeq());
+
+    appendEvents(restarted, 1);
+    drainAll(restarted);
+    TEST_ASSERT_EQUAL(6, publishedCount);
+    TEST_ASSERT_EQUAL_UINT32(6, publishedSeqs[5]);
+
+    // Con todo publicado los segmentos se borran pero la secuencia sigue
+    EventJournal again(&storage);
+    again.init();
+    TEST_ASSERT_EQUAL(0, again.getPending());
+    appendEvents(again, 1);
+    drainAll(again);
+    TEST_ASSERT_EQUAL_UINT32(7, publishedSeqs[6]);
+}
+
+void test_full_journal_drops_oldest_segment() {
+    EventJournal journal(&storage);
+    journal.init();
+    const int capacity = EVENT_JOURNAL_SEGMENTS * EVENT_JOURNAL_SEGMENT_RECORDS;
+    appendEvents(journal, capacity + 1);
+
+    TEST_ASSERT_EQUAL_UINT32(EVENT_JOURNAL_SEGMENT_RECORDS, journal.getDropped());
+    TEST_ASSERT_EQUAL(capacity - EVENT_JOURNAL_SEGMENT_RECORDS + 1, journal.getPending());
+
+    drainAll(journal);
+    TEST_ASSERT_EQUAL(capacity - EVENT_JOURNAL_SEGMENT_RECORDS + 1, publishedCount);
+    TEST_ASSERT_EQUAL_UINT32(EVENT_JOURNAL_SEGMENT_RECORDS + 1, publishedSeqs[0]);
+    TEST_ASSERT_EQUAL_UINT32(capacity + 1, publishedSeqs[publishedCount - 1]);
+}
+
+void test_torn_record_is_ignored_and_segment_closed() {
+    {
+        EventJournal journal(&storage);
+        journal.init();
+        appendEvents(journal, 3);
+    }
+
+    // Corte de energía a mitad de un registro
+    File file = LittleFS.open("/evj0.bin", "a");
+    file.write((const uint8_t*)"\x07\x00\x00\x00\x01", 5);
+    file.close();
+
+    EventJournal restarted(&storage);
+    restarted.init();
+    TEST_ASSERT_EQUAL(3, restarted.getPending());
+    appendEvents(restarted, 1);
+    TEST_ASSERT_TRUE(LittleFS.exists("/evj1.bin"));
+
+    drainAll(restarted);
+    TEST_ASSERT_EQUAL(4, publishedCount);
+    TEST_ASSERT_EQUAL_UINT32(4, publishedSeqs[3]);
+}
+
+void test_corrupt_state_replays_stored_events() {
+    {
+        EventJournal journal(&storage);
+        journal.init();
+        appendEvents(journal, 4);
+        TEST_ASSERT_EQUAL(2, journal.drain(recordPublish, 2));
+    }
+
+    File file = LittleFS.open(EVENT_JOURNAL_STATE_FILE, "w");
+    file.write((const uint8_t*)"basura", 6);
+    file.close();
+
+    // Sin estado se reenvía todo (el backend deduplica por seq + timestamp)
+    publishedCount = 0;
+    EventJournal restarted(&storage);
+    restarted.init();
+    TEST_ASSERT_EQUAL(4, restarted.getPending());
+    drainAll(restarted);
+    TEST_ASSERT_EQUAL(4, publishedCount);
+    TEST_ASSERT_EQUAL_UINT32(1, publishedSeqs[0]);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_events_are_published_in_order_and_cleared);
+    RUN_TEST(test_record_fields_round_trip);
+    RUN_TEST(test_publish_failure_keeps_events_pending);
+    RUN_TEST(test_record_publishes_directly_without_flash);
+    RUN_TEST(test_record_journals_when_offline_or_publish_fails);
+    RUN_TEST(test_record_queues_behind_pending_events);
+    RUN_TEST(test_pending_and_sequence_survive_restart);
+    RUN_TEST(test_full_journal_drops_oldest_segment);
+    RUN_TEST(test_torn_record_is_ignored_and_segment_closed);
+    RUN_TEST(test_corrupt_state_replays_stored_events);
+    return UNITY_END();
+}
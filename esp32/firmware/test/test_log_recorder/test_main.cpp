@@ -0,0 +1,218 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "storage/SPIFFSManager.h"
+#include "storage/LogRecorder.h"
+#include "utils/Logger.h"
+
+// ============================================================================
+// Test LogRecorder - codificación, lotes, rotación y escrituras fallidas
+// ============================================================================
+
+static SPIFFSManager storage;
+static LogRecorder* activeRecorder = nullptr;
+
+static void recordSink(int level, uint32_t id, PGM_P format, va_list args) {
+    if (activeRecorder != nullptr) activeRecorder->record(level, id, format, args);
+}
+
+static size_t encodef(uint8_t* out, size_t capacity, int level, uint32_t id, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t length = LogRecorder::encode(out, capacity, 0x01020304UL, level, id, format, args);
+    va_end(args);
+    return length;
+}
+
+static size_t fileSize(const char* path) {
+    if (!LittleFS.exists(path)) return 0;
+    File file = LittleFS.open(path, "r");
+    size_t size = file.size();
+    file.close();
+    return size;
+}
+
+void setUp() {
+    NativeShim::useFakeClock(1000);
+    NativeShim::setSerialQuiet(true);
+    NativeShim::setFsRoot("native_fs_test_log_recorder");
+    LittleFS.format();
+    storage.init();
+    activeRecorder = nullptr;
+    Logger::setRecordSink(recordSink);
+}
+
+void tearDown() {
+    Logger::setRecordSink(nullptr);
+    Logger::flush();
+}
+
+// FNV-1a de 32 bits, igual en compilación, en ejecución y en tools/log_formats.py
+void test_format_id_is_fnv1a() {
+    TEST_ASSERT_EQUAL_HEX32(0x811C9DC5UL, LOG_ID(""));
+    TEST_ASSERT_EQUAL_HEX32(0x1A47E90BUL, LOG_ID("abc"));
+    const char* runtime = "abc";
+    TEST_ASSERT_EQUAL_HEX32(0x1A47E90BUL, Logger::formatId(runtime));
+}
+
+void test_encode_layout() {
+    uint8_t out[LOG_RECORD_MAX];
+    size_t length = encodef(out, sizeof(out), LOG_LEVEL_WARN, 0xA1B2C3D4UL,
+                            "Zona %d: %u seg (%s) %.1f %lu%%", -3, 300u, "abc", 1.5, 70000UL);
+
+    const uint8_t expected[] = {
+        23,                         // Largo del resto
+        0x04, 0x03, 0x02, 0x01,     // millis
+        LOG_LEVEL_WARN,
+        0xD4, 0xC3, 0xB2, 0xA1,     // id
+        0x05,                       // -3 en zigzag
+        0xAC, 0x02,                 // 300 en varint
+        3, 'a', 'b', 'c',
+        0x00, 0x00, 0xC0, 0x3F,     // 1.5f
+        0xF0, 0xA2, 0x04            // 70000 en varint
+    };
+    TEST_ASSERT_EQUAL(sizeof(expected), length);
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        TEST_ASSERT_EQUAL_HEX8(expected[i], out[i]);
+    }
+}
+
+void test_long_arguments_are_cut() {
+    uint8_t out[LOG_RECORD_MAX];
+    char longText[LOG_RECORD_STRING_MAX + 20];
+    memset(longText, 'x', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = '\0';
+
+    // El texto se corta en LOG_RECORD_STRING_MAX bytes
+    size_t length = encodef(out, sizeof(out), LOG_LEVEL_INFO, 1, "%s", longText);
+    TEST_ASSERT_EQUAL(LOG_RECORD_HEADER + 1 + LOG_RECORD_STRING_MAX, length);
+    TEST_ASSERT_EQUAL(LOG_RECORD_STRING_MAX, out[LOG_RECORD_HEADER]);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INFO, out[5]);
+
+    // Lo que no entra en el registro no se escribe a medias y queda marcado
+    length = encodef(out, LOG_RECORD_HEADER + 4, LOG_LEVEL_INFO, 1, "%d %s", 7, longText);
+    TEST_ASSERT_EQUAL(LOG_RECORD_HEADER + 1, length);
+    TEST_ASSERT_EQUAL(length - 1, out[0]);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INFO | LOG_RECORD_TRUNCATED, out[5]);
+}
+
+// %.*s y %.Ns leen como printf: no más allá de la precisión (texto sin '\0')
+void test_string_precision_limits_read() {
+    uint8_t out[LOG_RECORD_MAX];
+    char* payload = (char*)malloc(4);               // Sin terminador: ASan marca si se lee de más
+    memcpy(payload, "ONxx", 4);
+
+    size_t length = encodef(out, sizeof(out), LOG_LEVEL_WARN, 1, "Payload: %.*s", 2, payload);
+    const uint8_t expected[] = {0x04, 2, 'O', 'N'};  // Precisión en zigzag y texto cortado
+    TEST_ASSERT_EQUAL(LOG_RECORD_HEADER + sizeof(expected), length);
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        TEST_ASSERT_EQUAL_HEX8(expected[i], out[LOG_RECORD_HEADER + i]);
+    }
+
+    length = encodef(out, sizeof(out), LOG_LEVEL_WARN, 1, "%.3s|%.0s", payload, payload);
+    TEST_ASSERT_EQUAL(LOG_RECORD_HEADER + 5, length);
+    TEST_ASSERT_EQUAL(3, out[LOG_RECORD_HEADER]);
+    TEST_ASSERT_EQUAL(0, out[LOG_RECORD_HEADER + 4]);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARN, out[5]);
+    free(payload);
+}
+
+// Las líneas esperan en RAM hasta llenar el lote; un ERROR se escribe ya
+void test_records_are_batched() {
+    LogRecorder recorder(&storage);
+    activeRecorder = &recorder;
+    recorder.begin();
+
+    LOG_INFO("Zona %d encendida", 1);
+    LOG_DEBUG("No se registra: %d", 2);      // Por encima de LOG_RECORD_LEVEL
+    TEST_ASSERT_FALSE(LittleFS.exists(LOG_RECORD_FILE));
+    TEST_ASSERT_EQUAL(2, recorder.getRecorded());
+
+    int lines = 0;
+    while (recorder.getRecorded() < 40 && fileSize(LOG_RECORD_FILE) == 0) {
+        LOG_INFO("Zona %d apagada tras %d seg", lines % 8 + 1, lines * 10);
+        lines++;
+    }
+    TEST_ASSERT_TRUE(fileSize(LOG_RECORD_FILE) > 0);
+    TEST_ASSERT_TRUE(fileSize(LOG_RECORD_FILE) <= LOG_RECORD_BATCH_BYTES);
+    TEST_ASSERT_TRUE(recorder.getBatchLength() > 0);
+
+    size_t before = fileSize(LOG_RECORD_FILE);
+    LOG_ERROR("Fallo de prueba %s", "xyz");
+    TEST_ASSERT_EQUAL(0, recorder.getBatchLength());
+    TEST_ASSERT_TRUE(fileSize(LOG_RECORD_FILE) > before);
+}
+
+void test_loop_writes_partial_batch_after_interval() {
+    LogRecorder recorder(&storage);
+    activeRecorder = &recorder;
+    recorder.begin();
+    LOG_WARN("Aviso %d", 1);
+
+    NativeShim::advanceMillis(LOG_RECORD_FLUSH_MS - 1);
+    recorder.loop();
+    TEST_ASSERT_FALSE(LittleFS.exists(LOG_RECORD_FILE));
+
+    NativeShim::advanceMillis(1);
+    recorder.loop();
+    TEST_ASSERT_EQUAL(0, recorder.getBatchLength());
+
+    // Marca de arranque y el aviso, enteros y en orden
+    File file = LittleFS.open(LOG_RECORD_FILE, "r");
+    uint8_t data[64];
+    size_t length = file.read(data, sizeof(data));
+    file.close();
+    TEST_ASSERT_EQUAL(LOG_RECORD_HEADER + LOG_RECORD_HEADER + 1, length);
+    TEST_ASSERT_EQUAL(LOG_RECORD_HEADER - 1, data[0]);
+    TEST_ASSERT_EQUAL(0, data[5]);
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARN, data[LOG_RECORD_HEADER + 5]);
+    uint32_t id = data[LOG_RECORD_HEADER + 6] | (data[LOG_RECORD_HEADER + 7] << 8) |
+                  ((uint32_t)data[LOG_RECORD_HEADER + 8] << 16) | ((uint32_t)data[LOG_RECORD_HEADER + 9] << 24);
+    TEST_ASSERT_EQUAL_HEX32(LOG_ID("Aviso %d"), id);
+}
+
+// Nunca más de dos archivos, cada uno hasta LOG_RECORD_FILE_MAX
+void test_rotation_keeps_two_files() {
+    LogRecorder recorder(&storage);
+    activeRecorder = &recorder;
+    recorder.begin();
+
+    for (int i = 0; i < 2000; i++) {
+        LOG_INFO("Riego zona %d: %lu ms, agenda %s", i % 8 + 1, (unsigned long)i * 1000UL, "nocturna");
+    }
+    recorder.flush();
+
+    TEST_ASSERT_TRUE(LittleFS.exists(LOG_RECORD_FILE_OLD));
+    TEST_ASSERT_TRUE(fileSize(LOG_RECORD_FILE_OLD) <= LOG_RECORD_FILE_MAX);
+    TEST_ASSERT_TRUE(fileSize(LOG_RECORD_FILE_OLD) > LOG_RECORD_FILE_MAX - LOG_RECORD_BATCH_BYTES);
+    TEST_ASSERT_TRUE(fileSize(LOG_RECORD_FILE) <= LOG_RECORD_FILE_MAX);
+    TEST_ASSERT_EQUAL(0, recorder.getDropped());
+}
+
+// Sin LittleFS el lote queda en RAM; lo que ya no entra se cuenta
+void test_failed_writes_keep_batch_and_count_drops() {
+    SPIFFSManager unmounted;
+    LogRecorder recorder(&unmounted);
+    activeRecorder = &recorder;
+
+    for (int i = 0; i < 100; i++) {
+        LOG_WARN("Sin almacenamiento %d", i);
+    }
+    TEST_ASSERT_FALSE(recorder.flush());
+    TEST_ASSERT_TRUE(recorder.getBatchLength() > LOG_RECORD_BATCH_BYTES - 16);
+    TEST_ASSERT_TRUE(recorder.getDropped() > 0);
+    TEST_ASSERT_EQUAL(100, recorder.getRecorded() + recorder.getDropped());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_format_id_is_fnv1a);
+    RUN_TEST(test_encode_layout);
+    RUN_TEST(test_long_arguments_are_cut);
+    RUN_TEST(test_string_precision_limits_read);
+    RUN_TEST(test_records_are_batched);
+    RUN_TEST(test_loop_writes_partial_batch_after_interval);
+    RUN_TEST(test_rotation_keeps_two_files);
+    RUN_TEST(test_failed_writes_keep_batch_and_count_drops);
+    return UNITY_END();
+}
@@ -0,0 +1,212 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "network/LogStreamer.h"
+#include "utils/Logger.h"
+
+// ============================================================================
+// Test LogStreamer - cola acotada, ritmo de publicación y nivel en ejecución
+// ============================================================================
+
+static LogStreamer* activeStreamer = nullptr;
+
+// Publicador simulado: guarda los mensajes y puede rechazar (socket lleno)
+static char messages[16][LOG_STREAM_PAYLOAD_MAX + 1];
+static int messageCount = 0;
+static bool acceptPublish = true;
+static bool logWhilePublishing = false;
+static size_t longestMessage = 0;
+
+static bool recordPublish(const char* payload, size_t length) {
+    if (logWhilePublishing) LOG_WARN("Publicando log remoto (%u bytes)", (unsigned)length);
+    if (!acceptPublish) return false;
+    if (length > longestMessage) longestMessage = length;
+    if (messageCount < 16) {
+        memcpy(messages[messageCount], payload, length);
+        messages[messageCount][length] = '\0';
+    }
+    messageCount++;
+    return true;
+}
+
+static void lineSink(int level, const char* line, size_t length) {
+    if (activeStreamer != nullptr) activeStreamer->enqueue(level, line, length);
+}
+
+static int countLines(const char* text) {
+    int lines = 1;
+    for (const char* p = text; *p != '\0'; p++) {
+        if (*p == '\n') lines++;
+    }
+    return lines;
+}
+
+void setUp() {
+    NativeShim::useFakeClock(1000);
+    NativeShim::setSerialQuiet(true);
+    Logger::setDeferred(false);
+    Logger::setLineSink(lineSink);
+    messageCount = 0;
+    acceptPublish = true;
+    logWhilePublishing = false;
+    longestMessage = 0;
+}
+
+void tearDown() {
+    Logger::setLineSink(nullptr);
+    activeStreamer = nullptr;
+}
+
+void test_off_by_default_and_filtered_by_level() {
+    LogStreamer streamer(recordPublish);
+    activeStreamer = &streamer;
+    TEST_ASSERT_EQUAL(LOG_STREAM_DEFAULT_LEVEL, streamer.getLevel());
+
+    LOG_ERROR("Antes de prender el log remoto");
+    streamer.loop(millis());
+    TEST_ASSERT_EQUAL(0, messageCount);
+
+    streamer.setLevel(LOG_LEVEL_WARN);
+    LOG_INFO("Zona %d encendida", 2);
+    LOG_WARN("Duracion invalida para zona %d", 3);
+    LOG_ERROR("Fallo %s", "bus");
+    streamer.loop(millis());
+
+    TEST_ASSERT_EQUAL(1, messageCount);
+    TEST_ASSERT_EQUAL_STRING("[WARN] Duracion invalida para zona 3\n[ERROR] Fallo bus", messages[0]);
+    TEST_ASSERT_EQUAL(2, streamer.getLinesPublished());
+    TEST_ASSERT_EQUAL(0, streamer.pending());
+}
+
+// Varias líneas por mensaje y a lo sumo un mensaje por intervalo
+void test_lines_are_batched_and_rate_limited() {
+    LogStreamer streamer(recordPublish);
+    activeStreamer = &streamer;
+    streamer.setLevel(LOG_LEVEL_INFO);
+
+    for (int i = 0; i < 12; i++) {
+        LOG_INFO("Riego zona %d: %d seg restantes en la agenda nocturna", i % 8 + 1, i * 60);
+    }
+    streamer.loop(millis());
+    TEST_ASSERT_EQUAL(1, messageCount);
+    int firstLines = countLines(messages[0]);
+    TEST_ASSERT_TRUE(firstLines > 1 && firstLines < 12);
+
+    // Dentro del intervalo no sale nada más
+    NativeShim::advanceMillis(LOG_STREAM_INTERVAL_MS - 1);
+    streamer.loop(millis());
+    TEST_ASSERT_EQUAL(1, messageCount);
+    TEST_ASSERT_EQUAL(1, streamer.getMsUntilNextPublish(millis()));
+
+    int total = firstLines;
+    while (streamer.pending() > 0 && messageCount < 16) {
+        NativeShim::advanceMillis(LOG_STREAM_INTERVAL_MS);
+        streamer.loop(millis());
+        total += countLines(messages[messageCount - 1]);
+    }
+    TEST_ASSERT_EQUAL(12, total);
+    TEST_ASSERT_TRUE(longestMessage <= LOG_STREAM_PAYLOAD_MAX);
+    TEST_ASSERT_EQUAL(12, streamer.getLinesPublished());
+    TEST_ASSERT_EQUAL(0, streamer.getDropped());
+    TEST_ASSERT_EQUAL(-1, streamer.getMsUntilNextPublish(millis()));
+}
+
+// Socket sin lugar: las líneas esperan y salen en el próximo intento
+void test_rejected_publish_keeps_lines() {
+    LogStreamer streamer(recordPublish);
+    activeStreamer = &streamer;
+    streamer.setLevel(LOG_LEVEL_INFO);
+    LOG_INFO("Linea %d", 1);
+    LOG_INFO("Linea %d", 2);
+
+    acceptPublish = false;
+    streamer.loop(millis());
+    TEST_ASSERT_EQUAL(0, messageCount);
+    TEST_ASSERT_TRUE(streamer.pending() > 0);
+
+    acceptPublish = true;
+    streamer.loop(millis());
+    TEST_ASSERT_EQUAL(0, messageCount);           // Espera el intervalo
+    NativeShim::advanceMillis(LOG_STREAM_INTERVAL_MS);
+    streamer.loop(millis());
+    TEST_ASSERT_EQUAL(1, messageCount);
+    TEST_ASSERT_EQUAL_STRING("[INFO] Linea 1\n[INFO] Linea 2", messages[0]);
+}
+
+// Cola llena: se cuenta lo perdido y el próximo mensaje empieza con el resumen
+void test_full_queue_drops_with_summary() {
+    LogStreamer streamer(recordPublish);
+    activeStreamer = &streamer;
+    streamer.setLevel(LOG_LEVEL_INFO);
+
+    acceptPublish = false;
+    for (int i = 0; i < 200; i++) {
+        LOG_INFO("Linea de relleno numero %d", i);
+    }
+    TEST_ASSERT_TRUE(streamer.getDropped() > 0);
+    TEST_ASSERT_TRUE(streamer.pending() < LOG_STREAM_QUEUE_BYTES);
+    uint32_t dropped = streamer.getDropped();
+
+    acceptPublish = true;
+    NativeShim::advanceMillis(LOG_STREAM_INTERVAL_MS);
+    streamer.loop(millis());
+    TEST_ASSERT_EQUAL(1, messageCount);
+    char summary[80];
+    snprintf(summary, sizeof(summary), "[WARN] Log remoto: %lu lineas descartadas (cola llena)\n",
+             (unsigned long)dropped);
+    TEST_ASSERT_EQUAL(0, strncmp(messages[0], summary, strlen(summary)));
+    TEST_ASSERT_EQUAL(0, strncmp(messages[0] + strlen(summary), "[INFO] Linea de relleno numero 0", 32));
+
+    // El resumen sale una sola vez
+    NativeShim::advanceMillis(LOG_STREAM_INTERVAL_MS);
+    streamer.loop(millis());
+    TEST_ASSERT_EQUAL(2, messageCount);
+    TEST_ASSERT_NULL(strstr(messages[1], "descartadas"));
+}
+
+// Lo que se loguea al publicar no vuelve a la cola (sin realimentación)
+void test_logging_while_publishing_is_not_streamed() {
+    LogStreamer streamer(recordPublish);
+    activeStreamer = &streamer;
+    streamer.setLevel(LOG_LEVEL_INFO);
+    logWhilePublishing = true;
+
+    LOG_INFO("Una sola linea");
+    streamer.loop(millis());
+    TEST_ASSERT_EQUAL(1, messageCount);
+    TEST_ASSERT_EQUAL(0, streamer.pending());
+    TEST_ASSERT_EQUAL(-1, streamer.getMsUntilNextPublish(millis()));
+}
+
+void test_level_parsing_and_limits() {
+    TEST_ASSERT_EQUAL(LOG_LEVEL_DEBUG, LogStreamer::parseLevel("debug", 5));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_WARN, LogStreamer::parseLevel("WARN\n", 5));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_INFO, LogStreamer::parseLevel("3", 1));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_NONE, LogStreamer::parseLevel("off", 3));
+    TEST_ASSERT_EQUAL(LOG_LEVEL_NONE, LogStreamer::parseLevel("NONE", 4));
+    TEST_ASSERT_EQUAL(-1, LogStreamer::parseLevel("9", 1));
+    TEST_ASSERT_EQUAL(-1, LogStreamer::parseLevel("INFORMACION", 11));
+    TEST_ASSERT_EQUAL(-1, LogStreamer::parseLevel("", 0));
+
+    // Un nivel no compilado queda en LOG_LEVEL; apagar vacía la cola
+    LogStreamer streamer(recordPublish);
+    activeStreamer = &streamer;
+    streamer.setLevel(LOG_LEVEL_DEBUG);
+    TEST_ASSERT_EQUAL(LOG_LEVEL, streamer.getLevel());
+    LOG_INFO("Pendiente");
+    TEST_ASSERT_TRUE(streamer.pending() > 0);
+    streamer.setLevel(LOG_LEVEL_NONE);
+    TEST_ASSERT_EQUAL(0, streamer.pending());
+    streamer.loop(millis());
+    TEST_ASSERT_EQUAL(0, messageCount);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_off_by_default_and_filtered_by_level);
+    RUN_TEST(test_lines_are_batched_and_rate_limited);
+    RUN_TEST(test_rejected_publish_keeps_lines);
+    RUN_TEST(test_full_queue_drops_with_summary);
+    RUN_TEST(test_logging_while_publishing_is_not_streamed);
+    RUN_TEST(test_level_parsing_and_limits);
+    return UNITY_END();
+}
@@ -0,0 +1,166 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "utils/Logger.h"
+
+// ============================================================================
+// Test Logger - buffer circular y vaciado diferido
+// ============================================================================
+
+// UART simulado: acepta hasta `room` bytes por write()
+class CapturePrint : public Print {
+public:
+    char data[8192];
+    size_t length;
+    size_t room;
+
+    CapturePrint() : length(0), room((size_t)-1) { data[0] = '\0'; }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        if (size > room) size = room;
+        if (length + size >= sizeof(data)) size = sizeof(data) - 1 - length;
+        memcpy(data + length, buffer, size);
+        length += size;
+        data[length] = '\0';
+        return size;
+    }
+
+    int countLines() const {
+        int lines = 0;
+        for (size_t i = 0; i < length; i++) {
+            if (data[i] == '\n') lines++;
+        }
+        return lines;
+    }
+};
+
+static void drainAll(CapturePrint& out) {
+    while (Logger::pending() > 0 && Logger::drain(out, 64) > 0) {}
+}
+
+void setUp() {
+    NativeShim::setSerialQuiet(true);
+    Logger::setDeferred(false);
+    Logger::flush();
+    Logger::setDeferred(true);
+}
+
+void tearDown() {
+    Logger::setDeferred(false);
+    NativeShim::setSerialQuiet(false);
+}
+
+void test_deferred_lines_wait_for_drain() {
+    CapturePrint out;
+    LOG_INFO("Zona 1 activada");
+    LOG_WARN("Zona %d: %s", 2, "sin caudal");
+    TEST_ASSERT_EQUAL(strlen("[INFO] Zona 1 activada\r\n[WARN] Zona 2: sin caudal\r\n"), Logger::pending());
+    TEST_ASSERT_EQUAL(0, out.length);
+
+    // Con la FIFO casi llena sale solo lo que entra
+    TEST_ASSERT_EQUAL(10, Logger::drain(out, 10));
+    TEST_ASSERT_EQUAL_STRING("[INFO] Zon", out.data);
+    drainAll(out);
+    TEST_ASSERT_EQUAL_STRING("[INFO] Zona 1 activada\r\n[WARN] Zona 2: sin caudal\r\n", out.data);
+    TEST_ASSERT_EQUAL(0, Logger::pending());
+}
+
+void test_order_kept_across_wraparound() {
+    CapturePrint out;
+    char expected[64];
+    // Varias vueltas al buffer, vaciando de a poco y con escrituras cortas
+    for (int i = 0; i < 200; i++) {
+        LOG_INFO("linea %03d", i);
+        out.room = 7;
+        for (int k = 0; k < 3; k++) Logger::drain(out, 16);
+        out.room = (size_t)-1;
+    }
+    drainAll(out);
+    TEST_ASSERT_EQUAL(200, out.countLines());
+    TEST_ASSERT_EQUAL(0, Logger::getDropped());
+    const char* cursor = out.data;
+    for (int i = 0; i < 200; i++) {
+        snprintf(expected, sizeof(expected), "[INFO] linea %03d\r\n", i);
+        TEST_ASSERT_EQUAL(0, strncmp(cursor, expected, strlen(expected)));
+        cursor += strlen(expected);
+    }
+}
+
+void test_full_buffer_drops_newest_and_reports() {
+    CapturePrint out;
+    uint32_t droppedBefore = Logger::getDropped();
+    int accepted = 0;
+    for (int i = 0; i < 200; i++) {
+        size_t before = Logger::pending();
+        LOG_INFO("riego %03d en curso", i);
+        if (Logger::pending() > before) accepted++;
+    }
+    uint32_t lost = Logger::getDropped() - droppedBefore;
+    TEST_ASSERT_TRUE(lost > 0);
+    TEST_ASSERT_EQUAL(200, accepted + (int)lost);
+    TEST_ASSERT_TRUE(Logger::pending() < LOG_BUFFER_SIZE);
+
+    drainAll(out);
+    // Las primeras líneas se conservan, la última es el aviso
+    TEST_ASSERT_EQUAL(0, strncmp(out.data, "[INFO] riego 000 en curso\r\n", 27));
+    char notice[80];
+    snprintf(notice, sizeof(notice), "[WARN] Log: %lu lineas descartadas (buffer lleno)\r\n", (unsigned long)lost);
+    TEST_ASSERT_EQUAL_STRING(notice, out.data + out.length - strlen(notice));
+    TEST_ASSERT_EQUAL(accepted + 1, out.countLines());
+
+    // El aviso sale una sola vez
+    CapturePrint again;
+    drainAll(again);
+    TEST_ASSERT_EQUAL(0, again.length);
+}
+
+void test_long_line_truncated_with_crlf() {
+    CapturePrint out;
+    char message[400];
+    memset(message, 'x', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+    LOG_WARN("%s", message);
+    Logger::logf(LOG_LEVEL_ERROR, "%s", message);
+    drainAll(out);
+    TEST_ASSERT_EQUAL(2, out.countLines());
+    TEST_ASSERT_EQUAL(2 * (LOG_LINE_MAX - 1), out.length);
+    TEST_ASSERT_EQUAL('\r', out.data[LOG_LINE_MAX - 3]);
+    TEST_ASSERT_EQUAL('\n', out.data[LOG_LINE_MAX - 2]);
+    TEST_ASSERT_EQUAL(0, strncmp("[ERROR] xxx", out.data + LOG_LINE_MAX - 1, 11));
+}
+
+static int evaluations = 0;
+
+static int countedArgument() {
+    return ++evaluations;
+}
+
+// Un nivel deshabilitado no llega al buffer ni evalúa sus argumentos
+void test_filtered_level_is_stripped() {
+    evaluations = 0;
+    LOG_DEBUG("zona %d", countedArgument());
+    Logger::logf(LOG_LEVEL_DEBUG, "zona %d", 3);
+    TEST_ASSERT_EQUAL(LOG_LEVEL >= LOG_LEVEL_DEBUG, Logger::pending() > 0);
+    TEST_ASSERT_EQUAL(LOG_LEVEL >= LOG_LEVEL_DEBUG ? 1 : 0, evaluations);
+
+    LOG_ERROR("zona %d", countedArgument());
+    TEST_ASSERT_EQUAL(LOG_LEVEL >= LOG_LEVEL_DEBUG ? 2 : 1, evaluations);
+}
+
+void test_immediate_mode_writes_through() {
+    Logger::setDeferred(false);
+    LOG_INFO("arranque");
+    TEST_ASSERT_EQUAL(0, Logger::pending());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_deferred_lines_wait_for_drain);
+    RUN_TEST(test_order_kept_across_wraparound);
+    RUN_TEST(test_full_buffer_drops_newest_and_reports);
+    RUN_TEST(test_long_line_truncated_with_crlf);
+    RUN_TEST(test_filtered_level_is_stripped);
+    RUN_TEST(test_immediate_mode_writes_through);
+    return UNITY_END();
+}
@@ -0,0 +1,170 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "utils/LoopProfiler.h"
+
+// ============================================================================
+// Test LoopProfiler - cubetas, percentiles, marcas y jitter del loop
+// ============================================================================
+// Los tiempos se pasan explícitos (microsegundos): no depende del reloj.
+
+static LoopProfiler* profiler = nullptr;
+
+// Print que junta la salida del reporte serial
+class CapturePrint : public Print {
+public:
+    String text;
+    size_t write(uint8_t c) override {
+        text += (char)c;
+        return 1;
+    }
+};
+
+void setUp() {
+    profiler = new LoopProfiler();
+}
+
+void tearDown() {
+    delete profiler;
+    profiler = nullptr;
+}
+
+void test_buckets_are_contiguous_half_octaves() {
+    TEST_ASSERT_EQUAL(0, LoopProfiler::bucketOf(0));
+    TEST_ASSERT_EQUAL(1, LoopProfiler::bucketOf(1));
+    TEST_ASSERT_EQUAL(3, LoopProfiler::bucketOf(3));
+    TEST_ASSERT_EQUAL(4, LoopProfiler::bucketOf(5));
+    TEST_ASSERT_EQUAL(5, LoopProfiler::bucketOf(6));
+    TEST_ASSERT_EQUAL(13, LoopProfiler::bucketOf(100));      // [96, 127]
+    TEST_ASSERT_EQUAL(LOOP_PROFILER_BUCKETS - 1, LoopProfiler::bucketOf(UINT32_MAX));
+
+    for (uint8_t i = 0; i + 1 < LOOP_PROFILER_BUCKETS; i++) {
+        TEST_ASSERT_EQUAL(i, LoopProfiler::bucketOf(LoopProfiler::bucketLower(i)));
+        TEST_ASSERT_EQUAL(i, LoopProfiler::bucketOf(LoopProfiler::bucketUpper(i)));
+        TEST_ASSERT_EQUAL(LoopProfiler::bucketUpper(i) + 1, LoopProfiler::bucketLower(i + 1));
+    }
+    // La última cubeta empieza por encima de POWER_SAVE_MAX_SLEEP_MS (período del loop)
+    TEST_ASSERT_TRUE(LoopProfiler::bucketLower(LOOP_PROFILER_BUCKETS - 1) > POWER_SAVE_MAX_SLEEP_MS * 1000UL);
+}
+
+// Cada marca se lleva el tiempo desde la anterior
+void test_marks_attribute_time_to_channels() {
+    profiler->startLoop(1000);
+    profiler->mark(PROF_WIFI, 1300);
+    profiler->mark(PROF_MQTT, 6300);
+    profiler->mark(PROF_MAIN, 6400);
+    TEST_ASSERT_FALSE(profiler->endLoop(6500, LOOP_DELAY_MS));
+
+    ProfileSummary summary;
+    profiler->summarize(PROF_WIFI, summary);
+    TEST_ASSERT_EQUAL(1, summary.count);
+    TEST_ASSERT_EQUAL(300, summary.minUs);
+    TEST_ASSERT_EQUAL(300, summary.p50Us);
+    TEST_ASSERT_EQUAL(300, summary.p99Us);
+    TEST_ASSERT_EQUAL(300, summary.maxUs);
+    profiler->summarize(PROF_MQTT, summary);
+    TEST_ASSERT_EQUAL(5000, summary.maxUs);
+    profiler->summarize(PROF_LOOP_BUSY, summary);
+    TEST_ASSERT_EQUAL(5500, summary.maxUs);
+    profiler->summarize(PROF_AGENDA, summary);
+    TEST_ASSERT_EQUAL(0, summary.count);
+
+    TEST_ASSERT_EQUAL(PROF_MQTT, profiler->getSlowestChannel());
+    TEST_ASSERT_EQUAL(5000, profiler->getSlowestUs());
+}
+
+void test_percentiles_from_buckets() {
+    for (int i = 0; i < 980; i++) profiler->record(PROF_AGENDA, 100);
+    for (int i = 0; i < 20; i++) profiler->record(PROF_AGENDA, 5000);
+
+    ProfileSummary summary;
+    profiler->summarize(PROF_AGENDA, summary);
+    TEST_ASSERT_EQUAL(1000, summary.count);
+    TEST_ASSERT_EQUAL(100, summary.minUs);
+    TEST_ASSERT_EQUAL(127, summary.p50Us);    // Cota superior de [96, 127]
+    TEST_ASSERT_EQUAL(5000, summary.p99Us);   // Acotado al máximo
+    TEST_ASSERT_EQUAL(5000, summary.maxUs);
+
+    // Muestras en 0 us: el percentil 0 es válido
+    profiler->reset(0);
+    for (int i = 0; i < 10; i++) profiler->record(PROF_OTA, 0);
+    profiler->summarize(PROF_OTA, summary);
+    TEST_ASSERT_EQUAL(0, summary.p50Us);
+    TEST_ASSERT_EQUAL(0, summary.p99Us);
+}
+
+// Período entre vueltas y retraso al despertar respecto del sueño planificado
+void test_period_and_wake_lateness() {
+    profiler->startLoop(0);
+    profiler->endLoop(2000, 100);
+    profiler->startLoop(103000);      // Durmió 101 ms de 100 planificados
+    profiler->endLoop(103500, 100);
+    profiler->startLoop(203500);      // Justo a tiempo
+
+    ProfileSummary summary;
+    profiler->summarize(PROF_LOOP_PERIOD, summary);
+    TEST_ASSERT_EQUAL(2, summary.count);
+    TEST_ASSERT_EQUAL(100500, summary.minUs);
+    TEST_ASSERT_EQUAL(103000, summary.maxUs);
+    profiler->summarize(PROF_LOOP_LATE, summary);
+    TEST_ASSERT_EQUAL(2, summary.count);
+    TEST_ASSERT_EQUAL(0, summary.minUs);
+    TEST_ASSERT_EQUAL(1000, summary.maxUs);
+}
+
+void test_slow_loop_is_counted_with_culprit() {
+    profiler->startLoop(0);
+    profiler->mark(PROF_WIFI, 200);
+    profiler->mark(PROF_AGENDA, LOOP_PROFILER_SLOW_MS * 1000UL + 200);
+    TEST_ASSERT_TRUE(profiler->endLoop(LOOP_PROFILER_SLOW_MS * 1000UL + 300, LOOP_DELAY_MS));
+    TEST_ASSERT_EQUAL(1, profiler->getSlowLoops());
+    TEST_ASSERT_EQUAL(PROF_AGENDA, profiler->getSlowestChannel());
+
+    // La vuelta siguiente empieza sin culpable
+    profiler->startLoop(LOOP_PROFILER_SLOW_MS * 1000UL + 400);
+    profiler->mark(PROF_WIFI, LOOP_PROFILER_SLOW_MS * 1000UL + 500);
+    TEST_ASSERT_EQUAL(PROF_WIFI, profiler->getSlowestChannel());
+    TEST_ASSERT_EQUAL(100, profiler->getSlowestUs());
+
+    profiler->reset(5000);
+    TEST_ASSERT_EQUAL(0, profiler->getSlowLoops());
+    TEST_ASSERT_EQUAL(1000, profiler->getWindowMs(6000));
+}
+
+// Cubeta saturada: se divide el canal a la mitad en lugar de dar la vuelta
+void test_saturated_bucket_keeps_proportions() {
+    for (uint32_t i = 0; i < 70000; i++) profiler->record(PROF_RELAY, 50);
+    for (uint32_t i = 0; i < 200; i++) profiler->record(PROF_RELAY, 5000);
+
+    ProfileSummary summary;
+    profiler->summarize(PROF_RELAY, summary);
+    TEST_ASSERT_EQUAL(70200, summary.count);
+    // Tras la mitad quedan ~37000 en 50 us: 200 es menos del 1% y el p99 sigue
+    // ahí (dando la vuelta serían 4464 y el p99 saltaría a 5000)
+    TEST_ASSERT_EQUAL(LoopProfiler::bucketUpper(LoopProfiler::bucketOf(50)), summary.p99Us);
+    TEST_ASSERT_EQUAL(5000, summary.maxUs);
+}
+
+void test_serial_report_lists_used_channels() {
+    profiler->startLoop(0);
+    profiler->mark(PROF_MQTT, 1200);
+    profiler->endLoop(1500, LOOP_DELAY_MS);
+
+    CapturePrint out;
+    profiler->printReport(out, 60000);
+    TEST_ASSERT_NOT_NULL(strstr(out.text.c_str(), "ventana 60 s"));
+    TEST_ASSERT_NOT_NULL(strstr(out.text.c_str(), "mqtt"));
+    TEST_ASSERT_NOT_NULL(strstr(out.text.c_str(), "vuelta"));
+    TEST_ASSERT_NULL(strstr(out.text.c_str(), "agenda"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_buckets_are_contiguous_half_octaves);
+    RUN_TEST(test_marks_attribute_time_to_channels);
+    RUN_TEST(test_percentiles_from_buckets);
+    RUN_TEST(test_period_and_wake_lateness);
+    RUN_TEST(test_slow_loop_is_counted_with_culprit);
+    RUN_TEST(test_saturated_bucket_keeps_proportions);
+    RUN_TEST(test_serial_report_lists_used_channels);
+    return UNITY_END();
+}
@@ -0,0 +1,295 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "network/MqttConnector.h"
+
+// ============================================================================
+// Test MqttConnector - conexión por pasos contra un broker simulado
+// ============================================================================
+// El broker es un socket en loopback atendido desde el propio test (sin
+// hilos): el kernel completa el TCP contra el listen() y el test decide qué
+// hacer con el CONNECT (aceptar, rechazar, no responder o cortar).
+
+static int brokerFd = -1;
+static int peerFd = -1;
+static uint16_t brokerPort = 0;
+
+static void brokerListen() {
+    brokerFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    bind(brokerFd, (struct sockaddr*)&addr, sizeof(addr));
+    listen(brokerFd, 4);
+    socklen_t len = sizeof(addr);
+    getsockname(brokerFd, (struct sockaddr*)&addr, &len);
+    brokerPort = ntohs(addr.sin_port);
+}
+
+// Aceptar al cliente y leer el CONNECT completo (devuelve su longitud)
+static int brokerAcceptConnect(uint8_t* packet, size_t capacity) {
+    peerFd = accept(brokerFd, nullptr, nullptr);
+    if (peerFd < 0) return -1;
+    uint8_t header[2];
+    if (recv(peerFd, header, 2, MSG_WAITALL) != 2) return -1;
+    size_t remaining = header[1];
+    if (header[0] != 0x10 || remaining + 2 > capacity) return -1;
+    packet[0] = header[0];
+    packet[1] = header[1];
+    if (recv(peerFd, packet + 2, remaining, MSG_WAITALL) != (ssize_t)remaining) return -1;
+    return (int)remaining + 2;
+}
+
+static void brokerConnack(uint8_t returnCode) {
+    uint8_t connack[4] = {0x20, 0x02, 0x00, returnCode};
+    send(peerFd, connack, sizeof(connack), 0);
+}
+
+static void brokerClosePeer() {
+    if (peerFd >= 0) close(peerFd);
+    peerFd = -1;
+}
+
+// Esperar (en tiempo real) a que el cliente vea los bytes o el cierre
+static void waitForClient(int fd) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    poll(&pfd, 1, 200);
+}
+
+static uint32_t wallMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000UL + ts.tv_nsec / 1000000UL);
+}
+
+// Avanzar RESOLVE y TCP: deja el CONNECT enviado
+static void tickUntilConnack(MqttConnector& connector) {
+    connector.tick(millis());
+    TEST_ASSERT_EQUAL(MQTT_CONN_TCP, connector.getState());
+    connector.tick(millis());
+    TEST_ASSERT_EQUAL(MQTT_CONN_CONNACK, connector.getState());
+}
+
+void setUp() {
+    NativeShim::useFakeClock(1000);
+    NativeShim::setSerialQuiet(true);
+    WiFi.begin("native");
+    brokerListen();
+}
+
+void tearDown() {
+    brokerClosePeer();
+    if (brokerFd >= 0) close(brokerFd);
+    brokerFd = -1;
+    NativeShim::setSerialQuiet(false);
+}
+
+void test_connect_packet_bytes() {
+    uint8_t packet[64];
+    size_t length = MqttConnector::buildConnectPacket(packet, sizeof(packet), "n1", nullptr, nullptr, 60);
+    static const uint8_t EXPECTED[] = {
+        0x10, 14,                                  // CONNECT, longitud restante
+        0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04,      // MQTT 3.1.1
+        0x02, 0x00, 60,                            // Sesión limpia, keepalive
+        0x00, 0x02, 'n', '1'                       // Client ID
+    };
+    TEST_ASSERT_EQUAL(sizeof(EXPECTED), length);
+    TEST_ASSERT_EQUAL_MEMORY(EXPECTED, packet, sizeof(EXPECTED));
+
+    length = MqttConnector::buildConnectPacket(packet, sizeof(packet), "n1", "u", "pw", 60);
+    TEST_ASSERT_EQUAL(sizeof(EXPECTED) + 3 + 4, length);
+    TEST_ASSERT_EQUAL_HEX8(0xC2, packet[9]);     // Usuario + password + sesión limpia
+    TEST_ASSERT_EQUAL(sizeof(EXPECTED) + 3 + 4 - 2, packet[1]);
+
+    // No entra en el buffer: no se arma un paquete truncado
+    TEST_ASSERT_EQUAL(0, MqttConnector::buildConnectPacket(packet, 16, "n1", "u", "pw", 60));
+}
+
+void test_backoff_grows_with_jitter_and_cap() {
+    for (uint16_t attempt = 1; attempt <= 12; attempt++) {
+        uint32_t base = (uint32_t)MQTT_BACKOFF_MIN_MS << (attempt - 1);
+        if (base > MQTT_BACKOFF_MAX_MS) base = MQTT_BACKOFF_MAX_MS;
+        TEST_ASSERT_EQUAL_UINT32(base / 2, MqttConnector::backoffDelay(attempt, 0));
+        TEST_ASSERT_EQUAL_UINT32(base, MqttConnector::backoffDelay(attempt, base - base / 2));
+        uint32_t jittered = MqttConnector::backoffDelay(attempt, 0x12345678);
+        TEST_ASSERT_TRUE(jittered >= base / 2 && jittered <= base);
+    }
+    // Muchos fallos seguidos: nunca más que el máximo
+    TEST_ASSERT_EQUAL_UINT32(MQTT_BACKOFF_MAX_MS / 2, MqttConnector::backoffDelay(60000, 0));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(MQTT_BACKOFF_MAX_MS, MqttConnector::backoffDelay(60000, 0xFFFFFFFF));
+}
+
+void test_connack_handoff_replays_to_client() {
+    WiFiClient transport;
+    MqttConnector connector(transport);
+    connector.configure("127.0.0.1", brokerPort, "nodo-test", "", "", 60);
+    connector.begin(millis());
+    tickUntilConnack(connector);
+
+    uint8_t packet[64];
+    TEST_ASSERT_EQUAL(2 + 10 + 2 + 9, brokerAcceptConnect(packet, sizeof(packet)));
+    TEST_ASSERT_EQUAL_HEX8(0x02, packet[9]);     // Sin usuario: "" no se envía
+
+    // Sin CONNACK todavía: el tick no espera
+    TEST_ASSERT_EQUAL(MQTT_CONN_CONNACK, connector.tick(millis()));
+    TEST_ASSERT_EQUAL(0, connector.getMsUntilNextStep(millis()));
+
+    brokerConnack(0);
+    waitForClient(brokerFd);
+    usleep(20000);
+    TEST_ASSERT_EQUAL(MQTT_CONN_READY, connector.tick(millis()));
+    TEST_ASSERT_EQUAL(1, connector.connected());
+
+    // Secuencia de PubSubClient::connect(): CONNECT (se descarta) y CONNACK
+    uint8_t pubsubConnect[] = {0x10, 0x03, 0x00, 0x00, 0x00};
+    TEST_ASSERT_EQUAL(sizeof(pubsubConnect), connector.write(pubsubConnect, sizeof(pubsubConnect)));
+    TEST_ASSERT_EQUAL(4, connector.available());
+    TEST_ASSERT_EQUAL(0x20, connector.read());
+    TEST_ASSERT_EQUAL(0x02, connector.read());
+    TEST_ASSERT_EQUAL(0x00, connector.read());
+    TEST_ASSERT_EQUAL(0x00, connector.read());
+    TEST_ASSERT_EQUAL(MQTT_CONN_CONNECTED, connector.getState());
+    TEST_ASSERT_EQUAL(-1, connector.getMsUntilNextStep(millis()));
+
+    // Desde ahí el tráfico pasa directo: un PINGREQ llega al broker
+    uint8_t ping[] = {0xC0, 0x00};
+    TEST_ASSERT_EQUAL(2, connector.write(ping, 2));
+    uint8_t received[2];
+    TEST_ASSERT_EQUAL(2, recv(peerFd, received, 2, MSG_WAITALL));
+    TEST_ASSERT_EQUAL_MEMORY(ping, received, 2);
+
+    // El broker corta: PubSubClient llama stop() y se reintenta con backoff
+    brokerClosePeer();
+    usleep(20000);
+    TEST_ASSERT_EQUAL(0, connector.connected());
+    connector.stop();
+    TEST_ASSERT_EQUAL(MQTT_CONN_BACKOFF, connector.getState());
+    TEST_ASSERT_EQUAL(MQTT_CONN_ERR_CLOSED, connector.getLastError());
+    TEST_ASSERT_TRUE(connector.getBackoffMs() <= MQTT_BACKOFF_MIN_MS);
+}
+
+void test_hung_broker_times_out_without_blocking() {
+    WiFiClient transport;
+    MqttConnector connector(transport);
+    connector.configure("127.0.0.1", brokerPort, "nodo-test", nullptr, nullptr, 60);
+    connector.begin(millis());
+    tickUntilConnack(connector);
+    uint8_t packet[64];
+    TEST_ASSERT_TRUE(brokerAcceptConnect(packet, sizeof(packet)) > 0);
+
+    // El broker nunca responde: cada tick vuelve enseguida
+    uint32_t slowestTick = 0;
+    for (uint32_t elapsed = 0; elapsed < MQTT_CONNACK_TIMEOUT_MS; elapsed += 100) {
+        uint32_t start = wallMs();
+        TEST_ASSERT_EQUAL(MQTT_CONN_CONNACK, connector.tick(millis()));
+        uint32_t spent = wallMs() - start;
+        if (spent > slowestTick) slowestTick = spent;
+        NativeShim::advanceMillis(100);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(20, slowestTick);
+
+    TEST_ASSERT_EQUAL(MQTT_CONN_BACKOFF, connector.tick(millis()));
+    TEST_ASSERT_EQUAL(MQTT_CONN_ERR_TIMEOUT, connector.getLastError());
+    TEST_ASSERT_EQUAL(1, connector.getFailedAttempts());
+    TEST_ASSERT_EQUAL(0, transport.connected());
+}
+
+void test_dropped_and_refused_connections_back_off() {
+    WiFiClient transport;
+    MqttConnector connector(transport);
+    connector.configure("127.0.0.1", brokerPort, "nodo-test", nullptr, nullptr, 60);
+    connector.begin(millis());
+
+    // 1) El broker corta después del CONNECT
+    tickUntilConnack(connector);
+    uint8_t packet[64];
+    TEST_ASSERT_TRUE(brokerAcceptConnect(packet, sizeof(packet)) > 0);
+    brokerClosePeer();
+    usleep(20000);
+    TEST_ASSERT_EQUAL(MQTT_CONN_BACKOFF, connector.tick(millis()));
+    TEST_ASSERT_EQUAL(MQTT_CONN_ERR_CLOSED, connector.getLastError());
+
+    // El backoff se respeta: no hay intento antes de que venza
+    uint32_t wait = connector.getBackoffMs();
+    TEST_ASSERT_EQUAL_INT32((int32_t)wait, connector.getMsUntilNextStep(millis()));
+    NativeShim::advanceMillis(wait - 1);
+    TEST_ASSERT_EQUAL(MQTT_CONN_BACKOFF, connector.tick(millis()));
+    NativeShim::advanceMillis(1);
+    TEST_ASSERT_EQUAL(MQTT_CONN_RESOLVE, connector.tick(millis()));
+
+    // 2) CONNACK con rechazo (código 5: no autorizado)
+    tickUntilConnack(connector);
+    TEST_ASSERT_TRUE(brokerAcceptConnect(packet, sizeof(packet)) > 0);
+    brokerConnack(5);
+    usleep(20000);
+    TEST_ASSERT_EQUAL(MQTT_CONN_BACKOFF, connector.tick(millis()));
+    TEST_ASSERT_EQUAL(MQTT_CONN_ERR_REFUSED, connector.getLastError());
+    TEST_ASSERT_EQUAL(5, connector.getRefusedCode());
+    TEST_ASSERT_EQUAL(2, connector.getFailedAttempts());
+
+    // 3) Broker caído (puerto cerrado): falla el TCP y el backoff crece
+    brokerClosePeer();
+    close(brokerFd);
+    brokerFd = -1;
+    uint32_t previousMax = 2 * MQTT_BACKOFF_MIN_MS;
+    for (uint16_t attempt = 3; attempt <= 8; attempt++) {
+        NativeShim::advanceMillis(connector.getBackoffMs());
+        TEST_ASSERT_EQUAL(MQTT_CONN_RESOLVE, connector.tick(millis()));
+        TEST_ASSERT_EQUAL(MQTT_CONN_TCP, connector.tick(millis()));
+        TEST_ASSERT_EQUAL(MQTT_CONN_BACKOFF, connector.tick(millis()));
+        TEST_ASSERT_EQUAL(MQTT_CONN_ERR_TCP, connector.getLastError());
+        TEST_ASSERT_EQUAL(attempt, connector.getFailedAttempts());
+        uint32_t maxDelay = previousMax * 2 > MQTT_BACKOFF_MAX_MS ? MQTT_BACKOFF_MAX_MS : previousMax * 2;
+        TEST_ASSERT_TRUE(connector.getBackoffMs() >= maxDelay / 2 && connector.getBackoffMs() <= maxDelay);
+        previousMax = maxDelay;
+    }
+
+    // retryNow descarta el backoff en curso
+    connector.retryNow(millis());
+    TEST_ASSERT_EQUAL(MQTT_CONN_RESOLVE, connector.getState());
+    TEST_ASSERT_EQUAL(0, connector.getFailedAttempts());
+}
+
+void test_no_attempt_without_wifi() {
+    WiFiClient transport;
+    MqttConnector connector(transport);
+    connector.configure("127.0.0.1", brokerPort, "nodo-test", nullptr, nullptr, 60);
+    WiFi.disconnect();
+
+    connector.begin(millis());
+    TEST_ASSERT_EQUAL(MQTT_CONN_BACKOFF, connector.tick(millis()));
+    TEST_ASSERT_EQUAL(MQTT_CONN_ERR_NO_WIFI, connector.getLastError());
+    TEST_ASSERT_EQUAL(0, connector.getFailedAttempts());
+    TEST_ASSERT_EQUAL_UINT32(MQTT_BACKOFF_MIN_MS, connector.getBackoffMs());
+
+    // Vuelve el WiFi: el siguiente intento sale al vencer la espera mínima
+    WiFi.begin("native");
+    NativeShim::advanceMillis(MQTT_BACKOFF_MIN_MS);
+    TEST_ASSERT_EQUAL(MQTT_CONN_RESOLVE, connector.tick(millis()));
+    tickUntilConnack(connector);
+
+    connector.end();
+    TEST_ASSERT_EQUAL(MQTT_CONN_IDLE, connector.tick(millis()));
+    TEST_ASSERT_EQUAL(-1, connector.getMsUntilNextStep(millis()));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_connect_packet_bytes);
+    RUN_TEST(test_backoff_grows_with_jitter_and_cap);
+    RUN_TEST(test_connack_handoff_replays_to_client);
+    RUN_TEST(test_hung_broker_times_out_without_blocking);
+    RUN_TEST(test_dropped_and_refused_connections_back_off);
+    RUN_TEST(test_no_attempt_without_wifi);
+    return UNITY_END();
+}
@@ -0,0 +1,206 @@
+#include <unity.h>
+#include <string.h>
+#include "utils/JsonWriter.h"
+#include "config/Config.h"
+#include "network/MqttPayloads.h"
+
+// ============================================================================
+// Test payloads MQTT - JsonWriter y esquemas fijos
+// ============================================================================
+// Los payloads esperados siguen el orden de campos de la serialización
+// anterior con ArduinoJson (contrato con el backend).
+
+static char buffer[512];
+
+void setUp() {
+    memset(buffer, 0x55, sizeof(buffer));
+}
+
+void tearDown() {}
+
+// ---------- JsonWriter ----------
+
+void test_writer_empty_object() {
+    JsonWriter out(buffer, sizeof(buffer));
+    out.begin();
+    out.end();
+    TEST_ASSERT_EQUAL_STRING("{}", out.c_str());
+    TEST_ASSERT_EQUAL(2, out.length());
+    TEST_ASSERT_FALSE(out.overflowed());
+}
+
+void test_writer_integer_limits() {
+    JsonWriter out(buffer, sizeof(buffer));
+    out.begin();
+    out.fieldInt("a", 0);
+    out.fieldInt("b", -42);
+    out.fieldInt("c", INT32_MIN);
+    out.fieldUInt("d", UINT32_MAX);
+    out.end();
+    TEST_ASSERT_EQUAL_STRING("{\"a\":0,\"b\":-42,\"c\":-2147483648,\"d\":4294967295}", out.c_str());
+}
+
+void test_writer_escapes_strings() {
+    JsonWriter out(buffer, sizeof(buffer));
+    out.begin();
+    out.fieldString("s", "a\"b\\c\nd\x01");
+    out.end();
+    TEST_ASSERT_EQUAL_STRING("{\"s\":\"a\\\"b\\\\c\\nd\\u0001\"}", out.c_str());
+}
+
+void test_writer_overflow_is_reported_and_terminated() {
+    char small[16];
+    JsonWriter out(small, sizeof(small));
+    out.begin();
+    out.fieldString("detalles", "texto demasiado largo");
+    out.end();
+    TEST_ASSERT_TRUE(out.overflowed());
+    TEST_ASSERT_TRUE(strlen(out.c_str()) < sizeof(small));
+
+    // begin() reinicia el estado: el mismo buffer se reutiliza
+    out.begin();
+    out.fieldInt("v", 1);
+    out.end();
+    TEST_ASSERT_FALSE(out.overflowed());
+    TEST_ASSERT_EQUAL_STRING("{\"v\":1}", out.c_str());
+}
+
+void test_writer_exact_fit() {
+    char exact[8];  // {"v":1} + '\0'
+    JsonWriter out(exact, sizeof(exact));
+    out.begin();
+    out.fieldInt("v", 1);
+    out.end();
+    TEST_ASSERT_FALSE(out.overflowed());
+    TEST_ASSERT_EQUAL_STRING("{\"v\":1}", out.c_str());
+}
+
+void test_writer_uint_array() {
+    static const uint16_t values[] = {0, 7, 65535};
+    JsonWriter out(buffer, sizeof(buffer));
+    out.begin();
+    out.fieldUIntArray("v", values, 3);
+    out.fieldUIntArray("e", values, 0);
+    out.end();
+    TEST_ASSERT_EQUAL_STRING("{\"v\":[0,7,65535],\"e\":[]}", out.c_str());
+}
+
+// ---------- MqttPayloads ----------
+
+void test_zone_status_payload() {
+    JsonWriter out(buffer, sizeof(buffer));
+    MqttPayloads::zoneStatus(out, true, 275);
+    TEST_ASSERT_EQUAL_STRING("{\"activa\":true,\"tiempoRestante\":275}", out.c_str());
+    MqttPayloads::zoneStatus(out, false, 0);
+    TEST_ASSERT_EQUAL_STRING("{\"activa\":false,\"tiempoRestante\":0}", out.c_str());
+}
+
+void test_zones_status_payload() {
+    uint16_t restante[MAX_ZONES] = {0, 275, 0, 0, 0, 0, 0, 7200};
+    JsonWriter out(buffer, sizeof(buffer));
+    MqttPayloads::zonesStatus(out, 0x82, restante, MAX_ZONES);
+    TEST_ASSERT_EQUAL_STRING("{\"activas\":130,\"restante\":[0,275,0,0,0,0,0,7200]}", out.c_str());
+
+    // Peor caso: todas las zonas activas con duración máxima entra en el buffer de publicación
+    char publishBuffer[MQTT_PUBLISH_BUFFER_SIZE];
+    for (int i = 0; i < MAX_ZONES; i++) restante[i] = MAX_RIEGO_DURATION;
+    JsonWriter full(publishBuffer, sizeof(publishBuffer));
+    MqttPayloads::zonesStatus(full, 0xFF, restante, MAX_ZONES);
+    TEST_ASSERT_FALSE(full.overflowed());
+}
+
+void test_riego_evento_inicio_agenda() {
+    JsonWriter out(buffer, sizeof(buffer));
+    MqttPayloads::riegoEvento(out, 3, RIEGO_INICIO, ORIGEN_AGENDA, 1735415280UL, 600, 12, 41);
+    TEST_ASSERT_EQUAL_STRING("{\"zona\":3,\"evento\":\"inicio\",\"timestamp\":1735415280,"
+                             "\"origen\":\"agenda\",\"duracionProgramada\":600,\"versionAgenda\":12,\"seq\":41}",
+                             out.c_str());
+}
+
+void test_riego_evento_fin_manual() {
+    JsonWriter out(buffer, sizeof(buffer));
+    MqttPayloads::riegoEvento(out, 1, RIEGO_FIN, ORIGEN_MANUAL, 90, 45, 0, 42);
+    TEST_ASSERT_EQUAL_STRING("{\"zona\":1,\"evento\":\"fin\",\"timestamp\":90,"
+                             "\"origen\":\"manual\",\"duracionReal\":45,\"versionAgenda\":null,\"seq\":42}",
+                             out.c_str());
+}
+
+// Evento publicado directo (fuera del diario): sin seq
+void test_riego_evento_without_seq() {
+    JsonWriter out(buffer, sizeof(buffer));
+    MqttPayloads::riegoEvento(out, 2, RIEGO_FIN, ORIGEN_AGENDA, 0, 300, 5, 0);
+    TEST_ASSERT_EQUAL_STRING("{\"zona\":2,\"evento\":\"fin\",\"timestamp\":0,"
+                             "\"origen\":\"agenda\",\"duracionReal\":300,\"versionAgenda\":5}",
+                             out.c_str());
+}
+
+void test_system_event_payload() {
+    JsonWriter out(buffer, sizeof(buffer));
+    MqttPayloads::systemEvent(out, SYS_AGENDA_SYNC_OK, 100, "Agendas cargadas: 9 total, 9 activas", 9, 38256);
+    TEST_ASSERT_EQUAL_STRING("{\"tipo\":\"agenda_sync_ok\",\"timestamp\":100,"
+                             "\"detalles\":\"Agendas cargadas: 9 total, 9 activas\","
+                             "\"agendasCargadas\":9,\"memoriaLibre\":38256}",
+                             out.c_str());
+
+    MqttPayloads::systemEvent(out, SYS_AGENDA_DELTA_ERROR, 5, "x", -1, 1);
+    TEST_ASSERT_EQUAL_STRING("{\"tipo\":\"agenda_delta_error\",\"timestamp\":5,"
+                             "\"detalles\":\"x\",\"memoriaLibre\":1}",
+                             out.c_str());
+}
+
+void test_system_event_names_match_contract() {
+    TEST_ASSERT_EQUAL_STRING("agenda_initial_load_ok", systemEventName(SYS_AGENDA_INITIAL_LOAD_OK));
+    TEST_ASSERT_EQUAL_STRING("agenda_parse_error", systemEventName(SYS_AGENDA_PARSE_ERROR));
+    TEST_ASSERT_EQUAL_STRING("agenda_format_error", systemEventName(SYS_AGENDA_FORMAT_ERROR));
+    TEST_ASSERT_EQUAL_STRING("agenda_storage_error", systemEventName(SYS_AGENDA_STORAGE_ERROR));
+    TEST_ASSERT_EQUAL_STRING("agenda_load_error", systemEventName(SYS_AGENDA_LOAD_ERROR));
+    TEST_ASSERT_EQUAL_STRING("agenda_fetch_warning", systemEventName(SYS_AGENDA_FETCH_WARNING));
+}
+
+void test_agenda_version_payload() {
+    JsonWriter out(buffer, sizeof(buffer));
+    MqttPayloads::agendaVersion(out, 17);
+    TEST_ASSERT_EQUAL_STRING("{\"version\":17}", out.c_str());
+}
+
+void test_loop_profile_payload() {
+    LoopProfiler profiler;
+    profiler.startLoop(0);
+    profiler.mark(PROF_WIFI, 300);
+    profiler.endLoop(400, LOOP_DELAY_MS);
+
+    JsonWriter out(buffer, sizeof(buffer));
+    MqttPayloads::loopProfile(out, profiler, 60000);
+    TEST_ASSERT_EQUAL_STRING("{\"ventanaMs\":60000,\"lentas\":0,"
+                             "\"wifi\":[1,300,300,300,300],\"vuelta\":[1,400,400,400,400]}",
+                             out.c_str());
+
+    // Peor caso realista (todos los canales, una hora sin publicar) entra en LOOP_PROFILER_PAYLOAD_MAX
+    for (uint8_t i = 0; i < PROF_CHANNELS; i++) {
+        for (uint32_t n = 0; n < 36000; n++) profiler.record(i, 1 + n * 83);
+    }
+    char profileBuffer[LOOP_PROFILER_PAYLOAD_MAX];
+    JsonWriter full(profileBuffer, sizeof(profileBuffer));
+    MqttPayloads::loopProfile(full, profiler, 3600000);
+    TEST_ASSERT_FALSE(full.overflowed());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_writer_empty_object);
+    RUN_TEST(test_writer_integer_limits);
+    RUN_TEST(test_writer_escapes_strings);
+    RUN_TEST(test_writer_overflow_is_reported_and_terminated);
+    RUN_TEST(test_writer_exact_fit);
+    RUN_TEST(test_writer_uint_array);
+    RUN_TEST(test_zone_status_payload);
+    RUN_TEST(test_zones_status_payload);
+    RUN_TEST(test_riego_evento_inicio_agenda);
+    RUN_TEST(test_riego_evento_fin_manual);
+    RUN_TEST(test_riego_evento_without_seq);
+    RUN_TEST(test_system_event_payload);
+    RUN_TEST(test_system_event_names_match_contract);
+    RUN_TEST(test_agenda_version_payload);
+    RUN_TEST(test_loop_profile_payload);
+    return UNITY_END();
+}
@@ -0,0 +1,183 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <LittleFS.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "storage/SPIFFSManager.h"
+#include "hardware/RelayController.h"
+#include "network/TimeSync.h"
+
+// ============================================================================
+// Test shim nativo - módulos del firmware contra el core simulado
+// ============================================================================
+
+// Lunes 2024-01-01 12:00:00 UTC
+static const uint32_t EPOCH_UTC = 1704110400UL;
+
+static int gpioWrites = 0;
+static int finEvents = 0;
+
+static void countGpioWrite(uint8_t pin, uint8_t value, unsigned long atMillis) {
+    (void)pin; (void)value; (void)atMillis;
+    gpioWrites++;
+}
+
+static void countRiegoEvent(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion, int versionAgenda) {
+    (void)zona; (void)origen; (void)duracion; (void)versionAgenda;
+    if (evento == RIEGO_FIN) finEvents++;
+}
+
+void setUp() {
+    NativeShim::useFakeClock(1000);
+    NativeShim::setSerialQuiet(true);
+    NativeShim::setNtpReachable(true);
+    NativeShim::setGpioWriteHook(nullptr);
+}
+
+void tearDown() {
+    NativeShim::setSerialQuiet(false);
+}
+
+void test_string_concat_and_conversion() {
+    uint8_t count = 3;
+    String s = String("Agendas: ") + count + " de " + 32;
+    TEST_ASSERT_EQUAL_STRING("Agendas: 3 de 32", s.c_str());
+    TEST_ASSERT_EQUAL(42, String("  42 ").substring(2).toInt());
+    String topic = "riego/n/cmd/zona/3";
+    TEST_ASSERT_EQUAL(3, topic.substring(topic.lastIndexOf('/') + 1).toInt());
+    String t = " hola ";
+    t.trim();
+    TEST_ASSERT_TRUE(t == "hola");
+}
+
+void test_littlefs_directory_backed() {
+    char root[] = "/tmp/native_fs_XXXXXX";
+    TEST_ASSERT_NOT_NULL(mkdtemp(root));
+    NativeShim::setFsRoot(root);
+    
+    SPIFFSManager storage;
+    TEST_ASSERT_TRUE(storage.init());
+    TEST_ASSERT_FALSE(storage.exists("/agenda.json"));
+    TEST_ASSERT_TRUE(storage.writeFile("/agenda.json", "{\"agendas\":[]}"));
+    TEST_ASSERT_TRUE(storage.appendFile("/agenda.json", "\n"));
+    TEST_ASSERT_EQUAL_STRING("{\"agendas\":[]}\n", storage.readFile("/agenda.json").c_str());
+    TEST_ASSERT_TRUE(storage.getUsedBytes() > 0);
+    
+    // El archivo existe en el directorio del host
+    String hostFile = String(root) + "/agenda.json";
+    TEST_ASSERT_EQUAL(0, access(hostFile.c_str(), F_OK));
+    
+    TEST_ASSERT_TRUE(LittleFS.rename("/agenda.json", "/sub/agenda.json"));
+    Dir dir = LittleFS.openDir("/sub");
+    TEST_ASSERT_TRUE(dir.next());
+    TEST_ASSERT_EQUAL_STRING("agenda.json", dir.fileName().c_str());
+    TEST_ASSERT_TRUE(storage.deleteFile("/sub/agenda.json"));
+    TEST_ASSERT_TRUE(storage.format());
+}
+
+void test_relay_timer_with_fake_clock() {
+    gpioWrites = 0;
+    finEvents = 0;
+    NativeShim::setGpioWriteHook(countGpioWrite);
+    
+    RelayController relays;
+    relays.init();
+    relays.setRiegoEventCallback(countRiegoEvent);
+    relays.loop();
+    
+    // El pin se conmuta en la vuelta siguiente (OutputScheduler)
+    relays.turnOn(1, 5, ORIGEN_MANUAL, 0);
+    TEST_ASSERT_EQUAL(RELAY_OFF, NativeShim::getPinLevel(RELAY_PINS[0]));
+    relays.loop();
+    TEST_ASSERT_EQUAL(RELAY_ON, NativeShim::getPinLevel(RELAY_PINS[0]));
+    
+    for (int i = 0; i < 4; i++) {
+        NativeShim::advanceMillis(1000);
+        relays.loop();
+    }
+    TEST_ASSERT_TRUE(relays.isActive(1));
+    TEST_ASSERT_EQUAL(1, relays.getRemainingTime(1));
+    
+    NativeShim::advanceMillis(1000);
+    relays.loop();
+    TEST_ASSERT_FALSE(relays.isActive(1));
+    relays.loop();
+    TEST_ASSERT_EQUAL(RELAY_OFF, NativeShim::getPinLevel(RELAY_PINS[0]));
+    TEST_ASSERT_EQUAL(1, finEvents);
+    TEST_ASSERT_EQUAL(MAX_ZONES + 2, gpioWrites);
+}
+
+void test_timesync_with_fake_ntp() {
+    NativeShim::setUtcEpoch(EPOCH_UTC);
+    
+    TimeSync timeSync;
+    timeSync.init();
+    TEST_ASSERT_TRUE(timeSync.sync());
+    TEST_ASSERT_EQUAL_UINT32(EPOCH_UTC + GMT_OFFSET_SEC, (uint32_t)timeSync.getEpoch());
+    TEST_ASSERT_EQUAL(9, timeSync.getHour());
+    
+    NativeShim::advanceMillis(90000);
+    TEST_ASSERT_EQUAL_UINT32(EPOCH_UTC + GMT_OFFSET_SEC + 90, (uint32_t)timeSync.getEpoch());
+    
+    // NTP caído: sync() reintenta con delay(), que avanza el reloj simulado
+    NativeShim::setNtpReachable(false);
+    unsigned long before = millis();
+    TimeSync offline;
+    offline.init();
+    TEST_ASSERT_FALSE(offline.sync());
+    TEST_ASSERT_EQUAL_UINT32(5000, millis() - before);
+    TEST_ASSERT_FALSE(offline.isSynchronized());
+}
+
+void test_wificlient_loopback() {
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT_TRUE(server >= 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    TEST_ASSERT_EQUAL(0, bind(server, (struct sockaddr*)&addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL(0, listen(server, 1));
+    socklen_t len = sizeof(addr);
+    getsockname(server, (struct sockaddr*)&addr, &len);
+    uint16_t port = ntohs(addr.sin_port);
+    
+    WiFiClient client;
+    WiFi.disconnect();
+    TEST_ASSERT_EQUAL(0, client.connect("127.0.0.1", port));  // Sin WiFi no conecta
+    
+    WiFi.begin("native");
+    TEST_ASSERT_EQUAL(1, client.connect("127.0.0.1", port));
+    int peer = accept(server, nullptr, nullptr);
+    TEST_ASSERT_TRUE(peer >= 0);
+    
+    TEST_ASSERT_EQUAL(4, client.write((const uint8_t*)"ping", 4));
+    char buf[8] = {0};
+    TEST_ASSERT_EQUAL(4, recv(peer, buf, 4, MSG_WAITALL));
+    TEST_ASSERT_EQUAL_STRING("ping", buf);
+    
+    send(peer, "pong", 4, 0);
+    while (client.available() < 4) {}
+    uint8_t in[4];
+    TEST_ASSERT_EQUAL(4, client.read(in, 4));
+    TEST_ASSERT_EQUAL_MEMORY("pong", in, 4);
+    
+    close(peer);
+    while (client.connected()) {}
+    client.stop();
+    close(server);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_string_concat_and_conversion);
+    RUN_TEST(test_littlefs_directory_backed);
+    RUN_TEST(test_relay_timer_with_fake_clock);
+    RUN_TEST(test_timesync_with_fake_ntp);
+    RUN_TEST(test_wificlient_loopback);
+    return UNITY_END();
+}
@@ -0,0 +1,302 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include "hardware/RelayController.h"
+#include "hardware/OutputBackend.h"
+#include "hardware/ShiftRegisterOutputBackend.h"
+#include "hardware/I2cExpanderOutputBackend.h"
+
+// ============================================================================
+// Test OutputBackend - escrituras por tanda en GPIO, 74HC595 e I2C
+// ============================================================================
+
+// Backend en memoria: cuenta las escrituras y guarda la última
+class MockOutputBackend : public OutputBackend {
+public:
+    uint32_t lastLevels;
+    uint32_t lastChanged;
+    int writes;
+    bool fail;
+
+    explicit MockOutputBackend(uint8_t channels)
+        : OutputBackend(channels), lastLevels(0), lastChanged(0), writes(0), fail(false) {}
+
+    const char* getName() const override { return "mock"; }
+
+protected:
+    bool beginBus() override { return true; }
+
+    bool write(uint32_t levels, uint32_t changed) override {
+        writes++;
+        lastLevels = levels;
+        lastChanged = changed;
+        return !fail;
+    }
+};
+
+// Nivel de salida de un canal encendido/apagado en el registro o expansor
+static bool onLevel(uint32_t levels, int channel) {
+    return ((levels >> channel) & 0x01) == (RELAY_ON == HIGH ? 1u : 0u);
+}
+
+// ---- Traza I2C ----
+struct I2cWrite {
+    uint8_t address;
+    uint8_t data[8];
+    size_t length;
+};
+
+static I2cWrite i2cTrace[64];
+static int i2cCount = 0;
+
+static void recordI2c(uint8_t address, const uint8_t* data, size_t length, unsigned long atMillis) {
+    (void)atMillis;
+    if (i2cCount < 64) {
+        i2cTrace[i2cCount].address = address;
+        i2cTrace[i2cCount].length = length;
+        for (size_t i = 0; i < length && i < 8; i++) i2cTrace[i2cCount].data[i] = data[i];
+    }
+    i2cCount++;
+}
+
+// ---- 74HC595 simulado sobre la traza de GPIO ----
+#define SR_DATA 5
+#define SR_CLOCK 4
+#define SR_LATCH 14
+#define SR_OE 12
+
+static uint8_t srData = LOW;
+static uint8_t srClock = LOW;
+static uint8_t srLatch = LOW;
+static uint32_t srShift = 0;      // Registro de desplazamiento (bit 0 = Q0 del chip 0)
+static uint32_t srOutputs = 0;    // Registro de salida
+static int srLatches = 0;
+static bool srEnabled = false;
+static bool srLatchedBeforeEnable = false;
+
+static void record595(uint8_t pin, uint8_t value, unsigned long atMillis) {
+    (void)atMillis;
+    if (pin == SR_DATA) srData = value;
+    if (pin == SR_CLOCK) {
+        if (value == HIGH && srClock == LOW) srShift = (srShift << 1) | (srData == HIGH ? 1u : 0u);
+        srClock = value;
+    }
+    if (pin == SR_LATCH) {
+        if (value == HIGH && srLatch == LOW) {
+            srOutputs = srShift;
+            srLatches++;
+            if (!srEnabled) srLatchedBeforeEnable = true;
+        }
+        srLatch = value;
+    }
+    if (pin == SR_OE) srEnabled = value == LOW;
+}
+
+void setUp() {
+    NativeShim::useFakeClock(1000);
+    NativeShim::setSerialQuiet(true);
+    i2cCount = 0;
+    srShift = 0;
+    srOutputs = 0;
+    srLatches = 0;
+    srEnabled = false;
+    srLatchedBeforeEnable = false;
+}
+
+void tearDown() {
+    NativeShim::setGpioWriteHook(nullptr);
+    NativeShim::setI2cWriteHook(nullptr);
+    for (uint8_t address = 0x20; address < 0x28; address++) {
+        NativeShim::setI2cDevicePresent(address, true);
+    }
+    NativeShim::setSerialQuiet(false);
+}
+
+// Todos los cambios de una vuelta salen en una sola escritura
+void test_one_transaction_per_tick() {
+    MockOutputBackend backend(MAX_ZONES);
+    RelayController relays;
+    relays.setOutputBackend(&backend);
+    relays.setSwitchTiming(0, 0);
+    relays.init();
+    TEST_ASSERT_EQUAL(1, backend.writes);             // Todo apagado al iniciar
+    TEST_ASSERT_FALSE(onLevel(backend.lastLevels, 0));
+
+    for (int zona = 1; zona <= 4; zona++) {
+        relays.turnOn(zona, 60, ORIGEN_MANUAL, 0);
+    }
+    relays.loop();
+    TEST_ASSERT_EQUAL(2, backend.writes);
+    TEST_ASSERT_EQUAL_HEX32(0x0F, backend.lastChanged);
+    for (int ch = 0; ch < MAX_ZONES; ch++) {
+        TEST_ASSERT_EQUAL(ch < 4, onLevel(backend.lastLevels, ch));
+    }
+
+    // Sin cambios no hay escrituras
+    for (int i = 0; i < 50; i++) {
+        NativeShim::advanceMillis(10);
+        relays.loop();
+    }
+    TEST_ASSERT_EQUAL(2, backend.writes);
+}
+
+// Con escalonamiento, una escritura por conmutación y solo el canal que cambió
+void test_staggered_writes_carry_single_channel() {
+    MockOutputBackend backend(MAX_ZONES);
+    RelayController relays;
+    relays.setOutputBackend(&backend);
+    relays.setSwitchTiming(250, 0);
+    relays.init();
+
+    relays.turnOn(2, 60, ORIGEN_MANUAL, 0);
+    relays.turnOn(5, 60, ORIGEN_MANUAL, 0);
+    relays.loop();
+    TEST_ASSERT_EQUAL_HEX32(0x02, backend.lastChanged);
+    NativeShim::advanceMillis(250);
+    relays.loop();
+    TEST_ASSERT_EQUAL_HEX32(0x10, backend.lastChanged);
+    TEST_ASSERT_EQUAL(3, backend.writes);
+}
+
+// Cadena de dos 595: bits en orden de canal, OE recién tras el primer latch
+void test_shift_register_chain_order() {
+    NativeShim::setGpioWriteHook(record595);
+    ShiftRegisterOutputBackend backend(SR_DATA, SR_CLOCK, SR_LATCH, 2, SR_OE);
+    TEST_ASSERT_EQUAL(16, backend.getChannelCount());
+
+    TEST_ASSERT_TRUE(backend.begin());
+    TEST_ASSERT_TRUE(srLatchedBeforeEnable);          // Salidas habilitadas recién con contenido
+    TEST_ASSERT_TRUE(srEnabled);
+    TEST_ASSERT_EQUAL(1, srLatches);
+    for (int ch = 0; ch < 16; ch++) {
+        TEST_ASSERT_FALSE(onLevel(srOutputs, ch));
+    }
+
+    backend.set(0, true);
+    backend.set(9, true);
+    backend.set(15, true);
+    TEST_ASSERT_TRUE(backend.commit());
+    TEST_ASSERT_EQUAL(2, srLatches);
+    for (int ch = 0; ch < 16; ch++) {
+        TEST_ASSERT_EQUAL(ch == 0 || ch == 9 || ch == 15, onLevel(srOutputs, ch));
+    }
+    TEST_ASSERT_TRUE(backend.commit());               // Nada pendiente
+    TEST_ASSERT_EQUAL(2, srLatches);
+}
+
+// PCF8574: un byte por chip y solo a los chips con cambios
+void test_pcf8574_writes_only_changed_chips() {
+    NativeShim::setI2cWriteHook(recordI2c);
+    Pcf8574OutputBackend backend(Wire, 0x20, 3);
+    TEST_ASSERT_TRUE(backend.begin());
+    TEST_ASSERT_EQUAL(3, i2cCount);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0x20 + i, i2cTrace[i].address);
+        TEST_ASSERT_EQUAL(1, i2cTrace[i].length);
+    }
+
+    i2cCount = 0;
+    backend.set(10, true);
+    backend.set(12, true);
+    TEST_ASSERT_TRUE(backend.commit());
+    TEST_ASSERT_EQUAL(1, i2cCount);
+    TEST_ASSERT_EQUAL_HEX8(0x21, i2cTrace[0].address);
+    TEST_ASSERT_TRUE(onLevel(i2cTrace[0].data[0], 2));
+    TEST_ASSERT_TRUE(onLevel(i2cTrace[0].data[0], 4));
+    TEST_ASSERT_FALSE(onLevel(i2cTrace[0].data[0], 3));
+}
+
+// MCP23017: latches apagados antes de IODIR y OLATA+OLATB en una escritura
+void test_mcp23017_configures_and_batches_ports() {
+    NativeShim::setI2cWriteHook(recordI2c);
+    Mcp23017OutputBackend backend(Wire, 0x24, 2);
+    TEST_ASSERT_EQUAL(32, backend.getChannelCount());
+    TEST_ASSERT_TRUE(backend.begin());
+
+    uint8_t off = RELAY_OFF == HIGH ? 0xFF : 0x00;
+    // chip 0: OLAT, IODIR; chip 1: OLAT, IODIR; luego el estado de ambos
+    TEST_ASSERT_EQUAL(6, i2cCount);
+    TEST_ASSERT_EQUAL_HEX8(0x24, i2cTrace[0].address);
+    TEST_ASSERT_EQUAL_HEX8(0x14, i2cTrace[0].data[0]);
+    TEST_ASSERT_EQUAL_HEX8(off, i2cTrace[0].data[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, i2cTrace[1].data[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, i2cTrace[1].data[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x25, i2cTrace[2].address);
+
+    i2cCount = 0;
+    backend.set(3, true);
+    backend.set(12, true);
+    backend.set(30, true);
+    TEST_ASSERT_TRUE(backend.commit());
+    TEST_ASSERT_EQUAL(2, i2cCount);
+    TEST_ASSERT_EQUAL(3, i2cTrace[0].length);
+    TEST_ASSERT_EQUAL_HEX8(0x24, i2cTrace[0].address);
+    TEST_ASSERT_EQUAL_HEX8(0x14, i2cTrace[0].data[0]);
+    TEST_ASSERT_TRUE(onLevel(i2cTrace[0].data[1], 3));
+    TEST_ASSERT_TRUE(onLevel(i2cTrace[0].data[2], 12 - 8));
+    TEST_ASSERT_EQUAL_HEX8(0x25, i2cTrace[1].address);
+    TEST_ASSERT_TRUE(onLevel(i2cTrace[1].data[2], 30 - 24));
+    TEST_ASSERT_FALSE(onLevel(i2cTrace[1].data[1], 0));
+}
+
+// Expansor sin responder: el loop reintenta y al volver se reescribe todo
+void test_i2c_nack_is_retried() {
+    NativeShim::setI2cWriteHook(recordI2c);
+    Pcf8574OutputBackend backend(Wire, 0x20, 1);
+    RelayController relays;
+    relays.setOutputBackend(&backend);
+    relays.setSwitchTiming(0, 0);
+    relays.init();
+
+    NativeShim::setI2cDevicePresent(0x20, false);
+    relays.turnOn(3, 60, ORIGEN_MANUAL, 0);
+    relays.loop();
+    TEST_ASSERT_TRUE(backend.isDirty());
+    TEST_ASSERT_EQUAL(1, backend.getFailureCount());
+    TEST_ASSERT_EQUAL(OUTPUT_BUS_RETRY_MS, relays.getMsUntilNextExpiry());
+
+    // Antes del intervalo no se golpea el bus
+    NativeShim::advanceMillis(OUTPUT_BUS_RETRY_MS / 2);
+    relays.loop();
+    TEST_ASSERT_EQUAL(1, backend.getFailureCount());
+
+    NativeShim::setI2cDevicePresent(0x20, true);
+    i2cCount = 0;
+    NativeShim::advanceMillis(OUTPUT_BUS_RETRY_MS / 2);
+    relays.loop();
+    TEST_ASSERT_FALSE(backend.isDirty());
+    TEST_ASSERT_EQUAL(1, i2cCount);
+    TEST_ASSERT_TRUE(onLevel(i2cTrace[0].data[0], 2));
+    TEST_ASSERT_TRUE(relays.getMsUntilNextExpiry() > (long)OUTPUT_BUS_RETRY_MS);
+}
+
+// Parada de emergencia sin esperar intervalo: todo apagado en una escritura
+void test_emergency_stop_single_write() {
+    MockOutputBackend backend(MAX_ZONES);
+    RelayController relays;
+    relays.setOutputBackend(&backend);
+    relays.setSwitchTiming(0, 0);
+    relays.init();
+    relays.turnOn(1, 60, ORIGEN_MANUAL, 0);
+    relays.turnOn(8, 60, ORIGEN_MANUAL, 0);
+    relays.loop();
+    int before = backend.writes;
+
+    relays.emergencyStop();
+    TEST_ASSERT_EQUAL(before + 1, backend.writes);
+    for (int ch = 0; ch < MAX_ZONES; ch++) {
+        TEST_ASSERT_FALSE(onLevel(backend.lastLevels, ch));
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_one_transaction_per_tick);
+    RUN_TEST(test_staggered_writes_carry_single_channel);
+    RUN_TEST(test_shift_register_chain_order);
+    RUN_TEST(test_pcf8574_writes_only_changed_chips);
+    RUN_TEST(test_mcp23017_configures_and_batches_ports);
+    RUN_TEST(test_i2c_nack_is_retried);
+    RUN_TEST(test_emergency_stop_single_write);
+    return UNITY_END();
+}
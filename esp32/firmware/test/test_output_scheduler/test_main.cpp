@@ -0,0 +1,224 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "hardware/RelayController.h"
+#include "hardware/OutputScheduler.h"
+#include "scheduler/ZoneSequencer.h"
+
+// ============================================================================
+// Test OutputScheduler - traza de GPIO con reloj simulado
+// ============================================================================
+
+struct GpioWrite {
+    uint8_t pin;
+    uint8_t value;
+    unsigned long at;
+};
+
+static GpioWrite trace[128];
+static int traceCount = 0;
+
+static void recordGpio(uint8_t pin, uint8_t value, unsigned long atMillis) {
+    if (traceCount < 128) {
+        trace[traceCount].pin = pin;
+        trace[traceCount].value = value;
+        trace[traceCount].at = atMillis;
+    }
+    traceCount++;
+}
+
+static int zoneOfPin(uint8_t pin) {
+    for (int i = 0; i < MAX_ZONES; i++) {
+        if (RELAY_PINS[i] == pin) return i + 1;
+    }
+    return 0;
+}
+
+// Vueltas de loop de 10 ms
+static void spin(RelayController& relays, unsigned long ms, ZoneSequencer* sequencer = nullptr) {
+    for (unsigned long t = 0; t < ms; t += 10) {
+        NativeShim::advanceMillis(10);
+        relays.loop();
+        if (sequencer != nullptr) sequencer->loop();
+    }
+}
+
+// Ninguna conmutación a menos de `minGap` ms de la anterior
+static void assertSpacing(int from, unsigned long minGap) {
+    for (int i = from + 1; i < traceCount; i++) {
+        TEST_ASSERT_TRUE(trace[i].at - trace[i - 1].at >= minGap);
+    }
+}
+
+static void startTrace(RelayController& relays) {
+    relays.init();
+    traceCount = 0;
+    NativeShim::setGpioWriteHook(recordGpio);
+}
+
+void setUp() {
+    NativeShim::useFakeClock(1000);
+    NativeShim::setSerialQuiet(true);
+    traceCount = 0;
+}
+
+void tearDown() {
+    NativeShim::setGpioWriteHook(nullptr);
+    NativeShim::setSerialQuiet(false);
+}
+
+void test_simultaneous_starts_are_staggered() {
+    RelayController relays;
+    relays.setSwitchTiming(250, 0);
+    startTrace(relays);
+
+    unsigned long t0 = millis();
+    for (int zona = 1; zona <= 4; zona++) {
+        relays.turnOn(zona, 600, ORIGEN_AGENDA, 1);
+    }
+    TEST_ASSERT_EQUAL(0, traceCount);   // Nada se escribe al pedir
+    spin(relays, 1000);
+
+    TEST_ASSERT_EQUAL(4, traceCount);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(RELAY_PINS[i], trace[i].pin);
+        TEST_ASSERT_EQUAL(RELAY_ON, trace[i].value);
+        TEST_ASSERT_EQUAL_UINT32(t0 + 10 + i * 250, trace[i].at);
+    }
+    assertSpacing(0, 250);
+}
+
+void test_off_goes_before_on() {
+    RelayController relays;
+    relays.setSwitchTiming(200, 0);
+    startTrace(relays);
+    relays.turnOn(1, 60, ORIGEN_MANUAL, 0);
+    relays.turnOn(2, 60, ORIGEN_MANUAL, 0);
+    spin(relays, 500);
+    traceCount = 0;
+
+    // En la misma vuelta se piden dos encendidos y un apagado
+    relays.turnOn(6, 60, ORIGEN_MANUAL, 0);
+    relays.turnOn(5, 60, ORIGEN_MANUAL, 0);
+    relays.turnOff(2);
+    spin(relays, 1000);
+
+    TEST_ASSERT_EQUAL(3, traceCount);
+    TEST_ASSERT_EQUAL(2, zoneOfPin(trace[0].pin));
+    TEST_ASSERT_EQUAL(RELAY_OFF, trace[0].value);
+    TEST_ASSERT_EQUAL(5, zoneOfPin(trace[1].pin));
+    TEST_ASSERT_EQUAL(6, zoneOfPin(trace[2].pin));
+    assertSpacing(0, 200);
+}
+
+// Traspaso con solapamiento: la zona que sigue abre antes de que cierre la
+// que terminó, y cierra recién pasado el solapamiento
+void test_changeover_overlap() {
+    RelayController relays;
+    relays.setSwitchTiming(200, 3000);
+    ZoneSequencer sequencer(&relays);
+    sequencer.setMaxActive(1);
+    startTrace(relays);
+
+    sequencer.request(3, 10, ORIGEN_AGENDA, 1);
+    sequencer.request(4, 10, ORIGEN_AGENDA, 1);
+    spin(relays, 25000, &sequencer);
+
+    // ON 3, ON 4 (traspaso), OFF 3 a los 3 s, OFF 4 al vencer
+    TEST_ASSERT_EQUAL(4, traceCount);
+    TEST_ASSERT_EQUAL(3, zoneOfPin(trace[0].pin));
+    TEST_ASSERT_EQUAL(RELAY_ON, trace[0].value);
+    TEST_ASSERT_EQUAL(4, zoneOfPin(trace[1].pin));
+    TEST_ASSERT_EQUAL(RELAY_ON, trace[1].value);
+    TEST_ASSERT_EQUAL(3, zoneOfPin(trace[2].pin));
+    TEST_ASSERT_EQUAL(RELAY_OFF, trace[2].value);
+    TEST_ASSERT_EQUAL_UINT32(trace[1].at + 3000, trace[2].at);
+    TEST_ASSERT_EQUAL(4, zoneOfPin(trace[3].pin));
+    TEST_ASSERT_EQUAL(RELAY_OFF, trace[3].value);
+}
+
+// Sin solapamiento el traspaso cierra primero: nunca más bobinas que zonas permitidas
+void test_changeover_without_overlap_never_exceeds_limit() {
+    RelayController relays;
+    relays.setSwitchTiming(300, 0);
+    ZoneSequencer sequencer(&relays);
+    sequencer.setMaxActive(2);
+    startTrace(relays);
+
+    for (int zona = 1; zona <= MAX_ZONES; zona++) {
+        sequencer.request(zona, 5, ORIGEN_AGENDA, 1);
+    }
+    spin(relays, 40000, &sequencer);
+
+    TEST_ASSERT_EQUAL(2 * MAX_ZONES, traceCount);
+    int energized = 0;
+    int maxEnergized = 0;
+    for (int i = 0; i < traceCount; i++) {
+        energized += trace[i].value == RELAY_ON ? 1 : -1;
+        if (energized > maxEnergized) maxEnergized = energized;
+    }
+    TEST_ASSERT_EQUAL(0, energized);
+    TEST_ASSERT_EQUAL(2, maxEnergized);
+    assertSpacing(0, 300);
+}
+
+void test_cancelled_before_applied_writes_nothing() {
+    RelayController relays;
+    startTrace(relays);
+    relays.turnOn(7, 60, ORIGEN_MANUAL, 0);
+    relays.turnOff(7);
+    spin(relays, 1000);
+    TEST_ASSERT_EQUAL(0, traceCount);
+}
+
+// El loop que duerme hasta getMsUntilNextExpiry() conmuta en el instante justo
+void test_sleeping_loop_hits_each_switch() {
+    RelayController relays;
+    relays.setSwitchTiming(400, 0);
+    startTrace(relays);
+
+    unsigned long t0 = millis();
+    relays.turnOn(1, 2, ORIGEN_MANUAL, 0);
+    relays.turnOn(2, 2, ORIGEN_MANUAL, 0);
+    relays.turnOn(3, 2, ORIGEN_MANUAL, 0);
+
+    int wakeups = 0;
+    long ms;
+    while ((ms = relays.getMsUntilNextExpiry()) >= 0 && wakeups < 20) {
+        NativeShim::advanceMillis(ms);
+        relays.loop();
+        wakeups++;
+    }
+    TEST_ASSERT_EQUAL(6, traceCount);
+    const unsigned long expected[] = {0, 400, 800, 2000, 2400, 2800};
+    for (int i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL_UINT32(t0 + expected[i], trace[i].at);
+    }
+}
+
+void test_emergency_stop_is_immediate() {
+    RelayController relays;
+    relays.setSwitchTiming(250, 0);
+    startTrace(relays);
+    relays.turnOn(1, 60, ORIGEN_MANUAL, 0);
+    relays.turnOn(2, 60, ORIGEN_MANUAL, 0);
+    spin(relays, 50);      // Solo la zona 1 alcanzó a conmutar
+    traceCount = 0;
+
+    relays.emergencyStop();
+    TEST_ASSERT_EQUAL(MAX_ZONES, traceCount);
+    TEST_ASSERT_EQUAL(RELAY_OFF, NativeShim::getPinLevel(RELAY_PINS[0]));
+    spin(relays, 1000);
+    TEST_ASSERT_EQUAL(MAX_ZONES, traceCount);   // La zona 2 ya no enciende
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_simultaneous_starts_are_staggered);
+    RUN_TEST(test_off_goes_before_on);
+    RUN_TEST(test_changeover_overlap);
+    RUN_TEST(test_changeover_without_overlap_never_exceeds_limit);
+    RUN_TEST(test_cancelled_before_applied_writes_nothing);
+    RUN_TEST(test_sleeping_loop_hits_each_switch);
+    RUN_TEST(test_emergency_stop_is_immediate);
+    return UNITY_END();
+}
@@ -0,0 +1,203 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "hardware/RelayController.h"
+#include "utils/DeadlineHeap.h"
+
+// ============================================================================
+// Test timers de relés - vencimientos absolutos bajo un loop irregular
+// ============================================================================
+
+static const unsigned long RIEGO_2H_MS = 7200UL * 1000UL;
+
+static uint32_t rng = 12345;
+static unsigned long finAt[MAX_ZONES + 1];
+static int finCount[MAX_ZONES + 1];
+
+// Período de loop irregular: 1..maxMs (LCG, reproducible)
+static unsigned long jitter(unsigned long maxMs) {
+    rng = rng * 1103515245UL + 12345UL;
+    return 1 + (rng >> 8) % maxMs;
+}
+
+static void recordFin(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion, int versionAgenda) {
+    (void)origen; (void)duracion; (void)versionAgenda;
+    if (evento != RIEGO_FIN) return;
+    finAt[zona] = millis();
+    finCount[zona]++;
+}
+
+void setUp() {
+    NativeShim::useFakeClock(1000);
+    NativeShim::setSerialQuiet(true);
+    rng = 12345;
+    for (int i = 0; i <= MAX_ZONES; i++) {
+        finAt[i] = 0;
+        finCount[i] = 0;
+    }
+}
+
+void tearDown() {
+    NativeShim::setSerialQuiet(false);
+}
+
+void test_heap_orders_and_reschedules() {
+    DeadlineHeap<8> heap;
+    TEST_ASSERT_EQUAL(-1, heap.msUntilNext(0));
+    heap.schedule(3, 5000);
+    heap.schedule(1, 2000);
+    heap.schedule(6, 9000);
+    heap.schedule(0, 7000);
+    TEST_ASSERT_EQUAL(1, heap.nextId());
+    TEST_ASSERT_EQUAL(1500, heap.msUntilNext(500));
+
+    heap.schedule(6, 1000);      // Adelantar
+    heap.schedule(1, 8000);      // Atrasar
+    TEST_ASSERT_TRUE(heap.cancel(3));
+    TEST_ASSERT_FALSE(heap.cancel(3));
+
+    uint8_t id;
+    const uint8_t expected[] = {6, 0, 1};
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(heap.popExpired(10000, id));
+        TEST_ASSERT_EQUAL(expected[i], id);
+    }
+    TEST_ASSERT_FALSE(heap.popExpired(10000, id));
+    TEST_ASSERT_TRUE(heap.isEmpty());
+}
+
+void test_heap_across_millis_overflow() {
+    DeadlineHeap<4> heap;
+    uint32_t now = 0xFFFFF000UL;
+    heap.schedule(0, now + 10000);   // Desborda: 0x00001710
+    heap.schedule(1, now + 1000);
+    TEST_ASSERT_EQUAL(1, heap.nextId());
+
+    uint8_t id;
+    TEST_ASSERT_FALSE(heap.popExpired(now + 999, id));
+    TEST_ASSERT_TRUE(heap.popExpired(now + 1000, id));
+    TEST_ASSERT_EQUAL(1, id);
+    TEST_ASSERT_EQUAL(9000, heap.msUntilNext(now + 1000));
+}
+
+// Riegos de 2 h encadenados con un loop de 1 ms a 2 s: cada riego dura lo
+// programado más, a lo sumo, una vuelta de loop, y el atraso no se arrastra
+void test_two_hour_cycles_under_jittery_loop() {
+    RelayController relays;
+    relays.init();
+    relays.setRiegoEventCallback(recordFin);
+
+    const int CYCLES = 6;
+    unsigned long maxOverrunMs = 0;
+
+    for (int cycle = 0; cycle < CYCLES; cycle++) {
+        unsigned long start = millis();
+        unsigned long lastPeriod = 0;
+        relays.turnOn(1, 7200, ORIGEN_AGENDA, 1);
+        while (relays.isActive(1)) {
+            lastPeriod = jitter(2000);
+            NativeShim::advanceMillis(lastPeriod);
+            relays.loop();
+        }
+        unsigned long onMs = finAt[1] - start;
+        TEST_ASSERT_TRUE(onMs >= RIEGO_2H_MS);
+        TEST_ASSERT_TRUE(onMs - RIEGO_2H_MS < lastPeriod);
+        if (onMs - RIEGO_2H_MS > maxOverrunMs) maxOverrunMs = onMs - RIEGO_2H_MS;
+    }
+    TEST_ASSERT_EQUAL(CYCLES, finCount[1]);
+    TEST_ASSERT_TRUE(maxOverrunMs < 2000);
+
+    // Un riego de 2 h sin reencadenar: vence en el instante exacto aunque el
+    // loop haya avanzado con fracciones de segundo todo el tiempo
+    unsigned long ideal = millis() + RIEGO_2H_MS;
+    relays.turnOn(2, 7200, ORIGEN_MANUAL, 0);
+    // Conmutar los relés (apagado de la zona 1, encendido de la 2): después
+    // solo queda el vencimiento
+    relays.loop();
+    NativeShim::advanceMillis(RELAY_SWITCH_INTERVAL_MS);
+    relays.loop();
+    unsigned long tick = 0;
+    while (relays.isActive(2)) {
+        unsigned long ms = (unsigned long)relays.getMsUntilNextExpiry();
+        TEST_ASSERT_EQUAL_UINT32(ideal - millis(), ms);
+        // Cada 7 vueltas el loop duerme justo hasta el vencimiento
+        unsigned long step = (++tick % 7 == 0) ? ms : jitter(1999);
+        if (step > ms) step = ms;
+        NativeShim::advanceMillis(step);
+        relays.loop();
+    }
+    TEST_ASSERT_EQUAL_UINT32(ideal, finAt[2]);
+}
+
+// Zonas superpuestas con duraciones distintas: cada una vence por su cuenta
+void test_overlapping_zones_expire_in_order() {
+    RelayController relays;
+    relays.init();
+    relays.setRiegoEventCallback(recordFin);
+
+    unsigned long t0 = millis();
+    relays.turnOn(3, 7200, ORIGEN_AGENDA, 1);
+    NativeShim::advanceMillis(250);
+    relays.turnOn(5, 1800, ORIGEN_MANUAL, 0);
+    NativeShim::advanceMillis(750);
+    relays.turnOn(8, 3601, ORIGEN_AGENDA, 2);
+
+    // Reprogramar la zona 5: vale el último encendido
+    NativeShim::advanceMillis(500);
+    relays.turnOn(5, 900, ORIGEN_MANUAL, 0);
+    unsigned long zona5Start = millis();
+
+    while (relays.isActive(3) || relays.isActive(5) || relays.isActive(8)) {
+        NativeShim::advanceMillis(jitter(1500));
+        relays.loop();
+    }
+
+    TEST_ASSERT_EQUAL(1, finCount[3]);
+    TEST_ASSERT_EQUAL(1, finCount[5]);
+    TEST_ASSERT_EQUAL(1, finCount[8]);
+    TEST_ASSERT_TRUE(finAt[5] - zona5Start >= 900000UL && finAt[5] - zona5Start < 901500UL);
+    TEST_ASSERT_TRUE(finAt[8] - (t0 + 1000) >= 3601000UL && finAt[8] - (t0 + 1000) < 3602500UL);
+    TEST_ASSERT_TRUE(finAt[3] - t0 >= RIEGO_2H_MS && finAt[3] - t0 < RIEGO_2H_MS + 1500);
+    TEST_ASSERT_TRUE(finAt[5] < finAt[8] && finAt[8] < finAt[3]);
+    NativeShim::advanceMillis(RELAY_SWITCH_INTERVAL_MS);
+    relays.loop();   // Último apagado del relé
+    TEST_ASSERT_EQUAL(-1, relays.getMsUntilNextExpiry());
+}
+
+// Tiempo restante en segundos redondeado hacia arriba; apagar a mano cancela
+void test_remaining_time_and_manual_off() {
+    RelayController relays;
+    relays.init();
+    relays.setRiegoEventCallback(recordFin);
+
+    relays.turnOn(4, 60, ORIGEN_MANUAL, 0);
+    TEST_ASSERT_EQUAL(60, relays.getRemainingTime(4));
+    NativeShim::advanceMillis(1);
+    relays.loop();
+    TEST_ASSERT_EQUAL(60, relays.getRemainingTime(4));
+    NativeShim::advanceMillis(999);
+    relays.loop();
+    TEST_ASSERT_EQUAL(59, relays.getRemainingTime(4));
+    NativeShim::advanceMillis(58999);
+    relays.loop();
+    TEST_ASSERT_TRUE(relays.isActive(4));
+    TEST_ASSERT_EQUAL(1, relays.getRemainingTime(4));
+
+    relays.turnOff(4);
+    TEST_ASSERT_EQUAL(1, finCount[4]);
+    TEST_ASSERT_EQUAL(0, relays.getRemainingTime(4));
+    relays.loop();
+    TEST_ASSERT_EQUAL(-1, relays.getMsUntilNextExpiry());
+    NativeShim::advanceMillis(5000);
+    relays.loop();
+    TEST_ASSERT_EQUAL(1, finCount[4]);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_heap_orders_and_reschedules);
+    RUN_TEST(test_heap_across_millis_overflow);
+    RUN_TEST(test_two_hour_cycles_under_jittery_loop);
+    RUN_TEST(test_overlapping_zones_expire_in_order);
+    RUN_TEST(test_remaining_time_and_manual_off);
+    return UNITY_END();
+}
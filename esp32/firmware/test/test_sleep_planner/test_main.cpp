@@ -0,0 +1,108 @@
+#include <unity.h>
+#include "utils/SleepPlanner.h"
+
+// ============================================================================
+// Test SleepPlanner - planificación de sueño con reloj simulado
+// ============================================================================
+
+static const uint32_t MIN_SLEEP = 100;
+static const uint32_t MAX_SLEEP = 2000;
+
+void test_no_deadlines_sleeps_max() {
+    SleepPlanner planner(MIN_SLEEP, MAX_SLEEP);
+    planner.begin();
+    planner.addDeadline(WAKE_AGENDA, -1);
+    TEST_ASSERT_EQUAL_UINT32(MAX_SLEEP, planner.sleepMs());
+    TEST_ASSERT_EQUAL(WAKE_NONE, planner.getReason());
+}
+
+void test_earliest_deadline_wins() {
+    SleepPlanner planner(MIN_SLEEP, MAX_SLEEP);
+    planner.begin();
+    planner.addDeadline(WAKE_DISPLAY, 1500);
+    planner.addDeadline(WAKE_RELAY, 700);
+    planner.addDeadline(WAKE_AGENDA, 900);
+    TEST_ASSERT_EQUAL_UINT32(700, planner.sleepMs());
+    TEST_ASSERT_EQUAL(WAKE_RELAY, planner.getReason());
+}
+
+void test_overdue_deadline_clamped_to_min() {
+    SleepPlanner planner(MIN_SLEEP, MAX_SLEEP);
+    planner.begin();
+    planner.addDeadline(WAKE_AGENDA, 0);
+    TEST_ASSERT_EQUAL_UINT32(MIN_SLEEP, planner.sleepMs());
+    TEST_ASSERT_EQUAL(WAKE_AGENDA, planner.getReason());
+}
+
+void test_periodic_handles_millis_wraparound() {
+    SleepPlanner planner(MIN_SLEEP, MAX_SLEEP);
+    planner.begin();
+    // Último refresco 500 ms antes del desborde de millis(), ahora 200 ms después
+    planner.addPeriodic(WAKE_DISPLAY, 200u, 0xFFFFFFFFu - 499u, 1000);
+    TEST_ASSERT_EQUAL_UINT32(300, planner.sleepMs());
+}
+
+// Simula una hora de loop: una agenda a los 60 s que riega 300 s, display cada
+// 30 s. Con reloj falso se verifica que ningún evento se atienda tarde y que
+// el loop despierte muchas menos veces que con polling fijo de MIN_SLEEP.
+void test_simulated_hour_never_late() {
+    SleepPlanner planner(MIN_SLEEP, MAX_SLEEP);
+
+    uint32_t clock = 0;
+    uint32_t agendaAt = 60000;
+    bool agendaDone = false;
+    uint32_t relayExpiry = 0;
+    bool relayOn = false;
+    uint32_t lastDisplay = 0;
+    uint32_t wakeups = 0;
+    uint32_t maxLateness = 0;
+
+    while (clock < 3600000u) {
+        // Atender eventos vencidos (como haría loop())
+        if (!agendaDone && clock >= agendaAt) {
+            uint32_t late = clock - agendaAt;
+            if (late > maxLateness) maxLateness = late;
+            agendaDone = true;
+            relayOn = true;
+            relayExpiry = clock + 300000;
+        }
+        if (relayOn && clock >= relayExpiry) {
+            uint32_t late = clock - relayExpiry;
+            if (late > maxLateness) maxLateness = late;
+            relayOn = false;
+        }
+        if (clock - lastDisplay >= 30000) {
+            uint32_t late = clock - lastDisplay - 30000;
+            if (late > maxLateness) maxLateness = late;
+            lastDisplay = clock;
+        }
+
+        planner.begin();
+        planner.addDeadline(WAKE_AGENDA, agendaDone ? -1 : (int32_t)(agendaAt - clock));
+        planner.addDeadline(WAKE_RELAY, relayOn ? (int32_t)(relayExpiry - clock) : -1);
+        planner.addPeriodic(WAKE_DISPLAY, clock, lastDisplay, 30000);
+
+        uint32_t sleep = planner.sleepMs();
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(MIN_SLEEP, sleep);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(MAX_SLEEP, sleep);
+
+        clock += sleep;
+        wakeups++;
+    }
+
+    TEST_ASSERT_TRUE(agendaDone);
+    TEST_ASSERT_FALSE(relayOn);
+    TEST_ASSERT_EQUAL_UINT32(0, maxLateness);
+    // Polling fijo: 36000 despertares; acotado por MAX_SLEEP: ~1800
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(3600000u / MAX_SLEEP + 10, wakeups);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_no_deadlines_sleeps_max);
+    RUN_TEST(test_earliest_deadline_wins);
+    RUN_TEST(test_overdue_deadline_clamped_to_min);
+    RUN_TEST(test_periodic_handles_millis_wraparound);
+    RUN_TEST(test_simulated_hour_never_late);
+    return UNITY_END();
+}
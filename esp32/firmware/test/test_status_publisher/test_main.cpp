@@ -0,0 +1,230 @@
+#include <unity.h>
+#include "network/StatusPublisher.h"
+
+// ============================================================================
+// Test StatusPublisher - publicación por flanco con reloj simulado
+// ============================================================================
+
+// Sinks simulados: cuentan mensajes y pueden fallar a pedido
+static uint32_t zoneMessages = 0;
+static uint32_t zonesMessages = 0;
+static int lastZona = 0;
+static uint16_t lastRestante = 0;
+static uint8_t lastActivas = 0;
+static bool sinkFails = false;
+
+static bool zoneSink(int zona, bool activa, uint16_t restante) {
+    if (sinkFails) return false;
+    zoneMessages++;
+    lastZona = zona;
+    lastRestante = restante;
+    return true;
+}
+
+static bool zonesSink(uint32_t activas, const uint16_t* restante) {
+    if (sinkFails) return false;
+    zonesMessages++;
+    lastActivas = activas;
+    return true;
+}
+
+// Relés simulados: vencimiento absoluto por zona (0 = apagada)
+static uint32_t nowMs = 0;
+static uint32_t zoneEndMs[MAX_ZONES];
+
+static void turnOn(int zona, uint32_t seconds) {
+    zoneEndMs[zona - 1] = nowMs + seconds * 1000UL;
+}
+
+static uint8_t snapshot(uint16_t* restante) {
+    uint8_t activas = 0;
+    for (int i = 0; i < MAX_ZONES; i++) {
+        restante[i] = 0;
+        if (zoneEndMs[i] != 0 && zoneEndMs[i] <= nowMs) zoneEndMs[i] = 0;  // Auto-apagado
+        if (zoneEndMs[i] == 0) continue;
+        activas |= (uint8_t)(1 << i);
+        restante[i] = (uint16_t)((zoneEndMs[i] - nowMs + 999) / 1000);
+    }
+    return activas;
+}
+
+static uint8_t tick(StatusPublisher& publisher) {
+    uint16_t restante[MAX_ZONES];
+    uint8_t activas = snapshot(restante);
+    return publisher.update(nowMs, activas, restante);
+}
+
+// Avanzar el reloj de a un segundo llamando update() en cada vuelta del loop
+static void advance(StatusPublisher& publisher, uint32_t seconds) {
+    for (uint32_t i = 0; i < seconds; i++) {
+        nowMs += 1000;
+        tick(publisher);
+    }
+}
+
+void setUp() {
+    zoneMessages = 0;
+    zonesMessages = 0;
+    lastZona = 0;
+    lastRestante = 0;
+    lastActivas = 0;
+    sinkFails = false;
+    nowMs = 1000;
+    for (int i = 0; i < MAX_ZONES; i++) zoneEndMs[i] = 0;
+}
+
+void tearDown() {}
+
+void test_first_update_publishes_full_state() {
+    StatusPublisher publisher(zoneSink, zonesSink);
+    publisher.setMode(STATUS_MODE_AGREGADO);
+    TEST_ASSERT_EQUAL(1, tick(publisher));
+    TEST_ASSERT_EQUAL(0, tick(publisher));
+    TEST_ASSERT_EQUAL_UINT32(0, zoneMessages);
+    TEST_ASSERT_EQUAL_UINT32(1, zonesMessages);
+}
+
+void test_countdown_without_changes_is_silent() {
+    StatusPublisher publisher(zoneSink, zonesSink);
+    publisher.setMode(STATUS_MODE_AGREGADO);
+    tick(publisher);
+
+    turnOn(3, 600);
+    TEST_ASSERT_EQUAL(1, tick(publisher));
+    TEST_ASSERT_EQUAL_HEX8(0x04, lastActivas);
+
+    // 10 minutos de cuenta regresiva normal: solo el apagado final
+    advance(publisher, 600);
+    TEST_ASSERT_EQUAL_UINT32(3, zonesMessages);
+    TEST_ASSERT_EQUAL_HEX8(0x00, lastActivas);
+}
+
+void test_remaining_time_drift_republishes() {
+    StatusPublisher publisher(zoneSink, zonesSink);
+    publisher.setMode(STATUS_MODE_ZONA);
+    TEST_ASSERT_EQUAL(MAX_ZONES, tick(publisher));  // Estado inicial de todas
+    zoneMessages = 0;
+
+    turnOn(1, 300);
+    tick(publisher);
+    TEST_ASSERT_EQUAL_UINT32(1, zoneMessages);
+
+    advance(publisher, 60);
+    TEST_ASSERT_EQUAL_UINT32(1, zoneMessages);
+
+    // Comando que extiende el riego: deriva > umbral
+    turnOn(1, 600);
+    TEST_ASSERT_EQUAL(1, tick(publisher));
+    TEST_ASSERT_EQUAL(1, lastZona);
+    TEST_ASSERT_EQUAL(600, lastRestante);
+
+    // Deriva dentro del umbral: no se publica
+    turnOn(1, 600 + STATUS_DRIFT_THRESHOLD_SEC);
+    TEST_ASSERT_EQUAL(0, tick(publisher));
+}
+
+void test_keepalive_is_low_frequency() {
+    StatusPublisher publisher(zoneSink, zonesSink);
+    publisher.setMode(STATUS_MODE_AMBOS);
+    publisher.setKeepalive(60000);
+    turnOn(2, 7200);
+    tick(publisher);
+    TEST_ASSERT_EQUAL_UINT32(MAX_ZONES, zoneMessages);
+    zoneMessages = 0;
+    TEST_ASSERT_EQUAL_UINT32(1, zonesMessages);
+    TEST_ASSERT_EQUAL_INT32(60000, publisher.getMsUntilKeepalive(nowMs));
+
+    // Keepalive por zona solo para las activas
+    advance(publisher, 59);
+    TEST_ASSERT_EQUAL_UINT32(0, zoneMessages);
+    advance(publisher, 1);
+    TEST_ASSERT_EQUAL_UINT32(1, zoneMessages);
+    TEST_ASSERT_EQUAL_UINT32(2, zonesMessages);
+    TEST_ASSERT_EQUAL(2, lastZona);
+}
+
+void test_failed_publish_is_retried() {
+    StatusPublisher publisher(zoneSink, zonesSink);
+    publisher.setMode(STATUS_MODE_AGREGADO);
+    tick(publisher);
+
+    sinkFails = true;
+    turnOn(5, 120);
+    TEST_ASSERT_EQUAL(0, tick(publisher));
+
+    sinkFails = false;
+    TEST_ASSERT_EQUAL(1, tick(publisher));
+    TEST_ASSERT_EQUAL_HEX8(0x10, lastActivas);
+}
+
+void test_invalidate_republishes_on_reconnect() {
+    StatusPublisher publisher(zoneSink, zonesSink);
+    publisher.setMode(STATUS_MODE_ZONA);
+    turnOn(4, 600);
+    tick(publisher);
+    TEST_ASSERT_EQUAL_UINT32(MAX_ZONES, zoneMessages);  // Estado inicial de todas
+
+    advance(publisher, 10);
+    publisher.invalidate();
+    TEST_ASSERT_EQUAL(MAX_ZONES, tick(publisher));
+}
+
+// Día de riego guionado: dos turnos de agenda (4 zonas x 10 min, en
+// secuencia) y un riego manual que se extiende por comando. Se compara
+// contra la publicación anterior: cada zona activa cada 5 s, más un
+// mensaje por transición (onZoneStateChanged) y por comando.
+void test_scripted_watering_day_message_count() {
+    StatusPublisher publisher(zoneSink, zonesSink);
+    publisher.setMode(STATUS_MODE_AGREGADO);
+
+    uint32_t legacyMessages = 0;
+    uint8_t previous = 0;
+    nowMs = 0;
+    tick(publisher);
+
+    for (uint32_t second = 1; second <= 86400; second++) {
+        nowMs = second * 1000UL;
+
+        // Turnos de agenda 06:00 y 20:00: zonas 1..4 de a una, 10 minutos
+        for (uint32_t shift = 6 * 3600UL; shift <= 20 * 3600UL; shift += 14 * 3600UL) {
+            for (int zona = 1; zona <= 4; zona++) {
+                if (second == shift + (zona - 1) * 600UL) turnOn(zona, 600);
+            }
+        }
+        // Manual 12:00 zona 6 por 5 minutos; a los 2 minutos un comando la lleva a 15
+        if (second == 12 * 3600UL) { turnOn(6, 300); legacyMessages++; }
+        if (second == 12 * 3600UL + 120) { turnOn(6, 900); legacyMessages++; }
+
+        uint16_t restante[MAX_ZONES];
+        uint8_t activas = snapshot(restante);
+        publisher.update(nowMs, activas, restante);
+
+        for (int i = 0; i < MAX_ZONES; i++) {
+            uint8_t bit = (uint8_t)(1 << i);
+            if ((activas & bit) != (previous & bit)) legacyMessages++;
+            if ((activas & bit) && second % 5 == 0) legacyMessages++;
+        }
+        previous = activas;
+    }
+
+    // 1 inicial + 13 cambios (por turno: encendido, 3 relevos y apagado;
+    // manual: encendido, extensión y apagado) + 87 keepalives (cada
+    // publicación reinicia el plazo de 15 minutos)
+    TEST_ASSERT_EQUAL_UINT32(zonesMessages, publisher.getPublishedCount());
+    TEST_ASSERT_EQUAL_UINT32(101, zonesMessages);
+    // Anterior: 5820 s de zonas activas / 5 s + 18 transiciones + 2 comandos
+    TEST_ASSERT_EQUAL_UINT32(1184, legacyMessages);
+    TEST_ASSERT_TRUE(legacyMessages >= 10 * zonesMessages);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_update_publishes_full_state);
+    RUN_TEST(test_countdown_without_changes_is_silent);
+    RUN_TEST(test_remaining_time_drift_republishes);
+    RUN_TEST(test_keepalive_is_low_frequency);
+    RUN_TEST(test_failed_publish_is_retried);
+    RUN_TEST(test_invalidate_republishes_on_reconnect);
+    RUN_TEST(test_scripted_watering_day_message_count);
+    return UNITY_END();
+}
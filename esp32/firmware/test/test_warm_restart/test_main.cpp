@@ -0,0 +1,200 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "hardware/RelayController.h"
+#include "storage/WarmRestart.h"
+
+// ============================================================================
+// Test WarmRestart - riegos en curso a través de un reinicio en caliente
+// ============================================================================
+
+static const uint32_t WATERMARK = 1704110400UL;
+static const SequencerSnapshot NO_QUEUE = {};
+
+static int inicioEvents = 0;
+static int finEvents = 0;
+static int lastFinZona = 0;
+static int lastFinDuracion = 0;
+
+static void countRiegoEvent(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion, int versionAgenda) {
+    (void)origen; (void)versionAgenda;
+    if (evento == RIEGO_INICIO) {
+        inicioEvents++;
+    } else {
+        finEvents++;
+        lastFinZona = zona;
+        lastFinDuracion = duracion;
+    }
+}
+
+static void advanceSeconds(RelayController& relays, int seconds) {
+    for (int i = 0; i < seconds; i++) {
+        NativeShim::advanceMillis(1000);
+        relays.loop();
+    }
+}
+
+// Riego en curso guardado antes de un reinicio: zona 2 por agenda con 500 s restantes
+static void saveRunningZones() {
+    RelayController before;
+    before.init();
+    before.loop();
+    before.turnOn(2, 600, ORIGEN_AGENDA, 7);
+    advanceSeconds(before, 100);
+    TEST_ASSERT_EQUAL(500, before.getRemainingTime(2));
+
+    RelaySnapshot snapshot;
+    before.snapshot(snapshot);
+    WarmRestart warm;
+    TEST_ASSERT_TRUE(warm.update(snapshot, NO_QUEUE, WATERMARK));
+}
+
+void setUp() {
+    NativeShim::useFakeClock(1000);
+    NativeShim::setSerialQuiet(true);
+    NativeShim::clearRtcMemory();
+    inicioEvents = 0;
+    finEvents = 0;
+    lastFinZona = 0;
+    lastFinDuracion = 0;
+}
+
+void tearDown() {
+    NativeShim::setSerialQuiet(false);
+}
+
+void test_zones_resume_after_restart() {
+    RelayController before;
+    before.init();
+    before.setRiegoEventCallback(countRiegoEvent);
+    before.loop();
+    before.turnOn(2, 600, ORIGEN_AGENDA, 7);
+    before.turnOn(5, 60, ORIGEN_MANUAL, 0);
+    advanceSeconds(before, 59);
+    TEST_ASSERT_EQUAL(1, before.getRemainingTime(5));
+
+    RelaySnapshot snapshot;
+    before.snapshot(snapshot);
+    WarmRestart warm;
+    TEST_ASSERT_TRUE(warm.save(snapshot, NO_QUEUE, WATERMARK, 3, 300000));
+    TEST_ASSERT_EQUAL(2, inicioEvents);
+
+    // Arranque: los pines quedan apagados hasta reanudar
+    RelayController after;
+    after.init();
+    after.setRiegoEventCallback(countRiegoEvent);
+    TEST_ASSERT_EQUAL(RELAY_OFF, NativeShim::getPinLevel(RELAY_PINS[1]));
+
+    WarmRestartBlock block;
+    TEST_ASSERT_TRUE(WarmRestart::take(block));
+    TEST_ASSERT_EQUAL(3, block.reason);
+    TEST_ASSERT_EQUAL_UINT32(300000, block.offlineMs);
+    TEST_ASSERT_EQUAL_UINT32(WATERMARK, block.agendaWatermark);
+
+    // El reinicio tardó 2 s: la zona 5 terminó en el medio
+    TEST_ASSERT_EQUAL(1, after.restore(block.relays, 2));
+    TEST_ASSERT_TRUE(after.isActive(2));
+    TEST_ASSERT_EQUAL(539, after.getRemainingTime(2));
+    after.loop();    // Primera vuelta: se conmuta el relé
+    TEST_ASSERT_EQUAL(RELAY_ON, NativeShim::getPinLevel(RELAY_PINS[1]));
+    TEST_ASSERT_FALSE(after.isActive(5));
+    TEST_ASSERT_EQUAL(RELAY_OFF, NativeShim::getPinLevel(RELAY_PINS[4]));
+
+    // Sin inicio duplicado; el riego que quedó abierto se cierra
+    TEST_ASSERT_EQUAL(2, inicioEvents);
+    TEST_ASSERT_EQUAL(1, finEvents);
+    TEST_ASSERT_EQUAL(5, lastFinZona);
+    TEST_ASSERT_EQUAL(60, lastFinDuracion);
+
+    // Termina a la hora original con la duración programada
+    after.loop();
+    advanceSeconds(after, 539);
+    TEST_ASSERT_FALSE(after.isActive(2));
+    TEST_ASSERT_EQUAL(2, finEvents);
+    TEST_ASSERT_EQUAL(2, lastFinZona);
+    TEST_ASSERT_EQUAL(600, lastFinDuracion);
+}
+
+// Escritura en cada cambio: un reinicio no pedido (watchdog, OTA) en
+// cualquier momento reanuda con a lo sumo 1 s de atraso
+void test_state_written_on_every_change() {
+    RelayController relays;
+    relays.init();
+    relays.loop();
+    WarmRestart warm;
+    RelaySnapshot snapshot;
+
+    relays.snapshot(snapshot);
+    TEST_ASSERT_TRUE(warm.update(snapshot, NO_QUEUE, WATERMARK));
+    TEST_ASSERT_FALSE(warm.update(snapshot, NO_QUEUE, WATERMARK));   // Sin cambios: no escribe
+
+    relays.turnOn(3, 300, ORIGEN_MANUAL, 0);
+    relays.snapshot(snapshot);
+    TEST_ASSERT_TRUE(warm.update(snapshot, NO_QUEUE, WATERMARK));
+
+    // Cuenta regresiva: una escritura por segundo, ninguna entre medio
+    for (int i = 0; i < 10; i++) {
+        NativeShim::advanceMillis(500);
+        relays.loop();
+        relays.snapshot(snapshot);
+        warm.update(snapshot, NO_QUEUE, WATERMARK);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2 + 5, warm.getWriteCount());
+
+    // El watermark de agendas avanza aunque no haya riegos
+    TEST_ASSERT_TRUE(warm.update(snapshot, NO_QUEUE, WATERMARK + 60));
+
+    // Watchdog: el bloque ya tiene la cuenta al día
+    WarmRestartBlock block;
+    TEST_ASSERT_TRUE(WarmRestart::take(block));
+    TEST_ASSERT_EQUAL(WARM_RESTART_REASON_STATE, block.reason);
+    TEST_ASSERT_EQUAL(295, block.relays.restante[2]);
+    TEST_ASSERT_EQUAL_UINT32(WATERMARK + 60, block.agendaWatermark);
+}
+
+void test_block_is_consumed_once() {
+    saveRunningZones();
+    WarmRestartBlock block;
+    TEST_ASSERT_TRUE(WarmRestart::take(block));
+    TEST_ASSERT_FALSE(WarmRestart::take(block));
+}
+
+void test_power_loss_or_corruption_is_cold_start() {
+    saveRunningZones();
+    NativeShim::clearRtcMemory();
+    WarmRestartBlock block;
+    TEST_ASSERT_FALSE(WarmRestart::take(block));
+
+    // Un bit cambiado en la foto: CRC inválido, no se reanuda nada
+    saveRunningZones();
+    uint32_t word;
+    uint32_t offset = WARM_RESTART_RTC_OFFSET + 4;
+    TEST_ASSERT_TRUE(ESP.rtcUserMemoryRead(offset, &word, sizeof(word)));
+    word ^= 0x00000100;
+    TEST_ASSERT_TRUE(ESP.rtcUserMemoryWrite(offset, &word, sizeof(word)));
+    TEST_ASSERT_FALSE(WarmRestart::take(block));
+}
+
+// eboot escribe su comando en los primeros 128 bytes al aplicar la OTA
+void test_block_survives_ota_reboot() {
+    saveRunningZones();
+    NativeShim::writeOtaCommand();
+    WarmRestartBlock block;
+    TEST_ASSERT_TRUE(WarmRestart::take(block));
+}
+
+void test_block_fits_rtc_memory() {
+    TEST_ASSERT_EQUAL(0, sizeof(WarmRestartBlock) % 4);
+    TEST_ASSERT_LESS_OR_EQUAL(512, WARM_RESTART_RTC_OFFSET * 4 + sizeof(WarmRestartBlock));
+    TEST_ASSERT_GREATER_OR_EQUAL(32, WARM_RESTART_RTC_OFFSET);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_zones_resume_after_restart);
+    RUN_TEST(test_state_written_on_every_change);
+    RUN_TEST(test_block_is_consumed_once);
+    RUN_TEST(test_power_loss_or_corruption_is_cold_start);
+    RUN_TEST(test_block_survives_ota_reboot);
+    RUN_TEST(test_block_fits_rtc_memory);
+    return UNITY_END();
+}
@@ -0,0 +1,239 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "hardware/RelayController.h"
+#include "scheduler/ZoneSequencer.h"
+
+// ============================================================================
+// Test ZoneSequencer - turnos por capacidad hidráulica con reloj simulado
+// ============================================================================
+
+struct RecordedEvent {
+    int zona;
+    RiegoEvento evento;
+    RiegoOrigen origen;
+    int duracion;
+};
+
+static RecordedEvent events[64];
+static int eventCount = 0;
+
+static void recordEvent(int zona, RiegoEvento evento, RiegoOrigen origen, int duracion, int versionAgenda) {
+    (void)versionAgenda;
+    if (eventCount < 64) {
+        events[eventCount].zona = zona;
+        events[eventCount].evento = evento;
+        events[eventCount].origen = origen;
+        events[eventCount].duracion = duracion;
+    }
+    eventCount++;
+}
+
+static int countEvents(RiegoEvento evento) {
+    int count = 0;
+    for (int i = 0; i < eventCount && i < 64; i++) {
+        if (events[i].evento == evento) count++;
+    }
+    return count;
+}
+
+// Orden en que arrancaron las zonas (eventos de inicio)
+static int startedZone(int n) {
+    for (int i = 0; i < eventCount && i < 64; i++) {
+        if (events[i].evento == RIEGO_INICIO && n-- == 0) return events[i].zona;
+    }
+    return 0;
+}
+
+static void runFor(RelayController& relays, ZoneSequencer& sequencer, unsigned long ms) {
+    for (unsigned long t = 0; t < ms; t += 250) {
+        NativeShim::advanceMillis(250);
+        relays.loop();
+        sequencer.loop();
+    }
+}
+
+void setUp() {
+    NativeShim::useFakeClock(1000);
+    NativeShim::setSerialQuiet(true);
+    eventCount = 0;
+}
+
+void tearDown() {
+    NativeShim::setSerialQuiet(false);
+}
+
+void test_limit_queues_and_starts_when_slot_frees() {
+    RelayController relays;
+    relays.init();
+    relays.setRiegoEventCallback(recordEvent);
+    ZoneSequencer sequencer(&relays);
+    sequencer.setRiegoEventCallback(recordEvent);
+    sequencer.setMaxActive(2);
+
+    TEST_ASSERT_EQUAL(SEQ_STARTED, sequencer.request(1, 60, ORIGEN_AGENDA, 3));
+    TEST_ASSERT_EQUAL(SEQ_STARTED, sequencer.request(2, 120, ORIGEN_AGENDA, 3));
+    TEST_ASSERT_EQUAL(SEQ_QUEUED, sequencer.request(3, 90, ORIGEN_AGENDA, 3));
+    TEST_ASSERT_FALSE(relays.isActive(3));
+    TEST_ASSERT_TRUE(sequencer.isQueued(3));
+    TEST_ASSERT_TRUE(sequencer.isBusy(3));
+    TEST_ASSERT_EQUAL(1, countEvents(RIEGO_EN_COLA));
+    TEST_ASSERT_EQUAL(90, events[2].duracion);
+
+    // La zona 1 termina: la 3 arranca en la misma vuelta
+    runFor(relays, sequencer, 60000);
+    TEST_ASSERT_FALSE(relays.isActive(1));
+    TEST_ASSERT_TRUE(relays.isActive(3));
+    TEST_ASSERT_EQUAL(90, relays.getRemainingTime(3));
+    TEST_ASSERT_EQUAL(0, sequencer.getQueuedCount());
+    TEST_ASSERT_EQUAL(2, sequencer.getActiveCount());
+}
+
+void test_manual_before_agenda_then_arrival_order() {
+    RelayController relays;
+    relays.init();
+    relays.setRiegoEventCallback(recordEvent);
+    ZoneSequencer sequencer(&relays);
+    sequencer.setMaxActive(1);
+
+    sequencer.request(1, 10, ORIGEN_AGENDA, 1);
+    TEST_ASSERT_EQUAL(SEQ_QUEUED, sequencer.request(4, 10, ORIGEN_AGENDA, 1));
+    TEST_ASSERT_EQUAL(SEQ_QUEUED, sequencer.request(2, 10, ORIGEN_AGENDA, 1));
+    TEST_ASSERT_EQUAL(SEQ_QUEUED, sequencer.request(6, 10, ORIGEN_MANUAL, 0));
+    TEST_ASSERT_EQUAL(SEQ_QUEUED, sequencer.request(5, 10, ORIGEN_MANUAL, 0));
+
+    runFor(relays, sequencer, 60000);
+    const int expected[] = {1, 6, 5, 4, 2};
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(expected[i], startedZone(i));
+    }
+    TEST_ASSERT_EQUAL(5, countEvents(RIEGO_FIN));
+}
+
+void test_flow_weights_share_capacity() {
+    RelayController relays;
+    relays.init();
+    relays.setRiegoEventCallback(recordEvent);
+    ZoneSequencer sequencer(&relays);
+    sequencer.setMaxActive(MAX_ZONES);
+    const uint8_t weights[MAX_ZONES] = {3, 1, 1, 2, 1, 1, 1, 5};
+    sequencer.setFlow(4, weights);
+
+    TEST_ASSERT_EQUAL(SEQ_STARTED, sequencer.request(1, 30, ORIGEN_AGENDA, 1));   // 3 de 4
+    TEST_ASSERT_EQUAL(SEQ_STARTED, sequencer.request(2, 60, ORIGEN_AGENDA, 1));   // 4 de 4
+    TEST_ASSERT_EQUAL(SEQ_QUEUED, sequencer.request(4, 30, ORIGEN_AGENDA, 1));
+    // La 3 entraría con la 4 esperando, pero la cola es estricta
+    TEST_ASSERT_EQUAL(SEQ_QUEUED, sequencer.request(3, 30, ORIGEN_AGENDA, 1));
+
+    runFor(relays, sequencer, 30000);     // Termina la 1: entran 4 (2) y 3 (1)
+    TEST_ASSERT_TRUE(relays.isActive(2));
+    TEST_ASSERT_TRUE(relays.isActive(4));
+    TEST_ASSERT_TRUE(relays.isActive(3));
+
+    // Una zona que sola supera el caudal riega sin compañía
+    TEST_ASSERT_EQUAL(SEQ_QUEUED, sequencer.request(8, 30, ORIGEN_MANUAL, 0));
+    runFor(relays, sequencer, 29000);
+    TEST_ASSERT_TRUE(sequencer.isQueued(8));
+    runFor(relays, sequencer, 1000);      // Terminan 2, 3 y 4
+    TEST_ASSERT_TRUE(relays.isActive(8));
+    TEST_ASSERT_EQUAL(1, sequencer.getActiveCount());
+}
+
+void test_cancel_and_update() {
+    RelayController relays;
+    relays.init();
+    relays.setRiegoEventCallback(recordEvent);
+    ZoneSequencer sequencer(&relays);
+    sequencer.setRiegoEventCallback(recordEvent);
+    sequencer.setMaxActive(1);
+
+    sequencer.request(1, 600, ORIGEN_AGENDA, 2);
+    sequencer.request(2, 300, ORIGEN_AGENDA, 2);
+    sequencer.request(3, 300, ORIGEN_AGENDA, 2);
+
+    // Pedido repetido: zona activa reemplaza duración, en cola sube a manual
+    TEST_ASSERT_EQUAL(SEQ_UPDATED, sequencer.request(1, 900, ORIGEN_AGENDA, 2));
+    TEST_ASSERT_EQUAL(900, relays.getRemainingTime(1));
+    TEST_ASSERT_EQUAL(SEQ_UPDATED, sequencer.request(3, 120, ORIGEN_MANUAL, 0));
+
+    // Apagar una zona en cola: evento cancelado y nunca arranca
+    TEST_ASSERT_TRUE(sequencer.cancel(2));
+    TEST_ASSERT_EQUAL(1, countEvents(RIEGO_CANCELADO));
+    TEST_ASSERT_FALSE(sequencer.isQueued(2));
+
+    // Apagar la activa: la 3 arranca enseguida con la duración actualizada
+    TEST_ASSERT_TRUE(sequencer.cancel(1));
+    TEST_ASSERT_TRUE(relays.isActive(3));
+    TEST_ASSERT_EQUAL(120, relays.getRemainingTime(3));
+    TEST_ASSERT_FALSE(sequencer.cancel(2));
+
+    TEST_ASSERT_EQUAL(SEQ_REJECTED, sequencer.request(9, 60, ORIGEN_MANUAL, 0));
+    TEST_ASSERT_EQUAL(SEQ_REJECTED, sequencer.request(4, MAX_RIEGO_DURATION + 1, ORIGEN_MANUAL, 0));
+}
+
+void test_queue_survives_snapshot_restore() {
+    RelayController relays;
+    relays.init();
+    ZoneSequencer before(&relays);
+    before.setMaxActive(1);
+    before.request(1, 60, ORIGEN_AGENDA, 4);
+    before.request(5, 100, ORIGEN_AGENDA, 4);
+    before.request(3, 200, ORIGEN_AGENDA, 4);
+    before.request(7, 50, ORIGEN_MANUAL, 0);
+
+    SequencerSnapshot queue;
+    before.snapshot(queue);
+
+    RelayController relaysAfter;
+    relaysAfter.init();
+    relaysAfter.setRiegoEventCallback(recordEvent);
+    relaysAfter.turnOn(1, 60, ORIGEN_AGENDA, 4);   // Reanudada por RelaySnapshot
+    ZoneSequencer after(&relaysAfter);
+    after.setMaxActive(1);
+    TEST_ASSERT_EQUAL(3, after.restore(queue));
+
+    // Un pedido nuevo va detrás de los restaurados de su mismo origen
+    after.request(2, 10, ORIGEN_AGENDA, 4);
+    runFor(relaysAfter, after, 500000);
+    const int expected[] = {1, 7, 5, 3, 2};
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(expected[i], startedZone(i));
+    }
+}
+
+// Noche con las 8 zonas programadas a la misma hora: nunca más de 2 abiertas
+// y se riega todo sin huecos (4 turnos de 30 min)
+void test_dense_night_schedule() {
+    RelayController relays;
+    relays.init();
+    relays.setRiegoEventCallback(recordEvent);
+    ZoneSequencer sequencer(&relays);
+    sequencer.setMaxActive(2);
+
+    unsigned long start = millis();
+    for (int zona = 1; zona <= MAX_ZONES; zona++) {
+        sequencer.request(zona, 1800, ORIGEN_AGENDA, 9);
+    }
+    uint8_t maxActive = 0;
+    unsigned long lastFin = 0;
+    while (countEvents(RIEGO_FIN) < MAX_ZONES) {
+        NativeShim::advanceMillis(1000);
+        relays.loop();
+        sequencer.loop();
+        uint8_t active = sequencer.getActiveCount();
+        if (active > maxActive) maxActive = active;
+        if (countEvents(RIEGO_FIN) == MAX_ZONES) lastFin = millis();
+    }
+    TEST_ASSERT_EQUAL(2, maxActive);
+    TEST_ASSERT_EQUAL_UINT32(4UL * 1800UL * 1000UL, lastFin - start);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_limit_queues_and_starts_when_slot_frees);
+    RUN_TEST(test_manual_before_agenda_then_arrival_order);
+    RUN_TEST(test_flow_weights_share_capacity);
+    RUN_TEST(test_cancel_and_update);
+    RUN_TEST(test_queue_survives_snapshot_restore);
+    RUN_TEST(test_dense_night_schedule);
+    return UNITY_END();
+}
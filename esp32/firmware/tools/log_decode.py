@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""
+Decodificador del registro binario de logs (storage/LogRecorder.h)
+
+Convierte /log.1.bin y /log.bin (bajados del nodo, por ejemplo desde el portal
+de configuración en http://192.168.4.1/log.bin) de vuelta a texto, con la
+tabla de formatos de tools/log_formats.py. Pasar los archivos del más viejo
+al más nuevo.
+
+Uso (desde esp32/firmware):
+    python tools/log_decode.py log.1.bin log.bin [--formats .pio/build/nodemcuv2/log_formats.json]
+
+Sin --formats la tabla se arma en el momento desde --src (default: src); debe
+corresponder al firmware que escribió el registro.
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+from pathlib import Path
+from typing import Dict, Iterator, List, Optional, Tuple
+
+LEVEL_NAMES = {0: "", 1: "ERROR", 2: "WARN", 3: "INFO", 4: "DEBUG"}
+LEVEL_TRUNCATED = 0x80
+HEADER = struct.Struct("<IBI")      # millis, nivel, id (después del largo)
+
+CONVERSION_RE = re.compile(r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d*))?"
+                           r"(?P<length>hh|h|ll|l|z|j|t|L)?(?P<conv>[diuxXocpsSfFeEgGaA%])")
+
+
+class ArgReader:
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+
+    def varint(self) -> int:
+        value = 0
+        shift = 0
+        while True:
+            if self.pos >= len(self.data):
+                raise EOFError
+            byte = self.data[self.pos]
+            self.pos += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    def signed(self) -> int:
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+    def string(self) -> str:
+        if self.pos >= len(self.data):
+            raise EOFError
+        length = self.data[self.pos]
+        raw = self.data[self.pos + 1:self.pos + 1 + length]
+        if len(raw) < length:
+            raise EOFError
+        self.pos += 1 + length
+        return raw.decode("utf-8", errors="replace")
+
+    def float32(self) -> float:
+        if self.pos + 4 > len(self.data):
+            raise EOFError
+        value = struct.unpack_from("<f", self.data, self.pos)[0]
+        self.pos += 4
+        return value
+
+
+def render(fmt: str, args: bytes, truncated: bool) -> str:
+    """printf de C en Python, leyendo cada argumento como lo codificó el firmware"""
+    reader = ArgReader(args)
+    missing = False
+
+    def convert(match: "re.Match") -> str:
+        nonlocal missing
+        conv = match.group("conv")
+        if conv == "%":
+            return "%"
+        if missing:
+            return "?"
+        try:
+            width = match.group("width") or ""
+            prec = match.group("prec")
+            if width == "*":
+                width = str(reader.signed())
+            if prec == "*":
+                value = reader.signed()
+                prec = str(value) if value >= 0 else None   # Negativa: como printf, sin precisión
+            spec = "%" + match.group("flags") + width + ("." + prec if prec is not None else "")
+            if conv in "di":
+                return (spec + "d") % reader.signed()
+            if conv in "uxXo":
+                return (spec + ("d" if conv == "u" else conv)) % reader.varint()
+            if conv == "c":
+                return (spec + "c") % reader.varint()
+            if conv == "p":
+                return "0x%x" % reader.varint()
+            if conv in "sS":
+                return (spec + "s") % reader.string()
+            return (spec + {"F": "f", "a": "e", "A": "E"}.get(conv, conv)) % reader.float32()
+        except EOFError:
+            missing = True
+            return "?"
+
+    text = CONVERSION_RE.sub(convert, fmt)
+    if truncated or missing:
+        text += " [argumentos cortados]"
+    return text
+
+
+def records(data: bytes) -> Iterator[Tuple[int, int, int, bytes]]:
+    """(millis, nivel, id, argumentos) de cada registro completo"""
+    pos = 0
+    while pos < len(data):
+        length = data[pos]
+        if length + 1 < 1 + HEADER.size or pos + 1 + length > len(data):
+            print(f"log_decode: registro incompleto en el byte {pos}, fin del archivo", file=sys.stderr)
+            return
+        millis, level, fmt_id = HEADER.unpack_from(data, pos + 1)
+        yield millis, level, fmt_id, data[pos + 1 + HEADER.size:pos + 1 + length]
+        pos += 1 + length
+
+
+def decode(data: bytes, formats: Dict[str, dict]) -> List[str]:
+    lines = []
+    for millis, level, fmt_id, args in records(data):
+        if fmt_id == 0:
+            lines.append("=== arranque ===")
+            continue
+        stamp = f"{millis // 1000:>8}.{millis % 1000:03d}"
+        name = LEVEL_NAMES.get(level & ~LEVEL_TRUNCATED, str(level))
+        entry: Optional[dict] = formats.get(f"0x{fmt_id:08x}")
+        if entry is None:
+            text = f"<formato desconocido 0x{fmt_id:08x}> {args.hex()}"
+        else:
+            text = render(entry["format"], args, bool(level & LEVEL_TRUNCATED))
+        lines.append(f"{stamp} [{name}] {text}")
+    return lines
+
+
+def load_formats(path: Optional[str], src: str) -> Dict[str, dict]:
+    if path:
+        return json.loads(Path(path).read_text(encoding="utf-8"))["formats"]
+    sys.path.insert(0, str(Path(__file__).resolve().parent))
+    import log_formats
+    table, collisions = log_formats.scan(Path(src))
+    for message in collisions:
+        print(f"log_decode: {message}", file=sys.stderr)
+    return table
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Registro binario de logs del nodo a texto")
+    parser.add_argument("files", nargs="+", help="Archivos del registro, del más viejo al más nuevo")
+    parser.add_argument("--formats", help="Tabla de tools/log_formats.py (JSON)")
+    parser.add_argument("--src", default="src", help="Fuentes para armar la tabla si no se pasa --formats")
+    args = parser.parse_args()
+
+    formats = load_formats(args.formats, args.src)
+    for name in args.files:
+        for line in decode(Path(name).read_bytes(), formats):
+            print(line)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+Tabla de formatos de log para el registro binario (storage/LogRecorder.h)
+
+El firmware no guarda el texto de cada línea sino el id de su formato: el
+hash FNV-1a de 32 bits del literal (Logger::formatId). Este script recorre las
+fuentes, junta los literales de LOG_ERROR/WARN/INFO/DEBUG y Logger::logf,
+calcula el mismo hash y escribe la tabla id -> formato que usa
+tools/log_decode.py. Falla si dos formatos distintos comparten id.
+
+Uso (desde esp32/firmware):
+    python tools/log_formats.py [--src src] [-o log_formats.json]
+
+También corre sola en cada compilación (extra_scripts = pre:tools/log_formats.py
+en platformio.ini) y deja la tabla en .pio/build/<env>/log_formats.json, junto
+al firmware que la usa.
+"""
+
+import argparse
+import json
+import re
+import sys
+from pathlib import Path
+from typing import Dict, List, Tuple
+
+BOOT_MARKER_ID = 0
+SOURCE_SUFFIXES = (".cpp", ".h")
+
+# Inicio de una llamada con formato literal: nivel fijo por macro o explícito en logf
+CALL_RE = re.compile(r"\bLOG_(ERROR|WARN|INFO|DEBUG)\s*\(|\bLogger::logf\s*\(\s*LOG_LEVEL_([A-Z]+)\s*,")
+STRING_RE = re.compile(r'\s*"((?:[^"\\\n]|\\.)*)"')
+SIMPLE_ESCAPES = {"n": 10, "t": 9, "r": 13, "0": 0, "\\": 92, '"': 34, "'": 39,
+                  "a": 7, "b": 8, "f": 12, "v": 11, "?": 63}
+
+
+def fnv1a(data: bytes) -> int:
+    value = 2166136261
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def unescape(literal: str) -> bytes:
+    """Bytes de un literal C tal como los ve el compilador (fuente en UTF-8)"""
+    out = bytearray()
+    i = 0
+    while i < len(literal):
+        ch = literal[i]
+        if ch != "\\":
+            out += ch.encode("utf-8")
+            i += 1
+            continue
+        nxt = literal[i + 1]
+        if nxt == "x":
+            match = re.match(r"[0-9a-fA-F]+", literal[i + 2:])
+            out.append(int(match.group(0), 16) & 0xFF)
+            i += 2 + len(match.group(0))
+        elif nxt in "01234567":
+            match = re.match(r"[0-7]{1,3}", literal[i + 1:])
+            out.append(int(match.group(0), 8) & 0xFF)
+            i += 1 + len(match.group(0))
+        else:
+            out.append(SIMPLE_ESCAPES.get(nxt, ord(nxt)))
+            i += 2
+    return bytes(out)
+
+
+def read_literal(text: str, pos: int) -> Tuple[bytes, bool]:
+    """Literales adyacentes a partir de `pos` ("a" "b" -> "ab"); False si no hay"""
+    data = b""
+    found = False
+    while True:
+        match = STRING_RE.match(text, pos)
+        if not match:
+            return data, found
+        data += unescape(match.group(1))
+        found = True
+        pos = match.end()
+
+
+def scan(src: Path) -> Tuple[Dict[str, dict], List[str]]:
+    """Tabla {"0x%08x": {...}} y lista de colisiones"""
+    table: Dict[str, dict] = {}
+    collisions: List[str] = []
+    for path in sorted(p for p in src.rglob("*") if p.suffix in SOURCE_SUFFIXES):
+        text = path.read_text(encoding="utf-8", errors="replace")
+        for call in CALL_RE.finditer(text):
+            data, found = read_literal(text, call.end())
+            if not found:
+                continue   # Definición de la macro o formato no literal
+            fmt_id = fnv1a(data)
+            key = f"0x{fmt_id:08x}"
+            line = text.count("\n", 0, call.start()) + 1
+            entry = {
+                "format": data.decode("utf-8", errors="replace"),
+                "level": call.group(1) or call.group(2),
+                "file": path.relative_to(src.parent).as_posix(),
+                "line": line,
+            }
+            if fmt_id == BOOT_MARKER_ID:
+                collisions.append(f"{entry['file']}:{line}: el formato tiene el id reservado 0")
+            elif key in table and table[key]["format"] != entry["format"]:
+                other = table[key]
+                collisions.append(f"{entry['file']}:{line} y {other['file']}:{other['line']}: "
+                                  f"mismo id {key} para formatos distintos")
+            elif key not in table:
+                table[key] = entry
+    return table, collisions
+
+
+def write_table(src: Path, output: Path) -> int:
+    table, collisions = scan(src)
+    for message in collisions:
+        print(f"log_formats: {message}", file=sys.stderr)
+    if collisions:
+        return 1
+    output.parent.mkdir(parents=True, exist_ok=True)
+    output.write_text(json.dumps({"hash": "fnv1a32", "formats": table},
+                                 ensure_ascii=False, indent=1, sort_keys=True), encoding="utf-8")
+    print(f"log_formats: {len(table)} formatos -> {output}", file=sys.stderr)
+    return 0
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Tabla id -> formato de los logs del firmware")
+    parser.add_argument("--src", default="src", help="Fuentes del firmware (default: src)")
+    parser.add_argument("-o", "--output", default="log_formats.json", help="JSON de salida")
+    args = parser.parse_args()
+    return write_table(Path(args.src), Path(args.output))
+
+
+# ============= Script de PlatformIO (extra_scripts = pre:...) =============
+try:
+    Import("env")  # noqa: F821 - lo define SCons al cargar el script
+except NameError:
+    env = None
+
+if env is not None:
+    project = Path(env.subst("$PROJECT_DIR"))
+    if write_table(project / "src", Path(env.subst("$BUILD_DIR")) / "log_formats.json") != 0:
+        env.Exit(1)
+elif __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+Costo en flash y RAM de cada nivel de log
+
+Compila el firmware una vez por LOG_LEVEL (0 = NONE ... 4 = DEBUG) con
+PlatformIO y compara las secciones del ELF. En el ESP8266:
+  - DRAM  = .data + .rodata + .bss (80 KB, la restricción más ajustada)
+  - IRAM  = .text / .iram0.text
+  - Flash = .irom0.text (código y formatos de log en PSTR)
+
+Uso (desde esp32/firmware):
+    python tools/log_size_report.py [--env nodemcuv2] [--levels 0,1,2,3,4]
+"""
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+from pathlib import Path
+from typing import Dict, List
+
+LEVEL_NAMES = {0: "NONE", 1: "ERROR", 2: "WARN", 3: "INFO", 4: "DEBUG"}
+
+REGIONS = {
+    "dram": (".data", ".rodata", ".bss"),
+    "iram": (".text", ".iram0.text", ".text1"),
+    "flash": (".irom0.text",),
+}
+
+
+def find_size_tool() -> str:
+    tool = shutil.which("xtensa-lx106-elf-size")
+    if tool:
+        return tool
+    packages = Path(os.environ.get("PLATFORMIO_CORE_DIR", Path.home() / ".platformio")) / "packages"
+    for candidate in sorted(packages.glob("toolchain-xtensa*/bin/xtensa-lx106-elf-size*")):
+        return str(candidate)
+    sys.exit("No se encontró xtensa-lx106-elf-size (instalar la plataforma espressif8266)")
+
+
+def build(env: str, level: int, build_dir: Path) -> Path:
+    environ = dict(os.environ)
+    environ["PLATFORMIO_BUILD_FLAGS"] = f"-DLOG_LEVEL={level}"
+    environ["PLATFORMIO_BUILD_DIR"] = str(build_dir)
+    print(f"Compilando {env} con LOG_LEVEL={level} ({LEVEL_NAMES.get(level, '?')})...", file=sys.stderr)
+    result = subprocess.run(["pio", "run", "-e", env], env=environ,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout[-4000:])
+        sys.exit(f"Falló la compilación con LOG_LEVEL={level}")
+    return build_dir / env / "firmware.elf"
+
+
+def section_sizes(size_tool: str, elf: Path) -> Dict[str, int]:
+    output = subprocess.check_output([size_tool, "-A", str(elf)], text=True)
+    sections = {}
+    for line in output.splitlines():
+        parts = line.split()
+        if len(parts) >= 2 and parts[0].startswith(".") and parts[1].isdigit():
+            sections[parts[0]] = int(parts[1])
+    return {region: sum(sections.get(name, 0) for name in names) for region, names in REGIONS.items()}
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Costo en flash/RAM por nivel de log")
+    parser.add_argument("--env", default="nodemcuv2", help="Entorno de platformio.ini")
+    parser.add_argument("--levels", default="0,1,2,3,4", help="Niveles a compilar (coma)")
+    parser.add_argument("--build-dir", default=".pio/log_size", help="Directorio de builds")
+    args = parser.parse_args()
+
+    levels: List[int] = sorted(int(level) for level in args.levels.split(","))
+    size_tool = find_size_tool()
+    sizes = {}
+    for level in levels:
+        elf = build(args.env, level, Path(args.build_dir) / f"level{level}")
+        sizes[level] = section_sizes(size_tool, elf)
+
+    base = sizes[levels[0]]
+    print(f"{'Nivel':<8}{'Flash':>10}{'IRAM':>9}{'DRAM':>9}   {'+Flash':>8}{'+IRAM':>8}{'+DRAM':>8}  (vs {LEVEL_NAMES[levels[0]]})")
+    for level in levels:
+        s = sizes[level]
+        print(f"{LEVEL_NAMES.get(level, str(level)):<8}{s['flash']:>10}{s['iram']:>9}{s['dram']:>9}   "
+              f"{s['flash'] - base['flash']:>+8}{s['iram'] - base['iram']:>+8}{s['dram'] - base['dram']:>+8}")
+
+
+if __name__ == "__main__":
+    main()
@@ -4,27 +4,29 @@ Mock ESP32 - Simulador de nodo de riego para testing
 
 Simula un ESP32 conectado al broker MQTT:
 - Se suscribe a riego/{nodeId}/agenda/sync para recibir agendas
+  (lista completa o delta por versión, igual que el firmware)
+- Reporta su versión en riego/{nodeId}/agenda/version al conectar y ante
+  un salto de versión, para que el backend le envíe los cambios perdidos
 - Se suscribe a riego/{nodeId}/cmd/zona/# para comandos manuales
 - Simula la ejecución de riegos (logs en consola)
-- Mantiene un estado simple de la agenda actual
 
 Uso:
     python mock_esp32.py --node-id UUID_DEL_NODO [--mqtt-host localhost] [--mqtt-port 1883]
+    python mock_esp32.py --self-test   # sync delta contra broker y backend simulados (sin red)
 """
 
 import argparse
 import json
 import sys
 import time
+import uuid
 from datetime import datetime
-from typing import Optional, Dict, Any
+from typing import Optional, Dict, Any, List, Callable
 
 try:
     import paho.mqtt.client as mqtt
 except ImportError:
-    print("ERROR: paho-mqtt no está instalado.")
-    print("Instala con: pip install paho-mqtt")
-    sys.exit(1)
+    mqtt = None  # Solo requerido para conectarse a un broker real
 
 
 class MockESP32:
@@ -34,13 +36,19 @@ class MockESP32:
         self.node_id = node_id
         self.mqtt_host = mqtt_host
         self.mqtt_port = mqtt_port
-        self.client: Optional[mqtt.Client] = None
-        self.agenda_actual: Optional[Dict[str, Any]] = None
+        self.client = None
+        self.agendas: Dict[str, Dict[str, Any]] = {}  # Agenda local por id
         self.agenda_version: int = 0
+        self.quiet = False
         
         # Topics
         self.topic_agenda_sync = f"riego/{node_id}/agenda/sync"
+        self.topic_agenda_version = f"riego/{node_id}/agenda/version"
         self.topic_cmd_zona = f"riego/{node_id}/cmd/zona/+"
+    
+    def log(self, mensaje: str = ""):
+        if not self.quiet:
+            print(mensaje)
         
     def on_connect(self, client, userdata, flags, rc, properties=None):
         """Callback cuando se conecta al broker"""
@@ -54,6 +62,9 @@ class MockESP32:
             
             client.subscribe(self.topic_cmd_zona)
             print(f"✓ Suscrito a: {self.topic_cmd_zona}")
+            
+            # Reportar versión local: el backend responde con delta o lista completa
+            self.report_version()
             print("\n--- Esperando mensajes MQTT ---\n")
         else:
             print(f"✗ Error de conexión. Código: {rc}")
@@ -79,42 +90,55 @@ class MockESP32:
         except Exception as e:
             print(f"[{timestamp}] ✗ Error procesando mensaje: {e}")
             
+    def report_version(self, version: Optional[int] = None):
+        """Publica la versión local en riego/{nodeId}/agenda/version"""
+        version = self.agenda_version if version is None else version
+        if self.client:
+            self.client.publish(self.topic_agenda_version, json.dumps({"version": version}))
+            self.log(f"→ Versión de agenda reportada: {version}")
+    
     def _handle_agenda_sync(self, payload: Dict[str, Any], timestamp: str):
-        """Procesa un mensaje de sincronización de agenda"""
-        print(f"\n{'='*60}")
-        print(f"[{timestamp}] 📅 AGENDA RECIBIDA")
-        print(f"{'='*60}")
-        
+        """Procesa un mensaje de sincronización de agenda (completa o delta)"""
+        tipo = payload.get("tipo", "completa")
         version = payload.get("version", 0)
-        nombre = payload.get("nombre", "Sin nombre")
-        activa = payload.get("activa", False)
-        programaciones = payload.get("programaciones", [])
-        
-        print(f"Versión: {version}")
-        print(f"Nombre: {nombre}")
-        print(f"Activa: {'SÍ' if activa else 'NO'}")
-        print(f"Programaciones: {len(programaciones)}")
-        
-        if self.agenda_version > 0 and version <= self.agenda_version:
-            print(f"⚠️  Versión recibida ({version}) <= versión actual ({self.agenda_version})")
-            print(f"   (Ignorando, ya tengo esta versión o una más reciente)")
+        agendas = payload.get("agendas", [])
+        
+        self.log(f"\n{'='*60}")
+        self.log(f"[{timestamp}] 📅 AGENDA RECIBIDA ({tipo})")
+        self.log(f"{'='*60}")
+        
+        if tipo == "delta":
+            base = payload.get("baseVersion", -1)
+            eliminadas = payload.get("eliminadas", [])
+            self.log(f"Delta: {base} -> {version} ({len(agendas)} nuevas/modificadas, {len(eliminadas)} eliminadas)")
+            
+            if version == self.agenda_version:
+                self.log("✓ Ya tengo esta versión, delta sin cambios")
+            elif base != self.agenda_version:
+                # Salto de versión: pedir los cambios desde la versión local
+                self.log(f"⚠️  Salto de versión (local {self.agenda_version}, base {base}), pidiendo resync")
+                self.report_version()
+            else:
+                # Aplicar sobre una copia y reemplazar de una vez (transaccional)
+                nuevas = dict(self.agendas)
+                for agenda in agendas:
+                    nuevas[agenda["id"]] = agenda
+                for agenda_id in eliminadas:
+                    nuevas.pop(agenda_id, None)
+                self.agendas = nuevas
+                self.agenda_version = version
+                self.log(f"✓ Delta aplicado (versión {version}, {len(self.agendas)} agendas)")
         else:
-            # Actualizar agenda local
-            self.agenda_actual = payload
+            self.agendas = {a["id"]: a for a in agendas}
             self.agenda_version = version
-            print(f"✓ Agenda actualizada (versión {version})")
-            
-            # Mostrar programaciones
-            if programaciones:
-                print("\nProgramaciones:")
-                for i, prog in enumerate(programaciones, 1):
-                    zona = prog.get("zona")
-                    hora = prog.get("hora")
-                    duracion = prog.get("duracionMinutos")
-                    dias = prog.get("diasSemana", [])
-                    print(f"  {i}. Zona {zona} - {hora} - {duracion}min - Días: {dias}")
+            self.log(f"✓ Agenda reemplazada (versión {version}, {len(self.agendas)} agendas)")
         
-        print(f"{'='*60}\n")
+        for i, agenda in enumerate(self.agendas.values(), 1):
+            estado = "" if agenda.get("activa", True) else " (inactiva)"
+            self.log(f"  {i}. Zona {agenda.get('zona')} - {agenda.get('horaInicio')} - "
+                     f"{agenda.get('duracionMin')}min - Días: {agenda.get('diasSemana', [])}{estado}")
+        
+        self.log(f"{'='*60}\n")
         
     def _handle_comando_zona(self, zona: str, payload: Dict[str, Any], timestamp: str):
         """Procesa un comando manual de riego en una zona"""
@@ -173,6 +197,11 @@ class MockESP32:
             
     def run(self):
         """Inicia el mock ESP32"""
+        if mqtt is None:
+            print("ERROR: paho-mqtt no está instalado.")
+            print("Instala con: pip install paho-mqtt")
+            sys.exit(1)
+        
         print("\n" + "="*60)
         print("  MOCK ESP32 - Simulador de nodo de riego")
         print("="*60 + "\n")
@@ -209,13 +238,195 @@ class MockESP32:
             sys.exit(1)
 
 
+# ============================================================================
+# Broker y backend simulados (sin red) para probar el sync delta
+# ============================================================================
+
+class _Message:
+    def __init__(self, topic: str, payload: bytes):
+        self.topic = topic
+        self.payload = payload
+
+
+def _topic_matches(pattern: str, topic: str) -> bool:
+    p_parts = pattern.split("/")
+    t_parts = topic.split("/")
+    for i, p in enumerate(p_parts):
+        if p == "#":
+            return True
+        if i >= len(t_parts) or (p != "+" and p != t_parts[i]):
+            return False
+    return len(p_parts) == len(t_parts)
+
+
+class LoopbackBroker:
+    """Broker MQTT en proceso: entrega cada publish a los suscriptores conectados.
+    Los publish hechos desde un callback se encolan y se entregan después (en orden)."""
+    
+    def __init__(self):
+        self.subscriptions: List[tuple] = []  # (pattern, callback, client)
+        self.pending: List[tuple] = []
+        self.delivering = False
+    
+    def client(self, on_message: Callable):
+        return LoopbackClient(self, on_message)
+    
+    def publish(self, topic: str, payload):
+        data = payload.encode() if isinstance(payload, str) else payload
+        self.pending.append((topic, data))
+        if self.delivering:
+            return
+        self.delivering = True
+        try:
+            while self.pending:
+                topic, data = self.pending.pop(0)
+                for pattern, callback, client in list(self.subscriptions):
+                    if client.connected and _topic_matches(pattern, topic):
+                        callback(client, None, _Message(topic, data))
+        finally:
+            self.delivering = False
+
+
+class LoopbackClient:
+    """Misma interfaz que paho (subscribe/publish) sobre LoopbackBroker"""
+    
+    def __init__(self, broker: LoopbackBroker, on_message: Callable):
+        self.broker = broker
+        self.on_message = on_message
+        self.connected = True
+    
+    def subscribe(self, pattern: str):
+        self.broker.subscriptions.append((pattern, self.on_message, self))
+    
+    def publish(self, topic: str, payload):
+        if self.connected:
+            self.broker.publish(topic, payload)
+
+
+class MockBackend:
+    """Réplica del sync del backend (AgendaService): deltas con tombstones"""
+    
+    def __init__(self, broker: LoopbackBroker, node_id: str):
+        self.node_id = node_id
+        self.version = 0
+        self.agendas: Dict[str, Dict[str, Any]] = {}  # id -> agenda (con "_version")
+        self.eliminadas: Dict[str, int] = {}          # id -> versión de la baja
+        self.client = broker.client(self._on_message)
+        self.client.subscribe("riego/+/agenda/version")
+    
+    def upsert(self, agenda: Dict[str, Any]):
+        self.version += 1
+        self.agendas[agenda["id"]] = dict(agenda, _version=self.version)
+        self.eliminadas.pop(agenda["id"], None)
+        self._publish(self.version - 1)
+    
+    def delete(self, agenda_id: str):
+        self.version += 1
+        del self.agendas[agenda_id]
+        self.eliminadas[agenda_id] = self.version
+        self._publish(self.version - 1)
+    
+    def build_payload(self, desde: int) -> Dict[str, Any]:
+        delta = 0 < desde <= self.version
+        visibles = [a for a in self.agendas.values() if not delta or a["_version"] > desde]
+        payload: Dict[str, Any] = {"tipo": "delta" if delta else "completa"}
+        if delta:
+            payload["baseVersion"] = desde
+        payload["version"] = self.version
+        payload["agendas"] = [{k: v for k, v in a.items() if k != "_version"} for a in visibles]
+        if delta:
+            payload["eliminadas"] = [i for i, v in self.eliminadas.items() if v > desde]
+        return payload
+    
+    def _publish(self, desde: int):
+        topic = f"riego/{self.node_id}/agenda/sync"
+        self.client.publish(topic, json.dumps(self.build_payload(desde)))
+    
+    def _on_message(self, client, userdata, msg):
+        version = json.loads(msg.payload.decode()).get("version", 0)
+        if version != self.version or version == 0:
+            self._publish(version)
+
+
+def _agenda(zona: int, hora: str) -> Dict[str, Any]:
+    return {"id": str(uuid.uuid4()), "zona": zona, "diasSemana": ["LUN", "JUE"],
+            "horaInicio": hora, "duracionMin": 10, "activa": True}
+
+
+def self_test() -> int:
+    """Escenario de sync delta completo contra el broker y backend simulados"""
+    node_id = "550e8400-e29b-41d4-a716-446655440000"
+    broker = LoopbackBroker()
+    backend = MockBackend(broker, node_id)
+    node = MockESP32(node_id)
+    node.quiet = True
+    node.client = broker.client(node.on_message)
+    node.client.subscribe(node.topic_agenda_sync)
+    
+    sent: List[Dict[str, Any]] = []
+    sniffer = broker.client(lambda c, u, m: sent.append(json.loads(m.payload.decode())))
+    sniffer.subscribe(f"riego/{node_id}/agenda/sync")
+    
+    def check(nombre: str, condicion: bool):
+        print(f"  {'✓' if condicion else '✗'} {nombre}")
+        if not condicion:
+            raise AssertionError(nombre)
+    
+    def same_as_backend() -> bool:
+        esperadas = backend.build_payload(0)["agendas"]
+        return (node.agenda_version == backend.version and
+                node.agendas == {a["id"]: a for a in esperadas})
+    
+    print("Self-test sync delta (broker y backend simulados)")
+    try:
+        # 1. Nodo nuevo: versión 0 -> lista completa; luego un delta por cambio
+        a1, a2, a3 = _agenda(1, "06:00"), _agenda(2, "07:00"), _agenda(3, "08:00")
+        backend.upsert(a1)
+        backend.upsert(a2)
+        check("primer cambio llega como lista completa", sent[0]["tipo"] == "completa")
+        check("cambios siguientes llegan como delta de una agenda",
+              sent[1]["tipo"] == "delta" and len(sent[1]["agendas"]) == 1)
+        check("nodo en la versión del backend", same_as_backend())
+        
+        # 2. Nodo desconectado: pierde dos cambios
+        node.client.connected = False
+        backend.upsert(dict(a1, horaInicio="06:30"))
+        backend.delete(a2["id"])
+        node.client.connected = True
+        
+        # 3. El siguiente delta tiene un salto de versión: el nodo pide resync
+        sent.clear()
+        backend.upsert(a3)
+        check("delta con salto de versión no se aplica directamente", sent[0]["baseVersion"] == 4)
+        check("resync por delta desde la versión local",
+              len(sent) == 2 and sent[1]["tipo"] == "delta" and sent[1]["baseVersion"] == 2)
+        check("el delta de resync incluye la baja", sent[1]["eliminadas"] == [a2["id"]])
+        check("nodo en la versión del backend tras el resync", same_as_backend())
+        
+        # 4. Reconexión al día: reportar versión no genera tráfico
+        sent.clear()
+        node.report_version()
+        check("nodo al día no recibe payload", sent == [])
+        
+        # 5. Nodo sin agenda local (versión 0): lista completa
+        node.agendas, node.agenda_version = {}, 0
+        node.report_version()
+        check("versión 0 recibe lista completa", sent[-1]["tipo"] == "completa")
+        check("nodo en la versión del backend tras la lista completa", same_as_backend())
+    except AssertionError:
+        print("Self-test FALLÓ")
+        return 1
+    
+    print("Self-test OK")
+    return 0
+
+
 def main():
     parser = argparse.ArgumentParser(
         description="Mock ESP32 - Simulador de nodo de riego para testing"
     )
     parser.add_argument(
         "--node-id",
-        required=True,
         help="UUID del nodo (ej: 550e8400-e29b-41d4-a716-446655440000)"
     )
     parser.add_argument(
@@ -230,8 +441,19 @@ def main():
         help="Puerto del broker MQTT (default: 1883)"
     )
     
+    parser.add_argument(
+        "--self-test",
+        action="store_true",
+        help="Probar el sync delta contra broker y backend simulados (sin red)"
+    )
+    
     args = parser.parse_args()
     
+    if args.self_test:
+        sys.exit(self_test())
+    if not args.node_id:
+        parser.error("--node-id es requerido")
+    
     # Crear y ejecutar el mock
     mock = MockESP32(
         node_id=args.node_id,